@@ -0,0 +1,159 @@
+/*
+Parneet Baidwan - 251259638
+Description: This benchmark runs the same FileSystemService operations (listing every directory without the cache, a parallel walk, pasting a folder and deleting the copy) on a generated tree through each filesystem backend: the posix-fd and std::filesystem backends on the real tree, and the memory backend seeded with a mirror of it, once with no delay and once modelling slower storage. It checks that every backend sees the same number of entries and copies the same number of bytes before reporting the times.
+February 1, 2026
+*/
+
+#include "FileSystemService.h"
+#include "FsBackend.h"
+#include "TreeWalker.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr int kDirs = 40;
+    constexpr int kFilesPerDir = 50;
+
+    // Memory backend models: no delay, then 100 us per call with copies at 200 MB/s
+    const char* const kSlowModel = "100:200000000";
+
+    struct Result
+    {
+        double list = 0;
+        double walk = 0;
+        double paste = 0;
+        double remove = 0;
+        std::uint64_t listed = 0;
+        std::uint64_t walked = 0;
+        std::uintmax_t copiedBytes = 0;
+        bool ok = true;
+    };
+
+    template <typename Fn>
+    double Seconds(Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /*
+    Function: Run
+    Description: Times the operations on one backend. The paste copies the first folder of the
+                 tree into a scratch folder next to it, which is deleted again afterwards.
+    Parameters:
+      - spec: Backend spec, as given to --backend=.
+      - root: Tree to work on.
+    Returns:
+      - Result: Times and totals; ok is false if an operation failed.
+    */
+    Result Run(const std::string& spec, const fs::path& root)
+    {
+        Result r;
+        std::string err;
+        std::shared_ptr<FsBackend> backend = MakeFsBackend(spec, err);
+        if (!backend)
+        {
+            std::printf("BackendBench: %s\n", err.c_str());
+            r.ok = false;
+            return r;
+        }
+        FileSystemService service(backend);
+
+        r.list = Seconds([&]
+        {
+            r.listed += service.ListDirectory(root, err).size();
+            for (int d = 0; d < kDirs; ++d)
+                r.listed += service.ListDirectory(root / ("dir" + std::to_string(d)), err).size();
+        });
+
+        TreeWalkCallbacks callbacks;
+        TreeWalkStats stats;
+        r.walk = Seconds([&] { r.ok &= service.WalkTree(root, TreeWalkOptions{}, callbacks, stats, err); });
+        r.walked = stats.entries;
+
+        const fs::path scratch = root / "scratch";
+        r.ok &= service.CreateDirectory(root, "scratch", err);
+        VirtualClipboard clip;
+        clip.source = root / "dir0";
+        clip.hasItem = true;
+        PasteStats pasted;
+        r.paste = Seconds([&] { r.ok &= service.PasteInto(clip, scratch, PasteOptions{}, pasted, err); });
+        r.copiedBytes = pasted.bytesCopied;
+
+        std::uintmax_t removed = 0;
+        r.remove = Seconds([&] { r.ok &= service.RemoveRecursive(scratch, removed, err); });
+
+        if (!r.ok) std::printf("BackendBench: %s: %s\n", spec.c_str(), err.c_str());
+        return r;
+    }
+}
+
+/*
+Function: main
+Description: Generates the tree, warms the page cache, runs every backend on it and compares
+             the results.
+Parameters:
+  - None
+Returns:
+  - int: 0 on success, 1 if an operation failed or the backends disagree.
+*/
+int main()
+{
+    const fs::path root = fs::temp_directory_path() / "fm-bench-backend";
+    fs::remove_all(root);
+    std::mt19937 rng(33);
+    const std::string block(256u << 10, 'x');
+    for (int d = 0; d < kDirs; ++d)
+    {
+        const fs::path dir = root / ("dir" + std::to_string(d));
+        fs::create_directories(dir);
+        for (int f = 0; f < kFilesPerDir; ++f)
+            std::ofstream(dir / ("file" + std::to_string(f) + ".dat"), std::ios::binary)
+                << block.substr(0, 1024 + rng() % (block.size() - 1024));
+    }
+
+    // label, spec; the memory backends mirror the generated tree
+    const std::string seed = ":" + root.string();
+    const std::pair<std::string, std::string> runs[] = {
+        { "posix", "posix" },
+        { "std", "std" },
+        { "memory", "memory:0:0" + seed },
+        { std::string("memory:") + kSlowModel, std::string("memory:") + kSlowModel + seed },
+    };
+
+    Run("posix", root);     // warms the page cache
+    std::vector<Result> results;
+    for (const auto& run : runs) results.push_back(Run(run.second, root));
+
+    fs::remove_all(root);
+
+    std::printf("BackendBench: %d directories, %d files\n", kDirs, kDirs * kFilesPerDir);
+    std::printf("  %-22s %10s %10s %10s %10s %10s\n", "backend", "list ms", "walk ms", "paste ms", "paste MB/s", "delete ms");
+    bool ok = true;
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        std::printf("  %-22s %10.1f %10.1f %10.1f %10.0f %10.1f\n", runs[i].first.c_str(), r.list * 1e3, r.walk * 1e3,
+                    r.paste * 1e3, (double)r.copiedBytes / (1024.0 * 1024.0) / r.paste, r.remove * 1e3);
+        ok &= r.ok && r.listed == results[0].listed && r.walked == results[0].walked
+              && r.copiedBytes == results[0].copiedBytes;
+    }
+    if (!ok)
+    {
+        std::printf("BackendBench: backends disagree or an operation failed\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+            std::printf("  %-22s listed %llu, walked %llu, copied %llu bytes\n", runs[i].first.c_str(),
+                        (unsigned long long)results[i].listed, (unsigned long long)results[i].walked,
+                        (unsigned long long)results[i].copiedBytes);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+Parneet Baidwan - 251259638
+Description: This benchmark times ContentSearch on a generated tree of many small log files and a few large ones, against a plain single-threaded search that reads every file line by line and calls std::string::find, and checks that both find the same lines. The tree is read once before timing, so the figures compare scanning speed with a warm page cache rather than disk speed.
+February 1, 2026
+*/
+
+#include "ContentSearch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <random>
+#include <string>
+
+namespace
+{
+    constexpr int kSmallFiles = 20000;
+    constexpr std::size_t kSmallBytes = 8u << 10;
+    constexpr int kLargeFiles = 4;
+    constexpr std::size_t kLargeBytes = 16u << 20;
+    constexpr const char* kToken = "ERR_QUOTA_EXCEEDED";
+
+    /*
+    Function: WriteLog
+    Description: Writes a file of log-like lines of random words; every hitEvery-th line holds
+                 the token (0 = never).
+    Parameters:
+      - p: File to write.
+      - bytes: Approximate size.
+      - hitEvery: Spacing of lines with the token.
+      - rng: Random source.
+    Returns:
+      - std::uint64_t: Number of lines with the token.
+    */
+    std::uint64_t WriteLog(const fs::path& p, std::size_t bytes, unsigned hitEvery, std::mt19937& rng)
+    {
+        static const char* const kWords[] = { "request", "served", "cache", "miss", "user", "session",
+                                              "timeout", "retry", "ok", "GET", "POST", "latency", "ms" };
+        std::string text;
+        text.reserve(bytes + 200);
+        std::uint64_t hits = 0;
+        for (unsigned line = 1; text.size() < bytes; ++line)
+        {
+            text += "2026-02-01T12:00:00 ";
+            for (int w = 0; w < 10; ++w)
+            {
+                text += kWords[rng() % (sizeof(kWords) / sizeof(kWords[0]))];
+                text += ' ';
+            }
+            if (hitEvery && line % hitEvery == 0)
+            {
+                text += kToken;
+                ++hits;
+            }
+            text += '\n';
+        }
+        std::ofstream(p, std::ios::binary) << text;
+        return hits;
+    }
+
+    /*
+    Function: PlainSearch
+    Description: Single-threaded baseline: reads every file below root line by line and counts
+                 the lines containing the token.
+    Parameters:
+      - root: Tree to search.
+    Returns:
+      - std::uint64_t: Matching lines.
+    */
+    std::uint64_t PlainSearch(const fs::path& root)
+    {
+        std::uint64_t matches = 0;
+        std::string line;
+        for (const auto& entry : fs::recursive_directory_iterator(root))
+        {
+            if (!entry.is_regular_file()) continue;
+            std::ifstream in(entry.path(), std::ios::binary);
+            while (std::getline(in, line))
+            {
+                if (line.find(kToken) != std::string::npos) ++matches;
+            }
+        }
+        return matches;
+    }
+
+    /*
+    Function: RunSearch
+    Description: Runs a ContentSearch to completion.
+    Parameters:
+      - root: Tree to search.
+      - opts: Search options.
+    Returns:
+      - ContentSearchStats: Totals of the search.
+    */
+    ContentSearchStats RunSearch(const fs::path& root, const ContentSearchOptions& opts)
+    {
+        ContentSearch search;
+        std::promise<ContentSearchStats> done;
+        std::string err;
+        if (!search.Start(root, opts, [](std::vector<ContentMatch>&&) {},
+                          [&](const ContentSearchStats& stats) { done.set_value(stats); }, err))
+        {
+            std::printf("ContentSearchBench: %s\n", err.c_str());
+            return ContentSearchStats{};
+        }
+        return done.get_future().get();
+    }
+
+    template <typename Fn>
+    double Seconds(Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+/*
+Function: main
+Description: Generates the tree, warms the page cache, and times the plain search and
+             ContentSearch with one thread and with the default thread count.
+Parameters:
+  - None
+Returns:
+  - int: 0 on success, 1 if the searches disagree.
+*/
+int main()
+{
+    const fs::path root = fs::temp_directory_path() / "fm-bench-search";
+    fs::remove_all(root);
+    std::mt19937 rng(31);
+    std::uint64_t expected = 0;
+    for (int i = 0; i < kSmallFiles; ++i)
+    {
+        const fs::path dir = root / ("host" + std::to_string(i % 100));
+        if (i < 100) fs::create_directories(dir);
+        expected += WriteLog(dir / ("app-" + std::to_string(i) + ".log"), kSmallBytes, i % 50 == 0 ? 40 : 0, rng);
+    }
+    for (int i = 0; i < kLargeFiles; ++i)
+        expected += WriteLog(root / ("archive-" + std::to_string(i) + ".log"), kLargeBytes, 100000, rng);
+
+    std::uint64_t plainMatches = PlainSearch(root);     // warms the page cache
+    const double plain = Seconds([&] { plainMatches = PlainSearch(root); });
+
+    ContentSearchOptions opts;
+    opts.pattern = kToken;
+    opts.threads = 1;
+    ContentSearchStats one;
+    const double single = Seconds([&] { one = RunSearch(root, opts); });
+    opts.threads = 0;
+    ContentSearchStats all;
+    const double parallel = Seconds([&] { all = RunSearch(root, opts); });
+    opts.pattern = "ERR_[A-Z]+_EXCEEDED";
+    opts.regex = true;
+    ContentSearchStats rx;
+    const double regex = Seconds([&] { rx = RunSearch(root, opts); });
+
+    fs::remove_all(root);
+
+    const double mb = (double)all.bytesScanned / (1024.0 * 1024.0);
+    std::printf("ContentSearchBench: %d files, %.0f MB, %llu matching lines\n",
+                kSmallFiles + kLargeFiles, mb, (unsigned long long)expected);
+    std::printf("  getline + find, 1 thread  %8.1f ms  %7.0f MB/s\n", plain * 1e3, mb / plain);
+    std::printf("  ContentSearch, 1 thread   %8.1f ms  %7.0f MB/s\n", single * 1e3, mb / single);
+    std::printf("  ContentSearch, parallel   %8.1f ms  %7.0f MB/s\n", parallel * 1e3, mb / parallel);
+    std::printf("  ContentSearch, regex      %8.1f ms  %7.0f MB/s\n", regex * 1e3, mb / regex);
+
+    if (plainMatches != expected || one.matches != expected || all.matches != expected || rx.matches != expected)
+    {
+        std::printf("ContentSearchBench: match counts differ (plain %llu, 1 thread %llu, parallel %llu, regex %llu)\n",
+                    (unsigned long long)plainMatches, (unsigned long long)one.matches,
+                    (unsigned long long)all.matches, (unsigned long long)rx.matches);
+        return 1;
+    }
+    return 0;
+}
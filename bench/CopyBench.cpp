@@ -0,0 +1,193 @@
+/*
+Parneet Baidwan - 251259638
+Description: This benchmark copies one large file several ways: with std::filesystem::copy_file (the copy before FileCopy), with CopyRegularFile (the kernel copy where the filesystem allows it), through a plain cached read/write loop that hashes the data, and with CopyAndHashFile, which hashes on a reader thread and moves the data through the aligned buffer ring around the page cache. Besides the time it reports how much of the source and the copy is left in the page cache, which is what the uncached path is meant to keep low, and it checks that every copy has the same contents as the source.
+February 1, 2026
+*/
+
+#include "Checksum.h"
+#include "FileCopy.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    constexpr std::uint64_t kFileBytes = 512ull << 20;
+    constexpr std::size_t kChunk = 1u << 20;
+
+    /*
+    Function: CachedPercent
+    Description: Measures how much of a file is in the page cache, with mincore.
+    Parameters:
+      - p: File to inspect.
+    Returns:
+      - double: Resident share of the file's pages, in percent.
+    */
+    double CachedPercent(const fs::path& p)
+    {
+        const int fd = ::open(p.c_str(), O_RDONLY);
+        if (fd < 0) return 0;
+        const std::size_t size = (std::size_t)fs::file_size(p);
+        void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return 0;
+
+        const std::size_t page = (std::size_t)::sysconf(_SC_PAGESIZE);
+        std::vector<unsigned char> resident((size + page - 1) / page);
+        std::size_t cached = 0;
+        if (::mincore(map, size, resident.data()) == 0)
+            for (unsigned char r : resident) cached += r & 1;
+        ::munmap(map, size);
+        return resident.empty() ? 0 : 100.0 * (double)cached / (double)resident.size();
+    }
+
+    // Writes back and evicts a file's pages, so every run starts from a cold cache
+    void Evict(const fs::path& p)
+    {
+        const int fd = ::open(p.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+
+    /*
+    Function: HashFile
+    Description: Reads a file through the cache and hashes it.
+    Parameters:
+      - p: File to read.
+    Returns:
+      - std::uint64_t: Hash of the contents.
+    */
+    std::uint64_t HashFile(const fs::path& p)
+    {
+        Hash64 hash;
+        std::unique_ptr<char[]> buf(new char[kChunk]);
+        const int fd = ::open(p.c_str(), O_RDONLY);
+        for (ssize_t n; fd >= 0 && (n = ::read(fd, buf.get(), kChunk)) > 0;)
+            hash.Update(buf.get(), (std::size_t)n);
+        if (fd >= 0) ::close(fd);
+        return hash.Digest();
+    }
+
+    /*
+    Function: CachedCopyAndHash
+    Description: Baseline for the hashing copy: a plain read/write loop through the cache.
+    Parameters:
+      - src, dst: Source and destination.
+      - outHash: Output hash of the data.
+    Returns:
+      - bool: true if the file was copied.
+    */
+    bool CachedCopyAndHash(const fs::path& src, const fs::path& dst, std::uint64_t& outHash)
+    {
+        const int in = ::open(src.c_str(), O_RDONLY);
+        const int out = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        bool ok = in >= 0 && out >= 0;
+        Hash64 hash;
+        std::unique_ptr<char[]> buf(new char[kChunk]);
+        for (ssize_t n; ok && (n = ::read(in, buf.get(), kChunk)) > 0;)
+        {
+            hash.Update(buf.get(), (std::size_t)n);
+            ok = ::write(out, buf.get(), (std::size_t)n) == n;
+        }
+        if (in >= 0) ::close(in);
+        if (out >= 0) ::close(out);
+        outHash = hash.Digest();
+        return ok;
+    }
+}
+
+/*
+Function: main
+Description: Writes the source file, then times each way of copying it from a cold cache and
+             reports the time and what the copy left in the page cache.
+Parameters:
+  - None
+Returns:
+  - int: 0 on success, 1 if a copy failed or differs from the source.
+*/
+int main()
+{
+    const fs::path dir = fs::temp_directory_path() / "fm-bench-copy";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const fs::path src = dir / "source.bin";
+    {
+        std::vector<std::uint64_t> block(kChunk / sizeof(std::uint64_t));
+        const int fd = ::open(src.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        for (std::uint64_t written = 0, word = 0; fd >= 0 && written < kFileBytes; written += kChunk)
+        {
+            for (std::uint64_t& w : block) w = ++word * 0x9E3779B97F4A7C15ull;
+            if (::write(fd, block.data(), kChunk) != (ssize_t)kChunk) break;
+        }
+        if (fd >= 0) ::close(fd);
+    }
+    const std::uint64_t expected = HashFile(src);
+
+    IoScheduler scheduler;
+    struct Way
+    {
+        const char* label;
+        bool (*copy)(const fs::path&, const fs::path&, IoScheduler&, std::string&);
+    };
+    const Way ways[] = {
+        { "std::filesystem::copy_file", [](const fs::path& s, const fs::path& d, IoScheduler&, std::string& err)
+          {
+              std::error_code ec;
+              fs::copy_file(s, d, ec);
+              if (ec) err = ec.message();
+              return !ec;
+          } },
+        { "CopyRegularFile", [](const fs::path& s, const fs::path& d, IoScheduler& sched, std::string& err)
+          {
+              std::uintmax_t bytes = 0;
+              std::uintmax_t holes = 0;
+              return CopyRegularFile(s, d, sched, bytes, holes, err);
+          } },
+        { "cached read/write + hash", [](const fs::path& s, const fs::path& d, IoScheduler&, std::string& err)
+          {
+              std::uint64_t hash = 0;
+              if (!CachedCopyAndHash(s, d, hash)) err = "copy failed";
+              return err.empty();
+          } },
+        { "CopyAndHashFile (ring)", [](const fs::path& s, const fs::path& d, IoScheduler& sched, std::string& err)
+          {
+              std::uintmax_t bytes = 0;
+              std::uintmax_t holes = 0;
+              std::uint64_t hash = 0;
+              return CopyAndHashFile(s, d, sched, bytes, holes, hash, err);
+          } },
+    };
+
+    std::printf("CopyBench: %llu MB file, cold cache\n", (unsigned long long)(kFileBytes >> 20));
+    std::printf("  %-28s %10s %8s %12s %12s\n", "copy", "ms", "MB/s", "src cached", "dst cached");
+    bool ok = true;
+    for (const Way& way : ways)
+    {
+        const fs::path dst = dir / "copy.bin";
+        Evict(src);
+        std::string err;
+        const auto start = std::chrono::steady_clock::now();
+        bool copied = way.copy(src, dst, scheduler, err);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double srcCached = CachedPercent(src);
+        const double dstCached = CachedPercent(dst);
+        copied = copied && HashFile(dst) == expected;
+        std::printf("  %-28s %10.1f %8.0f %11.0f%% %11.0f%%%s\n", way.label, seconds * 1e3,
+                    (double)(kFileBytes >> 20) / seconds, srcCached, dstCached, copied ? "" : "  FAILED");
+        if (!err.empty()) std::printf("    %s\n", err.c_str());
+        ok &= copied;
+        fs::remove(dst);
+    }
+
+    fs::remove_all(dir);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*
+Parneet Baidwan - 251259638
+Description: This benchmark times the formatting of the size and date cells of a large listing, once the way rows were formatted before ListingFormatter (a full strftime of the long date and a printf of the size for every row, which is what wxDateTime::Format and wxString::Format do underneath) and once through ListingFormatter. It checks that both produce the same text before reporting the times.
+February 1, 2026
+*/
+
+#include "ListingFormatter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t kRows = 300000;
+    constexpr int kRounds = 5;
+
+    struct Row
+    {
+        std::time_t modified;
+        std::uintmax_t sizeBytes;
+    };
+
+    /*
+    Function: PerRowDate
+    Description: Formats a date the way every row was formatted before: a localtime and a full
+                 strftime per call.
+    Parameters:
+      - t: Timestamp.
+    Returns:
+      - std::string: Formatted date.
+    */
+    std::string PerRowDate(std::time_t t)
+    {
+        std::tm tm{};
+        localtime_r(&t, &tm);
+        char buf[128];
+        return std::string(buf, std::strftime(buf, sizeof(buf), "%A, %B %d, %Y %H:%M:%S", &tm));
+    }
+
+    /*
+    Function: PerRowSize
+    Description: Formats a size the way every row was formatted before, with printf.
+    Parameters:
+      - bytes: Size in bytes.
+    Returns:
+      - std::string: Formatted size.
+    */
+    std::string PerRowSize(std::uintmax_t bytes)
+    {
+        char buf[32];
+        return std::string(buf, (std::size_t)std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)bytes));
+    }
+
+    /*
+    Function: Seconds
+    Description: Runs fn kRounds times and returns the best time, in seconds.
+    Parameters:
+      - fn: Work to time.
+    Returns:
+      - double: Fastest round.
+    */
+    template <typename Fn>
+    double Seconds(Fn&& fn)
+    {
+        double best = 1e30;
+        for (int round = 0; round < kRounds; ++round)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+            if (took.count() < best) best = took.count();
+        }
+        return best;
+    }
+}
+
+/*
+Function: main
+Description: Builds a listing whose timestamps cluster in the last month, as in a busy
+             directory, and compares the two ways of formatting it.
+Parameters:
+  - None
+Returns:
+  - int: 0 on success, 1 if the two ways disagree.
+*/
+int main()
+{
+    std::mt19937_64 rng(26);
+    const std::time_t now = std::time(nullptr);
+    std::vector<Row> rows(kRows);
+    for (Row& row : rows)
+    {
+        row.modified = now - (std::time_t)(rng() % (30 * 24 * 3600));
+        row.sizeBytes = rng() % (1ull << (rng() % 40));
+    }
+
+    ListingFormatter format;
+    for (const Row& row : rows)
+    {
+        if (format.FormatDate(row.modified) != PerRowDate(row.modified)
+            || format.FormatSize(row.sizeBytes) != PerRowSize(row.sizeBytes))
+        {
+            std::printf("FormatBench: formatter and per-row formatting disagree for %lld\n", (long long)row.modified);
+            return 1;
+        }
+    }
+
+    std::size_t sink = 0;
+    const double perRow = Seconds([&]
+    {
+        for (const Row& row : rows)
+            sink += PerRowDate(row.modified).size() + PerRowSize(row.sizeBytes).size();
+    });
+    const double cached = Seconds([&]
+    {
+        format.ClearCache();
+        for (const Row& row : rows)
+            sink += format.FormatDate(row.modified).size() + format.FormatSize(row.sizeBytes).size();
+    });
+    format.SetHumanReadableSizes(true);
+    const double human = Seconds([&]
+    {
+        for (const Row& row : rows)
+            sink += format.FormatSize(row.sizeBytes).size();
+    });
+
+    std::printf("FormatBench: %zu rows, best of %d (checksum %zu)\n", kRows, kRounds, sink);
+    std::printf("  per-row strftime/printf  %8.1f ms  %6.0f ns/row\n", perRow * 1e3, perRow * 1e9 / kRows);
+    std::printf("  ListingFormatter         %8.1f ms  %6.0f ns/row  (%.1fx)\n", cached * 1e3, cached * 1e9 / kRows, perRow / cached);
+    std::printf("  human-readable sizes     %8.1f ms  %6.0f ns/row\n", human * 1e3, human * 1e9 / kRows);
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+Parneet Baidwan - 251259638
+Description: The allocation counter in this file replaces the global operator new and delete of the profiling build with versions that count every allocation in one relaxed atomic before passing it to malloc. It is compiled in only with FM_COUNT_ALLOCS, so normal builds keep the standard allocator.
+February 1, 2026
+*/
+
+#include "AllocCounter.h"
+
+#ifdef FM_COUNT_ALLOCS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::uint64_t> g_allocations{ 0 };
+
+    /*
+    Function: CountedAllocate
+    Description: Counts one allocation and serves it from malloc, calling the new handler and
+                 retrying while memory is short, as the standard operator new does.
+    Parameters:
+      - size: Bytes requested.
+    Returns:
+      - void*: The memory; throws std::bad_alloc if none can be found.
+    */
+    void* CountedAllocate(std::size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (size == 0) size = 1;
+
+        for (;;)
+        {
+            if (void* p = std::malloc(size)) return p;
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return CountedAllocate(size); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return CountedAllocate(size); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif // FM_COUNT_ALLOCS
+
+/*
+Function: AllocationCount
+Description: Reads the number of global operator new calls made so far by every thread.
+Parameters:
+  - None
+Returns:
+  - std::uint64_t: Allocations counted; always 0 unless built with FM_COUNT_ALLOCS.
+*/
+std::uint64_t AllocationCount()
+{
+#ifdef FM_COUNT_ALLOCS
+    return g_allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,14 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the allocation counter of the profiling build. Built with FM_COUNT_ALLOCS (make ALLOCS=1), every global operator new is counted, so the allocations of an operation can be measured as the difference of two readings; in a normal build the counter is not compiled in and always reads zero.
+February 1, 2026
+*/
+
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+std::uint64_t AllocationCount();
+
+#endif // ALLOCCOUNTER_H
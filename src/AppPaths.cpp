@@ -0,0 +1,37 @@
+/*
+Parneet Baidwan - 251259638
+Description: The application path helper in this file finds the per-user data directory following each platform's convention: $XDG_DATA_HOME (or ~/.local/share) on Linux and other Unix systems, ~/Library/Application Support on macOS and %LOCALAPPDATA% on Windows.
+February 1, 2026
+*/
+
+#include "AppPaths.h"
+
+#include <cstdlib>
+
+/*
+Function: AppDataDirectory
+Description: Returns the directory for the file manager's own data. The directory is not
+             created here; callers create it when they first write to it.
+Parameters:
+  - None
+Returns:
+  - fs::path: Data directory, or an empty path if the user's home cannot be determined.
+*/
+fs::path AppDataDirectory()
+{
+#if defined(_WIN32)
+    const char* base = std::getenv("LOCALAPPDATA");
+    if (!base || !*base) return fs::path();
+    return fs::path(base) / "FileManager";
+#elif defined(__APPLE__)
+    const char* home = std::getenv("HOME");
+    if (!home || !*home) return fs::path();
+    return fs::path(home) / "Library" / "Application Support" / "FileManager";
+#else
+    const char* xdg = std::getenv("XDG_DATA_HOME");
+    if (xdg && *xdg) return fs::path(xdg) / "file-manager";
+    const char* home = std::getenv("HOME");
+    if (!home || !*home) return fs::path();
+    return fs::path(home) / ".local" / "share" / "file-manager";
+#endif
+}
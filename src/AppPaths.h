@@ -0,0 +1,17 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares where the file manager keeps its own per-user data, such as the trash journal, so every feature that persists state puts its files in the same place.
+February 1, 2026
+*/
+
+#ifndef APPPATHS_H
+#define APPPATHS_H
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// Per-user data directory of the file manager (may not exist yet); empty if unknown
+fs::path AppDataDirectory();
+
+#endif // APPPATHS_H
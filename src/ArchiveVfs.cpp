@@ -0,0 +1,1325 @@
+/*
+Parneet Baidwan - 251259638
+Description: The archive providers in this file expose tar, tar.gz and zip archives as read-only virtual directories. Opening an archive reads only its index (the tar headers, skipping over member data, or the zip central directory), so large archives list quickly. Extraction streams every member straight from the archive into its destination file: zip members and members of uncompressed tars are read with positioned reads and extracted in parallel, while a gzip-compressed tar is decompressed once, front to back, for all selected members.
+February 1, 2026
+*/
+
+#include "ArchiveVfs.h"
+#include "IoScheduler.h"
+#include "ThreadUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <zlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FM_HAVE_POSIX_IO 1
+#endif
+
+namespace
+{
+    constexpr std::size_t kIoChunk = 1u << 20;
+    constexpr std::size_t kTarBlock = 512;
+
+    // One file, directory or symlink inside an archive
+    struct ArchiveEntry
+    {
+        std::string path;               // '/' separated, no leading or trailing slash
+        bool isDir = false;
+        bool isSymlink = false;
+        std::uint64_t size = 0;
+        std::time_t mtime = 0;
+        std::uint32_t mode = 0;
+        std::uint64_t offset = 0;       // tar: start of the data; zip: local header
+        std::uint64_t packedSize = 0;   // zip only
+        std::uint16_t method = 0;       // zip only
+        std::uint16_t flags = 0;        // zip only
+        std::uint32_t crc = 0;          // zip only
+        std::string linkTarget;
+    };
+
+    // Member to write during an extraction
+    struct ExtractJob
+    {
+        const ArchiveEntry* entry = nullptr;
+        fs::path dst;
+    };
+
+    // Random-access reader for the archive file, safe to share between threads
+    class ArchiveFile
+    {
+    public:
+        ~ArchiveFile()
+        {
+#ifdef FM_HAVE_POSIX_IO
+            if (m_fd >= 0) ::close(m_fd);
+#else
+            if (m_file) std::fclose(m_file);
+#endif
+        }
+
+        bool Open(const fs::path& p)
+        {
+#ifdef FM_HAVE_POSIX_IO
+            m_fd = ::open(p.c_str(), O_RDONLY);
+            if (m_fd < 0) return false;
+            struct stat st{};
+            if (::fstat(m_fd, &st) != 0) return false;
+            m_size = (std::uint64_t)st.st_size;
+            return true;
+#else
+            m_file = std::fopen(p.string().c_str(), "rb");
+            if (!m_file) return false;
+            std::error_code ec;
+            m_size = fs::file_size(p, ec);
+            return !ec;
+#endif
+        }
+
+        std::uint64_t Size() const { return m_size; }
+
+        // Reads exactly len bytes at offset
+        bool ReadAt(std::uint64_t offset, void* data, std::size_t len) const
+        {
+#ifdef FM_HAVE_POSIX_IO
+            auto* out = static_cast<unsigned char*>(data);
+            while (len > 0)
+            {
+                const ssize_t n = ::pread(m_fd, out, len, (off_t)offset);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                out += n;
+                len -= (std::size_t)n;
+                offset += (std::uint64_t)n;
+            }
+            return true;
+#else
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (_fseeki64(m_file, (long long)offset, SEEK_SET) != 0) return false;
+            return std::fread(data, 1, len, m_file) == len;
+#endif
+        }
+
+    private:
+#ifdef FM_HAVE_POSIX_IO
+        int m_fd = -1;
+#else
+        std::FILE* m_file = nullptr;
+        mutable std::mutex m_mutex;
+#endif
+        std::uint64_t m_size = 0;
+    };
+
+    // New file receiving an extracted member
+    class OutputFile
+    {
+    public:
+        ~OutputFile() { Close(); }
+
+        bool Create(const fs::path& p, std::uint32_t mode)
+        {
+#ifdef FM_HAVE_POSIX_IO
+            m_fd = ::open(p.c_str(), O_WRONLY | O_CREAT | O_EXCL, mode ? (mode & 07777) : 0644);
+            return m_fd >= 0;
+#else
+            (void)mode;
+            m_file = std::fopen(p.string().c_str(), "wbx");
+            return m_file != nullptr;
+#endif
+        }
+
+        bool Write(const void* data, std::size_t len)
+        {
+#ifdef FM_HAVE_POSIX_IO
+            auto* in = static_cast<const unsigned char*>(data);
+            while (len > 0)
+            {
+                const ssize_t n = ::write(m_fd, in, len);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                in += n;
+                len -= (std::size_t)n;
+            }
+            return true;
+#else
+            return std::fwrite(data, 1, len, m_file) == len;
+#endif
+        }
+
+        bool Close()
+        {
+#ifdef FM_HAVE_POSIX_IO
+            if (m_fd < 0) return true;
+            const bool ok = ::close(m_fd) == 0;
+            m_fd = -1;
+            return ok;
+#else
+            if (!m_file) return true;
+            const bool ok = std::fclose(m_file) == 0;
+            m_file = nullptr;
+            return ok;
+#endif
+        }
+
+    private:
+#ifdef FM_HAVE_POSIX_IO
+        int m_fd = -1;
+#else
+        std::FILE* m_file = nullptr;
+#endif
+    };
+
+    std::uint16_t Le16(const unsigned char* p) { return (std::uint16_t)(p[0] | (p[1] << 8)); }
+    std::uint32_t Le32(const unsigned char* p) { return (std::uint32_t)Le16(p) | ((std::uint32_t)Le16(p + 2) << 16); }
+    std::uint64_t Le64(const unsigned char* p) { return (std::uint64_t)Le32(p) | ((std::uint64_t)Le32(p + 4) << 32); }
+
+    std::time_t ModifiedTime(const fs::path& p)
+    {
+        std::error_code ec;
+        const auto ftime = fs::last_write_time(p, ec);
+        if (ec) return 0;
+        return std::chrono::system_clock::to_time_t(
+            std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+                ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now()));
+    }
+
+    /*
+    Function: NormalizeEntryPath
+    Description: Turns a path stored in an archive into the form used by the index: forward
+                 slashes, no leading "/" or "./", no trailing slash. Entries that would escape
+                 the extraction directory (".." components) are rejected.
+    Parameters:
+      - raw: Path as stored in the archive.
+      - out: Output normalized path.
+    Returns:
+      - bool: true if the entry can be used; false if it should be skipped.
+    */
+    bool NormalizeEntryPath(std::string raw, std::string& out)
+    {
+        std::replace(raw.begin(), raw.end(), '\\', '/');
+        out.clear();
+
+        std::size_t pos = 0;
+        while (pos <= raw.size())
+        {
+            std::size_t next = raw.find('/', pos);
+            if (next == std::string::npos) next = raw.size();
+            const std::string part = raw.substr(pos, next - pos);
+            pos = next + 1;
+
+            if (part.empty() || part == ".") continue;
+            if (part == "..") return false;
+            if (!out.empty()) out += '/';
+            out += part;
+        }
+        return !out.empty();
+    }
+
+    /*
+    Function: InnerKey
+    Description: Converts a path inside an archive, as passed by FileSystemService, into an
+                 index key.
+    Parameters:
+      - inner: Relative path inside the archive ("" or "." for the root).
+    Returns:
+      - std::string: Normalized key ("" for the root).
+    */
+    std::string InnerKey(const fs::path& inner)
+    {
+        std::string key;
+        NormalizeEntryPath(inner.generic_string(), key);
+        return key;
+    }
+
+    // Index and extraction logic shared by the tar and zip providers
+    class ArchiveProvider : public VfsProvider
+    {
+    public:
+        bool Stat(const fs::path& inner, FileItem& outItem) const override;
+        bool List(const fs::path& mountedAt,
+                  const fs::path& inner,
+                  std::vector<FileItem>& outItems,
+                  std::string& outErr) const override;
+        bool Extract(const fs::path& inner,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     PasteStats& outStats,
+                     std::string& outErr) const override;
+
+    protected:
+        explicit ArchiveProvider(fs::path archive) : m_archive(std::move(archive)) {}
+
+        void AddEntry(ArchiveEntry entry);
+        void FinishIndex();
+
+        // Writes the regular-file members of jobs to their destinations
+        virtual bool ExtractFiles(const std::vector<ExtractJob>& jobs,
+                                  IoScheduler& scheduler,
+                                  PasteStats& outStats,
+                                  std::string& outErr) const = 0;
+
+        fs::path m_archive;
+        std::time_t m_archiveTime = 0;
+
+    private:
+        std::vector<ArchiveEntry> m_entries;
+        std::unordered_map<std::string, std::size_t> m_byPath;
+        std::unordered_map<std::string, std::vector<std::size_t>> m_children;
+    };
+
+    /*
+    Function: ArchiveProvider::AddEntry
+    Description: Adds an entry to the index. A later entry with the same path replaces the
+                 earlier one, as when a tar is appended to.
+    Parameters:
+      - entry: Entry with a normalized path.
+    Returns:
+      - None
+    */
+    void ArchiveProvider::AddEntry(ArchiveEntry entry)
+    {
+        auto it = m_byPath.find(entry.path);
+        if (it != m_byPath.end())
+        {
+            m_entries[it->second] = std::move(entry);
+            return;
+        }
+        m_byPath.emplace(entry.path, m_entries.size());
+        m_entries.push_back(std::move(entry));
+    }
+
+    /*
+    Function: ArchiveProvider::FinishIndex
+    Description: Completes the index after all entries were added: creates the parent
+                 directories that the archive does not list explicitly and builds the child
+                 lists used for listing.
+    Parameters:
+      - None
+    Returns:
+      - None
+    */
+    void ArchiveProvider::FinishIndex()
+    {
+        for (std::size_t i = 0; i < m_entries.size(); i++)
+        {
+            std::string path = m_entries[i].path;
+            for (std::size_t slash = path.rfind('/'); slash != std::string::npos; slash = path.rfind('/'))
+            {
+                path.resize(slash);
+                if (m_byPath.count(path)) break;
+
+                ArchiveEntry dir;
+                dir.path = path;
+                dir.isDir = true;
+                dir.mtime = m_archiveTime;
+                m_byPath.emplace(path, m_entries.size());
+                m_entries.push_back(std::move(dir));
+            }
+        }
+
+        m_children.clear();
+        m_children[std::string()];
+        for (std::size_t i = 0; i < m_entries.size(); i++)
+        {
+            const std::string& path = m_entries[i].path;
+            const std::size_t slash = path.rfind('/');
+            m_children[slash == std::string::npos ? std::string() : path.substr(0, slash)].push_back(i);
+        }
+    }
+
+    /*
+    Function: ArchiveProvider::Stat
+    Description: Looks up an entry of the archive; the root is reported as a directory with the
+                 archive's own modification time.
+    Parameters:
+      - inner: Path inside the archive.
+      - outItem: Output metadata (fullPath is left empty).
+    Returns:
+      - bool: true if the entry exists; false otherwise.
+    */
+    bool ArchiveProvider::Stat(const fs::path& inner, FileItem& outItem) const
+    {
+        const std::string key = InnerKey(inner);
+        outItem = FileItem{};
+        if (key.empty())
+        {
+            outItem.isDir = true;
+            outItem.modified = m_archiveTime;
+            return true;
+        }
+
+        auto it = m_byPath.find(key);
+        if (it == m_byPath.end()) return false;
+
+        const ArchiveEntry& e = m_entries[it->second];
+        outItem.isDir = e.isDir;
+        outItem.sizeBytes = e.size;
+        outItem.modified = e.mtime;
+        return true;
+    }
+
+    /*
+    Function: ArchiveProvider::List
+    Description: Lists the direct children of a directory inside the archive from the in-memory
+                 index; no archive data is read.
+    Parameters:
+      - mountedAt: Path under which the directory is shown (archive path plus inner).
+      - inner: Directory inside the archive.
+      - outItems: Output listing.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if inner is a directory of the archive; false otherwise.
+    */
+    bool ArchiveProvider::List(const fs::path& mountedAt,
+                               const fs::path& inner,
+                               std::vector<FileItem>& outItems,
+                               std::string& outErr) const
+    {
+        outItems.clear();
+        auto it = m_children.find(InnerKey(inner));
+        if (it == m_children.end())
+        {
+            outErr = "Not a directory in the archive: " + inner.generic_string();
+            return false;
+        }
+
+        outItems.reserve(it->second.size());
+        for (std::size_t idx : it->second)
+        {
+            const ArchiveEntry& e = m_entries[idx];
+            const std::size_t slash = e.path.rfind('/');
+
+            FileItem item;
+            item.fullPath = mountedAt / fs::u8path(slash == std::string::npos ? e.path : e.path.substr(slash + 1));
+            item.isDir = e.isDir;
+            item.sizeBytes = e.isDir ? 0 : e.size;
+            item.modified = e.mtime;
+            outItems.push_back(std::move(item));
+        }
+        return true;
+    }
+
+    /*
+    Function: ArchiveProvider::Extract
+    Description: Extracts one entry, or a whole directory of the archive, to dst. Directories
+                 and symlinks are created first, then the regular files are handed to the
+                 format's ExtractFiles in one batch so it can schedule them as a whole.
+    Parameters:
+      - inner: Entry inside the archive.
+      - dst: Destination path; must not exist.
+      - scheduler: I/O scheduler pacing the writes.
+      - outStats: Files and bytes extracted are added here.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if everything was extracted; false otherwise.
+    */
+    bool ArchiveProvider::Extract(const fs::path& inner,
+                                  const fs::path& dst,
+                                  IoScheduler& scheduler,
+                                  PasteStats& outStats,
+                                  std::string& outErr) const
+    {
+        const std::string key = InnerKey(inner);
+        const ArchiveEntry* root = nullptr;
+        if (!key.empty())
+        {
+            auto it = m_byPath.find(key);
+            if (it == m_byPath.end())
+            {
+                outErr = "Not found in the archive: " + key;
+                return false;
+            }
+            root = &m_entries[it->second];
+        }
+
+        std::vector<ExtractJob> jobs;
+        std::error_code ec;
+
+        if (root && !root->isDir)
+        {
+            if (root->isSymlink)
+            {
+                fs::create_symlink(fs::u8path(root->linkTarget), dst, ec);
+                if (ec) outErr = "Cannot create link " + dst.string() + ": " + ec.message();
+                return !ec;
+            }
+            jobs.push_back(ExtractJob{ root, dst });
+            return ExtractFiles(jobs, scheduler, outStats, outErr);
+        }
+
+        fs::create_directory(dst, ec);
+        if (ec)
+        {
+            outErr = "Cannot create " + dst.string() + ": " + ec.message();
+            return false;
+        }
+
+        // A directory is expanded only after it was created, so parents always exist
+        std::vector<std::string> pending{ key };
+        while (!pending.empty())
+        {
+            const std::string dir = std::move(pending.back());
+            pending.pop_back();
+
+            auto it = m_children.find(dir);
+            if (it == m_children.end()) continue;
+
+            for (std::size_t idx : it->second)
+            {
+                const ArchiveEntry& e = m_entries[idx];
+                const fs::path target = dst / fs::u8path(key.empty() ? e.path : e.path.substr(key.size() + 1));
+
+                if (e.isDir)
+                {
+                    fs::create_directory(target, ec);
+                    pending.push_back(e.path);
+                }
+                else if (e.isSymlink)
+                {
+                    fs::create_symlink(fs::u8path(e.linkTarget), target, ec);
+                }
+                else
+                {
+                    jobs.push_back(ExtractJob{ &e, target });
+                }
+
+                if (ec)
+                {
+                    outErr = "Cannot create " + target.string() + ": " + ec.message();
+                    return false;
+                }
+            }
+        }
+
+        return ExtractFiles(jobs, scheduler, outStats, outErr);
+    }
+
+    /*
+    Function: RunParallelJobs
+    Description: Runs one extraction callback per job on the scheduler's worker count and
+                 collects the totals and the first error.
+    Parameters:
+      - jobs: Members to extract.
+      - scheduler: Scheduler providing the parallelism limit.
+      - outStats: Files and bytes extracted are added here.
+      - outErr: Output string populated with the first error.
+      - extractOne: Extracts one job and returns the bytes written.
+    Returns:
+      - bool: true if every job succeeded; false otherwise.
+    */
+    template <typename Fn>
+    bool RunParallelJobs(const std::vector<ExtractJob>& jobs,
+                         IoScheduler& scheduler,
+                         PasteStats& outStats,
+                         std::string& outErr,
+                         Fn extractOne)
+    {
+        std::atomic<std::uintmax_t> files{ 0 };
+        std::atomic<std::uintmax_t> bytes{ 0 };
+        std::atomic<bool> failed{ false };
+        std::mutex errMutex;
+
+        ParallelFor(jobs.size(), scheduler.MaxParallelism(), [&](std::size_t i)
+        {
+            if (failed) return;
+
+            std::uint64_t written = 0;
+            std::string err;
+            if (!extractOne(jobs[i], written, err))
+            {
+                std::lock_guard<std::mutex> lock(errMutex);
+                if (!failed.exchange(true)) outErr = err;
+                return;
+            }
+            files++;
+            bytes += written;
+        });
+
+        outStats.filesCopied += files;
+        outStats.bytesCopied += bytes;
+        return !failed;
+    }
+
+    // ---------------------------------------------------------------- tar
+
+    std::uint64_t ParseTarNumber(const char* field, std::size_t len)
+    {
+        // GNU base-256 for values that do not fit in octal
+        if ((unsigned char)field[0] & 0x80)
+        {
+            std::uint64_t v = (unsigned char)field[0] & 0x7f;
+            for (std::size_t i = 1; i < len; i++) v = (v << 8) | (unsigned char)field[i];
+            return v;
+        }
+
+        std::uint64_t v = 0;
+        std::size_t i = 0;
+        while (i < len && (field[i] == ' ' || field[i] == '\0')) i++;
+        for (; i < len && field[i] >= '0' && field[i] <= '7'; i++) v = v * 8 + (std::uint64_t)(field[i] - '0');
+        return v;
+    }
+
+    std::string TarString(const char* field, std::size_t len)
+    {
+        return std::string(field, strnlen(field, len));
+    }
+
+    bool TarChecksumOk(const unsigned char* block)
+    {
+        unsigned sum = 0;
+        for (std::size_t i = 0; i < kTarBlock; i++) sum += (i >= 148 && i < 156) ? ' ' : block[i];
+        return sum == ParseTarNumber(reinterpret_cast<const char*>(block) + 148, 8);
+    }
+
+    /*
+    Function: ApplyPaxRecords
+    Description: Reads the path, linkpath, size and mtime records of a pax extended header,
+                 which override the fields of the following entry.
+    Parameters:
+      - data: Contents of the pax header.
+      - path, link: Output path and link target overrides (left unchanged if absent).
+      - size, mtime: Output size and mtime overrides; hasSize/hasMtime report presence.
+    Returns:
+      - None
+    */
+    void ApplyPaxRecords(const std::string& data, std::string& path, std::string& link,
+                         std::uint64_t& size, bool& hasSize, std::time_t& mtime, bool& hasMtime)
+    {
+        std::size_t pos = 0;
+        while (pos < data.size())
+        {
+            const std::size_t space = data.find(' ', pos);
+            if (space == std::string::npos) break;
+            const std::size_t recLen = (std::size_t)std::strtoull(data.c_str() + pos, nullptr, 10);
+            if (recLen == 0 || pos + recLen > data.size()) break;
+
+            const std::string rec = data.substr(space + 1, pos + recLen - space - 2);
+            pos += recLen;
+
+            const std::size_t eq = rec.find('=');
+            if (eq == std::string::npos) continue;
+            const std::string key = rec.substr(0, eq);
+            const std::string value = rec.substr(eq + 1);
+
+            if (key == "path") path = value;
+            else if (key == "linkpath") link = value;
+            else if (key == "size") { size = std::strtoull(value.c_str(), nullptr, 10); hasSize = true; }
+            else if (key == "mtime") { mtime = (std::time_t)std::strtoll(value.c_str(), nullptr, 10); hasMtime = true; }
+        }
+    }
+
+    // Sequential reader over the (possibly gzip-compressed) tar stream
+    class TarStream
+    {
+    public:
+        ~TarStream() { if (m_gz) gzclose(m_gz); }
+
+        bool Open(const fs::path& p, bool gzip)
+        {
+            if (gzip)
+            {
+                m_gz = gzopen(p.string().c_str(), "rb");
+                if (m_gz) gzbuffer(m_gz, 256u << 10);
+                return m_gz != nullptr;
+            }
+            return m_file.Open(p);
+        }
+
+        // Reads exactly len bytes at offset of the uncompressed stream
+        bool ReadAt(std::uint64_t offset, void* data, std::size_t len)
+        {
+            if (!m_gz) return m_file.ReadAt(offset, data, len);
+
+            // forward seeks decompress and discard; only an unusual backward seek rewinds
+            if ((std::uint64_t)gztell(m_gz) != offset && gzseek(m_gz, (z_off_t)offset, SEEK_SET) < 0)
+                return false;
+            auto* out = static_cast<unsigned char*>(data);
+            while (len > 0)
+            {
+                const int n = gzread(m_gz, out, (unsigned)std::min<std::size_t>(len, kIoChunk));
+                if (n <= 0) return false;
+                out += n;
+                len -= (std::size_t)n;
+            }
+            return true;
+        }
+
+    private:
+        gzFile m_gz = nullptr;
+        ArchiveFile m_file;
+    };
+
+    // Tar and tar.gz archives
+    class TarArchive final : public ArchiveProvider
+    {
+    public:
+        explicit TarArchive(const fs::path& archive) : ArchiveProvider(archive) {}
+
+        bool Load(std::string& outErr);
+
+    protected:
+        bool ExtractFiles(const std::vector<ExtractJob>& jobs,
+                          IoScheduler& scheduler,
+                          PasteStats& outStats,
+                          std::string& outErr) const override;
+
+    private:
+        bool m_gzip = false;
+        std::shared_ptr<ArchiveFile> m_file;    // uncompressed tars only
+    };
+
+    /*
+    Function: TarArchive::Load
+    Description: Builds the index of a tar archive by reading its 512-byte headers and jumping
+                 over member data. For an uncompressed tar the data is never read; for tar.gz
+                 the stream must still be decompressed to find the headers, but the data is
+                 discarded as it is skipped. GNU long names and pax headers are supported;
+                 hard links, devices and FIFOs are not shown.
+    Parameters:
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the archive was indexed; false otherwise.
+    */
+    bool TarArchive::Load(std::string& outErr)
+    {
+        m_archiveTime = ModifiedTime(m_archive);
+
+        unsigned char magic[2] = { 0, 0 };
+        {
+            ArchiveFile probe;
+            if (!probe.Open(m_archive))
+            {
+                outErr = "Cannot open archive: " + m_archive.string();
+                return false;
+            }
+            probe.ReadAt(0, magic, sizeof(magic));
+        }
+        m_gzip = magic[0] == 0x1f && magic[1] == 0x8b;
+
+        TarStream stream;
+        if (!stream.Open(m_archive, m_gzip))
+        {
+            outErr = "Cannot open archive: " + m_archive.string();
+            return false;
+        }
+
+        std::string longName, longLink, paxPath, paxLink;
+        std::uint64_t paxSize = 0;
+        std::time_t paxMtime = 0;
+        bool hasPaxSize = false, hasPaxMtime = false;
+
+        // a member must fit in the archive (the decompressed length of a gzip stream is not
+        // known up front, so only overflow is ruled out there)
+        std::error_code ec;
+        const std::uint64_t limit = m_gzip ? std::numeric_limits<std::uint64_t>::max() - kTarBlock : (std::uint64_t)fs::file_size(m_archive, ec);
+        const std::string damaged = "Tar archive is damaged: " + m_archive.string();
+
+        unsigned char block[kTarBlock];
+        std::uint64_t pos = 0;
+        bool first = true;
+        while (stream.ReadAt(pos, block, kTarBlock))
+        {
+            if (block[0] == 0) break;   // end-of-archive marker
+            if (!TarChecksumOk(block))
+            {
+                if (first)
+                {
+                    outErr = "Not a tar archive: " + m_archive.string();
+                    return false;
+                }
+                break;
+            }
+            first = false;
+
+            const char* h = reinterpret_cast<const char*>(block);
+            const char type = h[156];
+            std::uint64_t size = ParseTarNumber(h + 124, 12);
+            const std::uint64_t headerPos = pos;
+            const std::uint64_t dataPos = pos + kTarBlock;
+            if (ec || size > limit - dataPos)
+            {
+                outErr = damaged;
+                return false;
+            }
+            pos = dataPos + (size + kTarBlock - 1) / kTarBlock * kTarBlock;
+
+            // meta entries carry data for the next header
+            if (type == 'L' || type == 'K' || type == 'x')
+            {
+                std::string data((std::size_t)std::min<std::uint64_t>(size, 1u << 20), '\0');
+                if (!stream.ReadAt(dataPos, &data[0], data.size())) break;
+                if (type == 'L') longName = TarString(data.data(), data.size());
+                else if (type == 'K') longLink = TarString(data.data(), data.size());
+                else ApplyPaxRecords(data, paxPath, paxLink, paxSize, hasPaxSize, paxMtime, hasPaxMtime);
+                continue;
+            }
+            if (type == 'g') continue;
+
+            std::string name = TarString(h, 100);
+            if (std::memcmp(h + 257, "ustar", 5) == 0 && h[345] != '\0')
+                name = TarString(h + 345, 155) + "/" + name;
+            if (!longName.empty()) name = longName;
+            if (!paxPath.empty()) name = paxPath;
+
+            std::string link = TarString(h + 157, 100);
+            if (!longLink.empty()) link = longLink;
+            if (!paxLink.empty()) link = paxLink;
+
+            if (hasPaxSize)
+            {
+                size = paxSize;
+                if (size > limit - dataPos)
+                {
+                    outErr = damaged;
+                    return false;
+                }
+                pos = dataPos + (size + kTarBlock - 1) / kTarBlock * kTarBlock;
+            }
+            if (pos <= headerPos)
+            {
+                outErr = damaged;
+                return false;
+            }
+
+            ArchiveEntry e;
+            e.mode = (std::uint32_t)ParseTarNumber(h + 100, 8);
+            e.mtime = hasPaxMtime ? paxMtime : (std::time_t)ParseTarNumber(h + 136, 12);
+            e.offset = dataPos;
+
+            longName.clear();
+            longLink.clear();
+            paxPath.clear();
+            paxLink.clear();
+            hasPaxSize = hasPaxMtime = false;
+
+            if (type == '5') e.isDir = true;
+            else if (type == '2') { e.isSymlink = true; e.linkTarget = link; }
+            else if (type == '0' || type == '\0' || type == '7') e.size = size;
+            else continue;
+
+            if (!NormalizeEntryPath(name, e.path)) continue;
+            AddEntry(std::move(e));
+        }
+
+        if (first)
+        {
+            outErr = "Not a tar archive: " + m_archive.string();
+            return false;
+        }
+
+        if (!m_gzip)
+        {
+            m_file = std::make_shared<ArchiveFile>();
+            if (!m_file->Open(m_archive))
+            {
+                outErr = "Cannot open archive: " + m_archive.string();
+                return false;
+            }
+        }
+
+        FinishIndex();
+        return true;
+    }
+
+    /*
+    Function: TarArchive::ExtractFiles
+    Description: Writes tar members to their destinations. Members of an uncompressed tar are
+                 independent byte ranges and are copied in parallel with positioned reads.
+                 A gzip stream can only be decoded front to back, so those members are sorted
+                 by offset and extracted in a single decompression pass.
+    Parameters:
+      - jobs: Members to extract.
+      - scheduler: I/O scheduler pacing the writes.
+      - outStats: Files and bytes extracted are added here.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if every member was extracted; false otherwise.
+    */
+    bool TarArchive::ExtractFiles(const std::vector<ExtractJob>& jobs,
+                                  IoScheduler& scheduler,
+                                  PasteStats& outStats,
+                                  std::string& outErr) const
+    {
+        if (jobs.empty()) return true;
+        const DeviceId srcDev = IoScheduler::DeviceOf(m_archive);
+
+        if (!m_gzip)
+        {
+            std::shared_ptr<ArchiveFile> file = m_file;
+            return RunParallelJobs(jobs, scheduler, outStats, outErr,
+                [&](const ExtractJob& job, std::uint64_t& written, std::string& err)
+                {
+                    const DeviceId dstDev = IoScheduler::DeviceOf(job.dst.parent_path());
+                    IoScheduler::Ticket ticket = scheduler.Acquire({ srcDev, dstDev });
+
+                    OutputFile out;
+                    if (!out.Create(job.dst, job.entry->mode))
+                    {
+                        err = "Cannot create " + job.dst.string();
+                        return false;
+                    }
+
+                    std::unique_ptr<char[]> buf(new char[kIoChunk]);
+                    for (std::uint64_t done = 0; done < job.entry->size;)
+                    {
+                        const std::size_t n = (std::size_t)std::min<std::uint64_t>(kIoChunk, job.entry->size - done);
+                        if (!file->ReadAt(job.entry->offset + done, buf.get(), n))
+                        {
+                            err = "Archive is truncated: " + m_archive.string();
+                            return false;
+                        }
+                        if (!out.Write(buf.get(), n))
+                        {
+                            err = "Write failed for " + job.dst.string();
+                            return false;
+                        }
+                        done += n;
+                        written += n;
+                        scheduler.Transfer(dstDev, n);
+                        if (srcDev != dstDev) scheduler.Transfer(srcDev, n);
+                    }
+                    if (!out.Close())
+                    {
+                        err = "Write failed for " + job.dst.string();
+                        return false;
+                    }
+                    return true;
+                });
+        }
+
+        std::vector<const ExtractJob*> ordered;
+        ordered.reserve(jobs.size());
+        for (const auto& job : jobs) ordered.push_back(&job);
+        std::sort(ordered.begin(), ordered.end(), [](const ExtractJob* a, const ExtractJob* b)
+        {
+            return a->entry->offset < b->entry->offset;
+        });
+
+        TarStream stream;
+        if (!stream.Open(m_archive, true))
+        {
+            outErr = "Cannot open archive: " + m_archive.string();
+            return false;
+        }
+
+        const DeviceId dstDev = IoScheduler::DeviceOf(ordered.front()->dst.parent_path());
+        IoScheduler::Ticket ticket = scheduler.Acquire({ srcDev, dstDev });
+
+        std::unique_ptr<char[]> buf(new char[kIoChunk]);
+        for (const ExtractJob* job : ordered)
+        {
+            OutputFile out;
+            if (!out.Create(job->dst, job->entry->mode))
+            {
+                outErr = "Cannot create " + job->dst.string();
+                return false;
+            }
+
+            for (std::uint64_t done = 0; done < job->entry->size;)
+            {
+                const std::size_t n = (std::size_t)std::min<std::uint64_t>(kIoChunk, job->entry->size - done);
+                if (!stream.ReadAt(job->entry->offset + done, buf.get(), n))
+                {
+                    outErr = "Archive is truncated or corrupt: " + m_archive.string();
+                    return false;
+                }
+                if (!out.Write(buf.get(), n))
+                {
+                    outErr = "Write failed for " + job->dst.string();
+                    return false;
+                }
+                done += n;
+                scheduler.Transfer(dstDev, n);
+            }
+            if (!out.Close())
+            {
+                outErr = "Write failed for " + job->dst.string();
+                return false;
+            }
+
+            outStats.filesCopied++;
+            outStats.bytesCopied += job->entry->size;
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- zip
+
+    constexpr std::uint32_t kZipLocalSig = 0x04034b50;
+    constexpr std::uint32_t kZipCentralSig = 0x02014b50;
+    constexpr std::uint32_t kZipEndSig = 0x06054b50;
+    constexpr std::uint32_t kZip64EndSig = 0x06064b50;
+    constexpr std::uint32_t kZip64LocatorSig = 0x07064b50;
+
+    std::time_t DosToTimeT(std::uint16_t date, std::uint16_t time)
+    {
+        std::tm tm{};
+        tm.tm_year = ((date >> 9) & 0x7f) + 80;
+        tm.tm_mon = ((date >> 5) & 0x0f) - 1;
+        tm.tm_mday = date & 0x1f;
+        tm.tm_hour = (time >> 11) & 0x1f;
+        tm.tm_min = (time >> 5) & 0x3f;
+        tm.tm_sec = (time & 0x1f) * 2;
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    }
+
+    // Zip archives
+    class ZipArchive final : public ArchiveProvider
+    {
+    public:
+        explicit ZipArchive(const fs::path& archive) : ArchiveProvider(archive) {}
+
+        bool Load(std::string& outErr);
+
+    protected:
+        bool ExtractFiles(const std::vector<ExtractJob>& jobs,
+                          IoScheduler& scheduler,
+                          PasteStats& outStats,
+                          std::string& outErr) const override;
+
+    private:
+        bool ExtractMember(const ExtractJob& job, IoScheduler& scheduler, DeviceId srcDev,
+                           std::uint64_t& outWritten, std::string& outErr) const;
+
+        ArchiveFile m_file;
+    };
+
+    /*
+    Function: ZipArchive::Load
+    Description: Builds the index of a zip archive from its central directory alone: the
+                 end-of-central-directory record is located in the last 64 KiB, the zip64
+                 record is followed when present, and the whole central directory is read with
+                 one call. Unix permission bits and extended timestamps are used when stored.
+    Parameters:
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the archive was indexed; false otherwise.
+    */
+    bool ZipArchive::Load(std::string& outErr)
+    {
+        if (!m_file.Open(m_archive))
+        {
+            outErr = "Cannot open archive: " + m_archive.string();
+            return false;
+        }
+
+        const std::uint64_t fileSize = m_file.Size();
+        const std::size_t tailLen = (std::size_t)std::min<std::uint64_t>(fileSize, 65535 + 22);
+        std::vector<unsigned char> tail(tailLen);
+        if (tailLen < 22 || !m_file.ReadAt(fileSize - tailLen, tail.data(), tailLen))
+        {
+            outErr = "Not a zip archive: " + m_archive.string();
+            return false;
+        }
+
+        std::size_t eocd = std::string::npos;
+        for (std::size_t i = tailLen - 22 + 1; i-- > 0;)
+        {
+            if (Le32(&tail[i]) == kZipEndSig)
+            {
+                eocd = i;
+                break;
+            }
+        }
+        if (eocd == std::string::npos)
+        {
+            outErr = "Not a zip archive: " + m_archive.string();
+            return false;
+        }
+
+        std::uint64_t count = Le16(&tail[eocd + 10]);
+        std::uint64_t cdSize = Le32(&tail[eocd + 12]);
+        std::uint64_t cdOffset = Le32(&tail[eocd + 16]);
+
+        if (eocd >= 20 && Le32(&tail[eocd - 20]) == kZip64LocatorSig)
+        {
+            unsigned char rec[56];
+            const std::uint64_t recOffset = Le64(&tail[eocd - 20 + 8]);
+            if (m_file.ReadAt(recOffset, rec, sizeof(rec)) && Le32(rec) == kZip64EndSig)
+            {
+                count = Le64(rec + 32);
+                cdSize = Le64(rec + 40);
+                cdOffset = Le64(rec + 48);
+            }
+        }
+
+        if (cdSize > fileSize || cdOffset > fileSize - cdSize)
+        {
+            outErr = "Zip central directory is damaged: " + m_archive.string();
+            return false;
+        }
+
+        std::vector<unsigned char> cd((std::size_t)cdSize);
+        if (cdSize > 0 && !m_file.ReadAt(cdOffset, cd.data(), cd.size()))
+        {
+            outErr = "Cannot read zip central directory: " + m_archive.string();
+            return false;
+        }
+
+        std::size_t pos = 0;
+        for (std::uint64_t i = 0; i < count && pos + 46 <= cd.size(); i++)
+        {
+            const unsigned char* h = &cd[pos];
+            if (Le32(h) != kZipCentralSig) break;
+
+            const std::uint16_t madeBy = Le16(h + 4);
+            const std::uint16_t nameLen = Le16(h + 28);
+            const std::uint16_t extraLen = Le16(h + 30);
+            const std::uint16_t commentLen = Le16(h + 32);
+            if (pos + 46 + nameLen + extraLen + commentLen > cd.size()) break;
+
+            ArchiveEntry e;
+            e.flags = Le16(h + 8);
+            e.method = Le16(h + 10);
+            e.mtime = DosToTimeT(Le16(h + 14), Le16(h + 12));
+            e.crc = Le32(h + 16);
+            e.packedSize = Le32(h + 20);
+            e.size = Le32(h + 24);
+            e.offset = Le32(h + 42);
+            const std::uint32_t external = Le32(h + 38);
+            if ((madeBy >> 8) == 3) e.mode = external >> 16;   // created on Unix
+
+            const std::string name(reinterpret_cast<const char*>(h + 46), nameLen);
+            e.isDir = !name.empty() && (name.back() == '/' || name.back() == '\\');
+
+            // zip64 sizes/offset and Unix timestamp
+            const unsigned char* extra = h + 46 + nameLen;
+            for (std::size_t x = 0; x + 4 <= extraLen;)
+            {
+                const std::uint16_t id = Le16(extra + x);
+                const std::uint16_t len = Le16(extra + x + 2);
+                const unsigned char* data = extra + x + 4;
+                if (x + 4 + len > extraLen) break;
+
+                if (id == 0x0001)
+                {
+                    std::size_t o = 0;
+                    if (e.size == 0xffffffffu && o + 8 <= len) { e.size = Le64(data + o); o += 8; }
+                    if (e.packedSize == 0xffffffffu && o + 8 <= len) { e.packedSize = Le64(data + o); o += 8; }
+                    if (e.offset == 0xffffffffu && o + 8 <= len) { e.offset = Le64(data + o); o += 8; }
+                }
+                else if (id == 0x5455 && len >= 5 && (data[0] & 1))
+                {
+                    e.mtime = (std::time_t)(std::int32_t)Le32(data + 1);
+                }
+                x += 4 + len;
+            }
+
+            pos += 46 + nameLen + extraLen + commentLen;
+
+#if defined(S_IFMT) && defined(S_IFLNK)
+            // a symlink's target is stored as its data; it is shown and extracted as a small file
+            if ((e.mode & S_IFMT) == S_IFLNK) e.mode = 0644;
+#endif
+            if (e.isDir) e.size = 0;
+            if (!NormalizeEntryPath(name, e.path)) continue;
+            AddEntry(std::move(e));
+        }
+
+        m_archiveTime = ModifiedTime(m_archive);
+        FinishIndex();
+        return true;
+    }
+
+    /*
+    Function: ZipArchive::ExtractMember
+    Description: Streams one zip member from the archive to its destination: stored data is
+                 copied, deflated data is inflated chunk by chunk into a fixed buffer, and the
+                 CRC-32 and size are checked against the central directory.
+    Parameters:
+      - job: Member and destination.
+      - scheduler: I/O scheduler pacing the writes.
+      - srcDev: Device of the archive.
+      - outWritten: Output number of bytes written.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the member was extracted and verified; false otherwise.
+    */
+    bool ZipArchive::ExtractMember(const ExtractJob& job, IoScheduler& scheduler, DeviceId srcDev,
+                                   std::uint64_t& outWritten, std::string& outErr) const
+    {
+        const ArchiveEntry& e = *job.entry;
+        if (e.flags & 1)
+        {
+            outErr = "Encrypted zip entries are not supported: " + e.path;
+            return false;
+        }
+        if (e.method != 0 && e.method != 8)
+        {
+            outErr = "Unsupported zip compression method " + std::to_string(e.method) + ": " + e.path;
+            return false;
+        }
+
+        unsigned char local[30];
+        if (!m_file.ReadAt(e.offset, local, sizeof(local)) || Le32(local) != kZipLocalSig)
+        {
+            outErr = "Zip entry is damaged: " + e.path;
+            return false;
+        }
+        std::uint64_t inPos = e.offset + 30 + Le16(local + 26) + Le16(local + 28);
+        std::uint64_t inLeft = e.packedSize;
+
+        const DeviceId dstDev = IoScheduler::DeviceOf(job.dst.parent_path());
+        IoScheduler::Ticket ticket = scheduler.Acquire({ srcDev, dstDev });
+
+        OutputFile out;
+        if (!out.Create(job.dst, e.mode))
+        {
+            outErr = "Cannot create " + job.dst.string();
+            return false;
+        }
+
+        std::unique_ptr<unsigned char[]> inBuf(new unsigned char[kIoChunk]);
+        std::unique_ptr<unsigned char[]> outBuf(e.method == 8 ? new unsigned char[kIoChunk] : nullptr);
+        uLong crc = crc32(0L, Z_NULL, 0);
+
+        z_stream zs{};
+        if (e.method == 8 && inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+        {
+            outErr = "Cannot initialize decompression.";
+            return false;
+        }
+        struct InflateGuard
+        {
+            z_stream* zs;
+            ~InflateGuard() { if (zs) inflateEnd(zs); }
+        } guard{ e.method == 8 ? &zs : nullptr };
+
+        auto emit = [&](const unsigned char* data, std::size_t n)
+        {
+            crc = crc32(crc, data, (uInt)n);
+            outWritten += n;
+            scheduler.Transfer(dstDev, n);
+            return out.Write(data, n);
+        };
+
+        bool streamEnd = e.method == 0;
+        while (inLeft > 0)
+        {
+            const std::size_t n = (std::size_t)std::min<std::uint64_t>(kIoChunk, inLeft);
+            if (!m_file.ReadAt(inPos, inBuf.get(), n))
+            {
+                outErr = "Archive is truncated: " + m_archive.string();
+                return false;
+            }
+            inPos += n;
+            inLeft -= n;
+            if (srcDev != dstDev) scheduler.Transfer(srcDev, n);
+
+            if (e.method == 0)
+            {
+                if (!emit(inBuf.get(), n))
+                {
+                    outErr = "Write failed for " + job.dst.string();
+                    return false;
+                }
+                continue;
+            }
+
+            zs.next_in = inBuf.get();
+            zs.avail_in = (uInt)n;
+            do
+            {
+                zs.next_out = outBuf.get();
+                zs.avail_out = (uInt)kIoChunk;
+                const int rc = inflate(&zs, Z_NO_FLUSH);
+                if (rc == Z_BUF_ERROR) break;   // needs more input
+                if (rc != Z_OK && rc != Z_STREAM_END)
+                {
+                    outErr = "Zip entry is corrupt: " + e.path;
+                    return false;
+                }
+                if (!emit(outBuf.get(), kIoChunk - zs.avail_out))
+                {
+                    outErr = "Write failed for " + job.dst.string();
+                    return false;
+                }
+                streamEnd = rc == Z_STREAM_END;
+            } while (!streamEnd && (zs.avail_in > 0 || zs.avail_out == 0));
+        }
+
+        if (!out.Close())
+        {
+            outErr = "Write failed for " + job.dst.string();
+            return false;
+        }
+        if (!streamEnd || outWritten != e.size || crc != e.crc)
+        {
+            outErr = "Zip entry failed its integrity check: " + e.path;
+            return false;
+        }
+        return true;
+    }
+
+    /*
+    Function: ZipArchive::ExtractFiles
+    Description: Extracts zip members in parallel. Every member is compressed independently and
+                 read with positioned reads, so workers need no coordination beyond the I/O
+                 scheduler's per-device limits.
+    Parameters:
+      - jobs: Members to extract.
+      - scheduler: I/O scheduler pacing the writes.
+      - outStats: Files and bytes extracted are added here.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if every member was extracted; false otherwise.
+    */
+    bool ZipArchive::ExtractFiles(const std::vector<ExtractJob>& jobs,
+                                  IoScheduler& scheduler,
+                                  PasteStats& outStats,
+                                  std::string& outErr) const
+    {
+        const DeviceId srcDev = IoScheduler::DeviceOf(m_archive);
+        return RunParallelJobs(jobs, scheduler, outStats, outErr,
+            [&](const ExtractJob& job, std::uint64_t& written, std::string& err)
+            {
+                return ExtractMember(job, scheduler, srcDev, written, err);
+            });
+    }
+}
+
+/*
+Function: OpenTarArchive
+Description: Opens a tar archive, compressed with gzip or not, and indexes its headers.
+Parameters:
+  - archive: Archive file.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - std::shared_ptr<VfsProvider>: Provider for the archive, or nullptr on error.
+*/
+std::shared_ptr<VfsProvider> OpenTarArchive(const fs::path& archive, std::string& outErr)
+{
+    auto provider = std::make_shared<TarArchive>(archive);
+    if (!provider->Load(outErr)) return nullptr;
+    return provider;
+}
+
+/*
+Function: OpenZipArchive
+Description: Opens a zip archive and indexes its central directory.
+Parameters:
+  - archive: Archive file.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - std::shared_ptr<VfsProvider>: Provider for the archive, or nullptr on error.
+*/
+std::shared_ptr<VfsProvider> OpenZipArchive(const fs::path& archive, std::string& outErr)
+{
+    auto provider = std::make_shared<ZipArchive>(archive);
+    if (!provider->Load(outErr)) return nullptr;
+    return provider;
+}
@@ -0,0 +1,21 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the archive providers of the virtual filesystem. Tar (optionally gzip-compressed) and zip archives are opened by reading only their headers or central directory, after which their contents can be listed like folders and extracted without temporary files.
+February 1, 2026
+*/
+
+#ifndef ARCHIVEVFS_H
+#define ARCHIVEVFS_H
+
+#include "VfsProvider.h"
+
+#include <memory>
+#include <string>
+
+// Opens a .tar, .tar.gz or .tgz archive (gzip is detected from the file contents)
+std::shared_ptr<VfsProvider> OpenTarArchive(const fs::path& archive, std::string& outErr);
+
+// Opens a .zip archive (stored and deflated entries, including zip64)
+std::shared_ptr<VfsProvider> OpenZipArchive(const fs::path& archive, std::string& outErr);
+
+#endif // ARCHIVEVFS_H
@@ -0,0 +1,108 @@
+/*
+Parneet Baidwan - 251259638
+Description: The BackgroundPurger class implementation in this file owns one worker thread, started on first use, that removes queued files and directory trees at idle CPU and I/O priority. Paths still queued when the application exits are removed before the purger is destroyed.
+February 1, 2026
+*/
+
+#include "BackgroundPurger.h"
+#include "FsBackend.h"
+#include "ThreadUtil.h"
+
+/*
+Function: BackgroundPurger::BackgroundPurger
+Description: Creates an idle purger; its thread starts with the first queued path.
+Parameters:
+  - backend: Backend the queued paths live on.
+Returns:
+  - None
+*/
+BackgroundPurger::BackgroundPurger(std::shared_ptr<const FsBackend> backend)
+    : m_backend(std::move(backend))
+{
+}
+
+/*
+Function: BackgroundPurger::~BackgroundPurger
+Description: Lets the worker finish the paths already queued, then joins it, so replaced data
+             does not linger on disk under hidden names after the application exits.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+BackgroundPurger::~BackgroundPurger()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+/*
+Function: BackgroundPurger::Enqueue
+Description: Queues a path for recursive removal, starting the worker thread on first use.
+Parameters:
+  - p: File or directory to delete.
+Returns:
+  - None
+*/
+void BackgroundPurger::Enqueue(const fs::path& p)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) return;
+        m_queue.push_back(p);
+        if (!m_thread.joinable()) m_thread = std::thread(&BackgroundPurger::Run, this);
+    }
+    m_cv.notify_one();
+}
+
+/*
+Function: BackgroundPurger::Pending
+Description: Reports how many paths are queued or being removed.
+Parameters:
+  - None
+Returns:
+  - std::size_t: Number of outstanding removals.
+*/
+std::size_t BackgroundPurger::Pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size() + (m_busy ? 1 : 0);
+}
+
+/*
+Function: BackgroundPurger::Run
+Description: Worker loop. Lowers its own priority, then removes queued paths one at a time
+             until asked to stop and the queue is empty. Removal errors are ignored; the path
+             simply stays behind.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void BackgroundPurger::Run()
+{
+    SetCurrentThreadIdlePriority();
+
+    for (;;)
+    {
+        fs::path victim;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_busy = false;
+            m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+
+            victim = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_busy = true;
+        }
+
+        std::uintmax_t removed = 0;
+        std::string err;
+        m_backend->RemoveAll(victim, removed, err);
+    }
+}
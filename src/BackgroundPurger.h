@@ -0,0 +1,48 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the BackgroundPurger class, which deletes directory trees that are no longer needed (such as the old copy left behind by a staged overwrite) on an idle-priority background thread so that the user never waits for a large recursive delete.
+February 1, 2026
+*/
+
+#ifndef BACKGROUNDPURGER_H
+#define BACKGROUNDPURGER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class FsBackend;
+
+// Idle-priority thread that removes queued paths
+class BackgroundPurger final
+{
+public:
+    explicit BackgroundPurger(std::shared_ptr<const FsBackend> backend);
+    ~BackgroundPurger();
+
+    BackgroundPurger(const BackgroundPurger&) = delete;
+    BackgroundPurger& operator=(const BackgroundPurger&) = delete;
+
+    void Enqueue(const fs::path& p);
+    std::size_t Pending() const;
+
+private:
+    void Run();
+
+    std::shared_ptr<const FsBackend> m_backend;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<fs::path> m_queue;
+    bool m_busy = false;
+    bool m_stop = false;
+
+    std::thread m_thread;
+};
+
+#endif // BACKGROUNDPURGER_H
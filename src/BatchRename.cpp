@@ -0,0 +1,224 @@
+/*
+Parneet Baidwan - 251259638
+Description: The batch rename planner in this file compiles the rule once (the regular expression and the name template, parsed into literal and field segments) and then runs it over every entry of the listing. New names are checked for being valid entry names, and all final names of the directory, renamed or not, are counted in one hash table so that every collision is found without touching the filesystem.
+February 1, 2026
+*/
+
+#include "BatchRename.h"
+
+#include <ctime>
+#include <regex>
+#include <unordered_map>
+
+namespace
+{
+    const char* const kInvalidName = "Invalid name";
+    const char* const kNameTooLong = "Name too long";
+    const char* const kNameTaken = "Name already used";
+
+    constexpr std::size_t kMaxNameBytes = 255;
+
+    // Piece of a parsed name template: literal text, or one field letter
+    struct Segment
+    {
+        char field = 0;
+        std::string text;
+    };
+
+    /*
+    Function: ParseTemplate
+    Description: Splits a name template into literal text and fields.
+    Parameters:
+      - tmpl: Template text.
+      - outSegments: Output segments in order.
+      - outErr: Output string populated with an error message for an unknown or unclosed field.
+    Returns:
+      - bool: true if the template is valid; false otherwise.
+    */
+    bool ParseTemplate(const std::string& tmpl, std::vector<Segment>& outSegments, std::string& outErr)
+    {
+        outSegments.clear();
+        std::string literal;
+        for (std::size_t i = 0; i < tmpl.size(); ++i)
+        {
+            if (tmpl[i] != '[')
+            {
+                literal.push_back(tmpl[i]);
+                continue;
+            }
+            if (i + 1 < tmpl.size() && tmpl[i + 1] == '[')
+            {
+                literal.push_back('[');
+                ++i;
+                continue;
+            }
+            if (i + 2 >= tmpl.size() || tmpl[i + 2] != ']')
+            {
+                outErr = "Unclosed field in the name template (write [[ for a bracket).";
+                return false;
+            }
+
+            const char field = tmpl[i + 1];
+            if (std::string("NECDTP").find(field) == std::string::npos)
+            {
+                outErr = std::string("Unknown template field [") + field + "].";
+                return false;
+            }
+            if (!literal.empty()) outSegments.push_back({ 0, std::move(literal) });
+            literal.clear();
+            outSegments.push_back({ field, std::string() });
+            i += 2;
+        }
+        if (!literal.empty()) outSegments.push_back({ 0, std::move(literal) });
+        return true;
+    }
+
+    void AppendCounter(std::string& out, long long value, int width)
+    {
+        const std::string digits = std::to_string(value < 0 ? -(unsigned long long)value : (unsigned long long)value);
+        if (value < 0) out.push_back('-');
+        if ((int)digits.size() < width) out.append((std::size_t)width - digits.size(), '0');
+        out.append(digits);
+    }
+
+    void AppendTime(std::string& out, std::time_t t, const char* format)
+    {
+        std::tm tm{};
+#if defined(_WIN32)
+        if (localtime_s(&tm, &t) != 0) return;
+#else
+        if (!localtime_r(&t, &tm)) return;
+#endif
+        char buf[32];
+        const std::size_t n = std::strftime(buf, sizeof(buf), format, &tm);
+        out.append(buf, n);
+    }
+
+    bool IsValidName(const std::string& name)
+    {
+        return !name.empty() && name != "." && name != ".." &&
+               name.find('/') == std::string::npos && name.find('\0') == std::string::npos
+#if defined(_WIN32)
+               && name.find_first_of("\\:*?\"<>|") == std::string::npos
+#endif
+               ;
+    }
+}
+
+/*
+Function: PlanBatchRename
+Description: Computes the new name of every entry a rule selects. An entry is selected when
+             the find expression occurs in its name (every entry when find is empty;
+             directories are skipped with filesOnly). Each occurrence is replaced with the
+             replace text, and the result is split into name and extension for the template,
+             whose fields are:
+               [N] name without extension   [E] extension with its dot
+               [C] counter                  [D] modification date (YYYY-MM-DD)
+               [T] modification time (HHMMSS)   [P] name of the directory
+               [[ a literal bracket
+             The counter starts at counterStart and advances by counterStep per selected
+             entry. A new name is a conflict if it is not a valid entry name or if it equals
+             the final name of any other entry of the directory.
+Parameters:
+  - items: Listing of one directory.
+  - rule: Selection and naming rule.
+  - outPlan: Output preview rows and the renames to apply.
+  - outErr: Output string populated with an error message for an invalid rule; cleared on success.
+Returns:
+  - bool: true if the rule is valid; false otherwise.
+*/
+bool PlanBatchRename(const std::vector<FileItem>& items,
+                     const RenameRule& rule,
+                     RenamePlan& outPlan,
+                     std::string& outErr)
+{
+    outErr.clear();
+    outPlan = RenamePlan();
+
+    std::vector<Segment> segments;
+    if (!ParseTemplate(rule.nameTemplate, segments, outErr)) return false;
+
+    std::regex re;
+    if (!rule.find.empty())
+    {
+        try
+        {
+            re.assign(rule.find, std::regex::ECMAScript);
+        }
+        catch (const std::regex_error& e)
+        {
+            outErr = std::string("Invalid expression: ") + e.what();
+            return false;
+        }
+    }
+
+    // names of the selected entries, then the final name of every entry of the directory
+    std::vector<std::string> oldNames;
+    oldNames.reserve(items.size());
+    long long counter = rule.counterStart;
+    std::string name;
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        const FileItem& item = items[i];
+        oldNames.push_back(item.fullPath.filename().string());
+        const std::string& oldName = oldNames.back();
+
+        if (rule.filesOnly && item.isDir) continue;
+        if (!rule.find.empty())
+        {
+            if (!std::regex_search(oldName, re)) continue;
+            name = std::regex_replace(oldName, re, rule.replace);
+        }
+        else
+        {
+            name = oldName;
+        }
+
+        // split like fs::path: a leading dot does not start an extension
+        const std::size_t dot = name.rfind('.');
+        const std::size_t stemLength = (dot == std::string::npos || dot == 0) ? name.size() : dot;
+
+        RenamePreviewRow row;
+        row.item = i;
+        for (const Segment& seg : segments)
+        {
+            switch (seg.field)
+            {
+            case 0:   row.newName.append(seg.text); break;
+            case 'N': row.newName.append(name, 0, stemLength); break;
+            case 'E': row.newName.append(name, stemLength, std::string::npos); break;
+            case 'C': AppendCounter(row.newName, counter, rule.counterWidth); break;
+            case 'D': AppendTime(row.newName, item.modified, "%Y-%m-%d"); break;
+            case 'T': AppendTime(row.newName, item.modified, "%H%M%S"); break;
+            default:  row.newName.append(item.fullPath.parent_path().filename().string()); break;
+            }
+        }
+        counter += rule.counterStep;
+
+        if (!IsValidName(row.newName)) row.problem = kInvalidName;
+        else if (row.newName.size() > kMaxNameBytes) row.problem = kNameTooLong;
+        outPlan.rows.push_back(std::move(row));
+    }
+
+    std::unordered_map<std::string, unsigned> finalNames;
+    finalNames.reserve(items.size());
+    {
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < items.size(); ++i)
+        {
+            const bool selected = next < outPlan.rows.size() && outPlan.rows[next].item == i;
+            ++finalNames[selected ? outPlan.rows[next].newName : oldNames[i]];
+            if (selected) ++next;
+        }
+    }
+
+    for (RenamePreviewRow& row : outPlan.rows)
+    {
+        const std::string& oldName = oldNames[row.item];
+        if (!row.problem && row.newName != oldName && finalNames[row.newName] > 1) row.problem = kNameTaken;
+
+        if (row.problem) ++outPlan.conflicts;
+        else if (row.newName != oldName) outPlan.ops.push_back({ oldName, row.newName });
+    }
+    return true;
+}
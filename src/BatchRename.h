@@ -0,0 +1,50 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the batch rename planner. A rule selects entries of a directory listing with a regular expression, rewrites the matched text, and builds each new name from a template with fields for the name, extension, a counter and the modification date. The planner works only on the in-memory listing, so the preview can be recomputed on every keystroke, and it finds every name collision in one pass over a hash table before anything is renamed.
+February 1, 2026
+*/
+
+#ifndef BATCHRENAME_H
+#define BATCHRENAME_H
+
+#include "FileSystemService.h"
+#include "FsBackend.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// How the new names of a batch rename are built
+struct RenameRule
+{
+    std::string find;                       // ECMAScript regex; empty selects every entry
+    std::string replace = "$&";             // replaces each match ($& = the match, $1 = a group)
+    std::string nameTemplate = "[N][E]";    // see PlanBatchRename for the fields
+    long long counterStart = 1;
+    long long counterStep = 1;
+    int counterWidth = 1;                   // digits, zero-padded
+    bool filesOnly = false;
+};
+
+// One selected entry in the preview
+struct RenamePreviewRow
+{
+    std::size_t item = 0;               // index in the listing
+    std::string newName;
+    const char* problem = nullptr;      // why the entry cannot get newName; null if it can
+};
+
+// Preview of a batch rename and the renames that apply it
+struct RenamePlan
+{
+    std::vector<RenamePreviewRow> rows;     // every selected entry, in listing order
+    std::vector<RenameOp> ops;              // selected entries whose name changes
+    std::size_t conflicts = 0;              // rows with a problem
+};
+
+bool PlanBatchRename(const std::vector<FileItem>& items,
+                     const RenameRule& rule,
+                     RenamePlan& outPlan,
+                     std::string& outErr);
+
+#endif // BATCHRENAME_H
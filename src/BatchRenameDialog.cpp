@@ -0,0 +1,246 @@
+/*
+Parneet Baidwan - 251259638
+Description: The BatchRenameDialog class in this file builds the batch rename window. The preview is a virtual list that reads its rows straight from the current rename plan, so even a directory of tens of thousands of entries is previewed without creating a row per entry, and the plan is recomputed from the in-memory listing shortly after each change to the rule.
+February 1, 2026
+*/
+
+#include "BatchRenameDialog.h"
+
+#include <wx/listctrl.h>
+#include <wx/msgdlg.h>
+
+namespace
+{
+    // Quiet time after the last keystroke before the preview is recomputed
+    constexpr int kPreviewDelayMs = 150;
+}
+
+// Preview list (old name, new name, problem) drawn from a rename plan on demand
+class RenamePreviewList final : public wxListCtrl
+{
+public:
+    RenamePreviewList(wxWindow* parent, const RenamePlan& plan, const DirectoryListing& listing)
+        : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL),
+          m_plan(plan),
+          m_listing(listing)
+    {
+        InsertColumn(0, "Name", wxLIST_FORMAT_LEFT, 300);
+        InsertColumn(1, "New Name", wxLIST_FORMAT_LEFT, 300);
+        InsertColumn(2, "Problem", wxLIST_FORMAT_LEFT, 160);
+    }
+
+private:
+    wxString OnGetItemText(long item, long column) const override
+    {
+        if (item < 0 || (std::size_t)item >= m_plan.rows.size()) return wxString();
+
+        const RenamePreviewRow& row = m_plan.rows[(std::size_t)item];
+        if (column == 0) return wxString::FromUTF8((*m_listing)[row.item].fullPath.filename().u8string());
+        if (column == 1) return wxString::FromUTF8(row.newName);
+        return row.problem ? wxString(row.problem) : wxString();
+    }
+
+    const RenamePlan& m_plan;
+    const DirectoryListing& m_listing;
+};
+
+// bind event ids to handler methods
+wxBEGIN_EVENT_TABLE(BatchRenameDialog, wxDialog)
+    EVT_TEXT(BatchRenameDialog::ID_Rule,       BatchRenameDialog::OnRuleChanged)
+    EVT_CHECKBOX(BatchRenameDialog::ID_Rule,   BatchRenameDialog::OnRuleChanged)
+    EVT_SPINCTRL(BatchRenameDialog::ID_Rule,   BatchRenameDialog::OnCounterChanged)
+    EVT_TIMER(BatchRenameDialog::ID_PreviewTimer, BatchRenameDialog::OnPreviewTimer)
+    EVT_BUTTON(BatchRenameDialog::ID_Rename,   BatchRenameDialog::OnRename)
+wxEND_EVENT_TABLE()
+
+/*
+Function: BatchRenameDialog::BatchRenameDialog
+Description: Builds the dialog: find, replace and template fields, the counter settings, the
+             files-only option, the preview list and the Rename/Cancel buttons, and shows the
+             preview of the default rule (every entry keeps its name).
+Parameters:
+  - parent: Owning window.
+  - fs: Filesystem service that applies the renames.
+  - dir: Directory whose entries are renamed.
+  - listing: Current listing of dir.
+Returns:
+  - None
+*/
+BatchRenameDialog::BatchRenameDialog(wxWindow* parent, const FileSystemService& fs, const fs::path& dir, DirectoryListing listing)
+    : wxDialog(parent, wxID_ANY, "Batch Rename", wxDefaultPosition, wxSize(820, 600), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_previewTimer(this, ID_PreviewTimer),
+      m_fs(fs),
+      m_dir(dir),
+      m_listing(listing ? std::move(listing) : std::make_shared<const std::vector<FileItem>>())
+{
+    const RenameRule defaults;
+    m_findCtrl = new wxTextCtrl(this, ID_Rule, "");
+    m_replaceCtrl = new wxTextCtrl(this, ID_Rule, wxString::FromUTF8(defaults.replace));
+    m_templateCtrl = new wxTextCtrl(this, ID_Rule, wxString::FromUTF8(defaults.nameTemplate));
+    m_startCtrl = new wxSpinCtrl(this, ID_Rule, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, -1000000000, 1000000000, (int)defaults.counterStart);
+    m_stepCtrl = new wxSpinCtrl(this, ID_Rule, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, -10000, 10000, (int)defaults.counterStep);
+    m_widthCtrl = new wxSpinCtrl(this, ID_Rule, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 1, 12, defaults.counterWidth);
+    m_filesOnlyCheck = new wxCheckBox(this, ID_Rule, "Files only");
+
+    m_preview = new RenamePreviewList(this, m_plan, m_listing);
+    m_summary = new wxStaticText(this, wxID_ANY, "");
+    m_renameButton = new wxButton(this, ID_Rename, "Rename");
+
+    auto* fields = new wxFlexGridSizer(2, 5, 5);
+    fields->AddGrowableCol(1, 1);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Find (regex):"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_findCtrl, 1, wxEXPAND);
+    fields->Add(new wxStaticText(this, wxID_ANY, "Replace with:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_replaceCtrl, 1, wxEXPAND);
+    fields->Add(new wxStaticText(this, wxID_ANY, "New name:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_templateCtrl, 1, wxEXPAND);
+
+    auto* counter = new wxBoxSizer(wxHORIZONTAL);
+    counter->Add(new wxStaticText(this, wxID_ANY, "Counter start:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    counter->Add(m_startCtrl, 0, wxRIGHT, 10);
+    counter->Add(new wxStaticText(this, wxID_ANY, "Step:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    counter->Add(m_stepCtrl, 0, wxRIGHT, 10);
+    counter->Add(new wxStaticText(this, wxID_ANY, "Digits:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    counter->Add(m_widthCtrl, 0, wxRIGHT, 10);
+    counter->Add(m_filesOnlyCheck, 0, wxALIGN_CENTER_VERTICAL);
+
+    auto* help = new wxStaticText(this, wxID_ANY,
+        "Fields: [N] name  [E] extension  [C] counter  [D] date  [T] time  [P] folder  [[ bracket");
+
+    auto* buttons = new wxBoxSizer(wxHORIZONTAL);
+    buttons->Add(m_summary, 1, wxALIGN_CENTER_VERTICAL);
+    buttons->Add(m_renameButton, 0, wxLEFT, 5);
+    buttons->Add(new wxButton(this, wxID_CANCEL, "Cancel"), 0, wxLEFT, 5);
+
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(fields, 0, wxEXPAND | wxALL, 10);
+    sizer->Add(counter, 0, wxEXPAND | wxLEFT | wxRIGHT, 10);
+    sizer->Add(help, 0, wxLEFT | wxRIGHT | wxTOP, 10);
+    sizer->Add(m_preview, 1, wxEXPAND | wxALL, 10);
+    sizer->Add(buttons, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+    SetSizer(sizer);
+
+    UpdatePreview();
+}
+
+/*
+Function: BatchRenameDialog::ReadRule
+Description: Builds the rename rule from the dialog fields.
+Parameters:
+  - None
+Returns:
+  - RenameRule: Current rule.
+*/
+RenameRule BatchRenameDialog::ReadRule() const
+{
+    RenameRule rule;
+    rule.find = m_findCtrl->GetValue().ToStdString();
+    rule.replace = m_replaceCtrl->GetValue().ToStdString();
+    rule.nameTemplate = m_templateCtrl->GetValue().ToStdString();
+    rule.counterStart = m_startCtrl->GetValue();
+    rule.counterStep = m_stepCtrl->GetValue();
+    rule.counterWidth = m_widthCtrl->GetValue();
+    rule.filesOnly = m_filesOnlyCheck->GetValue();
+    return rule;
+}
+
+/*
+Function: BatchRenameDialog::UpdatePreview
+Description: Recomputes the rename plan for the current rule and redraws the preview and the
+             summary line. Rename is only enabled when something changes and nothing collides.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void BatchRenameDialog::UpdatePreview()
+{
+    std::string err;
+    const bool valid = PlanBatchRename(*m_listing, ReadRule(), m_plan, err);
+
+    m_preview->SetItemCount((long)m_plan.rows.size());
+    m_preview->Refresh();
+
+    if (!valid)
+        m_summary->SetLabel(wxString::FromUTF8(err));
+    else
+        m_summary->SetLabel(wxString::Format("%zu selected, %zu to rename, %zu conflict(s)",
+                                             m_plan.rows.size(), m_plan.ops.size(), m_plan.conflicts));
+    m_renameButton->Enable(valid && !m_plan.ops.empty() && m_plan.conflicts == 0);
+}
+
+/*
+Function: BatchRenameDialog::OnRuleChanged
+Description: Text and checkbox handler for the rule fields. Restarts the preview delay so the
+             plan is recomputed once the user pauses.
+Parameters:
+  - event: wxWidgets command event.
+Returns:
+  - None
+*/
+void BatchRenameDialog::OnRuleChanged(wxCommandEvent&)
+{
+    m_previewTimer.StartOnce(kPreviewDelayMs);
+}
+
+/*
+Function: BatchRenameDialog::OnCounterChanged
+Description: Spin control handler for the counter settings; same as OnRuleChanged.
+Parameters:
+  - event: wxWidgets spin event.
+Returns:
+  - None
+*/
+void BatchRenameDialog::OnCounterChanged(wxSpinEvent&)
+{
+    m_previewTimer.StartOnce(kPreviewDelayMs);
+}
+
+/*
+Function: BatchRenameDialog::OnPreviewTimer
+Description: Timer handler that recomputes the preview after the delay.
+Parameters:
+  - event: wxWidgets timer event.
+Returns:
+  - None
+*/
+void BatchRenameDialog::OnPreviewTimer(wxTimerEvent&)
+{
+    UpdatePreview();
+}
+
+/*
+Function: BatchRenameDialog::OnRename
+Description: Button handler for “Rename”. Brings the plan up to date, asks for confirmation
+             and applies every rename of the plan as one batch, then closes the dialog. If the
+             batch fails part way the error is shown and the dialog still closes, since the
+             directory has changed.
+Parameters:
+  - event: wxWidgets button command event.
+Returns:
+  - None
+*/
+void BatchRenameDialog::OnRename(wxCommandEvent&)
+{
+    m_previewTimer.Stop();
+    UpdatePreview();
+    if (m_plan.ops.empty() || m_plan.conflicts != 0) return;
+
+    const wxString q = wxString::Format("Rename %zu entries in:\n", m_plan.ops.size()) +
+                       wxString::FromUTF8(m_dir.u8string());
+    if (wxMessageBox(q, "Confirm Rename", wxYES_NO | wxNO_DEFAULT | wxICON_QUESTION, this) != wxYES)
+        return;
+
+    std::string err;
+    bool ok;
+    {
+        wxBusyCursor busy;
+        ok = m_fs.RenameBatch(m_dir, m_plan.ops, m_renamed, err);
+    }
+    if (!ok)
+    {
+        wxMessageBox(wxString::Format("%zu of %zu entries renamed.\n\n", m_renamed, m_plan.ops.size()) +
+                     wxString::FromUTF8(err), "Batch Rename", wxOK | wxICON_ERROR, this);
+    }
+    EndModal(wxID_OK);
+}
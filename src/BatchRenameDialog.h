@@ -0,0 +1,64 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the BatchRenameDialog class, the window used to rename many entries of one directory at once. The user writes a find/replace expression and a name template, watches the preview of every old and new name update as they type, and applies the whole batch in one step once no name collides.
+February 1, 2026
+*/
+
+#ifndef BATCHRENAMEDIALOG_H
+#define BATCHRENAMEDIALOG_H
+
+#include <wx/wx.h>
+#include <wx/spinctrl.h>
+#include <wx/timer.h>
+
+#include "BatchRename.h"
+
+class RenamePreviewList;
+
+class BatchRenameDialog final : public wxDialog
+{
+public:
+    BatchRenameDialog(wxWindow* parent, const FileSystemService& fs, const fs::path& dir, DirectoryListing listing);
+
+    // Entries renamed by the dialog (also after a failed batch)
+    std::size_t Renamed() const { return m_renamed; }
+
+private:
+    wxTextCtrl* m_findCtrl = nullptr;
+    wxTextCtrl* m_replaceCtrl = nullptr;
+    wxTextCtrl* m_templateCtrl = nullptr;
+    wxSpinCtrl* m_startCtrl = nullptr;
+    wxSpinCtrl* m_stepCtrl = nullptr;
+    wxSpinCtrl* m_widthCtrl = nullptr;
+    wxCheckBox* m_filesOnlyCheck = nullptr;
+    RenamePreviewList* m_preview = nullptr;
+    wxStaticText* m_summary = nullptr;
+    wxButton* m_renameButton = nullptr;
+    // recomputes the preview shortly after the user stops typing
+    wxTimer m_previewTimer;
+
+    const FileSystemService& m_fs;
+    fs::path m_dir;
+    DirectoryListing m_listing;
+    RenamePlan m_plan;
+    std::size_t m_renamed = 0;
+
+    enum
+    {
+        ID_Rule = wxID_HIGHEST + 1,
+        ID_Rename,
+        ID_PreviewTimer
+    };
+
+    RenameRule ReadRule() const;
+    void UpdatePreview();
+
+    void OnRuleChanged(wxCommandEvent& event);
+    void OnCounterChanged(wxSpinEvent& event);
+    void OnPreviewTimer(wxTimerEvent& event);
+    void OnRename(wxCommandEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+#endif // BATCHRENAMEDIALOG_H
@@ -0,0 +1,255 @@
+/*
+Parneet Baidwan - 251259638
+Description: The checksum implementation in this file provides the XXH64 hash (a fast non-cryptographic 64-bit hash used to compare file contents), a helper that hashes a whole file with large sequential reads, and the rsync-style rolling checksum whose value can be updated in constant time when a window slides by one byte.
+February 1, 2026
+*/
+
+#include "Checksum.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    constexpr std::uint64_t kPrime1 = 11400714785074694791ULL;
+    constexpr std::uint64_t kPrime2 = 14029467366897019727ULL;
+    constexpr std::uint64_t kPrime3 = 1609587929392839161ULL;
+    constexpr std::uint64_t kPrime4 = 9650029242287828579ULL;
+    constexpr std::uint64_t kPrime5 = 2870177450012600261ULL;
+
+    constexpr std::size_t kReadChunk = 1 << 20;
+
+    inline std::uint64_t Rotl(std::uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline std::uint64_t Read64(const unsigned char* p)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline std::uint32_t Read32(const unsigned char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline std::uint64_t Round(std::uint64_t acc, std::uint64_t input)
+    {
+        acc += input * kPrime2;
+        acc = Rotl(acc, 31);
+        return acc * kPrime1;
+    }
+
+    inline std::uint64_t MergeRound(std::uint64_t acc, std::uint64_t val)
+    {
+        acc ^= Round(0, val);
+        return acc * kPrime1 + kPrime4;
+    }
+}
+
+/*
+Function: Hash64::Hash64
+Description: Starts a new XXH64 computation.
+Parameters:
+  - seed: Hash seed; the same seed must be used to compare digests.
+Returns:
+  - None
+*/
+Hash64::Hash64(std::uint64_t seed)
+    : m_seed(seed)
+{
+    m_acc[0] = seed + kPrime1 + kPrime2;
+    m_acc[1] = seed + kPrime2;
+    m_acc[2] = seed;
+    m_acc[3] = seed - kPrime1;
+}
+
+/*
+Function: Hash64::Update
+Description: Feeds more bytes into the hash. Input is consumed in 32-byte stripes; a partial
+             stripe is buffered until the next call or Digest().
+Parameters:
+  - data: Bytes to hash.
+  - len: Number of bytes.
+Returns:
+  - None
+*/
+void Hash64::Update(const void* data, std::size_t len)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + len;
+    m_totalLen += len;
+
+    if (m_bufLen + len < sizeof(m_buf))
+    {
+        std::memcpy(m_buf + m_bufLen, p, len);
+        m_bufLen += len;
+        return;
+    }
+
+    if (m_bufLen > 0)
+    {
+        const std::size_t fill = sizeof(m_buf) - m_bufLen;
+        std::memcpy(m_buf + m_bufLen, p, fill);
+        for (int i = 0; i < 4; ++i) m_acc[i] = Round(m_acc[i], Read64(m_buf + 8 * i));
+        p += fill;
+        m_bufLen = 0;
+    }
+
+    while (end - p >= 32)
+    {
+        for (int i = 0; i < 4; ++i) m_acc[i] = Round(m_acc[i], Read64(p + 8 * i));
+        p += 32;
+    }
+
+    m_bufLen = static_cast<std::size_t>(end - p);
+    std::memcpy(m_buf, p, m_bufLen);
+}
+
+/*
+Function: Hash64::Digest
+Description: Returns the hash of all bytes fed so far. The hasher can keep being updated.
+Parameters:
+  - None
+Returns:
+  - std::uint64_t: XXH64 digest.
+*/
+std::uint64_t Hash64::Digest() const
+{
+    std::uint64_t h;
+    if (m_totalLen >= 32)
+    {
+        h = Rotl(m_acc[0], 1) + Rotl(m_acc[1], 7) + Rotl(m_acc[2], 12) + Rotl(m_acc[3], 18);
+        for (int i = 0; i < 4; ++i) h = MergeRound(h, m_acc[i]);
+    }
+    else
+    {
+        h = m_seed + kPrime5;
+    }
+
+    h += m_totalLen;
+
+    const unsigned char* p = m_buf;
+    const unsigned char* const end = m_buf + m_bufLen;
+    while (end - p >= 8)
+    {
+        h ^= Round(0, Read64(p));
+        h = Rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (end - p >= 4)
+    {
+        h ^= static_cast<std::uint64_t>(Read32(p)) * kPrime1;
+        h = Rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end)
+    {
+        h ^= (*p) * kPrime5;
+        h = Rotl(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+/*
+Function: Hash64::Of
+Description: One-shot XXH64 of a memory block.
+Parameters:
+  - data: Bytes to hash.
+  - len: Number of bytes.
+  - seed: Hash seed.
+Returns:
+  - std::uint64_t: XXH64 digest.
+*/
+std::uint64_t Hash64::Of(const void* data, std::size_t len, std::uint64_t seed)
+{
+    Hash64 h(seed);
+    h.Update(data, len);
+    return h.Digest();
+}
+
+/*
+Function: RollingChecksum::Reset
+Description: Computes the checksum of a new window from scratch.
+Parameters:
+  - data: First byte of the window.
+  - len: Window length; later Roll() calls keep this length.
+Returns:
+  - None
+*/
+void RollingChecksum::Reset(const unsigned char* data, std::size_t len)
+{
+    m_a = 0;
+    m_b = 0;
+    m_len = len;
+    for (std::size_t i = 0; i < len; ++i)
+    {
+        m_a += data[i];
+        m_b += static_cast<std::uint32_t>(len - i) * data[i];
+    }
+}
+
+/*
+Function: RollingChecksum::Roll
+Description: Slides the window forward by one byte in constant time.
+Parameters:
+  - out: Byte leaving the window (its first byte).
+  - in: Byte entering the window (the byte after its last byte).
+Returns:
+  - None
+*/
+void RollingChecksum::Roll(unsigned char out, unsigned char in)
+{
+    m_a = m_a - out + in;
+    m_b = m_b - static_cast<std::uint32_t>(m_len) * out + m_a;
+}
+
+/*
+Function: HashFileContents
+Description: Computes the XXH64 digest of a file's contents using large sequential reads.
+Parameters:
+  - file: File to hash.
+  - outHash: Output digest (unchanged on failure).
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the whole file was read and hashed; false otherwise.
+*/
+bool HashFileContents(const fs::path& file, std::uint64_t& outHash, std::string& outErr)
+{
+    outErr.clear();
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> f(std::fopen(file.c_str(), "rb"), &std::fclose);
+    if (!f)
+    {
+        outErr = "Cannot open for hashing: " + file.string();
+        return false;
+    }
+
+    std::unique_ptr<unsigned char[]> buf(new unsigned char[kReadChunk]);
+    Hash64 h;
+    std::size_t n;
+    while ((n = std::fread(buf.get(), 1, kReadChunk, f.get())) > 0)
+        h.Update(buf.get(), n);
+
+    if (std::ferror(f.get()))
+    {
+        outErr = "Read error while hashing: " + file.string();
+        return false;
+    }
+
+    outHash = h.Digest();
+    return true;
+}
@@ -0,0 +1,52 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the checksum routines used when file contents have to be compared: a streaming 64-bit xxHash (XXH64) for content hashes, a whole-file hashing helper, and the rolling weak checksum used to find matching blocks for delta transfers.
+February 1, 2026
+*/
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// Streaming XXH64 hasher
+class Hash64 final
+{
+public:
+    explicit Hash64(std::uint64_t seed = 0);
+
+    void Update(const void* data, std::size_t len);
+    std::uint64_t Digest() const;
+
+    static std::uint64_t Of(const void* data, std::size_t len, std::uint64_t seed = 0);
+
+private:
+    std::uint64_t m_acc[4];
+    std::uint64_t m_seed;
+    std::uint64_t m_totalLen = 0;
+    unsigned char m_buf[32];
+    std::size_t m_bufLen = 0;
+};
+
+// Rolling weak checksum over a fixed-size window (rsync style)
+class RollingChecksum final
+{
+public:
+    void Reset(const unsigned char* data, std::size_t len);
+    void Roll(unsigned char out, unsigned char in);
+    std::uint32_t Value() const { return (m_a & 0xffff) | (m_b << 16); }
+
+private:
+    std::uint32_t m_a = 0;
+    std::uint32_t m_b = 0;
+    std::size_t m_len = 0;
+};
+
+bool HashFileContents(const fs::path& file, std::uint64_t& outHash, std::string& outErr);
+
+#endif // CHECKSUM_H
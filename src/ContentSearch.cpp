@@ -0,0 +1,505 @@
+/*
+Parneet Baidwan - 251259638
+Description: The ContentSearch class implementation in this file walks a directory tree with the parallel tree walker and scans every regular file for the search pattern on the walker thread that found it. Files are read in large chunks, split at line ends, rather than memory-mapped, so a file truncated while it is scanned simply ends early instead of faulting. Literal patterns are located with an SSE2 scan that checks the first and last byte of the token sixteen positions at a time before verifying candidates; regular expressions are prefiltered by the longest literal they require and only candidate lines are handed to std::regex. Files with a NUL byte near the start are treated as binary and skipped.
+February 1, 2026
+*/
+
+#include "ContentSearch.h"
+#include "TreeWalker.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <regex>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FM_HAVE_POSIX_IO 1
+#endif
+
+namespace
+{
+    // Bytes inspected for NUL to decide a file is binary
+    constexpr std::size_t kSniffBytes = 8192;
+    // Bytes read per call; smaller files are read in one
+    constexpr std::size_t kReadChunk = 1u << 20;
+    // An unfinished line is carried into the next chunk up to this length, then scanned as is
+    constexpr std::size_t kMaxCarry = 16u << 20;
+
+    inline char Lower(char c)
+    {
+        return (char)std::tolower((unsigned char)c);
+    }
+
+    /*
+    Class: LiteralFinder
+    Description: Finds a fixed token in a buffer. Candidate positions are those where both the
+                 first and the last byte of the token match, tested 16 positions per step with
+                 SSE2; candidates are then verified byte by byte. Without SSE2 the scan falls
+                 back to memchr on the first byte.
+    */
+    class LiteralFinder
+    {
+    public:
+        void Init(const std::string& needle, bool ignoreCase)
+        {
+            m_ignoreCase = ignoreCase;
+            m_needle = needle;
+            if (ignoreCase)
+                std::transform(m_needle.begin(), m_needle.end(), m_needle.begin(), Lower);
+        }
+
+        bool Empty() const { return m_needle.empty(); }
+
+        const char* Find(const char* p, const char* end) const
+        {
+            const std::size_t n = m_needle.size();
+            if (n == 0 || (std::size_t)(end - p) < n) return nullptr;
+            const char* const last = end - n;
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+            const char first = m_needle.front();
+            const char lastCh = m_needle.back();
+            const __m128i f1 = _mm_set1_epi8(first);
+            const __m128i f2 = _mm_set1_epi8(m_ignoreCase ? (char)std::toupper((unsigned char)first) : first);
+            const __m128i l1 = _mm_set1_epi8(lastCh);
+            const __m128i l2 = _mm_set1_epi8(m_ignoreCase ? (char)std::toupper((unsigned char)lastCh) : lastCh);
+
+            while (last - p >= 15)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n - 1));
+                const __m128i ma = _mm_or_si128(_mm_cmpeq_epi8(a, f1), _mm_cmpeq_epi8(a, f2));
+                const __m128i mb = _mm_or_si128(_mm_cmpeq_epi8(b, l1), _mm_cmpeq_epi8(b, l2));
+                unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(ma, mb));
+                while (mask != 0)
+                {
+                    const int bit = __builtin_ctz(mask);
+                    if (Verify(p + bit)) return p + bit;
+                    mask &= mask - 1;
+                }
+                p += 16;
+            }
+#endif
+
+            if (!m_ignoreCase)
+            {
+                while (p <= last)
+                {
+                    p = static_cast<const char*>(std::memchr(p, m_needle.front(), (std::size_t)(last - p) + 1));
+                    if (!p) return nullptr;
+                    if (std::memcmp(p, m_needle.data(), n) == 0) return p;
+                    ++p;
+                }
+                return nullptr;
+            }
+
+            for (; p <= last; ++p)
+            {
+                if (Verify(p)) return p;
+            }
+            return nullptr;
+        }
+
+    private:
+        bool Verify(const char* p) const
+        {
+            if (!m_ignoreCase) return std::memcmp(p, m_needle.data(), m_needle.size()) == 0;
+            for (std::size_t i = 0; i < m_needle.size(); ++i)
+            {
+                if (Lower(p[i]) != m_needle[i]) return false;
+            }
+            return true;
+        }
+
+        std::string m_needle;
+        bool m_ignoreCase = false;
+    };
+
+    /*
+    Function: RequiredLiteral
+    Description: Extracts the longest run of plain characters that every match of an
+                 ECMAScript regex must contain, for use as a prefilter. Alternation disables
+                 the prefilter; characters inside groups, classes, or followed by an optional
+                 quantifier are not considered required.
+    Parameters:
+      - pattern: Regular expression source.
+    Returns:
+      - std::string: Required literal, or empty if none could be derived safely.
+    */
+    std::string RequiredLiteral(const std::string& pattern)
+    {
+        if (pattern.find('|') != std::string::npos) return "";
+
+        std::string best;
+        std::string run;
+        int depth = 0;
+        bool inClass = false;
+
+        auto endRun = [&]()
+        {
+            if (run.size() > best.size()) best = run;
+            run.clear();
+        };
+
+        for (std::size_t i = 0; i < pattern.size(); ++i)
+        {
+            const char c = pattern[i];
+            const char next = i + 1 < pattern.size() ? pattern[i + 1] : '\0';
+            const bool optional = next == '?' || next == '*' || next == '{';
+
+            if (inClass)
+            {
+                if (c == '\\') ++i;
+                else if (c == ']') inClass = false;
+                continue;
+            }
+
+            if (c == '\\')
+            {
+                if (i + 1 < pattern.size() && std::ispunct((unsigned char)next) && depth == 0)
+                {
+                    const char after = i + 2 < pattern.size() ? pattern[i + 2] : '\0';
+                    if (after == '?' || after == '*' || after == '{') endRun();
+                    else run.push_back(next);
+                }
+                else
+                {
+                    endRun();
+                }
+                ++i;
+                continue;
+            }
+
+            switch (c)
+            {
+            case '[': inClass = true; endRun(); break;
+            case '(': ++depth; endRun(); break;
+            case ')': --depth; endRun(); break;
+            case '{':
+                endRun();
+                while (i + 1 < pattern.size() && pattern[i] != '}') ++i;
+                break;
+            case '.': case '^': case '$': case '*': case '+': case '?': case '}':
+                endRun();
+                break;
+            default:
+                if (depth != 0 || optional) endRun();
+                else run.push_back(c);
+                break;
+            }
+        }
+        endRun();
+        return best;
+    }
+
+    // Literal finder plus optional regex verification
+    struct Matcher
+    {
+        LiteralFinder literal;
+        std::unique_ptr<std::regex> regex;
+    };
+
+    // Totals shared by the walker threads
+    struct SharedStats
+    {
+        std::atomic<std::uint64_t> filesScanned{ 0 };
+        std::atomic<std::uint64_t> filesSkippedBinary{ 0 };
+        std::atomic<std::uint64_t> bytesScanned{ 0 };
+        std::atomic<std::uint64_t> matches{ 0 };
+    };
+
+    /*
+    Function: ScanBuffer
+    Description: Finds matching lines in a file's contents. Each hit of the literal prefilter
+                 is widened to its line, verified against the regex if there is one, and
+                 reported with its 1-based line number; scanning resumes after that line.
+    Parameters:
+      - data: File contents, or a chunk of them starting at a line.
+      - len: Number of bytes.
+      - file: File path recorded in the matches.
+      - matcher: Compiled pattern.
+      - opts: Search options.
+      - out: Matches are appended here.
+      - firstLine: Line number of the first line in data.
+    Returns:
+      - None
+    */
+    void ScanBuffer(const char* data, std::size_t len, const fs::path& file, const Matcher& matcher,
+                    const ContentSearchOptions& opts, std::vector<ContentMatch>& out, std::uint64_t firstLine)
+    {
+        const char* const end = data + len;
+        const char* p = data;
+        const char* counted = data;
+        std::uint64_t line = firstLine;
+
+        while (p < end)
+        {
+            const char* hit = p;
+            if (!matcher.literal.Empty())
+            {
+                hit = matcher.literal.Find(p, end);
+                if (!hit) break;
+            }
+
+            const char* lineStart = hit;
+            while (lineStart > p && lineStart[-1] != '\n') --lineStart;
+            const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', (std::size_t)(end - hit)));
+            if (!lineEnd) lineEnd = end;
+
+            if (matcher.regex && !std::regex_search(lineStart, lineEnd, *matcher.regex))
+            {
+                p = lineEnd + 1;
+                continue;
+            }
+
+            line += (std::uint64_t)std::count(counted, lineStart, '\n');
+            counted = lineStart;
+
+            const char* textEnd = lineEnd;
+            if (textEnd > lineStart && textEnd[-1] == '\r') --textEnd;
+            const std::size_t textLen = std::min<std::size_t>((std::size_t)(textEnd - lineStart), opts.maxLineLength);
+            out.push_back(ContentMatch{ file, line, std::string(lineStart, textLen) });
+
+            if (opts.firstMatchPerFile) break;
+            p = lineEnd + 1;
+        }
+    }
+
+    /*
+    Function: ScanFile
+    Description: Reads one file in chunks with sequential read-ahead, skips it if it looks
+                 binary, and scans it for matches. Each chunk is scanned up to its last line
+                 end and the unfinished line is carried into the next chunk, so a match is
+                 never split. The file is read rather than memory-mapped: a file that shrinks
+                 during the scan just ends early, where a mapping would fault with SIGBUS.
+    Parameters:
+      - file: File to scan.
+      - matcher: Compiled pattern.
+      - opts: Search options.
+      - buffer: Per-thread scratch buffer reused across files.
+      - out: Matches are appended here.
+      - stats: Totals updated for the file.
+    Returns:
+      - None
+    */
+    void ScanFile(const fs::path& file, const Matcher& matcher, const ContentSearchOptions& opts,
+                  std::vector<char>& buffer, std::vector<ContentMatch>& out, SharedStats& stats)
+    {
+        const std::size_t before = out.size();
+        std::uint64_t scanned = 0;
+
+#ifdef FM_HAVE_POSIX_IO
+        const int fd = ::open(file.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            return;
+        }
+        if ((std::uint64_t)st.st_size > kReadChunk) ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        std::size_t carry = 0;
+        std::uint64_t line = 1;
+        bool first = true;
+        for (;;)
+        {
+            if (buffer.size() < carry + kReadChunk) buffer.resize(carry + kReadChunk);
+            std::size_t got = 0;
+            while (got < kReadChunk)
+            {
+                const ssize_t n = ::read(fd, buffer.data() + carry + got, kReadChunk - got);
+                if (n <= 0) break;
+                got += (std::size_t)n;
+            }
+            const bool eof = got < kReadChunk;
+            const std::size_t avail = carry + got;
+
+            if (first && std::memchr(buffer.data(), '\0', std::min(avail, kSniffBytes)) != nullptr)
+            {
+                ::close(fd);
+                stats.filesSkippedBinary++;
+                return;
+            }
+            first = false;
+
+            // whole lines only, unless the file ends or one line outgrows the carry limit
+            std::size_t scanLen = avail;
+            if (!eof && avail < kMaxCarry)
+            {
+                while (scanLen > 0 && buffer[scanLen - 1] != '\n') --scanLen;
+            }
+
+            ScanBuffer(buffer.data(), scanLen, file, matcher, opts, out, line);
+            scanned += scanLen;
+            if (eof || (opts.firstMatchPerFile && out.size() > before)) break;
+
+            line += (std::uint64_t)std::count(buffer.data(), buffer.data() + scanLen, '\n');
+            carry = avail - scanLen;
+            std::memmove(buffer.data(), buffer.data() + scanLen, carry);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(file, std::ios::binary);
+        if (!in) return;
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (std::memchr(buffer.data(), '\0', std::min(buffer.size(), kSniffBytes)) != nullptr)
+        {
+            stats.filesSkippedBinary++;
+            return;
+        }
+        ScanBuffer(buffer.data(), buffer.size(), file, matcher, opts, out, 1);
+        scanned = buffer.size();
+#endif
+
+        stats.filesScanned++;
+        stats.bytesScanned += scanned;
+        stats.matches += out.size() - before;
+    }
+}
+
+/*
+Function: ContentSearch::~ContentSearch
+Description: Cancels a running search and waits for its threads to finish.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+ContentSearch::~ContentSearch()
+{
+    Cancel();
+}
+
+/*
+Function: ContentSearch::Start
+Description: Compiles the pattern and starts searching below root in the background. Matches
+             are passed to onMatches per file, from worker threads, while the search runs;
+             onDone is called once with the totals when it ends. A search already running is
+             cancelled first.
+Parameters:
+  - root: Directory to search.
+  - opts: Pattern and search options.
+  - onMatches: Receives batches of matches (must be thread-safe).
+  - onDone: Receives the final totals.
+  - outErr: Output string populated with an error message if the search cannot start; cleared on success.
+Returns:
+  - bool: true if the search was started; false otherwise.
+*/
+bool ContentSearch::Start(const fs::path& root,
+                          const ContentSearchOptions& opts,
+                          MatchSink onMatches,
+                          DoneSink onDone,
+                          std::string& outErr)
+{
+    outErr.clear();
+    Cancel();
+
+    std::error_code ec;
+    if (!fs::is_directory(root, ec))
+    {
+        outErr = "Not a directory: " + root.string();
+        return false;
+    }
+    if (opts.pattern.empty())
+    {
+        outErr = "Search text cannot be empty.";
+        return false;
+    }
+
+    auto matcher = std::make_shared<Matcher>();
+    if (opts.regex)
+    {
+        try
+        {
+            auto flags = std::regex::ECMAScript | std::regex::optimize;
+            if (opts.ignoreCase) flags |= std::regex::icase;
+            matcher->regex = std::make_unique<std::regex>(opts.pattern, flags);
+        }
+        catch (const std::regex_error& e)
+        {
+            outErr = std::string("Invalid regular expression: ") + e.what();
+            return false;
+        }
+        matcher->literal.Init(RequiredLiteral(opts.pattern), opts.ignoreCase);
+    }
+    else
+    {
+        matcher->literal.Init(opts.pattern, opts.ignoreCase);
+    }
+
+    m_cancel = false;
+    m_running = true;
+    m_thread = std::thread([this, root, opts, matcher, onMatches, onDone]()
+    {
+        SharedStats shared;
+
+        // read and match buffers of each walker thread
+        struct Scratch
+        {
+            std::vector<char> buffer;
+            std::vector<ContentMatch> matches;
+        };
+        const unsigned threads = TreeWalkThreads(root, opts.threads);
+        std::vector<Scratch> scratch(threads);
+
+        TreeWalkOptions walkOpts;
+        walkOpts.threads = threads;
+        walkOpts.statEntries = false;       // ScanFile sizes each file itself
+        walkOpts.cancel = &m_cancel;
+
+        TreeWalkCallbacks callbacks;
+        callbacks.filter = [](const WalkEntry& e) { return e.type == FsEntryType::File; };
+        callbacks.onEntry = [&](const WalkEntry& e)
+        {
+            Scratch& own = scratch[e.worker];
+            ScanFile(e.path, *matcher, opts, own.buffer, own.matches, shared);
+            if (!own.matches.empty())
+            {
+                onMatches(std::move(own.matches));
+                own.matches.clear();
+            }
+        };
+
+        TreeWalkStats walkStats;
+        std::string walkErr;
+        WalkTree(root, walkOpts, callbacks, walkStats, walkErr);
+
+        ContentSearchStats stats;
+        stats.filesScanned = shared.filesScanned;
+        stats.filesSkippedBinary = shared.filesSkippedBinary;
+        stats.bytesScanned = shared.bytesScanned;
+        stats.matches = shared.matches;
+        stats.cancelled = m_cancel;
+
+        m_running = false;
+        if (onDone) onDone(stats);
+    });
+    return true;
+}
+
+/*
+Function: ContentSearch::Cancel
+Description: Stops a running search as soon as each worker finishes its current file, and
+             waits for it. onDone is still called, with cancelled set.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ContentSearch::Cancel()
+{
+    m_cancel = true;
+    if (m_thread.joinable()) m_thread.join();
+}
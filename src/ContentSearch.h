@@ -0,0 +1,79 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the ContentSearch class and its data structures, which search the contents of every file below a directory for a literal token or a regular expression. The search runs on a pool of background threads, skips binary files, and hands matches to a caller-supplied sink while it is still running.
+February 1, 2026
+*/
+
+#ifndef CONTENTSEARCH_H
+#define CONTENTSEARCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// One matching line
+struct ContentMatch
+{
+    fs::path file;
+    std::uint64_t lineNumber = 0;
+    std::string lineText;
+};
+
+// What to search for and how
+struct ContentSearchOptions
+{
+    std::string pattern;
+    bool regex = false;
+    bool ignoreCase = false;
+    bool firstMatchPerFile = false;     // stop reading a file at its first match
+    unsigned threads = 0;               // 0 = one per core, more on network filesystems
+    std::size_t maxLineLength = 400;    // longer lines are truncated in results
+};
+
+// Totals of a finished (or cancelled) search
+struct ContentSearchStats
+{
+    std::uint64_t filesScanned = 0;
+    std::uint64_t filesSkippedBinary = 0;
+    std::uint64_t bytesScanned = 0;
+    std::uint64_t matches = 0;
+    bool cancelled = false;
+};
+
+// Background parallel content search
+class ContentSearch final
+{
+public:
+    // Called from worker threads with the matches of one file
+    using MatchSink = std::function<void(std::vector<ContentMatch>&&)>;
+    // Called once from a worker thread when the search ends
+    using DoneSink = std::function<void(const ContentSearchStats&)>;
+
+    ContentSearch() = default;
+    ~ContentSearch();
+
+    ContentSearch(const ContentSearch&) = delete;
+    ContentSearch& operator=(const ContentSearch&) = delete;
+
+    bool Start(const fs::path& root,
+               const ContentSearchOptions& opts,
+               MatchSink onMatches,
+               DoneSink onDone,
+               std::string& outErr);
+    void Cancel();
+    bool Running() const { return m_running; }
+
+private:
+    std::thread m_thread;
+    std::atomic<bool> m_cancel{ false };
+    std::atomic<bool> m_running{ false };
+};
+
+#endif // CONTENTSEARCH_H
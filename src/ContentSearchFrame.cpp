@@ -0,0 +1,262 @@
+/*
+Parneet Baidwan - 251259638
+Description: The ContentSearchFrame class in this file builds the content search window. It starts and stops the background ContentSearch, streams its matches into a file/line/text list while it runs, reports progress in the status bar, and opens a result with the default application when it is double-clicked.
+February 1, 2026
+*/
+
+#include "ContentSearchFrame.h"
+
+#include <wx/msgdlg.h>
+
+namespace
+{
+    // Rows beyond this are counted but not shown, to keep the list responsive
+    constexpr std::uint64_t kMaxShownMatches = 100000;
+}
+
+// bind event ids to handler methods
+wxBEGIN_EVENT_TABLE(ContentSearchFrame, wxFrame)
+    EVT_TEXT_ENTER(ContentSearchFrame::ID_Pattern, ContentSearchFrame::OnStart)
+    EVT_BUTTON(ContentSearchFrame::ID_Start, ContentSearchFrame::OnStart)
+    EVT_LIST_ITEM_ACTIVATED(ContentSearchFrame::ID_Results, ContentSearchFrame::OnResultActivated)
+    EVT_TIMER(ContentSearchFrame::ID_Drain, ContentSearchFrame::OnDrainTimer)
+wxEND_EVENT_TABLE()
+
+/*
+Function: ContentSearchFrame::ContentSearchFrame
+Description: Builds the search window: directory and pattern fields, option checkboxes, the
+             Search/Stop button and the result list.
+Parameters:
+  - parent: Owning window.
+  - root: Directory the search starts in.
+Returns:
+  - None
+*/
+ContentSearchFrame::ContentSearchFrame(wxWindow* parent, const fs::path& root)
+    : wxFrame(parent, wxID_ANY, "Search File Contents", wxDefaultPosition, wxSize(900, 600)),
+      m_drainTimer(this, ID_Drain)
+{
+    auto* panel = new wxPanel(this);
+
+    m_rootCtrl = new wxTextCtrl(panel, wxID_ANY, wxString::FromUTF8(root.u8string()));
+    m_patternCtrl = new wxTextCtrl(panel, ID_Pattern, "", wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+    m_regexCheck = new wxCheckBox(panel, wxID_ANY, "Regular expression");
+    m_caseCheck = new wxCheckBox(panel, wxID_ANY, "Ignore case");
+    m_firstOnlyCheck = new wxCheckBox(panel, wxID_ANY, "First match per file");
+    m_startButton = new wxButton(panel, ID_Start, "Search");
+
+    m_resultList = new wxListCtrl(panel, ID_Results, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL);
+    m_resultList->InsertColumn(0, "File", wxLIST_FORMAT_LEFT, 380);
+    m_resultList->InsertColumn(1, "Line", wxLIST_FORMAT_RIGHT, 70);
+    m_resultList->InsertColumn(2, "Text", wxLIST_FORMAT_LEFT, 420);
+
+    auto* fields = new wxFlexGridSizer(2, 5, 5);
+    fields->AddGrowableCol(1, 1);
+    fields->Add(new wxStaticText(panel, wxID_ANY, "Directory:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_rootCtrl, 1, wxEXPAND);
+    fields->Add(new wxStaticText(panel, wxID_ANY, "Find:"), 0, wxALIGN_CENTER_VERTICAL);
+    fields->Add(m_patternCtrl, 1, wxEXPAND);
+
+    auto* options = new wxBoxSizer(wxHORIZONTAL);
+    options->Add(m_regexCheck, 0, wxRIGHT, 10);
+    options->Add(m_caseCheck, 0, wxRIGHT, 10);
+    options->Add(m_firstOnlyCheck, 0, wxRIGHT, 10);
+    options->AddStretchSpacer();
+    options->Add(m_startButton, 0);
+
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(fields, 0, wxEXPAND | wxALL, 10);
+    sizer->Add(options, 0, wxEXPAND | wxLEFT | wxRIGHT, 10);
+    sizer->Add(m_resultList, 1, wxEXPAND | wxALL, 10);
+    panel->SetSizer(sizer);
+
+    CreateStatusBar(1);
+    SetStatusText("Enter text to find and press Search.");
+}
+
+/*
+Function: ContentSearchFrame::~ContentSearchFrame
+Description: Stops a running search before the window (and its result buffer) goes away.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+ContentSearchFrame::~ContentSearchFrame()
+{
+    m_drainTimer.Stop();
+    m_search.Cancel();
+}
+
+/*
+Function: ContentSearchFrame::StartSearch
+Description: Clears previous results and starts a background search with the current
+             settings. Worker threads only append to the pending buffer; the drain timer
+             moves matches into the list on the UI thread.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ContentSearchFrame::StartSearch()
+{
+    StopSearch();
+
+    m_resultList->DeleteAllItems();
+    m_resultFiles.clear();
+    m_shownMatches = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.clear();
+        m_finished = false;
+    }
+
+    ContentSearchOptions opts;
+    opts.pattern = m_patternCtrl->GetValue().utf8_string();
+    opts.regex = m_regexCheck->GetValue();
+    opts.ignoreCase = m_caseCheck->GetValue();
+    opts.firstMatchPerFile = m_firstOnlyCheck->GetValue();
+
+    std::string err;
+    const bool started = m_search.Start(
+        fs::path(m_rootCtrl->GetValue().ToStdString()),
+        opts,
+        [this](std::vector<ContentMatch>&& matches)
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            for (auto& m : matches) m_pending.push_back(std::move(m));
+        },
+        [this](const ContentSearchStats& stats)
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_finalStats = stats;
+            m_finished = true;
+        },
+        err);
+
+    if (!started)
+    {
+        wxMessageBox(wxString::FromUTF8(err), "Search", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    m_startButton->SetLabel("Stop");
+    SetStatusText("Searching...");
+    m_drainTimer.Start(100);
+}
+
+/*
+Function: ContentSearchFrame::StopSearch
+Description: Cancels a running search; the drain timer then shows the final totals.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ContentSearchFrame::StopSearch()
+{
+    if (m_search.Running()) m_search.Cancel();
+}
+
+/*
+Function: ContentSearchFrame::DrainPending
+Description: Moves matches collected by the workers into the result list (up to a display
+             limit) and updates the status bar; once the search has ended, shows the final
+             totals and stops the timer.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ContentSearchFrame::DrainPending()
+{
+    std::vector<ContentMatch> batch;
+    bool finished = false;
+    ContentSearchStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        batch.swap(m_pending);
+        finished = m_finished;
+        stats = m_finalStats;
+    }
+
+    if (!batch.empty())
+    {
+        m_resultList->Freeze();
+        for (auto& m : batch)
+        {
+            if (m_shownMatches >= kMaxShownMatches) break;
+            const long idx = m_resultList->InsertItem(m_resultList->GetItemCount(), wxString::FromUTF8(m.file.u8string()));
+            m_resultList->SetItem(idx, 1, wxString::Format("%llu", (unsigned long long)m.lineNumber));
+            m_resultList->SetItem(idx, 2, wxString::FromUTF8(m.lineText));
+            m_resultFiles.push_back(std::move(m.file));
+            ++m_shownMatches;
+        }
+        m_resultList->Thaw();
+    }
+
+    if (!finished)
+    {
+        SetStatusText(wxString::Format("Searching... %llu match(es) so far", (unsigned long long)m_shownMatches));
+        return;
+    }
+
+    m_drainTimer.Stop();
+    m_startButton->SetLabel("Search");
+    SetStatusText(wxString::Format("%s: %llu match(es) in %llu file(s) scanned, %llu binary file(s) skipped, %.1f MB read%s",
+                                   stats.cancelled ? "Stopped" : "Done",
+                                   (unsigned long long)stats.matches,
+                                   (unsigned long long)stats.filesScanned,
+                                   (unsigned long long)stats.filesSkippedBinary,
+                                   stats.bytesScanned / (1024.0 * 1024.0),
+                                   stats.matches > kMaxShownMatches ? " (list truncated)" : ""));
+}
+
+/*
+Function: ContentSearchFrame::OnStart
+Description: Handler for the Search/Stop button and Enter in the pattern field. Starts a new
+             search, or stops the running one when the button reads “Stop”.
+Parameters:
+  - event: wxWidgets command event.
+Returns:
+  - None
+*/
+void ContentSearchFrame::OnStart(wxCommandEvent& event)
+{
+    if (m_search.Running() && event.GetId() == ID_Start)
+    {
+        StopSearch();
+        return;
+    }
+    StartSearch();
+}
+
+/*
+Function: ContentSearchFrame::OnResultActivated
+Description: Opens the file of a double-clicked result with the system default application.
+Parameters:
+  - event: wxListEvent with the activated row.
+Returns:
+  - None
+*/
+void ContentSearchFrame::OnResultActivated(wxListEvent& event)
+{
+    const long row = event.GetIndex();
+    if (row < 0 || (std::size_t)row >= m_resultFiles.size()) return;
+
+    if (!wxLaunchDefaultApplication(wxString::FromUTF8(m_resultFiles[(std::size_t)row].u8string())))
+        wxMessageBox("Could not open file with the default application.", "Open Failed", wxOK | wxICON_ERROR, this);
+}
+
+/*
+Function: ContentSearchFrame::OnDrainTimer
+Description: Timer handler; delegates to DrainPending().
+Parameters:
+  - event: wxWidgets timer event.
+Returns:
+  - None
+*/
+void ContentSearchFrame::OnDrainTimer(wxTimerEvent&)
+{
+    DrainPending();
+}
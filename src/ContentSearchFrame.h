@@ -0,0 +1,63 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the ContentSearchFrame class, the window in which the user searches file contents below a directory. Matches found by the background ContentSearch are collected under a lock and moved into the result list by a timer, so the list fills while the search runs without flooding the event queue.
+February 1, 2026
+*/
+
+#ifndef CONTENTSEARCHFRAME_H
+#define CONTENTSEARCHFRAME_H
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <mutex>
+#include <vector>
+
+#include "ContentSearch.h"
+
+class ContentSearchFrame final : public wxFrame
+{
+public:
+    ContentSearchFrame(wxWindow* parent, const fs::path& root);
+    ~ContentSearchFrame() override;
+
+private:
+    wxTextCtrl* m_rootCtrl = nullptr;
+    wxTextCtrl* m_patternCtrl = nullptr;
+    wxCheckBox* m_regexCheck = nullptr;
+    wxCheckBox* m_caseCheck = nullptr;
+    wxCheckBox* m_firstOnlyCheck = nullptr;
+    wxButton* m_startButton = nullptr;
+    wxListCtrl* m_resultList = nullptr;
+    wxTimer m_drainTimer;
+
+    ContentSearch m_search;
+
+    // filled by worker threads, drained by the timer
+    std::mutex m_pendingMutex;
+    std::vector<ContentMatch> m_pending;
+    bool m_finished = false;
+    ContentSearchStats m_finalStats;
+
+    std::vector<fs::path> m_resultFiles;
+    std::uint64_t m_shownMatches = 0;
+
+    enum
+    {
+        ID_Pattern = wxID_HIGHEST + 1,
+        ID_Start,
+        ID_Results,
+        ID_Drain
+    };
+
+    void StartSearch();
+    void StopSearch();
+    void DrainPending();
+
+    void OnStart(wxCommandEvent& event);
+    void OnResultActivated(wxListEvent& event);
+    void OnDrainTimer(wxTimerEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+#endif // CONTENTSEARCHFRAME_H
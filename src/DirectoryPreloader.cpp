@@ -0,0 +1,109 @@
+/*
+Parneet Baidwan - 251259638
+Description: The DirectoryPreloader class implementation in this file runs a single idle-priority worker thread that pulls directory hints from a small queue and lists them through FileSystemService, which stores the result in the listing cache shared with the tabs. The newest hint is served first and old hints are dropped when the queue is full.
+February 1, 2026
+*/
+
+#include "DirectoryPreloader.h"
+#include "ThreadUtil.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Hints older than this are no longer worth the I/O
+    constexpr std::size_t kMaxQueuedHints = 32;
+}
+
+/*
+Function: DirectoryPreloader::DirectoryPreloader
+Description: Starts the background preloading thread.
+Parameters:
+  - fs: Filesystem service whose listing cache is filled; must outlive the preloader.
+Returns:
+  - None
+*/
+DirectoryPreloader::DirectoryPreloader(const FileSystemService& fs)
+    : m_fs(fs)
+{
+    m_thread = std::thread(&DirectoryPreloader::Run, this);
+}
+
+/*
+Function: DirectoryPreloader::~DirectoryPreloader
+Description: Drops pending hints and joins the background thread. A listing already in
+             progress is allowed to finish.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+DirectoryPreloader::~DirectoryPreloader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_queue.clear();
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+/*
+Function: DirectoryPreloader::Request
+Description: Queues a directory to be listed in the background. A hint that is already queued
+             moves to the front; the oldest hint is dropped when the queue is full.
+Parameters:
+  - dir: Directory the user is likely to open soon.
+Returns:
+  - None
+*/
+void DirectoryPreloader::Request(const fs::path& dir)
+{
+    if (dir.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) return;
+
+        auto it = std::find(m_queue.begin(), m_queue.end(), dir);
+        if (it != m_queue.end()) m_queue.erase(it);
+
+        m_queue.push_front(dir);
+        if (m_queue.size() > kMaxQueuedHints) m_queue.pop_back();
+    }
+    m_cv.notify_one();
+}
+
+/*
+Function: DirectoryPreloader::Run
+Description: Worker loop. Lowers its own priority, then lists queued directories through the
+             cached listing path until asked to stop. Directories whose cached listing is still
+             current are only stat'ed, not re-enumerated.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void DirectoryPreloader::Run()
+{
+    SetCurrentThreadIdlePriority();
+
+    for (;;)
+    {
+        fs::path dir;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+
+            dir = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        if (!m_fs.IsDirectory(dir)) continue;
+
+        std::string err;
+        m_fs.ListDirectoryCached(dir, true, err);
+    }
+}
@@ -0,0 +1,42 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the DirectoryPreloader class which speculatively lists directories the user is likely to open next (the parent, recently visited folders and the folder under the mouse) on an idle-priority background thread, so that the shared listing cache is already warm when the user navigates.
+February 1, 2026
+*/
+
+#ifndef DIRECTORYPRELOADER_H
+#define DIRECTORYPRELOADER_H
+
+#include "FileSystemService.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Background thread that fills the listing cache ahead of navigation
+class DirectoryPreloader final
+{
+public:
+    explicit DirectoryPreloader(const FileSystemService& fs);
+    ~DirectoryPreloader();
+
+    DirectoryPreloader(const DirectoryPreloader&) = delete;
+    DirectoryPreloader& operator=(const DirectoryPreloader&) = delete;
+
+    void Request(const fs::path& dir);
+
+private:
+    void Run();
+
+    const FileSystemService& m_fs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<fs::path> m_queue;
+    bool m_stop = false;
+
+    std::thread m_thread;
+};
+
+#endif // DIRECTORYPRELOADER_H
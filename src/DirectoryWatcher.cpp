@@ -0,0 +1,837 @@
+/*
+Parneet Baidwan - 251259638
+Description: The DirectoryWatcher class implementation in this file reads Linux change notifications for a directory tree on a background thread. With the rights to do so it puts one fanotify mark on the whole filesystem, which needs no per-directory watch and reports the parent directory and name of every change; otherwise it adds an inotify watch per directory, shallowest first, and stops adding them when the watch limit is reached so that a huge tree leaves only its deepest directories unwatched. Each event is counted into a ring of one-second buckets of its directory; the watcher thread is the only writer, and readers check a bucket's second before and after reading it instead of taking a lock.
+February 1, 2026
+*/
+
+#include "DirectoryWatcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/fanotify.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#endif
+
+namespace
+{
+    // Seconds of history per directory; bounds the rate window
+    constexpr std::size_t kRateSlots = 16;
+    // Event log lines kept until the window drains them
+    constexpr std::size_t kMaxLogEntries = 2000;
+    // Files whose last size is remembered to measure growth
+    constexpr std::size_t kMaxTrackedSizes = 200000;
+    // Directory handles resolved to paths (fanotify)
+    constexpr std::size_t kMaxHandles = 200000;
+    // How often the watcher thread checks for Stop while no events arrive
+    constexpr int kPollMs = 250;
+
+    constexpr std::size_t KindIndex(WatchEventKind kind) { return (std::size_t)kind; }
+
+    // Adds to a counter only the watcher thread writes
+    template <class T>
+    void Bump(std::atomic<T>& counter, T by)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+}
+
+// Counts of one directory during one second
+struct WatchRateSlot
+{
+    std::atomic<std::int64_t> second{ -1 };    // -1 while the slot is being reset
+    std::array<std::atomic<std::uint32_t>, 3> counts{};
+    std::atomic<std::uint64_t> bytes{ 0 };
+};
+
+// Statistics of one directory that has had events
+struct WatchDirStats
+{
+    std::string dir;                            // set before the entry is published
+    std::array<WatchRateSlot, kRateSlots> ring;
+    std::array<std::atomic<std::uint64_t>, 3> totals{};
+};
+
+/*
+Function: DirectoryWatcher::DirectoryWatcher
+Description: Creates an idle watcher.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+DirectoryWatcher::DirectoryWatcher() = default;
+
+/*
+Function: DirectoryWatcher::~DirectoryWatcher
+Description: Stops the watch and frees the statistics.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+DirectoryWatcher::~DirectoryWatcher()
+{
+    Stop();
+    ResetStats();
+}
+
+/*
+Function: DirectoryWatcher::Stop
+Description: Asks the watcher thread to stop and waits for it. The statistics stay readable.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void DirectoryWatcher::Stop()
+{
+    m_stop = true;
+    if (m_thread.joinable()) m_thread.join();
+    m_running = false;
+}
+
+/*
+Function: DirectoryWatcher::ResetStats
+Description: Frees the statistics of the previous watch. Only called while no watcher thread
+             runs and from the thread that reads the statistics.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void DirectoryWatcher::ResetStats()
+{
+    for (auto& chunk : m_statsChunks)
+    {
+        delete[] chunk.load(std::memory_order_relaxed);
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    m_statsCount = 0;
+    m_statsByDir.clear();
+
+    m_fanotify = false;
+    m_watchedDirs = 0;
+    m_unwatchedDirs = 0;
+    m_watchLimit = 0;
+    m_events = 0;
+    m_overflows = 0;
+
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log.clear();
+    m_error.clear();
+}
+
+/*
+Function: DirectoryWatcher::Second
+Description: Seconds since the watch started; the clock of the rate buckets.
+Parameters:
+  - None
+Returns:
+  - std::int64_t: Whole seconds elapsed.
+*/
+std::int64_t DirectoryWatcher::Second() const
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - m_started).count();
+}
+
+/*
+Function: DirectoryWatcher::StatsFor
+Description: Returns the statistics of a directory, publishing a new entry on its first event.
+             Watcher thread only.
+Parameters:
+  - dir: Directory path.
+Returns:
+  - WatchDirStats*: Statistics of dir, or nullptr once the table is full.
+*/
+WatchDirStats* DirectoryWatcher::StatsFor(const std::string& dir)
+{
+    auto it = m_statsByDir.find(dir);
+    if (it != m_statsByDir.end()) return it->second;
+
+    const std::size_t n = m_statsCount.load(std::memory_order_relaxed);
+    if (n >= kStatsChunk * kMaxStatsChunks) return nullptr;
+
+    WatchDirStats* chunk = m_statsChunks[n / kStatsChunk].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+        chunk = new WatchDirStats[kStatsChunk];
+        m_statsChunks[n / kStatsChunk].store(chunk, std::memory_order_relaxed);
+    }
+
+    WatchDirStats* stats = &chunk[n % kStatsChunk];
+    stats->dir = dir;
+    m_statsCount.store(n + 1, std::memory_order_release);
+    m_statsByDir.emplace(dir, stats);
+    return stats;
+}
+
+/*
+Function: DirectoryWatcher::Record
+Description: Counts one event into its directory's bucket for the current second, resetting
+             the bucket if it still holds an older second, and appends it to the event log.
+             Watcher thread only.
+Parameters:
+  - stats: Statistics of the directory the event happened in.
+  - kind: Kind of event.
+  - path: Full path of the entry.
+  - bytes: Bytes the entry grew by, if known.
+Returns:
+  - None
+*/
+void DirectoryWatcher::Record(WatchDirStats* stats, WatchEventKind kind, const std::string& path, std::uint64_t bytes)
+{
+    Bump<std::uint64_t>(m_events, 1);
+
+    const std::int64_t now = Second();
+    WatchRateSlot& slot = stats->ring[(std::size_t)now % kRateSlots];
+    if (slot.second.load(std::memory_order_relaxed) != now)
+    {
+        // readers skip the slot until its new second is stored
+        slot.second.store(-1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (auto& count : slot.counts) count.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+        slot.second.store(now, std::memory_order_release);
+    }
+    Bump<std::uint32_t>(slot.counts[KindIndex(kind)], 1);
+    Bump<std::uint64_t>(slot.bytes, bytes);
+    Bump<std::uint64_t>(stats->totals[KindIndex(kind)], 1);
+
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log.push_back(WatchLogEntry{ std::time(nullptr), kind, fs::u8path(path), bytes });
+    if (m_log.size() > kMaxLogEntries) m_log.pop_front();
+}
+
+/*
+Function: DirectoryWatcher::Rates
+Description: Computes the change rate of every directory that has had events, averaged over
+             the last complete seconds. A bucket that the watcher thread resets while it is
+             being read is left out rather than waited for.
+Parameters:
+  - windowSeconds: Seconds to average over (1 to 15).
+  - outRates: Output rates, one per directory, in the order directories first changed.
+Returns:
+  - None
+*/
+void DirectoryWatcher::Rates(unsigned windowSeconds, std::vector<WatchDirRate>& outRates) const
+{
+    outRates.clear();
+    const std::int64_t window = std::clamp<std::int64_t>(windowSeconds, 1, (std::int64_t)kRateSlots - 1);
+    const std::int64_t now = Second();
+
+    const std::size_t n = m_statsCount.load(std::memory_order_acquire);
+    outRates.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const WatchDirStats& stats = m_statsChunks[i / kStatsChunk].load(std::memory_order_relaxed)[i % kStatsChunk];
+
+        std::uint64_t events = 0;
+        std::uint64_t bytes = 0;
+        for (const WatchRateSlot& slot : stats.ring)
+        {
+            // the second in progress is not complete yet
+            const std::int64_t second = slot.second.load(std::memory_order_acquire);
+            if (second < now - window || second >= now) continue;
+
+            std::uint64_t slotEvents = 0;
+            for (const auto& count : slot.counts) slotEvents += count.load(std::memory_order_relaxed);
+            const std::uint64_t slotBytes = slot.bytes.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.second.load(std::memory_order_relaxed) != second) continue;
+            events += slotEvents;
+            bytes += slotBytes;
+        }
+
+        WatchDirRate rate;
+        rate.dir = fs::u8path(stats.dir);
+        rate.eventsPerSec = (double)events / (double)window;
+        rate.bytesPerSec = (double)bytes / (double)window;
+        rate.created = stats.totals[KindIndex(WatchEventKind::Created)].load(std::memory_order_relaxed);
+        rate.modified = stats.totals[KindIndex(WatchEventKind::Modified)].load(std::memory_order_relaxed);
+        rate.deleted = stats.totals[KindIndex(WatchEventKind::Deleted)].load(std::memory_order_relaxed);
+        outRates.push_back(std::move(rate));
+    }
+}
+
+/*
+Function: DirectoryWatcher::DrainLog
+Description: Moves the events logged since the last call to the caller, oldest first.
+Parameters:
+  - outEntries: Output log entries.
+Returns:
+  - None
+*/
+void DirectoryWatcher::DrainLog(std::vector<WatchLogEntry>& outEntries)
+{
+    outEntries.clear();
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    outEntries.assign(std::make_move_iterator(m_log.begin()), std::make_move_iterator(m_log.end()));
+    m_log.clear();
+}
+
+/*
+Function: DirectoryWatcher::Status
+Description: Returns the mode, watch counts and totals of the watch.
+Parameters:
+  - None
+Returns:
+  - WatchStatus: Current state.
+*/
+WatchStatus DirectoryWatcher::Status() const
+{
+    WatchStatus status;
+    status.running = m_running;
+    status.fanotify = m_fanotify;
+    status.watchedDirs = m_watchedDirs;
+    status.unwatchedDirs = m_unwatchedDirs;
+    status.watchLimit = m_watchLimit;
+    status.events = m_events;
+    status.overflows = m_overflows;
+
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    status.error = m_error;
+    return status;
+}
+
+#if defined(__linux__)
+
+// Kernel notification reader of one watch; runs on the watcher thread
+class DirectoryWatcher::NotifyReader final
+{
+public:
+    explicit NotifyReader(DirectoryWatcher& owner) : m_owner(owner) {}
+    ~NotifyReader();
+
+    void Run(const std::string& root);
+
+private:
+    // A directory events are reported for
+    struct WatchedDir
+    {
+        std::string path;                   // empty: outside the watched tree (fanotify)
+        WatchDirStats* stats = nullptr;     // looked up on the first event
+    };
+
+    bool StartFanotify();
+    WatchedDir* ResolveHandle(const char* handle, std::size_t size);
+    void ReadFanotify();
+
+    bool StartInotify(std::string& outErr);
+    void WatchTree(const std::string& top);
+    void ReadInotify();
+
+    void Count(WatchedDir& dir, WatchEventKind kind, const char* name, bool isDir);
+    std::uint64_t Growth(const std::string& path, WatchEventKind kind);
+    bool IsUnderRoot(const std::string& path) const;
+    void Fail(const std::string& err);
+
+    DirectoryWatcher& m_owner;
+    std::string m_root;
+    int m_fd = -1;
+    bool m_fanotify = false;
+
+    int m_rootFd = -1;                                          // fanotify: resolves handles
+    std::unordered_map<std::string, WatchedDir> m_handles;      // fanotify: directory handle
+    std::unordered_map<int, WatchedDir> m_dirs;                 // inotify: watch descriptor
+    std::uint64_t m_budget = 0;                                 // inotify: watches to use, 0 = no known limit
+    std::unordered_map<std::string, std::uint64_t> m_sizes;     // last size of written files
+};
+
+namespace
+{
+    constexpr std::uint32_t kInotifyMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO |
+                                           IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    /*
+    Function: JoinPath
+    Description: Appends an entry name to a directory path.
+    Parameters:
+      - dir: Directory path.
+      - name: Entry name.
+    Returns:
+      - std::string: dir/name.
+    */
+    std::string JoinPath(const std::string& dir, const char* name)
+    {
+        std::string path = dir;
+        if (path.empty() || path.back() != '/') path += '/';
+        path += name;
+        return path;
+    }
+
+    /*
+    Function: ReadProcNumber
+    Description: Reads a number from a /proc file such as a kernel limit.
+    Parameters:
+      - file: Path of the /proc file.
+    Returns:
+      - std::uint64_t: The number, or 0 if it could not be read.
+    */
+    std::uint64_t ReadProcNumber(const char* file)
+    {
+        std::ifstream in(file);
+        std::uint64_t value = 0;
+        return (in >> value) ? value : 0;
+    }
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::~NotifyReader
+Description: Closes the notification descriptors; the kernel drops the watches with them.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+DirectoryWatcher::NotifyReader::~NotifyReader()
+{
+    if (m_fd >= 0) ::close(m_fd);
+    if (m_rootFd >= 0) ::close(m_rootFd);
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::Fail
+Description: Records why the watch stopped, for the status line.
+Parameters:
+  - err: Error message.
+Returns:
+  - None
+*/
+void DirectoryWatcher::NotifyReader::Fail(const std::string& err)
+{
+    std::lock_guard<std::mutex> lock(m_owner.m_logMutex);
+    m_owner.m_error = err;
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::Run
+Description: Sets up fanotify, or inotify if fanotify is not available to this process, then
+             reads events until the watcher is stopped.
+Parameters:
+  - root: Canonical path of the directory to watch.
+Returns:
+  - None
+*/
+void DirectoryWatcher::NotifyReader::Run(const std::string& root)
+{
+    m_root = root;
+
+    std::string err;
+    m_fanotify = StartFanotify();
+    if (!m_fanotify && !StartInotify(err))
+    {
+        Fail(err);
+        return;
+    }
+
+    while (!m_owner.m_stop)
+    {
+        pollfd pfd{ m_fd, POLLIN, 0 };
+        const int ready = ::poll(&pfd, 1, kPollMs);
+        if (ready < 0)
+        {
+            if (errno == EINTR) continue;
+            Fail(std::string("Waiting for events failed: ") + std::strerror(errno));
+            return;
+        }
+        if (ready == 0) continue;
+
+        if (m_fanotify) ReadFanotify();
+        else ReadInotify();
+    }
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::IsUnderRoot
+Description: Whether a path is the watched root or below it.
+Parameters:
+  - path: Canonical path.
+Returns:
+  - bool: true if inside the watched tree; false otherwise.
+*/
+bool DirectoryWatcher::NotifyReader::IsUnderRoot(const std::string& path) const
+{
+    if (path.compare(0, m_root.size(), m_root) != 0) return false;
+    return path.size() == m_root.size() || m_root.back() == '/' || path[m_root.size()] == '/';
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::StartFanotify
+Description: Marks the filesystem holding the root for entry creation, modification and
+             deletion, reported with the handle of the parent directory and the entry name.
+             Needs CAP_SYS_ADMIN for the mark and CAP_DAC_READ_SEARCH to turn directory handles
+             back into paths, and Linux 5.9 or later; any failure leaves inotify to be used.
+Parameters:
+  - None
+Returns:
+  - bool: true if fanotify is set up; false otherwise.
+*/
+bool DirectoryWatcher::NotifyReader::StartFanotify()
+{
+#ifdef FAN_REPORT_DFID_NAME
+    const int fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK | FAN_REPORT_DFID_NAME, O_RDONLY | O_LARGEFILE);
+    if (fd < 0) return false;
+
+    const std::uint64_t mask = FAN_CREATE | FAN_DELETE | FAN_MODIFY | FAN_MOVED_FROM | FAN_MOVED_TO | FAN_ONDIR;
+    if (fanotify_mark(fd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, mask, AT_FDCWD, m_root.c_str()) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // make sure handles can be resolved before relying on them
+    m_rootFd = ::open(m_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    alignas(file_handle) char handle[sizeof(file_handle) + MAX_HANDLE_SZ];
+    auto* fh = reinterpret_cast<file_handle*>(handle);
+    fh->handle_bytes = MAX_HANDLE_SZ;
+    int mountId = 0;
+    if (m_rootFd < 0 || name_to_handle_at(m_rootFd, "", fh, &mountId, AT_EMPTY_PATH) != 0 ||
+        !ResolveHandle(handle, sizeof(file_handle) + fh->handle_bytes))
+    {
+        ::close(fd);
+        if (m_rootFd >= 0) ::close(m_rootFd);
+        m_rootFd = -1;
+        m_handles.clear();
+        return false;
+    }
+
+    m_fd = fd;
+    m_owner.m_fanotify = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::ResolveHandle
+Description: Turns a directory handle from a fanotify event into the directory's path, caching
+             the answer. Directories outside the watched tree are cached as such.
+Parameters:
+  - handle: struct file_handle followed by its bytes.
+  - size: Size of the handle including its header.
+Returns:
+  - WatchedDir*: Directory, or nullptr if it is outside the tree or no longer exists.
+*/
+DirectoryWatcher::NotifyReader::WatchedDir* DirectoryWatcher::NotifyReader::ResolveHandle(const char* handle, std::size_t size)
+{
+    std::string key(handle, size);
+    auto it = m_handles.find(key);
+    if (it != m_handles.end()) return it->second.path.empty() ? nullptr : &it->second;
+
+    if (m_handles.size() >= kMaxHandles) m_handles.clear();
+
+    std::string path;
+    const int fd = open_by_handle_at(m_rootFd, reinterpret_cast<file_handle*>(&key[0]), O_PATH | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        char link[PATH_MAX];
+        const ssize_t len = ::readlink(("/proc/self/fd/" + std::to_string(fd)).c_str(), link, sizeof(link));
+        ::close(fd);
+        if (len > 0) path.assign(link, (std::size_t)len);
+    }
+    if (!IsUnderRoot(path)) path.clear();
+
+    WatchedDir& dir = m_handles[std::move(key)];
+    dir.path = std::move(path);
+    dir.stats = nullptr;
+    return dir.path.empty() ? nullptr : &dir;
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::ReadFanotify
+Description: Reads and counts all queued fanotify events. Events below other directories of
+             the filesystem are dropped once their directory handle is resolved.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void DirectoryWatcher::NotifyReader::ReadFanotify()
+{
+#ifdef FAN_REPORT_DFID_NAME
+    alignas(fanotify_event_metadata) char buf[64 * 1024];
+    for (;;)
+    {
+        ssize_t len = ::read(m_fd, buf, sizeof(buf));
+        if (len <= 0) return;
+
+        for (auto* md = reinterpret_cast<const fanotify_event_metadata*>(buf); FAN_EVENT_OK(md, len); md = FAN_EVENT_NEXT(md, len))
+        {
+            if (md->mask & FAN_Q_OVERFLOW)
+            {
+                Bump<std::uint64_t>(m_owner.m_overflows, 1);
+                continue;
+            }
+
+            const auto* info = reinterpret_cast<const fanotify_event_info_fid*>(md + 1);
+            if (md->event_len < sizeof(*md) + sizeof(*info) || info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME) continue;
+
+            const auto* fh = reinterpret_cast<const file_handle*>(info->handle);
+            const char* name = reinterpret_cast<const char*>(fh->f_handle) + fh->handle_bytes;
+            WatchedDir* dir = ResolveHandle(reinterpret_cast<const char*>(fh), sizeof(file_handle) + fh->handle_bytes);
+            if (!dir) continue;
+
+            const bool isDir = (md->mask & FAN_ONDIR) != 0;
+            if (md->mask & (FAN_CREATE | FAN_MOVED_TO)) Count(*dir, WatchEventKind::Created, name, isDir);
+            if (md->mask & FAN_MODIFY) Count(*dir, WatchEventKind::Modified, name, isDir);
+            if (md->mask & (FAN_DELETE | FAN_MOVED_FROM)) Count(*dir, WatchEventKind::Deleted, name, isDir);
+
+            // paths cached below a moved or deleted directory are no longer right
+            if (isDir && (md->mask & (FAN_MOVED_FROM | FAN_DELETE))) m_handles.clear();
+        }
+    }
+#endif
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::StartInotify
+Description: Creates the inotify instance and watches the tree. The watch budget is the
+             user's inotify watch limit less a tenth left to other programs (editors, build
+             tools, indexers that watch files too).
+Parameters:
+  - outErr: Error message if the root cannot be watched.
+Returns:
+  - bool: true if at least the root is watched; false otherwise.
+*/
+bool DirectoryWatcher::NotifyReader::StartInotify(std::string& outErr)
+{
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+        outErr = std::string("inotify is not available: ") + std::strerror(errno);
+        return false;
+    }
+
+    const std::uint64_t limit = ReadProcNumber("/proc/sys/fs/inotify/max_user_watches");
+    m_budget = limit - limit / 10;
+    m_owner.m_watchLimit = m_budget;
+
+    WatchTree(m_root);
+    if (m_dirs.empty())
+    {
+        outErr = "Could not watch " + m_root + ": " + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::WatchTree
+Description: Watches a directory and everything below it, breadth first, so that if the watch
+             budget runs out it is the deepest directories that stay unwatched. Those are
+             counted (the directories waiting in the queue at that point, a lower bound since
+             their subtrees are not read). Watching a directory that is already watched under
+             another path, after it was moved, updates its path.
+Parameters:
+  - top: Directory to watch.
+Returns:
+  - None
+*/
+void DirectoryWatcher::NotifyReader::WatchTree(const std::string& top)
+{
+    std::deque<std::string> queue{ top };
+    while (!queue.empty() && !m_owner.m_stop)
+    {
+        std::string dir = std::move(queue.front());
+        queue.pop_front();
+
+        const bool full = m_budget != 0 && m_dirs.size() >= m_budget;
+        const int wd = full ? -1 : inotify_add_watch(m_fd, dir.c_str(), kInotifyMask);
+        if (wd < 0)
+        {
+            if (!full && errno != ENOSPC && errno != ENOMEM) continue;     // vanished or unreadable
+
+            // out of watches: the kernel limit may be lower than the budget read at start
+            if (!full) m_owner.m_watchLimit = m_dirs.size();
+            Bump<std::uint64_t>(m_owner.m_unwatchedDirs, 1 + queue.size());
+            return;
+        }
+        // a directory moved within the tree keeps its wd; its counts move to the new path
+        WatchedDir& watched = m_dirs[wd];
+        if (watched.path != dir)
+        {
+            watched.path = dir;
+            watched.stats = nullptr;
+        }
+        m_owner.m_watchedDirs = m_dirs.size();
+
+        DIR* d = ::opendir(dir.c_str());
+        if (!d) continue;
+        while (const dirent* e = ::readdir(d))
+        {
+            if (std::strcmp(e->d_name, ".") == 0 || std::strcmp(e->d_name, "..") == 0) continue;
+
+            bool isDir = e->d_type == DT_DIR;
+            if (e->d_type == DT_UNKNOWN)
+            {
+                struct stat st;
+                isDir = ::fstatat(::dirfd(d), e->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+            }
+            if (isDir) queue.push_back(JoinPath(dir, e->d_name));
+        }
+        ::closedir(d);
+    }
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::ReadInotify
+Description: Reads and counts all queued inotify events, watching directories created or
+             moved into the tree and forgetting watches the kernel has dropped.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void DirectoryWatcher::NotifyReader::ReadInotify()
+{
+    alignas(inotify_event) char buf[64 * 1024];
+    for (;;)
+    {
+        const ssize_t len = ::read(m_fd, buf, sizeof(buf));
+        if (len <= 0) return;
+
+        for (const char* p = buf; p < buf + len;)
+        {
+            const auto* ev = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW)
+            {
+                Bump<std::uint64_t>(m_owner.m_overflows, 1);
+                continue;
+            }
+            if (ev->mask & IN_IGNORED)
+            {
+                m_dirs.erase(ev->wd);
+                m_owner.m_watchedDirs = m_dirs.size();
+                continue;
+            }
+
+            auto it = m_dirs.find(ev->wd);
+            if (it == m_dirs.end() || ev->len == 0) continue;
+            WatchedDir& dir = it->second;   // stays valid while WatchTree adds watches
+
+            const bool isDir = (ev->mask & IN_ISDIR) != 0;
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+                Count(dir, WatchEventKind::Created, ev->name, isDir);
+                if (isDir) WatchTree(JoinPath(dir.path, ev->name));
+            }
+            if (ev->mask & IN_MODIFY) Count(dir, WatchEventKind::Modified, ev->name, isDir);
+            if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) Count(dir, WatchEventKind::Deleted, ev->name, isDir);
+        }
+    }
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::Count
+Description: Counts an event of an entry of a watched directory.
+Parameters:
+  - dir: Directory the event was reported for.
+  - kind: Kind of event.
+  - name: Entry name.
+  - isDir: Whether the entry is a directory.
+Returns:
+  - None
+*/
+void DirectoryWatcher::NotifyReader::Count(WatchedDir& dir, WatchEventKind kind, const char* name, bool isDir)
+{
+    if (!dir.stats) dir.stats = m_owner.StatsFor(dir.path);
+    if (!dir.stats) return;
+
+    const std::string path = JoinPath(dir.path, name);
+    m_owner.Record(dir.stats, kind, path, isDir ? 0 : Growth(path, kind));
+}
+
+/*
+Function: DirectoryWatcher::NotifyReader::Growth
+Description: Measures how many bytes a file grew by since its last event, from its size now
+             and the size remembered then. A file seen for the first time counts its whole
+             size if it was just created or moved in and nothing otherwise; a file that shrank
+             counts nothing.
+Parameters:
+  - path: Full path of the file.
+  - kind: Kind of event.
+Returns:
+  - std::uint64_t: Bytes added.
+*/
+std::uint64_t DirectoryWatcher::NotifyReader::Growth(const std::string& path, WatchEventKind kind)
+{
+    if (kind == WatchEventKind::Deleted)
+    {
+        m_sizes.erase(path);
+        return 0;
+    }
+
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return 0;
+    const std::uint64_t size = (std::uint64_t)st.st_size;
+
+    auto it = m_sizes.find(path);
+    if (it == m_sizes.end())
+    {
+        if (m_sizes.size() >= kMaxTrackedSizes) m_sizes.clear();
+        m_sizes.emplace(path, size);
+        return kind == WatchEventKind::Created ? size : 0;
+    }
+
+    const std::uint64_t grown = size > it->second ? size - it->second : 0;
+    it->second = size;
+    return grown;
+}
+
+#endif // __linux__
+
+/*
+Function: DirectoryWatcher::Start
+Description: Starts watching every directory below root on a background thread, discarding
+             the statistics of the previous watch.
+Parameters:
+  - root: Directory to watch.
+  - outErr: Error message on failure.
+Returns:
+  - bool: true if the watch started; false otherwise.
+*/
+bool DirectoryWatcher::Start(const fs::path& root, std::string& outErr)
+{
+    outErr.clear();
+    Stop();
+
+#if defined(__linux__)
+    std::error_code ec;
+    const fs::path canonical = fs::canonical(root, ec);
+    if (ec || !fs::is_directory(canonical, ec))
+    {
+        outErr = "Not a directory: " + root.string();
+        return false;
+    }
+
+    ResetStats();
+    m_started = std::chrono::steady_clock::now();
+    m_stop = false;
+    m_running = true;
+    m_thread = std::thread([this, dir = canonical.string()]()
+    {
+        NotifyReader reader(*this);
+        reader.Run(dir);
+        m_running = false;
+    });
+    return true;
+#else
+    (void)root;
+    outErr = "Watching directories is only supported on Linux.";
+    return false;
+#endif
+}
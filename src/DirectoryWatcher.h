@@ -0,0 +1,122 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the DirectoryWatcher class and its data structures, which watch every directory below a root for entries being created, modified and deleted and keep per-directory change rates. A background thread reads the kernel's change notifications (fanotify when the process is allowed to mark the whole filesystem, inotify otherwise) and counts each event into a ring of one-second buckets of its directory; the window reading the rates never locks against that thread.
+February 1, 2026
+*/
+
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// What happened to an entry
+enum class WatchEventKind : std::uint8_t
+{
+    Created,    // created or moved in
+    Modified,   // written to
+    Deleted     // deleted or moved out
+};
+
+// One line of the event log
+struct WatchLogEntry
+{
+    std::time_t time = 0;
+    WatchEventKind kind = WatchEventKind::Modified;
+    fs::path path;
+    std::uint64_t bytes = 0;        // growth of a modified file, if known
+};
+
+// Change rate of one directory over the rate window
+struct WatchDirRate
+{
+    fs::path dir;
+    double eventsPerSec = 0;
+    double bytesPerSec = 0;
+    std::uint64_t created = 0;      // totals since the watch started
+    std::uint64_t modified = 0;
+    std::uint64_t deleted = 0;
+};
+
+// State of a running watch
+struct WatchStatus
+{
+    bool running = false;
+    bool fanotify = false;              // whole filesystem marked; no per-directory watches
+    std::uint64_t watchedDirs = 0;      // inotify watches held
+    std::uint64_t unwatchedDirs = 0;    // directories found but left unwatched (at least)
+    std::uint64_t watchLimit = 0;       // watches this process allows itself, 0 if unknown
+    std::uint64_t events = 0;
+    std::uint64_t overflows = 0;        // times the kernel queue overflowed and events were lost
+    std::string error;                  // why the watch stopped, if it failed
+};
+
+struct WatchDirStats;
+
+// Background watcher of a directory tree
+class DirectoryWatcher final
+{
+public:
+    DirectoryWatcher();
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    bool Start(const fs::path& root, std::string& outErr);
+    void Stop();
+    bool Running() const { return m_running; }
+
+    // Readers; called from one thread (the UI) while the watcher thread writes
+    void Rates(unsigned windowSeconds, std::vector<WatchDirRate>& outRates) const;
+    void DrainLog(std::vector<WatchLogEntry>& outEntries);
+    WatchStatus Status() const;
+
+private:
+    // Directories with statistics are kept in chunks that never move once published
+    static constexpr std::size_t kStatsChunk = 1024;
+    static constexpr std::size_t kMaxStatsChunks = 1024;
+
+    class NotifyReader;
+
+    WatchDirStats* StatsFor(const std::string& dir);
+    void Record(WatchDirStats* stats, WatchEventKind kind, const std::string& path, std::uint64_t bytes);
+    std::int64_t Second() const;
+    void ResetStats();
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop{ false };
+    std::atomic<bool> m_running{ false };
+    std::chrono::steady_clock::time_point m_started;
+
+    // written by the watcher thread only; published through m_statsCount
+    std::array<std::atomic<WatchDirStats*>, kMaxStatsChunks> m_statsChunks{};
+    std::atomic<std::size_t> m_statsCount{ 0 };
+    std::unordered_map<std::string, WatchDirStats*> m_statsByDir;     // watcher thread only
+
+    std::atomic<bool> m_fanotify{ false };
+    std::atomic<std::uint64_t> m_watchedDirs{ 0 };
+    std::atomic<std::uint64_t> m_unwatchedDirs{ 0 };
+    std::atomic<std::uint64_t> m_watchLimit{ 0 };
+    std::atomic<std::uint64_t> m_events{ 0 };
+    std::atomic<std::uint64_t> m_overflows{ 0 };
+
+    mutable std::mutex m_logMutex;
+    std::deque<WatchLogEntry> m_log;
+    std::string m_error;                // guarded by m_logMutex
+};
+
+#endif // DIRECTORYWATCHER_H
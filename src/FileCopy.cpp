@@ -0,0 +1,802 @@
+/*
+Parneet Baidwan - 251259638
+Description: The file copy implementation in this file copies one regular file in bounded chunks so that the IoScheduler can pace it. Sparse files are copied one data extent at a time, found with SEEK_DATA/SEEK_HOLE, so their holes stay holes at the destination. On Linux the chunks are moved in the kernel with copy_file_range, falling back to read/write when the filesystems do not support it; other systems use a plain read/write loop. Large files that cannot be copied in the kernel bypass the page cache instead (O_DIRECT on Linux, F_NOCACHE on macOS): a reader thread and the writing thread take turns on three page-aligned buffers from a pool shared by the copies running at the time, so reading the next chunk overlaps writing the previous one, and copying a huge file does not evict everything else from memory.
+February 1, 2026
+*/
+
+#include "FileCopy.h"
+#include "Checksum.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FM_HAVE_POSIX_IO 1
+#endif
+
+namespace
+{
+    // Small enough for bandwidth pacing to be smooth, large enough to keep syscalls cheap
+    constexpr std::size_t kChunk = 8u << 20;
+    constexpr std::size_t kBufferChunk = 1u << 20;
+
+#ifdef FM_HAVE_POSIX_IO
+    // Closes a file descriptor on scope exit
+    struct FdGuard
+    {
+        int fd = -1;
+        ~FdGuard() { if (fd >= 0) ::close(fd); }
+    };
+
+    std::string ErrnoMessage(const char* what, const fs::path& p)
+    {
+        return std::string(what) + " " + p.string() + ": " + std::generic_category().message(errno);
+    }
+#endif
+
+    void Account(IoScheduler& scheduler, DeviceId a, DeviceId b, std::uint64_t bytes)
+    {
+        scheduler.Transfer(a, bytes);
+        if (b != a) scheduler.Transfer(b, bytes);
+    }
+
+#if defined(FM_HAVE_POSIX_IO) && defined(SEEK_DATA) && defined(SEEK_HOLE)
+    // Files with at least this much unallocated space are copied extent by extent
+    constexpr std::uint64_t kSparseMinHole = 64u << 10;
+
+    /*
+    Function: IsSparse
+    Description: Tells whether a file has fewer blocks allocated than its length needs, i.e.
+                 holes worth preserving. Small files whose data lives in the inode are not
+                 counted as sparse.
+    Parameters:
+      - st: Result of fstat on the file.
+    Returns:
+      - bool: true if the file should be copied extent by extent.
+    */
+    bool IsSparse(const struct stat& st)
+    {
+        return (std::uint64_t)st.st_blocks * 512 + kSparseMinHole <= (std::uint64_t)st.st_size;
+    }
+
+    /*
+    Function: CopyExtent
+    Description: Copies one data extent to the same offset of the destination: in the kernel
+                 with copy_file_range on Linux while that works (and no hash is needed),
+                 otherwise through a user-space buffer.
+    Parameters:
+      - in, out: Open source and destination descriptors.
+      - offset, length: Extent of the source to copy.
+      - src, dst: Paths, for error messages.
+      - scheduler, srcDev, dstDev: Scheduler and devices charged for each chunk.
+      - kernelCopy: Whether to try copy_file_range; cleared when it is not supported.
+      - buf: User-space buffer, allocated on first use.
+      - hasher: If not null, receives the extent's bytes.
+      - outBytes: Incremented by the bytes copied.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the extent was copied; false otherwise.
+    */
+    bool CopyExtent(int in, int out, std::uint64_t offset, std::uint64_t length,
+                    const fs::path& src, const fs::path& dst,
+                    IoScheduler& scheduler, DeviceId srcDev, DeviceId dstDev,
+                    bool& kernelCopy, std::unique_ptr<char[]>& buf, Hash64* hasher,
+                    std::uintmax_t& outBytes, std::string& outErr)
+    {
+        const std::uint64_t end = offset + length;
+#if defined(__linux__)
+        while (kernelCopy && !hasher && offset < end)
+        {
+            loff_t inOff = (loff_t)offset;
+            loff_t outOff = (loff_t)offset;
+            const ssize_t n = ::copy_file_range(in, &inOff, out, &outOff, (std::size_t)std::min<std::uint64_t>(kChunk, end - offset), 0);
+            if (n > 0)
+            {
+                offset += (std::uint64_t)n;
+                outBytes += (std::uintmax_t)n;
+                Account(scheduler, srcDev, dstDev, (std::uint64_t)n);
+                continue;
+            }
+            if (n == 0) return true;    // the file shrank while being copied
+            if (errno == EINTR) continue;
+            if (errno != EXDEV && errno != ENOSYS && errno != EINVAL && errno != EOPNOTSUPP)
+            {
+                outErr = ErrnoMessage("Copy failed for", src);
+                return false;
+            }
+            kernelCopy = false;
+        }
+#else
+        kernelCopy = false;
+#endif
+
+        if (offset < end && !buf) buf.reset(new char[kBufferChunk]);
+        while (offset < end)
+        {
+            const ssize_t n = ::pread(in, buf.get(), (std::size_t)std::min<std::uint64_t>(kBufferChunk, end - offset), (off_t)offset);
+            if (n == 0) return true;
+            if (n < 0)
+            {
+                if (errno == EINTR) continue;
+                outErr = ErrnoMessage("Read failed for", src);
+                return false;
+            }
+
+            for (ssize_t done = 0; done < n;)
+            {
+                const ssize_t w = ::pwrite(out, buf.get() + done, (std::size_t)(n - done), (off_t)offset + done);
+                if (w < 0)
+                {
+                    if (errno == EINTR) continue;
+                    outErr = ErrnoMessage("Write failed for", dst);
+                    return false;
+                }
+                done += w;
+            }
+
+            if (hasher) hasher->Update(buf.get(), (std::size_t)n);
+            offset += (std::uint64_t)n;
+            outBytes += (std::uintmax_t)n;
+            Account(scheduler, srcDev, dstDev, (std::uint64_t)n);
+        }
+        return true;
+    }
+
+    /*
+    Function: CopySparse
+    Description: Copies a sparse file by walking its data extents with SEEK_DATA/SEEK_HOLE.
+                 Only the extents are read and written, each at its own offset, and the
+                 destination is finally given the source's length, so every hole, including
+                 a trailing one, stays unallocated. A source that shrinks during the copy
+                 gives the destination its new length instead. A hasher sees the holes as the
+                 zeros they read back as.
+    Parameters:
+      - in, out: Open source and (empty) destination descriptors.
+      - size: Length of the source.
+      - src, dst: Paths, for error messages.
+      - scheduler, srcDev, dstDev: Scheduler and devices charged for each chunk.
+      - hasher: If not null, receives every byte of the file in order.
+      - outBytes: Output number of data bytes copied (holes excluded).
+      - outHoleBytes: Output number of bytes of holes skipped.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the file was copied completely; false otherwise.
+    */
+    bool CopySparse(int in, int out, std::uint64_t size,
+                    const fs::path& src, const fs::path& dst,
+                    IoScheduler& scheduler, DeviceId srcDev, DeviceId dstDev,
+                    Hash64* hasher, std::uintmax_t& outBytes, std::uintmax_t& outHoleBytes, std::string& outErr)
+    {
+        bool kernelCopy = true;
+        std::unique_ptr<char[]> buf;
+        std::unique_ptr<char[]> zeros;
+
+        for (std::uint64_t pos = 0; pos < size;)
+        {
+            off_t data = ::lseek(in, (off_t)pos, SEEK_DATA);
+            if (data < 0 && errno != ENXIO)
+            {
+                outErr = ErrnoMessage("Cannot seek in", src);
+                return false;
+            }
+            if (data < 0)
+            {
+                // no data after pos: the rest is a trailing hole, unless the file shrank
+                const off_t end = ::lseek(in, 0, SEEK_END);
+                if (end >= 0 && (std::uint64_t)end < size) size = (std::uint64_t)end;
+                if (pos >= size) break;
+                data = (off_t)size;
+            }
+            const std::uint64_t dataStart = std::min<std::uint64_t>((std::uint64_t)data, size);
+
+            off_t hole = dataStart < size ? ::lseek(in, (off_t)dataStart, SEEK_HOLE) : (off_t)size;
+            if (hole < 0)
+            {
+                outErr = ErrnoMessage("Cannot seek in", src);
+                return false;
+            }
+            const std::uint64_t dataEnd = std::min<std::uint64_t>((std::uint64_t)hole, size);
+
+            if (dataStart > pos) outHoleBytes += dataStart - pos;
+            if (hasher && dataStart > pos)
+            {
+                if (!zeros) zeros.reset(new char[kBufferChunk]());
+                for (std::uint64_t left = dataStart - pos; left > 0;)
+                {
+                    const std::size_t n = (std::size_t)std::min<std::uint64_t>(kBufferChunk, left);
+                    hasher->Update(zeros.get(), n);
+                    left -= n;
+                }
+            }
+
+            if (!CopyExtent(in, out, dataStart, dataEnd - dataStart, src, dst, scheduler, srcDev, dstDev,
+                            kernelCopy, buf, hasher, outBytes, outErr))
+                return false;
+            pos = dataEnd;
+        }
+
+        if (::ftruncate(out, (off_t)size) != 0)
+        {
+            outErr = ErrnoMessage("Cannot set the length of", dst);
+            return false;
+        }
+        return true;
+    }
+#endif
+
+#ifdef FM_HAVE_POSIX_IO
+    // Files at least this large skip the page cache when the kernel cannot copy them itself
+    constexpr std::uint64_t kUncachedThreshold = 256ull << 20;
+    // Direct I/O needs buffers, offsets and lengths aligned to the logical block size
+    constexpr std::size_t kAlign = 4096;
+    constexpr std::size_t kDirectChunk = 8u << 20;
+    // Buffers in flight per copy
+    constexpr std::size_t kRingSlots = 3;
+
+    // Idle buffers are only kept while a pipelined copy is running, at most a ring's worth per
+    // running copy, so a copy starting while others run reuses theirs and nothing stays
+    // allocated once the last one is done
+    std::mutex g_poolMutex;
+    std::vector<char*> g_pool;
+    std::size_t g_poolUsers = 0;
+
+    // Returns a buffer to the pool (or frees it when the running copies have enough)
+    struct ReturnToPool
+    {
+        void operator()(char* p) const
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            if (g_pool.size() < g_poolUsers * kRingSlots)
+                g_pool.push_back(p);
+            else
+                std::free(p);
+        }
+    };
+    using AlignedBuffer = std::unique_ptr<char, ReturnToPool>;
+
+    // Counts a pipelined copy as a pool user; the last one out frees the idle buffers
+    struct PoolUser
+    {
+        PoolUser()
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            ++g_poolUsers;
+        }
+        ~PoolUser()
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            --g_poolUsers;
+            while (g_pool.size() > g_poolUsers * kRingSlots)
+            {
+                std::free(g_pool.back());
+                g_pool.pop_back();
+            }
+        }
+        PoolUser(const PoolUser&) = delete;
+        PoolUser& operator=(const PoolUser&) = delete;
+    };
+
+    /*
+    Function: TakeAlignedBuffer
+    Description: Hands out a kDirectChunk buffer aligned for direct I/O, reusing an idle one
+                 left by another running copy when possible.
+    Parameters:
+      - None
+    Returns:
+      - AlignedBuffer: The buffer, or empty if memory is exhausted.
+    */
+    AlignedBuffer TakeAlignedBuffer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            if (!g_pool.empty())
+            {
+                char* p = g_pool.back();
+                g_pool.pop_back();
+                return AlignedBuffer(p);
+            }
+        }
+        void* p = nullptr;
+        if (::posix_memalign(&p, kAlign, kDirectChunk) != 0) return AlignedBuffer();
+        return AlignedBuffer(static_cast<char*>(p));
+    }
+
+    /*
+    Function: BypassCache
+    Description: Asks the kernel to move data for fd without the page cache (O_DIRECT on
+                 Linux, F_NOCACHE on macOS). Set after open, so an unsupported filesystem
+                 only means the copy stays cached.
+    Parameters:
+      - fd: Open file descriptor.
+      - on: true to bypass the cache, false to go back to cached I/O.
+    Returns:
+      - bool: true if the descriptor now does uncached I/O.
+    */
+    bool BypassCache(int fd, bool on)
+    {
+#if defined(__linux__)
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags < 0) return false;
+        return ::fcntl(fd, F_SETFL, on ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) == 0 && on;
+#elif defined(__APPLE__)
+        return ::fcntl(fd, F_NOCACHE, on ? 1 : 0) == 0 && on;
+#else
+        (void)fd;
+        (void)on;
+        return false;
+#endif
+    }
+
+    // Drops cached pages of a file range that has already been read or written back
+    void DropCache(int fd, std::uint64_t offset, std::uint64_t length)
+    {
+#ifdef POSIX_FADV_DONTNEED
+        ::posix_fadvise(fd, (off_t)offset, (off_t)length, POSIX_FADV_DONTNEED);
+#else
+        (void)fd;
+        (void)offset;
+        (void)length;
+#endif
+    }
+
+    // One buffer of the read/write ring
+    struct RingSlot
+    {
+        AlignedBuffer buf;
+        std::size_t length = 0;
+        bool full = false;
+    };
+
+    /*
+    Function: CopyPipelined
+    Description: Copies a file through a ring of aligned buffers. A reader thread fills the
+                 buffers in order (and hashes each one when asked) while the calling thread
+                 writes them out, so one chunk is read and hashed while the previous ones are
+                 written. With uncached set, large files go around the page cache: a
+                 descriptor whose filesystem refuses direct I/O falls back to cached I/O for
+                 that side, with the source's pages dropped after reading (and the
+                 destination's after write-back on Linux); the unaligned tail of the file is
+                 written cached.
+    Parameters:
+      - in, out: Open source and (empty) destination descriptors.
+      - src, dst: Paths, for error messages.
+      - scheduler, srcDev, dstDev: Scheduler and devices charged for each chunk.
+      - uncached: true to keep the file out of the page cache.
+      - hasher: If not null, receives every byte of the file in order.
+      - outBytes: Output number of bytes copied.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the file was copied completely; false otherwise.
+    */
+    bool CopyPipelined(int in, int out,
+                       const fs::path& src, const fs::path& dst,
+                       IoScheduler& scheduler, DeviceId srcDev, DeviceId dstDev,
+                       bool uncached, Hash64* hasher,
+                       std::uintmax_t& outBytes, std::string& outErr)
+    {
+        // declared before the ring, so the ring's buffers are back in the pool when it leaves
+        PoolUser user;
+        RingSlot ring[kRingSlots];
+        for (RingSlot& slot : ring)
+        {
+            slot.buf = TakeAlignedBuffer();
+            if (!slot.buf)
+            {
+                outErr = "Out of memory copying " + src.string();
+                return false;
+            }
+        }
+
+        bool inDirect = uncached && BypassCache(in, true);
+        bool outDirect = uncached && BypassCache(out, true);
+#ifdef POSIX_FADV_SEQUENTIAL
+        if (!inDirect) ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool eof = false;
+        bool stop = false;
+        std::string readErr;
+
+        std::thread reader([&]
+        {
+            std::uint64_t offset = 0;
+            for (std::size_t next = 0;; next = (next + 1) % kRingSlots)
+            {
+                RingSlot& slot = ring[next];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return stop || !slot.full; });
+                    if (stop) return;
+                }
+
+                // fill the whole chunk so every read but the last stays aligned
+                std::size_t length = 0;
+                while (length < kDirectChunk)
+                {
+                    const ssize_t n = ::pread(in, slot.buf.get() + length, kDirectChunk - length, (off_t)(offset + length));
+                    if (n > 0)
+                    {
+                        length += (std::size_t)n;
+                        continue;
+                    }
+                    if (n == 0) break;
+                    if (errno == EINTR) continue;
+                    if (errno == EINVAL && inDirect)
+                    {
+                        inDirect = BypassCache(in, false);
+                        continue;
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    readErr = ErrnoMessage("Read failed for", src);
+                    eof = true;
+                    changed.notify_all();
+                    return;
+                }
+                if (uncached && !inDirect) DropCache(in, offset, length);
+                if (hasher) hasher->Update(slot.buf.get(), length);
+                offset += length;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.length = length;
+                slot.full = length > 0;
+                eof = length < kDirectChunk;
+                changed.notify_all();
+                if (eof) return;
+            }
+        });
+
+        bool ok = true;
+        std::uint64_t offset = 0;
+        for (std::size_t next = 0;; next = (next + 1) % kRingSlots)
+        {
+            RingSlot& slot = ring[next];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return slot.full || eof; });
+                if (!slot.full)
+                {
+                    ok = readErr.empty();
+                    if (!ok) outErr = readErr;
+                    break;
+                }
+            }
+
+            // direct writes must be whole blocks; the short tail goes through the cache
+            if (outDirect && slot.length % kAlign != 0)
+                outDirect = BypassCache(out, false);
+
+            for (std::size_t done = 0; ok && done < slot.length;)
+            {
+                const ssize_t w = ::pwrite(out, slot.buf.get() + done, slot.length - done, (off_t)(offset + done));
+                if (w >= 0)
+                {
+                    done += (std::size_t)w;
+                    continue;
+                }
+                if (errno == EINTR) continue;
+                if (errno == EINVAL && outDirect)
+                {
+                    outDirect = BypassCache(out, false);
+                    continue;
+                }
+                outErr = ErrnoMessage("Write failed for", dst);
+                ok = false;
+            }
+            if (!ok) break;
+
+#if defined(__linux__)
+            if (uncached && !outDirect)
+            {
+                ::sync_file_range(out, (off_t)offset, (off_t)slot.length,
+                                  SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+                DropCache(out, offset, slot.length);
+            }
+#endif
+            offset += slot.length;
+            outBytes += slot.length;
+            Account(scheduler, srcDev, dstDev, slot.length);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.full = false;
+            changed.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            changed.notify_all();
+        }
+        reader.join();
+        return ok;
+    }
+#endif
+}
+
+/*
+Function: CopyFileImpl
+Description: Copies the contents and permission bits of a regular file to a new file; a FIFO,
+             socket, device or symlink at src is refused with an error. The copy first takes
+             a slot on the source and destination devices from the scheduler (so it waits
+             while those devices are at their concurrency limit) and reports every chunk to it
+             for throughput tuning and bandwidth capping. Files of 256 MB or more that the
+             kernel cannot copy directly are copied around the page cache. When a hasher is
+             given, the data has to pass through user space, so the kernel copy is skipped and
+             files of a few MB or more are hashed on the reader thread while earlier chunks
+             are written. Sparse files are copied extent by extent instead, so only their data
+             is transferred and outBytes leaves out the holes.
+Parameters:
+  - src: Source file.
+  - dst: Destination path; must not exist yet.
+  - scheduler: I/O scheduler pacing the copy.
+  - hasher: If not null, receives every byte copied.
+  - outBytes: Output number of bytes copied.
+  - outHoleBytes: Output number of bytes of holes left unwritten.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file was copied completely; false otherwise (a partial dst may remain).
+*/
+static bool CopyFileImpl(const fs::path& src,
+                         const fs::path& dst,
+                         IoScheduler& scheduler,
+                         Hash64* hasher,
+                         std::uintmax_t& outBytes,
+                         std::uintmax_t& outHoleBytes,
+                         std::string& outErr)
+{
+    outErr.clear();
+    outBytes = 0;
+    outHoleBytes = 0;
+
+    const DeviceId srcDev = IoScheduler::DeviceOf(src);
+    const DeviceId dstDev = IoScheduler::DeviceOf(dst.parent_path());
+    IoScheduler::Ticket ticket = scheduler.Acquire({ srcDev, dstDev });
+
+#ifdef FM_HAVE_POSIX_IO
+    // a FIFO would block the open and a device might never end: open without waiting or
+    // following a link, and refuse anything that is not a regular file
+    FdGuard in{ ::open(src.c_str(), O_RDONLY | O_NONBLOCK | O_NOFOLLOW) };
+    if (in.fd < 0)
+    {
+        outErr = ErrnoMessage("Cannot open", src);
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(in.fd, &st) != 0)
+    {
+        outErr = ErrnoMessage("Cannot stat", src);
+        return false;
+    }
+    if (!S_ISREG(st.st_mode))
+    {
+        outErr = "Cannot copy " + src.string() + ": not a regular file";
+        return false;
+    }
+    ::fcntl(in.fd, F_SETFL, ::fcntl(in.fd, F_GETFL) & ~O_NONBLOCK);
+
+    FdGuard out{ ::open(dst.c_str(), O_WRONLY | O_CREAT | O_EXCL, st.st_mode & 07777) };
+    if (out.fd < 0)
+    {
+        outErr = ErrnoMessage("Cannot create", dst);
+        return false;
+    }
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    // Sparse files (VM images, databases) keep their holes; a filesystem that cannot report
+    // holes makes the probe fail and the file is copied in full
+    if (IsSparse(st))
+    {
+        if (::lseek(in.fd, 0, SEEK_DATA) >= 0 || errno == ENXIO)
+            return CopySparse(in.fd, out.fd, (std::uint64_t)st.st_size, src, dst, scheduler, srcDev, dstDev, hasher, outBytes, outHoleBytes, outErr);
+        ::lseek(in.fd, 0, SEEK_SET);
+    }
+#endif
+
+#if defined(__linux__)
+    // Kernel-side copy (reflink/server-side copy where the filesystem supports it)
+    while (!hasher)
+    {
+        const ssize_t n = ::copy_file_range(in.fd, nullptr, out.fd, nullptr, kChunk, 0);
+        if (n > 0)
+        {
+            outBytes += (std::uintmax_t)n;
+            Account(scheduler, srcDev, dstDev, (std::uint64_t)n);
+            continue;
+        }
+        if (n == 0) return true;
+
+        if (outBytes == 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+            break;
+        outErr = ErrnoMessage("Copy failed for", src);
+        return false;
+    }
+#endif
+
+    if ((std::uint64_t)st.st_size >= kUncachedThreshold || (hasher && (std::uint64_t)st.st_size >= kDirectChunk))
+    {
+        const bool uncached = (std::uint64_t)st.st_size >= kUncachedThreshold;
+        return CopyPipelined(in.fd, out.fd, src, dst, scheduler, srcDev, dstDev, uncached, hasher, outBytes, outErr);
+    }
+
+    std::unique_ptr<char[]> buf(new char[kBufferChunk]);
+    for (;;)
+    {
+        const ssize_t n = ::read(in.fd, buf.get(), kBufferChunk);
+        if (n == 0) return true;
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            outErr = ErrnoMessage("Read failed for", src);
+            return false;
+        }
+
+        for (ssize_t done = 0; done < n;)
+        {
+            const ssize_t w = ::write(out.fd, buf.get() + done, (std::size_t)(n - done));
+            if (w < 0)
+            {
+                if (errno == EINTR) continue;
+                outErr = ErrnoMessage("Write failed for", dst);
+                return false;
+            }
+            done += w;
+        }
+
+        if (hasher) hasher->Update(buf.get(), (std::size_t)n);
+        outBytes += (std::uintmax_t)n;
+        Account(scheduler, srcDev, dstDev, (std::uint64_t)n);
+    }
+#else
+    std::error_code ec;
+    fs::copy_file(src, dst, fs::copy_options::none, ec);
+    if (ec)
+    {
+        outErr = "Copy failed for " + src.string() + ": " + ec.message();
+        return false;
+    }
+    (void)hasher;
+    outBytes = fs::file_size(dst, ec);
+    Account(scheduler, srcDev, dstDev, outBytes);
+    return true;
+#endif
+}
+
+/*
+Function: CopyRegularFile
+Description: Copies the contents and permission bits of a regular file to a new file, paced by
+             the I/O scheduler (see CopyFileImpl).
+Parameters:
+  - src: Source file.
+  - dst: Destination path; must not exist yet.
+  - scheduler: I/O scheduler pacing the copy.
+  - outBytes: Output number of bytes copied.
+  - outHoleBytes: Output number of bytes of holes left unwritten (sparse files).
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file was copied completely; false otherwise (a partial dst may remain).
+*/
+bool CopyRegularFile(const fs::path& src,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     std::uintmax_t& outBytes,
+                     std::uintmax_t& outHoleBytes,
+                     std::string& outErr)
+{
+    return CopyFileImpl(src, dst, scheduler, nullptr, outBytes, outHoleBytes, outErr);
+}
+
+
+/*
+Function: CopyAndHashFile
+Description: Copies a regular file like CopyRegularFile and computes the XXH64 digest of the
+             data while it streams through the copy buffers, so the source is read only once.
+             Where there is no user-space copy loop (non-POSIX builds) the source is hashed
+             separately.
+Parameters:
+  - src: Source file.
+  - dst: Destination path; must not exist yet.
+  - scheduler: I/O scheduler pacing the copy.
+  - outBytes: Output number of bytes copied.
+  - outHoleBytes: Output number of bytes of holes left unwritten (sparse files).
+  - outHash: Output XXH64 digest of the source contents.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file was copied and hashed; false otherwise (a partial dst may remain).
+*/
+bool CopyAndHashFile(const fs::path& src,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     std::uintmax_t& outBytes,
+                     std::uintmax_t& outHoleBytes,
+                     std::uint64_t& outHash,
+                     std::string& outErr)
+{
+#ifdef FM_HAVE_POSIX_IO
+    Hash64 hasher;
+    if (!CopyFileImpl(src, dst, scheduler, &hasher, outBytes, outHoleBytes, outErr)) return false;
+    outHash = hasher.Digest();
+    return true;
+#else
+    if (!CopyFileImpl(src, dst, scheduler, nullptr, outBytes, outHoleBytes, outErr)) return false;
+    return HashFileContents(src, outHash, outErr);
+#endif
+}
+
+/*
+Function: VerifyFileHash
+Description: Re-reads a freshly written file and compares its XXH64 digest with the one taken
+             while it was copied. The file is first flushed and its cached pages dropped, so
+             the check reads what reached the device rather than what is still in memory;
+             sequential readahead keeps the disk busy while earlier chunks are hashed.
+Parameters:
+  - file: File to check.
+  - expectedHash: Digest computed during the copy.
+  - scheduler: I/O scheduler pacing the read.
+  - outMatches: Output true if the contents hash to expectedHash.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file could be read completely; false otherwise.
+*/
+bool VerifyFileHash(const fs::path& file,
+                    std::uint64_t expectedHash,
+                    IoScheduler& scheduler,
+                    bool& outMatches,
+                    std::string& outErr)
+{
+    outErr.clear();
+    outMatches = false;
+
+    const DeviceId dev = IoScheduler::DeviceOf(file);
+    IoScheduler::Ticket ticket = scheduler.Acquire({ dev });
+
+#ifdef FM_HAVE_POSIX_IO
+    FdGuard in{ ::open(file.c_str(), O_RDONLY) };
+    if (in.fd < 0)
+    {
+        outErr = ErrnoMessage("Cannot open", file);
+        return false;
+    }
+
+    ::fsync(in.fd);
+    DropCache(in.fd, 0, 0);
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(in.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    std::unique_ptr<char[]> buf(new char[kBufferChunk]);
+    Hash64 hasher;
+    for (;;)
+    {
+        const ssize_t n = ::read(in.fd, buf.get(), kBufferChunk);
+        if (n == 0) break;
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            outErr = ErrnoMessage("Read failed for", file);
+            return false;
+        }
+        hasher.Update(buf.get(), (std::size_t)n);
+        scheduler.Transfer(dev, (std::uint64_t)n);
+    }
+    outMatches = hasher.Digest() == expectedHash;
+    return true;
+#else
+    std::uint64_t digest = 0;
+    if (!HashFileContents(file, digest, outErr)) return false;
+    std::error_code ec;
+    scheduler.Transfer(dev, fs::file_size(file, ec));
+    outMatches = digest == expectedHash;
+    return true;
+#endif
+}
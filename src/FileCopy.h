@@ -0,0 +1,39 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the single-file copy routine used by every bulk operation (paste, sync), and the hashing copy and re-read check used by verified pastes. Copies are admitted and paced by the IoScheduler of the devices involved, so concurrency and bandwidth limits apply uniformly no matter which feature started the copy.
+February 1, 2026
+*/
+
+#ifndef FILECOPY_H
+#define FILECOPY_H
+
+#include "IoScheduler.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+bool CopyRegularFile(const fs::path& src,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     std::uintmax_t& outBytes,
+                     std::uintmax_t& outHoleBytes,
+                     std::string& outErr);
+
+bool CopyAndHashFile(const fs::path& src,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     std::uintmax_t& outBytes,
+                     std::uintmax_t& outHoleBytes,
+                     std::uint64_t& outHash,
+                     std::string& outErr);
+
+bool VerifyFileHash(const fs::path& file,
+                    std::uint64_t expectedHash,
+                    IoScheduler& scheduler,
+                    bool& outMatches,
+                    std::string& outErr);
+
+#endif // FILECOPY_H
@@ -6,15 +6,18 @@ The application entry point for the file manager system resides in this document
 February 1, 2026
 */
 
+#include "FsBackend.h"
 #include "MainFrame.h"
 #include <wx/wx.h>
+#include <cstdlib>
 
 
 /*
 Function: FileManagerApp::OnInit
-Description: Entry point called by wxWidgets during application startup. Creates the main
-             application window (MainFrame), shows it, and returns whether initialization
-             succeeded. If this returns false, the GUI will not launch.
+Description: Entry point called by wxWidgets during application startup. Picks the filesystem
+             backend from the --backend= argument or the FM_BACKEND environment variable,
+             creates the main application window (MainFrame), shows it, and returns whether
+             initialization succeeded. If this returns false, the GUI will not launch.
 Parameters:
   - None
 Returns:
@@ -33,8 +36,23 @@ wxIMPLEMENT_APP(FileManagerApp);
 // Called on application startup
 bool FileManagerApp::OnInit() {
 
+    // Filesystem backend: --backend=posix|std|memory[:latency_us[:bytes_per_second[:dir]]], or FM_BACKEND
+    std::string spec;
+    if (const char* env = std::getenv("FM_BACKEND")) spec = env;
+    for (int i = 1; i < argc; ++i) {
+        wxString rest;
+        if (wxString(argv[i]).StartsWith("--backend=", &rest)) spec = rest.ToStdString();
+    }
+
+    std::string err;
+    std::shared_ptr<FsBackend> backend = MakeFsBackend(spec, err);
+    if (!backend) {
+        wxMessageBox(wxString::FromUTF8(err) + "\nUsing the default backend.", "File Manager", wxOK | wxICON_WARNING);
+        backend = MakeDefaultFsBackend();
+    }
+
     // Create the main window and show it
-    MainFrame* frame = new MainFrame("CS3307 File Manager");
+    MainFrame* frame = new MainFrame("CS3307 File Manager", backend);
     frame->Show(true);
 return true;
 }
\ No newline at end of file
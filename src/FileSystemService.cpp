@@ -6,32 +6,265 @@ February 1, 2026
 
 
 #include "FileSystemService.h"
+#include "AppPaths.h"
+#include "ArchiveVfs.h"
+#include "BackgroundPurger.h"
+#include "FileCopy.h"
+#include "FsBackend.h"
+#include "IoScheduler.h"
+#include "ListingCache.h"
+#include "ThreadUtil.h"
+#include "Trash.h"
+#include "TreeSnapshot.h"
+#include "TreeWalker.h"
+#include "VfsProvider.h"
+#include "ZstdCopy.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <chrono>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+// One regular file of a tree copy
+struct FileJob
+{
+    fs::path src;
+    fs::path dst;
+    PasteTransform transform = PasteTransform::None;
+};
+
+// Registered container formats and the providers opened for them; shared with the preloader
+struct VfsMounts
+{
+    struct Mounted
+    {
+        fs::file_time_type mtime;
+        std::shared_ptr<VfsProvider> provider;
+    };
+
+    std::mutex mutex;
+    std::vector<std::pair<std::string, VfsFactory>> factories;     // lower-case filename suffix
+    std::unordered_map<std::string, Mounted> open;
+};
+
+// Opened archives kept indexed for fast re-entry
+static constexpr std::size_t kMaxOpenContainers = 16;
+
+/*
+Function: CurrentProcessId
+Description: Returns the id of the running process, used to make temporary names unique.
+Parameters:
+  - None
+Returns:
+  - long: Process id.
+*/
+static long CurrentProcessId()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    return (long)::getpid();
+#else
+    return (long)::_getpid();
+#endif
+}
+
+/*
+Function: FileSystemService::FileSystemService
+Description: Creates the service on top of a filesystem backend, together with the listing
+             cache shared by all tabs, the background purger that deletes data replaced by
+             staged pastes, the I/O scheduler that paces bulk copies per device, the
+             virtual filesystem providers for the supported archive formats and, for local
+             backends, the trash that deletes are moved into.
+Parameters:
+  - backend: Backend performing the filesystem operations; nullptr selects the platform
+             default.
+Returns:
+  - None
+*/
+FileSystemService::FileSystemService(std::shared_ptr<FsBackend> backend)
+    : m_backend(backend ? std::move(backend) : MakeDefaultFsBackend()),
+      m_cache(std::make_shared<ListingCache>()),
+      m_purger(std::make_shared<BackgroundPurger>(m_backend)),
+      m_scheduler(std::make_shared<IoScheduler>()),
+      m_vfs(std::make_shared<VfsMounts>())
+{
+    RegisterProvider(".zip", OpenZipArchive);
+    RegisterProvider(".tar", OpenTarArchive);
+    RegisterProvider(".tar.gz", OpenTarArchive);
+    RegisterProvider(".tgz", OpenTarArchive);
+    RegisterProvider(kSnapshotSuffix, OpenTreeSnapshot);
+
+    const fs::path dataDir = AppDataDirectory();
+    if (m_backend->IsLocal() && !dataDir.empty())
+        m_trash = std::make_shared<Trash>(m_backend, m_purger, dataDir);
+}
+
+/*
+Function: FileSystemService::Backend
+Description: Gives access to the backend, e.g. to show its name or to check whether paths
+             refer to real files.
+Parameters:
+  - None
+Returns:
+  - const FsBackend&: Backend of this service.
+*/
+const FsBackend& FileSystemService::Backend() const
+{
+    return *m_backend;
+}
+
+/*
+Function: FileSystemService::RegisterProvider
+Description: Makes files whose name ends with suffix browsable as directories through the
+             provider that factory opens for them.
+Parameters:
+  - suffix: Filename suffix, matched case-insensitively (e.g. ".zip").
+  - factory: Opens a provider for one such file.
+Returns:
+  - None
+*/
+void FileSystemService::RegisterProvider(const std::string& suffix, VfsFactory factory)
+{
+    std::string lower = suffix;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+    std::lock_guard<std::mutex> lock(m_vfs->mutex);
+    m_vfs->factories.emplace_back(std::move(lower), std::move(factory));
+}
+
+/*
+Function: FileSystemService::ResolveVirtual
+Description: Decides whether a path refers to a container file or to something inside one.
+             Real directories are recognized with a single stat; otherwise the path is walked
+             up to its nearest existing ancestor, which must be a regular file with a
+             registered suffix. Providers stay open (keyed by the file's mtime) so entering
+             the same archive again does not re-read its index. Containers are only looked
+             for on backends whose paths are real files.
+Parameters:
+  - p: Path to resolve.
+  - outInner: Output path inside the container ("" for the container itself).
+  - outErr: Output string populated if the container exists but cannot be opened.
+Returns:
+  - std::shared_ptr<VfsProvider>: Provider of the container, or nullptr for a real path.
+*/
+std::shared_ptr<VfsProvider> FileSystemService::ResolveVirtual(const fs::path& p, fs::path& outInner, std::string& outErr) const
+{
+    outInner.clear();
+    if (!m_backend->IsLocal()) return nullptr;
+
+    std::error_code ec;
+    fs::path container = p;
+    fs::file_status st = fs::status(container, ec);
+    if (fs::is_directory(st)) return nullptr;
+
+    while (!fs::exists(st))
+    {
+        if (container.empty() || !container.has_relative_path()) return nullptr;
+        outInner = outInner.empty() ? container.filename() : container.filename() / outInner;
+        container = container.parent_path();
+        st = fs::status(container, ec);
+    }
+    if (!fs::is_regular_file(st))
+    {
+        outInner.clear();
+        return nullptr;
+    }
+
+    std::string name = container.filename().string();
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+    VfsFactory factory;
+    {
+        std::lock_guard<std::mutex> lock(m_vfs->mutex);
+        for (const auto& entry : m_vfs->factories)
+        {
+            const std::string& suffix = entry.first;
+            if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                factory = entry.second;
+                break;
+            }
+        }
+    }
+    if (!factory)
+    {
+        outInner.clear();
+        return nullptr;
+    }
+
+    const fs::file_time_type mtime = fs::last_write_time(container, ec);
+    const std::string key = container.string();
+    {
+        std::lock_guard<std::mutex> lock(m_vfs->mutex);
+        auto it = m_vfs->open.find(key);
+        if (it != m_vfs->open.end() && it->second.mtime == mtime)
+            return it->second.provider;
+    }
+
+    // Index outside the lock; a large tar.gz takes a while
+    std::shared_ptr<VfsProvider> provider = factory(container, outErr);
+    if (!provider) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_vfs->mutex);
+    if (m_vfs->open.size() >= kMaxOpenContainers && !m_vfs->open.count(key))
+        m_vfs->open.erase(m_vfs->open.begin());
+    m_vfs->open[key] = VfsMounts::Mounted{ mtime, provider };
+    return provider;
+}
 
 /*
-Function: ToTimeT
-Description: Converts a std::filesystem::file_time_type into a std::time_t. This is used to
-             display last-modified timestamps in a portable way by translating from the
-             filesystem clock to system_clock. Conversion can be sensitive to platform clock
-             differences, so this function centralizes the logic.
+Function: FileSystemService::IsBrowsable
+Description: Checks whether a path can be shown as a directory: a real directory, a supported
+             archive, or a directory inside an archive.
 Parameters:
-  - ftime: Filesystem timestamp (file_time_type) to convert.
+  - p: Path to test.
+Returns:
+  - bool: true if p can be listed; false otherwise.
+*/
+bool FileSystemService::IsBrowsable(const fs::path& p) const
+{
+    fs::path inner;
+    std::string err;
+    if (std::shared_ptr<VfsProvider> vfs = ResolveVirtual(p, inner, err))
+    {
+        FileItem item;
+        return vfs->Stat(inner, item) && item.isDir;
+    }
+    return IsDirectory(p);
+}
+
+/*
+Function: FileSystemService::IsInArchive
+Description: Checks whether a path refers to an entry inside an archive (not the archive file
+             itself). Such entries are read-only.
+Parameters:
+  - p: Path to test.
 Returns:
-  - std::time_t: Converted timestamp suitable for formatting and display.
+  - bool: true if p lies inside an archive; false otherwise.
 */
-static std::time_t ToTimeT(const fs::file_time_type& ftime)
+bool FileSystemService::IsInArchive(const fs::path& p) const
 {
-    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-        ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now()
-    );
-    return std::chrono::system_clock::to_time_t(sctp);
+    fs::path inner;
+    std::string err;
+    return ResolveVirtual(p, inner, err) != nullptr && !inner.empty();
 }
 
 /*
 Function: FileSystemService::ListDirectory
 Description: Produces a list of FileItem entries for a directory, including metadata needed
-             by the UI (name/type/size/last modified). Returns an empty vector on failure and
-             sets outErr with a human-readable message (e.g., not a directory, permission errors).
+             by the UI (name/type/size/last modified). Archives and directories inside them are
+             listed through their virtual filesystem provider. The extended fields chosen
+             with SetDetailFields are read by the same per-entry stat call; archive entries
+             carry none of them. Room is reserved for as many entries as the directory's last
+             cached listing had. Returns an empty vector on failure and sets outErr with a
+             human-readable message (e.g., not a directory, permission errors).
 Parameters:
   - dir: Directory path to enumerate.
   - outErr: Output string populated with an error message if listing fails; cleared on success.
@@ -43,44 +276,259 @@ std::vector<FileItem> FileSystemService::ListDirectory(const fs::path& dir, std:
     outErr.clear();
     std::vector<FileItem> items;
 
-    std::error_code ec;
-    if (!fs::exists(dir, ec) || !fs::is_directory(dir, ec))
+    // archives list from their in-memory index
+    fs::path inner;
+    if (std::shared_ptr<VfsProvider> vfs = ResolveVirtual(dir, inner, outErr))
     {
-        outErr = "Not a directory: " + dir.string();
+        if (!vfs->List(dir, inner, items, outErr)) items.clear();
         return items;
     }
+    if (!outErr.empty()) return items;
 
-    fs::directory_iterator it(dir, ec);
-    if (ec)
-    {
-        outErr = "Cannot iterate directory: " + ec.message();
-        return items;
-    }
+    items.reserve(m_cache->SizeHint(dir));
+    if (!m_backend->List(dir, m_details.load(std::memory_order_relaxed), items, outErr)) items.clear();
+    return items;
+}
 
-    for (const auto& entry : it)
-    {
-        FileItem item;
-        item.fullPath = entry.path();
+/*
+Function: FileSystemService::ListDirectoryStream
+Description: Enumerates a directory like ListDirectory but hands the entries to a callback in
+             chunks while the directory is still being read, reusing one chunk buffer, so
+             memory stays bounded by the chunk size however large the directory is and the
+             consumer can start before enumeration finishes. Archive listings come from their
+             in-memory index and are handed out in chunks the same way.
+Parameters:
+  - dir: Directory path to enumerate.
+  - sink: Receives the chunks; returning false stops the enumeration early.
+  - outErr: Output string populated with an error message if listing fails; cleared on success.
+  - chunkSize: Maximum number of entries per chunk.
+Returns:
+  - bool: true if the directory was listed (or the sink stopped early); false otherwise.
+*/
+bool FileSystemService::ListDirectoryStream(const fs::path& dir,
+                                            const ListChunkSink& sink,
+                                            std::string& outErr,
+                                            std::size_t chunkSize) const
+{
+    outErr.clear();
 
-        std::error_code e2;
-        item.isDir = entry.is_directory(e2);
-        if (e2) item.isDir = false;
+    fs::path inner;
+    if (std::shared_ptr<VfsProvider> vfs = ResolveVirtual(dir, inner, outErr))
+    {
+        std::vector<FileItem> items;
+        if (!vfs->List(dir, inner, items, outErr)) return false;
 
-        if (!item.isDir)
+        if (chunkSize == 0) chunkSize = kListChunkEntries;
+        std::vector<FileItem> chunk;
+        for (std::size_t i = 0; i < items.size(); i += chunkSize)
         {
-            std::error_code e3;
-            item.sizeBytes = fs::file_size(item.fullPath, e3);
-            if (e3) item.sizeBytes = 0;
+            const std::size_t end = std::min(items.size(), i + chunkSize);
+            chunk.assign(std::make_move_iterator(items.begin() + (long)i), std::make_move_iterator(items.begin() + (long)end));
+            if (!sink(chunk)) break;
         }
+        return true;
+    }
+    if (!outErr.empty()) return false;
+
+    return m_backend->ListStream(dir, m_details.load(std::memory_order_relaxed), chunkSize, sink, outErr);
+}
+
+/*
+Function: FileSystemService::ListDirectoryCached
+Description: Returns the listing of a directory from the shared listing cache when the cached
+             copy was read at the directory's current modification time; otherwise enumerates
+             the directory and stores the result. A fresh enumeration reserves room for as many
+             entries as the directory's previous listing had and moves every chunk into the
+             listing. When onProgress is given it is shown the entries read so far after each
+             chunk, so the caller can show the first entries of a huge directory before the
+             rest arrive; on a cache hit onProgress is not called. Safe to call from the
+             preloader thread.
+Parameters:
+  - dir: Directory path to enumerate.
+  - allowCached: If false, always re-enumerate (used by an explicit refresh).
+  - outErr: Output string populated with an error message if listing fails; cleared on success.
+  - onProgress: Optional callback for the partial listing of a fresh enumeration; returning
+                false abandons the listing (nullptr is returned and nothing is cached).
+Returns:
+  - DirectoryListing: Shared listing, or nullptr on error.
+*/
+DirectoryListing FileSystemService::ListDirectoryCached(const fs::path& dir,
+                                                        bool allowCached,
+                                                        std::string& outErr,
+                                                        const ListProgressSink& onProgress) const
+{
+    outErr.clear();
+
+    // Read the mtime before enumerating so a concurrent change makes the entry stale
+    FsStat st;
+    const bool haveStamp = m_backend->Stat(dir, true, st);
+    const unsigned details = m_details.load(std::memory_order_relaxed);
 
-        std::error_code e4;
-        auto t = fs::last_write_time(item.fullPath, e4);
-        item.modified = e4 ? 0 : ToTimeT(t);
+    // taken before the lookup, which drops a stale entry
+    const std::size_t sizeHint = m_cache->SizeHint(dir);
 
-        items.push_back(std::move(item));
+    if (allowCached && haveStamp)
+    {
+        if (DirectoryListing hit = m_cache->Lookup(dir, st.changeStamp, details))
+            return hit;
     }
 
-    return items;
+    auto items = std::make_shared<std::vector<FileItem>>();
+    items->reserve(sizeHint);
+
+    bool abandoned = false;
+    const bool listed = ListDirectoryStream(dir, [&](std::vector<FileItem>& chunk)
+    {
+        items->insert(items->end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+        abandoned = onProgress && !onProgress(*items);
+        return !abandoned;
+    }, outErr);
+    if (!listed || abandoned) return nullptr;
+
+    DirectoryListing listing = std::move(items);
+    if (haveStamp) m_cache->Store(dir, listing, st.changeStamp, details);
+    return listing;
+}
+
+/*
+Function: FileSystemService::InvalidateListing
+Description: Drops the cached listing of a directory so the next ListDirectoryCached call
+             re-enumerates it. Every mutating operation calls this for the directories it
+             changes.
+Parameters:
+  - dir: Directory whose cached listing is no longer valid.
+Returns:
+  - None
+*/
+void FileSystemService::InvalidateListing(const fs::path& dir) const
+{
+    m_cache->Invalidate(dir);
+}
+
+/*
+Function: FileSystemService::SnapshotListing
+Description: Returns the cached listing of a directory if it is still current, together with
+             the change stamp it was read at, without enumerating the directory. Used to save
+             the listings of the open tabs with the session.
+Parameters:
+  - dir: Directory whose listing is wanted.
+  - outStamp: Output change stamp of the directory the listing matches.
+Returns:
+  - DirectoryListing: Cached listing, or nullptr if none is current.
+*/
+DirectoryListing FileSystemService::SnapshotListing(const fs::path& dir, fs::file_time_type& outStamp) const
+{
+    FsStat st;
+    if (!m_backend->Stat(dir, true, st)) return nullptr;
+
+    DirectoryListing hit = m_cache->Lookup(dir, st.changeStamp, m_details.load(std::memory_order_relaxed));
+    if (hit) outStamp = st.changeStamp;
+    return hit;
+}
+
+/*
+Function: FileSystemService::AdoptListing
+Description: Stores a listing read earlier (a session snapshot) in the listing cache if the
+             directory still has the change stamp the listing was read at, so the next
+             ListDirectoryCached call uses it instead of enumerating. The listing must have
+             been read with the current detail fields.
+Parameters:
+  - dir: Directory the listing belongs to.
+  - listing: Complete listing of dir.
+  - stamp: Change stamp of dir when the listing was read.
+Returns:
+  - bool: true if the listing is still current and was adopted; false otherwise.
+*/
+bool FileSystemService::AdoptListing(const fs::path& dir, DirectoryListing listing, const fs::file_time_type& stamp) const
+{
+    FsStat st;
+    if (!listing || !m_backend->Stat(dir, true, st) || st.changeStamp != stamp) return false;
+
+    m_cache->Store(dir, std::move(listing), stamp, m_details.load(std::memory_order_relaxed));
+    return true;
+}
+
+/*
+Function: FileSystemService::SetDetailFields
+Description: Chooses which extended metadata (owner, mode, inode, link count, allocated size,
+             birth time) listings read from now on. Fields that are not chosen are neither
+             requested from the kernel nor stored. Cached listings that lack a newly chosen
+             field are re-read on their next lookup; those that have more are still used.
+Parameters:
+  - details: Combination of kDetail* flags.
+Returns:
+  - None
+*/
+void FileSystemService::SetDetailFields(unsigned details)
+{
+    m_details.store(details & kDetailAll, std::memory_order_relaxed);
+}
+
+/*
+Function: FileSystemService::WalkTree
+Description: Walks everything below a directory in parallel (see WalkTree in TreeWalker.h).
+             Local backends are walked directly on the real filesystem with descriptor-relative
+             calls; other backends are walked through their own listing calls.
+Parameters:
+  - root: Directory to walk.
+  - opts: Traversal options (threads, link following, same device, cancellation).
+  - callbacks: Filter, pruning and result hooks, called from the walker threads.
+  - outStats: Output totals of the walk.
+  - outErr: Output string populated with an error message if root cannot be walked; cleared on success.
+Returns:
+  - bool: true if the walk ran; false otherwise.
+*/
+bool FileSystemService::WalkTree(const fs::path& root,
+                                 const TreeWalkOptions& opts,
+                                 const TreeWalkCallbacks& callbacks,
+                                 TreeWalkStats& outStats,
+                                 std::string& outErr) const
+{
+    return ::WalkTree(root, opts, callbacks, outStats, outErr, m_backend->IsLocal() ? nullptr : m_backend.get());
+}
+
+/*
+Function: FileSystemService::DetailFields
+Description: Returns the extended metadata fields listings currently read.
+Parameters:
+  - None
+Returns:
+  - unsigned: Combination of kDetail* flags.
+*/
+unsigned FileSystemService::DetailFields() const
+{
+    return m_details.load(std::memory_order_relaxed);
+}
+
+/*
+Function: FileSystemService::CopyFile
+Description: Copies one regular file to a path that does not exist yet, through the backend
+             and the I/O scheduler. Used by features that manage their own temporary names (e.g. sync).
+Parameters:
+  - src: Source file.
+  - dst: Destination path (must not exist).
+  - outBytes: Output number of bytes copied.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file was copied; false otherwise.
+*/
+bool FileSystemService::CopyFile(const fs::path& src, const fs::path& dst, std::uintmax_t& outBytes, std::string& outErr) const
+{
+    std::uintmax_t holes = 0;
+    return m_backend->CopyFile(src, dst, *m_scheduler, outBytes, holes, outErr);
+}
+
+/*
+Function: FileSystemService::Scheduler
+Description: Gives access to the I/O scheduler, e.g. to change the bandwidth cap.
+Parameters:
+  - None
+Returns:
+  - IoScheduler&: Scheduler shared by all bulk operations of this service.
+*/
+IoScheduler& FileSystemService::Scheduler() const
+{
+    return *m_scheduler;
 }
 
 /*
@@ -102,23 +550,27 @@ bool FileSystemService::CreateDirectory(const fs::path& dir, const std::string&
         outErr = "Directory name cannot be empty.";
         return false;
     }
+    fs::path inner;
+    std::string vfsErr;
+    if (ResolveVirtual(dir, inner, vfsErr))
+    {
+        outErr = "Archives are read-only.";
+        return false;
+    }
 
     const fs::path newDir = dir / fs::path(name);
 
-    std::error_code ec;
-    if (fs::exists(newDir, ec))
+    FsStat st;
+    if (m_backend->Stat(newDir, false, st))
     {
         outErr = "That name already exists.";
         return false;
     }
 
-    const bool ok = fs::create_directory(newDir, ec);
-    if (!ok || ec)
-    {
-        outErr = "Create directory failed: " + (ec ? ec.message() : std::string("unknown error"));
+    if (!m_backend->CreateDirectory(newDir, fs::path(), outErr))
         return false;
-    }
 
+    InvalidateListing(dir);
     return true;
 }
 
@@ -141,31 +593,69 @@ bool FileSystemService::RenamePath(const fs::path& oldPath, const std::string& n
         outErr = "New name cannot be empty.";
         return false;
     }
+    if (IsInArchive(oldPath))
+    {
+        outErr = "Archives are read-only.";
+        return false;
+    }
 
-    std::error_code ec;
-    if (!fs::exists(oldPath, ec))
+    FsStat st;
+    if (!m_backend->Stat(oldPath, false, st))
     {
         outErr = "Source does not exist.";
         return false;
     }
 
     const fs::path newPath = oldPath.parent_path() / fs::path(newName);
-    if (fs::exists(newPath, ec))
+    if (m_backend->Stat(newPath, false, st))
     {
         outErr = "A file/directory with that name already exists.";
         return false;
     }
 
-    fs::rename(oldPath, newPath, ec);
-    if (ec)
+    std::string err;
+    const bool ok = m_backend->Rename(oldPath, newPath, err);
+    InvalidateListing(oldPath.parent_path());
+    if (!ok)
     {
-        outErr = "Rename failed: " + ec.message();
+        outErr = "Rename failed: " + err;
         return false;
     }
 
+    InvalidateListing(oldPath);
     return true;
 }
 
+/*
+Function: FileSystemService::RenameBatch
+Description: Renames many entries of one directory in a single batch (see FsBackend::RenameBatch).
+             The names are expected to have been checked already, e.g. by PlanBatchRename;
+             the backend still never replaces an existing entry.
+Parameters:
+  - dir: Directory holding every entry of the batch.
+  - ops: Renames to apply, by entry name.
+  - outDone: Output number of entries that carry their new name.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if every rename was applied; false otherwise.
+*/
+bool FileSystemService::RenameBatch(const fs::path& dir, const std::vector<RenameOp>& ops, std::size_t& outDone, std::string& outErr) const
+{
+    outDone = 0;
+    outErr.clear();
+    if (IsInArchive(dir))
+    {
+        outErr = "Archives are read-only.";
+        return false;
+    }
+    if (ops.empty()) return true;
+
+    const bool ok = m_backend->RenameBatch(dir, ops, outDone, outErr);
+    InvalidateListing(dir);
+    for (const RenameOp& op : ops) InvalidateListing(dir / op.from);
+    return ok;
+}
+
 /*
 Function: FileSystemService::RemoveRecursive
 Description: Deletes a file or directory. For directories, performs recursive removal using
@@ -183,132 +673,707 @@ bool FileSystemService::RemoveRecursive(const fs::path& target, std::uintmax_t&
     outErr.clear();
     outRemovedCount = 0;
 
-    std::error_code ec;
-    if (!fs::exists(target, ec))
+    if (IsInArchive(target))
+    {
+        outErr = "Archives are read-only.";
+        return false;
+    }
+
+    FsStat st;
+    if (!m_backend->Stat(target, false, st))
     {
         outErr = "Target does not exist.";
         return false;
     }
 
-    outRemovedCount = fs::remove_all(target, ec);
-    if (ec)
+    std::string err;
+    const bool ok = m_backend->RemoveAll(target, outRemovedCount, err);
+    InvalidateListing(target.parent_path());
+    InvalidateListing(target);
+    if (!ok)
     {
-        outErr = "Delete failed: " + ec.message();
+        outErr = "Delete failed: " + err;
         return false;
     }
 
     return true;
 }
 
+/*
+Function: FileSystemService::HasTrash
+Description: Tells whether deletes can go to the trash (local backend with a known user data
+             directory).
+Parameters:
+  - None
+Returns:
+  - bool: true if MoveToTrash is available; false otherwise.
+*/
+bool FileSystemService::HasTrash() const
+{
+    return m_trash != nullptr;
+}
+
+/*
+Function: FileSystemService::MoveToTrash
+Description: Deletes a file or directory by renaming it into the trash of its volume, which
+             takes the same short time no matter how large the tree is. The data is reclaimed
+             later in the background; until then UndoDelete can bring it back.
+Parameters:
+  - target: File or directory to delete.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if target was moved to the trash; false otherwise (target unchanged).
+*/
+bool FileSystemService::MoveToTrash(const fs::path& target, std::string& outErr) const
+{
+    outErr.clear();
+    if (!m_trash)
+    {
+        outErr = "No trash is available for this filesystem.";
+        return false;
+    }
+    if (IsInArchive(target))
+    {
+        outErr = "Archives are read-only.";
+        return false;
+    }
+
+    FsStat st;
+    if (!m_backend->Stat(target, false, st))
+    {
+        outErr = "Target does not exist.";
+        return false;
+    }
+
+    const bool ok = m_trash->MoveToTrash(target, outErr);
+    InvalidateListing(target.parent_path());
+    InvalidateListing(target);
+    return ok;
+}
+
+/*
+Function: FileSystemService::UndoDelete
+Description: Restores the item most recently moved to the trash to where it was.
+Parameters:
+  - outRestored: Output path the item was restored to.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if an item was restored; false otherwise.
+*/
+bool FileSystemService::UndoDelete(fs::path& outRestored, std::string& outErr) const
+{
+    outErr.clear();
+    if (!m_trash)
+    {
+        outErr = "Nothing to undo.";
+        return false;
+    }
+
+    TrashEntry entry;
+    if (!m_trash->UndoLast(entry, outErr)) return false;
+
+    outRestored = entry.original;
+    InvalidateListing(entry.original.parent_path());
+    InvalidateListing(entry.original);
+    return true;
+}
+
+/*
+Function: StagingSibling
+Description: Builds a unique hidden name next to dest that is used to stage a paste before
+             it is swapped into place. Being in the same directory guarantees the same
+             filesystem, so the final swap is a single rename.
+Parameters:
+  - backend: Backend the destination lives on.
+  - dest: Final destination path.
+Returns:
+  - fs::path: Hidden sibling path that does not exist yet.
+*/
+static fs::path StagingSibling(const FsBackend& backend, const fs::path& dest)
+{
+    static std::atomic<unsigned> counter{ 0 };
+    FsStat st;
+    for (;;)
+    {
+        const fs::path candidate = dest.parent_path() /
+            ("." + dest.filename().string() + ".fm-stage-" +
+             std::to_string(CurrentProcessId()) + "-" + std::to_string(counter++));
+        if (!backend.Stat(candidate, false, st)) return candidate;
+    }
+}
+
+/*
+Function: FileTransform
+Description: Decides what a compressed or decompressed paste does with one regular file: files
+             that are already .zst are not compressed again, and only .zst files are
+             decompressed. Everything else is copied unchanged.
+Parameters:
+  - src: Regular source file.
+  - requested: Transform chosen for the paste.
+Returns:
+  - PasteTransform: Transform to apply to this file.
+*/
+static PasteTransform FileTransform(const fs::path& src, PasteTransform requested)
+{
+    const bool isZst = src.extension() == kZstdSuffix;
+    if (requested == PasteTransform::Compress && isZst) return PasteTransform::None;
+    if (requested == PasteTransform::Decompress && !isZst) return PasteTransform::None;
+    return requested;
+}
+
+/*
+Function: TransformedName
+Description: Returns the destination name of a file after a transform (adds or removes .zst).
+Parameters:
+  - dst: Destination path of the unchanged file.
+  - transform: Transform applied to the file.
+Returns:
+  - fs::path: Destination path to write.
+*/
+static fs::path TransformedName(const fs::path& dst, PasteTransform transform)
+{
+    if (transform == PasteTransform::Compress) return fs::path(dst.string() + kZstdSuffix);
+    if (transform == PasteTransform::Decompress) return fs::path(dst).replace_extension();
+    return dst;
+}
+
+/*
+Function: PlanTreeCopy
+Description: First pass of a tree copy. Recreates the directory structure and symlinks at the
+             destination (symlinks are copied as links, not followed, so a link cycle cannot
+             make the copy run forever) and collects every regular file to copy, with the
+             transform to apply to it. FIFOs, sockets and devices are refused rather than
+             read, since opening one could block or never reach its end. Files below the root
+             are renamed for their transform; the root keeps the dst name the caller chose.
+             Directories are read as a stream: files and links are handled chunk by chunk and
+             only the subdirectory names are kept until the directory has been read, so a huge
+             flat directory never has its whole listing in memory and only one directory is
+             open at a time.
+Parameters:
+  - backend: Backend performing the operations.
+  - src: Source file or directory.
+  - dst: Destination path (must not exist).
+  - transform: Transform requested for the paste.
+  - nested: True when src is below the root of the copy.
+  - jobs: Regular files to copy are appended here.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the structure was created; false otherwise.
+*/
+static bool PlanTreeCopy(const FsBackend& backend,
+                         const fs::path& src,
+                         const fs::path& dst,
+                         PasteTransform transform,
+                         bool nested,
+                         std::vector<FileJob>& jobs,
+                         std::string& outErr)
+{
+    FsStat st;
+    if (!backend.Stat(src, false, st))
+    {
+        outErr = "Copy failed for " + src.string() + ": source vanished";
+        return false;
+    }
+
+    if (st.type == FsEntryType::Symlink)
+        return backend.CopySymlink(src, dst, outErr);
+
+    if (st.type == FsEntryType::Directory)
+    {
+        std::string err;
+        if (!backend.CreateDirectory(dst, src, err))
+        {
+            outErr = "Copy failed for " + src.string() + ": " + err;
+            return false;
+        }
+
+        std::vector<fs::path> subdirs;
+        bool ok = true;
+        const bool listed = backend.ListStream(src, 0, kListChunkEntries, [&](const std::vector<FileItem>& chunk)
+        {
+            for (const FileItem& child : chunk)
+            {
+                if (child.isDir)
+                {
+                    subdirs.push_back(child.fullPath);
+                    continue;
+                }
+                if (!PlanTreeCopy(backend, child.fullPath, dst / child.fullPath.filename(), transform, true, jobs, outErr))
+                {
+                    ok = false;
+                    return false;
+                }
+            }
+            return true;
+        }, err);
+        if (!listed)
+        {
+            outErr = "Copy failed for " + src.string() + ": " + err;
+            return false;
+        }
+        if (!ok) return false;
+
+        for (const fs::path& child : subdirs)
+        {
+            if (!PlanTreeCopy(backend, child, dst / child.filename(), transform, true, jobs, outErr))
+                return false;
+        }
+        return true;
+    }
+
+    if (st.type != FsEntryType::File)
+    {
+        outErr = "Copy failed for " + src.string() + ": not a regular file (FIFO, socket or device)";
+        return false;
+    }
+
+    const PasteTransform fileTransform = FileTransform(src, transform);
+    jobs.push_back(FileJob{ src, nested ? TransformedName(dst, fileTransform) : dst, fileTransform });
+    return true;
+}
+
+/*
+Function: CopyTree
+Description: Copies a file, symlink or directory tree to a destination that does not exist
+             yet. The structure is created first, then the regular files are copied in
+             parallel through the I/O scheduler, which limits how many copies run at once on
+             each device. Compressed and decompressed pastes run each file through a zstd
+             pipeline instead, sharing the CPU between the files in flight for zstd's block
+             workers. With opts.verify, plain copies are hashed as they stream through the copy
+             buffers and each destination is read back once and compared; files whose copy
+             does not match are listed in stats.verifyFailures ((de)compressed files are
+             covered by the checksum inside every zstd frame instead). Counts the files and
+             bytes copied and publishes them to opts.progress.
+Parameters:
+  - src: Source file or directory.
+  - dst: Destination path (must not exist).
+  - backend: Backend performing the copies.
+  - scheduler: Scheduler admitting and pacing the file copies.
+  - opts: Transform, compression level and progress counters of the paste.
+  - stats: Totals updated as files are copied.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if everything was copied; false otherwise.
+*/
+static bool CopyTree(const fs::path& src,
+                     const fs::path& dst,
+                     const FsBackend& backend,
+                     IoScheduler& scheduler,
+                     const PasteOptions& opts,
+                     PasteStats& stats,
+                     std::string& outErr)
+{
+    std::vector<FileJob> jobs;
+    if (!PlanTreeCopy(backend, src, dst, opts.transform, false, jobs, outErr)) return false;
+
+    std::atomic<std::uintmax_t> files{ 0 };
+    std::atomic<std::uintmax_t> bytes{ 0 };
+    std::atomic<std::uintmax_t> rawBytes{ 0 };
+    std::atomic<std::uintmax_t> compressedBytes{ 0 };
+    std::atomic<std::uintmax_t> verified{ 0 };
+    std::atomic<std::uintmax_t> holes{ 0 };
+    std::atomic<bool> failed{ false };
+    std::mutex errMutex;
+    std::vector<fs::path> mismatches;
+
+    const unsigned lanes = (unsigned)std::max<std::size_t>(1, std::min<std::size_t>(jobs.size(), scheduler.MaxParallelism()));
+    ZstdCopyOptions zstdOpts;
+    zstdOpts.level = opts.compressionLevel;
+    zstdOpts.workers = std::max(1u, DefaultWorkerCount() / lanes);
+    if (opts.progress)
+    {
+        PasteProgress* progress = opts.progress;
+        zstdOpts.onProgress = [progress](std::uint64_t raw, std::uint64_t compressed)
+        {
+            progress->rawBytes += raw;
+            progress->compressedBytes += compressed;
+        };
+    }
+
+    ParallelFor(jobs.size(), lanes, [&](std::size_t i)
+    {
+        if (failed) return;
+
+        const FileJob& job = jobs[i];
+        std::uintmax_t copied = 0;
+        std::uintmax_t skipped = 0;
+        std::uintmax_t raw = 0;
+        std::uintmax_t compressed = 0;
+        std::string err;
+        bool ok = false;
+        switch (job.transform)
+        {
+        case PasteTransform::Compress:
+            ok = CompressFileZstd(job.src, job.dst, scheduler, zstdOpts, raw, compressed, err);
+            copied = compressed;
+            break;
+        case PasteTransform::Decompress:
+            ok = DecompressFileZstd(job.src, job.dst, scheduler, zstdOpts, raw, compressed, err);
+            copied = raw;
+            break;
+        case PasteTransform::None:
+            if (opts.verify)
+            {
+                std::uint64_t hash = 0;
+                bool matches = false;
+                ok = CopyAndHashFile(job.src, job.dst, scheduler, copied, skipped, hash, err) &&
+                     VerifyFileHash(job.dst, hash, scheduler, matches, err);
+                if (ok && !matches)
+                {
+                    std::lock_guard<std::mutex> lock(errMutex);
+                    mismatches.push_back(job.src);
+                }
+                if (ok)
+                {
+                    verified++;
+                    if (opts.progress) opts.progress->filesVerified++;
+                }
+            }
+            else
+            {
+                ok = backend.CopyFile(job.src, job.dst, scheduler, copied, skipped, err);
+            }
+            break;
+        }
+        if (!ok)
+        {
+            std::lock_guard<std::mutex> lock(errMutex);
+            if (!failed.exchange(true)) outErr = err;
+            return;
+        }
+        files++;
+        bytes += copied;
+        holes += skipped;
+        rawBytes += raw;
+        compressedBytes += compressed;
+        if (opts.progress) opts.progress->filesCopied++;
+    });
+
+    stats.filesCopied += files;
+    stats.bytesCopied += bytes;
+    stats.rawBytes += rawBytes;
+    stats.compressedBytes += compressedBytes;
+    stats.filesVerified += verified;
+    stats.holeBytes += holes;
+    std::sort(mismatches.begin(), mismatches.end());
+    stats.verifyFailures.insert(stats.verifyFailures.end(), mismatches.begin(), mismatches.end());
+    return !failed;
+}
+
+/*
+Function: SwapIntoPlace
+Description: Atomically exchanges a staged entry with an existing destination, so dest always
+             holds either the complete old or the complete new data (renameat2 with
+             RENAME_EXCHANGE on Linux, renamex_np with RENAME_SWAP on macOS, through the
+             backend). If the backend cannot exchange, falls back to moving dest aside and
+             renaming the staged entry in, which leaves only a very short window without
+             dest. The old data is left at outOld (the staged path after an exchange, the
+             hidden aside sibling otherwise) for the caller to purge.
+Parameters:
+  - backend: Backend performing the renames.
+  - staged: Fully written staged entry.
+  - dest: Existing destination to replace.
+  - outOld: Output path now holding the replaced data.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if dest now holds the staged data; false otherwise (dest unchanged).
+*/
+static bool SwapIntoPlace(const FsBackend& backend, const fs::path& staged, const fs::path& dest,
+                          fs::path& outOld, std::string& outErr)
+{
+    if (backend.Exchange(staged, dest))
+    {
+        outOld = staged;
+        return true;
+    }
+
+    std::string err;
+    const fs::path aside = StagingSibling(backend, dest);
+    if (!backend.Rename(dest, aside, err))
+    {
+        outErr = "Failed moving destination aside: " + err;
+        return false;
+    }
+
+    if (!backend.Rename(staged, dest, err))
+    {
+        std::string ignore;
+        backend.Rename(aside, dest, ignore);
+        outErr = "Failed replacing destination: " + err;
+        return false;
+    }
+
+    outOld = aside;
+    return true;
+}
+
+/*
+Function: FileSystemService::PasteTarget
+Description: Returns the path a paste will create: the source's name inside destDir, with .zst
+             added or removed when a single file is pasted compressed or decompressed.
+Parameters:
+  - clip: VirtualClipboard describing the source path.
+  - destDir: Directory that will receive the pasted item.
+  - opts: Paste options (only the transform is used).
+Returns:
+  - fs::path: Destination path of the pasted item.
+*/
+fs::path FileSystemService::PasteTarget(const VirtualClipboard& clip, const fs::path& destDir, const PasteOptions& opts) const
+{
+    const fs::path plain = destDir / clip.source.filename();
+    if (opts.transform == PasteTransform::None || clip.isCut) return plain;
+
+    FsStat st;
+    if (!m_backend->Stat(clip.source, false, st) || st.type != FsEntryType::File) return plain;
+    return TransformedName(plain, FileTransform(clip.source, opts.transform));
+}
+
+/*
+Function: FileSystemService::PasteInto
+Description: Convenience overload that pastes with the default options and only reports
+             success or failure.
+Parameters:
+  - clip: VirtualClipboard describing the source path and whether it is a cut (move) or copy.
+  - destDir: Directory that will receive the pasted item.
+  - overwriteExisting: If true, allow replacing an existing destination entry.
+  - outErr: Output string populated with an error message if paste fails; cleared on success.
+Returns:
+  - bool: true if the paste operation succeeded; false otherwise.
+*/
+bool FileSystemService::PasteInto(const VirtualClipboard& clip,
+                                 const fs::path& destDir,
+                                 bool overwriteExisting,
+                                 std::string& outErr) const
+{
+    PasteOptions opts;
+    opts.overwriteExisting = overwriteExisting;
+    PasteStats stats;
+    return PasteInto(clip, destDir, opts, stats, outErr);
+}
+
 /*
 Function: FileSystemService::PasteInto
 Description: Executes a copy or move operation from the virtual clipboard into the destination
              directory. If overwriteExisting is false and a target exists, the function fails with
              an explanatory error. When cut is set in the clipboard, the operation moves; otherwise
-             it copies. Handles directory vs file semantics using filesystem functions.
+             it copies. With staged set, the new data is first written (or moved) to a hidden
+             sibling, flushed in one batch, and atomically swapped with the destination, so a
+             failure at any point leaves the old destination intact; the replaced data is then
+             deleted by the background purger. Without staged, the destination is removed
+             before copying, as before. A source inside an archive is extracted directly to
+             the destination (copy only); archives cannot be pasted into. A copy can also
+             compress every file into name.zst or decompress name.zst files on the way
+             (see PasteTarget for the resulting name). A verified copy reads every copied file
+             back and fails, without replacing the destination, if any of them differs.
 Parameters:
   - clip: VirtualClipboard describing the source path and whether it is a cut (move) or copy.
   - destDir: Directory that will receive the pasted item.
-  - overwriteExisting: If true, allow replacing an existing destination entry.
+  - opts: Overwrite, staging, transform, verify and progress options.
+  - outStats: Output number of files and bytes copied.
   - outErr: Output string populated with an error message if paste fails; cleared on success.
 Returns:
   - bool: true if the paste operation succeeded; false otherwise.
 */
 bool FileSystemService::PasteInto(const VirtualClipboard& clip,
                                  const fs::path& destDir,
-                                 bool overwriteExisting,
+                                 const PasteOptions& opts,
+                                 PasteStats& outStats,
                                  std::string& outErr) const
 {
     outErr.clear();
+    outStats = PasteStats{};
     if (!clip.hasItem)
     {
         outErr = "Clipboard is empty.";
         return false;
     }
 
-    std::error_code ec;
-    if (!fs::exists(clip.source, ec))
+    // entries inside an archive are extracted straight from it
+    fs::path srcInner;
+    std::string vfsErr;
+    const std::shared_ptr<VfsProvider> srcVfs = ResolveVirtual(clip.source, srcInner, vfsErr);
+    const bool fromArchive = srcVfs && !srcInner.empty();
+
+    FileItem srcItem;
+    FsStat srcStat;
+    if (fromArchive ? !srcVfs->Stat(srcInner, srcItem) : !m_backend->Stat(clip.source, false, srcStat))
     {
         outErr = "Source no longer exists.";
         return false;
     }
+    if (fromArchive && clip.isCut)
+    {
+        outErr = "Items inside an archive cannot be moved; use Copy to extract them.";
+        return false;
+    }
+    if (opts.transform != PasteTransform::None)
+    {
+        if (!ZstdCopySupported())
+            outErr = "This build has no zstd support.";
+        else if (clip.isCut)
+            outErr = "Compressed and decompressed pastes only copy; use Copy instead of Cut.";
+        else if (fromArchive)
+            outErr = "Archive entries can only be pasted as they are.";
+        else if (!m_backend->IsLocal())
+            outErr = "Compressed paste needs a backend on the local filesystem.";
+        if (!outErr.empty()) return false;
+    }
+    if (opts.verify && !clip.isCut && !fromArchive && !m_backend->IsLocal())
+    {
+        outErr = "Verified paste needs a backend on the local filesystem.";
+        return false;
+    }
+
+    fs::path destInner;
+    if (ResolveVirtual(destDir, destInner, vfsErr))
+    {
+        outErr = "Archives are read-only.";
+        return false;
+    }
+
+    auto copySource = [&](const fs::path& to)
+    {
+        if (fromArchive) return srcVfs->Extract(srcInner, to, *m_scheduler, outStats, outErr);
+        if (!CopyTree(clip.source, to, *m_backend, *m_scheduler, opts, outStats, outErr)) return false;
+        if (outStats.verifyFailures.empty()) return true;
+
+        outErr = std::to_string(outStats.verifyFailures.size()) + " file(s) did not read back intact:";
+        for (std::size_t i = 0; i < outStats.verifyFailures.size() && i < 10; ++i)
+            outErr += "\n" + outStats.verifyFailures[i].string();
+        return false;
+    };
+
+    const fs::path dest = PasteTarget(clip, destDir, opts);
+
+    // Whatever happens below, the destination directory listing changes
+    InvalidateListing(destDir);
+    InvalidateListing(dest);
+
+    FsStat destStat;
+    const bool destExists = m_backend->Stat(dest, false, destStat);
+    if (destExists && !opts.overwriteExisting)
+    {
+        outErr = "Destination exists (overwrite not allowed).";
+        return false;
+    }
 
-    const fs::path dest = destDir / clip.source.filename();
+    if (clip.isCut)
+    {
+        InvalidateListing(clip.source.parent_path());
+        InvalidateListing(clip.source);
+    }
 
-    if (fs::exists(dest, ec))
+    if (!opts.staged)
     {
-        if (!overwriteExisting)
+        std::string err;
+        std::uintmax_t removed = 0;
+        if (destExists && !m_backend->RemoveAll(dest, removed, err))
         {
-            outErr = "Destination exists (overwrite not allowed).";
+            outErr = "Failed removing destination: " + err;
             return false;
         }
 
-        fs::remove_all(dest, ec);
-        if (ec)
+        if (clip.isCut)
         {
-            outErr = "Failed removing destination: " + ec.message();
-            return false;
+            if (!m_backend->Rename(clip.source, dest, err))
+            {
+                outErr = "Move failed: " + err;
+                return false;
+            }
+            return true;
         }
+
+        return copySource(dest);
     }
 
+    // Build the new entry under a hidden name next to the destination
+    const fs::path staged = StagingSibling(*m_backend, dest);
+    std::string err;
+    std::string ignore;
     if (clip.isCut)
     {
-        fs::rename(clip.source, dest, ec);
-        if (ec)
+        if (!m_backend->Rename(clip.source, staged, err))
         {
-            outErr = "Move failed: " + ec.message();
+            outErr = "Move failed: " + err;
             return false;
         }
-        return true;
+    }
+    else
+    {
+        if (!copySource(staged))
+        {
+            m_purger->Enqueue(staged);
+            return false;
+        }
+        FsStat stagedStat;
+        m_backend->Stat(staged, false, stagedStat);
+        m_backend->Flush(staged, stagedStat.type == FsEntryType::Directory);
     }
 
-    if (fs::is_directory(clip.source, ec))
+    if (!destExists)
     {
-        fs::copy(clip.source, dest, fs::copy_options::recursive, ec);
-        if (ec)
+        if (!m_backend->Rename(staged, dest, err))
         {
-            outErr = "Copy directory failed: " + ec.message();
+            outErr = "Failed moving staged copy into place: " + err;
+            if (clip.isCut)
+            {
+                m_backend->Rename(staged, clip.source, ignore);
+            }
+            else
+            {
+                m_purger->Enqueue(staged);
+            }
             return false;
         }
         return true;
     }
 
-    fs::copy_file(clip.source, dest, fs::copy_options::overwrite_existing, ec);
-    if (ec)
+    fs::path old;
+    if (!SwapIntoPlace(*m_backend, staged, dest, old, outErr))
     {
-        outErr = "Copy file failed: " + ec.message();
+        if (clip.isCut)
+        {
+            m_backend->Rename(staged, clip.source, ignore);
+        }
+        else
+        {
+            m_purger->Enqueue(staged);
+        }
         return false;
     }
 
+    m_purger->Enqueue(old);
     return true;
 }
 
 /*
 Function: FileSystemService::Exists
-Description: Convenience wrapper to check whether a path exists in the filesystem.
+Description: Convenience wrapper to check whether a path exists on the backend (following
+             symbolic links, so a dangling link does not count).
 Parameters:
   - p: Path to test.
 Returns:
   - bool: true if p exists; false otherwise.
 */
-bool FileSystemService::Exists(const fs::path& p)
+bool FileSystemService::Exists(const fs::path& p) const
 {
-    std::error_code ec;
-    return fs::exists(p, ec);
+    FsStat st;
+    return m_backend->Stat(p, true, st);
 }
 
 /*
 Function: FileSystemService::IsDirectory
-Description: Convenience wrapper to check whether a path refers to a directory.
+Description: Convenience wrapper to check whether a path refers to a directory (following
+             symlinks).
 Parameters:
   - p: Path to test.
 Returns:
   - bool: true if p is a directory; false otherwise.
 */
-bool FileSystemService::IsDirectory(const fs::path& p)
+bool FileSystemService::IsDirectory(const fs::path& p) const
 {
-    std::error_code ec;
-    return fs::is_directory(p, ec);
+    FsStat st;
+    return m_backend->Stat(p, true, st) && st.type == FsEntryType::Directory;
 }
 
 /*
@@ -321,9 +1386,7 @@ Parameters:
 Returns:
   - fs::path: Canonical path on success, otherwise the original path.
 */
-fs::path FileSystemService::CanonicalOrSame(const fs::path& p)
+fs::path FileSystemService::CanonicalOrSame(const fs::path& p) const
 {
-    std::error_code ec;
-    fs::path c = fs::canonical(p, ec);
-    return ec ? p : c;
+    return m_backend->Canonical(p);
 }
@@ -8,13 +8,26 @@ February 1, 2026
 #define FILESYSTEMSERVICE_H
 
 #include <filesystem>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <system_error>
 #include <ctime>
+#include <functional>
+#include <memory>
 
 namespace fs = std::filesystem;
 
+// Optional FileItem fields a listing can be asked for (bit flags, see SetDetailFields)
+static constexpr unsigned kDetailOwner = 1u << 0;       // uid, gid
+static constexpr unsigned kDetailMode = 1u << 1;        // type and permission bits
+static constexpr unsigned kDetailInode = 1u << 2;
+static constexpr unsigned kDetailLinks = 1u << 3;
+static constexpr unsigned kDetailAllocated = 1u << 4;   // bytes on disk (less than the size for sparse files)
+static constexpr unsigned kDetailBirthTime = 1u << 5;
+static constexpr unsigned kDetailAll = (1u << 6) - 1;
+
 // Model for one row in the UI listing 
 struct FileItem
 {
@@ -22,8 +35,87 @@ struct FileItem
     bool isDir = false;
     std::uintmax_t sizeBytes = 0;
     std::time_t modified = 0;
+
+    // Extended metadata; only the fields flagged in details were read
+    unsigned details = 0;
+    std::uint32_t uid = 0;
+    std::uint32_t gid = 0;
+    std::uint32_t mode = 0;
+    std::uint64_t inode = 0;
+    std::uint64_t links = 0;
+    std::uintmax_t allocatedBytes = 0;
+    std::time_t birthTime = 0;
+};
+
+// Immutable listing that tabs and the listing cache share without copying
+using DirectoryListing = std::shared_ptr<const std::vector<FileItem>>;
+
+// Receives a directory listing one chunk at a time. The sink may move entries out of the
+// chunk; the buffer is cleared and reused after the call returns. Returning false stops the
+// enumeration.
+using ListChunkSink = std::function<bool(std::vector<FileItem>& chunk)>;
+
+// Shown the entries of a listing read so far after every chunk; returning false stops it
+using ListProgressSink = std::function<bool(const std::vector<FileItem>& soFar)>;
+
+// Entries per chunk handed to a ListChunkSink
+static constexpr std::size_t kListChunkEntries = 512;
+
+// How file contents are changed while pasting a copy
+enum class PasteTransform
+{
+    None,
+    Compress,       // write every file as name.zst
+    Decompress      // expand every name.zst back to name
+};
+
+// Live counters a paste updates while it runs; safe to poll from another thread
+struct PasteProgress
+{
+    std::atomic<std::uint64_t> filesCopied{ 0 };
+    std::atomic<std::uint64_t> filesVerified{ 0 };
+    std::atomic<std::uint64_t> rawBytes{ 0 };           // uncompressed side of (de)compressed files
+    std::atomic<std::uint64_t> compressedBytes{ 0 };    // compressed side of (de)compressed files
+};
+
+// Options for FileSystemService::PasteInto
+struct PasteOptions
+{
+    bool overwriteExisting = false;
+    bool staged = true;         // build in a hidden sibling, then swap atomically
+    PasteTransform transform = PasteTransform::None;
+    int compressionLevel = 3;
+    bool verify = false;        // hash while copying, re-read the copies and compare
+    PasteProgress* progress = nullptr;
 };
 
+// Totals reported by FileSystemService::PasteInto
+struct PasteStats
+{
+    std::uintmax_t filesCopied = 0;
+    std::uintmax_t bytesCopied = 0;         // bytes written to the destination
+    std::uintmax_t rawBytes = 0;            // uncompressed bytes of (de)compressed files
+    std::uintmax_t compressedBytes = 0;     // compressed bytes of (de)compressed files
+    std::uintmax_t filesVerified = 0;
+    std::uintmax_t holeBytes = 0;           // holes of sparse files left unwritten
+    std::vector<fs::path> verifyFailures;   // source files whose copy did not read back intact
+};
+
+class FsBackend;
+struct RenameOp;
+struct TreeWalkOptions;
+struct TreeWalkCallbacks;
+struct TreeWalkStats;
+class ListingCache;
+class BackgroundPurger;
+class Trash;
+class IoScheduler;
+class VfsProvider;
+struct VfsMounts;
+
+// Opens a provider for a container file (e.g. an archive); nullptr and outErr on failure
+using VfsFactory = std::function<std::shared_ptr<VfsProvider>(const fs::path& file, std::string& outErr)>;
+
 // Virtual clipboard 
 struct VirtualClipboard
 {
@@ -39,24 +131,82 @@ struct VirtualClipboard
     }
 };
 
-// Filesystem operations used by the GUI
+// Filesystem operations used by the GUI, performed through a pluggable backend
 class FileSystemService final
 {
 public:
+    explicit FileSystemService(std::shared_ptr<FsBackend> backend = nullptr);
+
+    const FsBackend& Backend() const;
+
     std::vector<FileItem> ListDirectory(const fs::path& dir, std::string& outErr) const;
+    bool ListDirectoryStream(const fs::path& dir,
+                             const ListChunkSink& sink,
+                             std::string& outErr,
+                             std::size_t chunkSize = kListChunkEntries) const;
+    DirectoryListing ListDirectoryCached(const fs::path& dir,
+                                         bool allowCached,
+                                         std::string& outErr,
+                                         const ListProgressSink& onProgress = nullptr) const;
+    void InvalidateListing(const fs::path& dir) const;
+    DirectoryListing SnapshotListing(const fs::path& dir, fs::file_time_type& outStamp) const;
+    bool AdoptListing(const fs::path& dir, DirectoryListing listing, const fs::file_time_type& stamp) const;
+    void SetDetailFields(unsigned details);
+    unsigned DetailFields() const;
+
+    bool WalkTree(const fs::path& root,
+                  const TreeWalkOptions& opts,
+                  const TreeWalkCallbacks& callbacks,
+                  TreeWalkStats& outStats,
+                  std::string& outErr) const;
+
+    void RegisterProvider(const std::string& suffix, VfsFactory factory);
+    bool IsBrowsable(const fs::path& p) const;
+    bool IsInArchive(const fs::path& p) const;
+
+    bool CopyFile(const fs::path& src, const fs::path& dst, std::uintmax_t& outBytes, std::string& outErr) const;
+    IoScheduler& Scheduler() const;
 
     bool CreateDirectory(const fs::path& dir, const std::string& name, std::string& outErr) const;
     bool RenamePath(const fs::path& oldPath, const std::string& newName, std::string& outErr) const;
+    bool RenameBatch(const fs::path& dir, const std::vector<RenameOp>& ops, std::size_t& outDone, std::string& outErr) const;
     bool RemoveRecursive(const fs::path& target, std::uintmax_t& outRemovedCount, std::string& outErr) const;
+    bool HasTrash() const;
+    bool MoveToTrash(const fs::path& target, std::string& outErr) const;
+    bool UndoDelete(fs::path& outRestored, std::string& outErr) const;
 
+    fs::path PasteTarget(const VirtualClipboard& clip, const fs::path& destDir, const PasteOptions& opts) const;
     bool PasteInto(const VirtualClipboard& clip,
                    const fs::path& destDir,
                    bool overwriteExisting,
                    std::string& outErr) const;
+    bool PasteInto(const VirtualClipboard& clip,
+                   const fs::path& destDir,
+                   const PasteOptions& opts,
+                   PasteStats& outStats,
+                   std::string& outErr) const;
+
+    bool Exists(const fs::path& p) const;
+    bool IsDirectory(const fs::path& p) const;
+    fs::path CanonicalOrSame(const fs::path& p) const;
+
+private:
+    std::shared_ptr<VfsProvider> ResolveVirtual(const fs::path& p, fs::path& outInner, std::string& outErr) const;
 
-    static bool Exists(const fs::path& p);
-    static bool IsDirectory(const fs::path& p);
-    static fs::path CanonicalOrSame(const fs::path& p);
+    // Performs the actual filesystem operations
+    std::shared_ptr<FsBackend> m_backend;
+    // Shared by every tab and the preloader thread; internally synchronized
+    std::shared_ptr<ListingCache> m_cache;
+    // Deletes data replaced by staged pastes at idle priority
+    std::shared_ptr<BackgroundPurger> m_purger;
+    // Rename-based deletes with an undo journal; null when the backend is not local
+    std::shared_ptr<Trash> m_trash;
+    // Per-device concurrency and bandwidth control for bulk copies
+    std::shared_ptr<IoScheduler> m_scheduler;
+    // Registered container formats and the providers opened for them
+    std::shared_ptr<VfsMounts> m_vfs;
+    // kDetail* fields listings read in addition to name/type/size/date; read by the preloader too
+    std::atomic<unsigned> m_details{ 0 };
 };
 
 #endif // MAINFRAME_H
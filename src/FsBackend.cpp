@@ -0,0 +1,250 @@
+/*
+Parneet Baidwan - 251259638
+Description: This file contains the default implementations shared by filesystem backends and the factory that builds a backend from its name, as given on the command line or in the environment.
+February 1, 2026
+*/
+
+#include "FsBackend.h"
+#include "MemoryFsBackend.h"
+#include "PosixFdBackend.h"
+#include "StdFsBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+#include <unordered_set>
+
+/*
+Function: FsBackend::ListStream
+Description: Default for backends that can only list a directory at once: the full listing
+             is read with List and then handed out in chunks.
+Parameters:
+  - dir: Directory to enumerate.
+  - details: kDetail* fields to read.
+  - chunkSize: Maximum number of entries per chunk.
+  - sink: Receives the chunks; returning false stops early.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was listed (or the sink stopped early); false otherwise.
+*/
+bool FsBackend::ListStream(const fs::path& dir,
+                           unsigned details,
+                           std::size_t chunkSize,
+                           const ListChunkSink& sink,
+                           std::string& outErr) const
+{
+    std::vector<FileItem> items;
+    if (!List(dir, details, items, outErr)) return false;
+
+    if (chunkSize == 0) chunkSize = kListChunkEntries;
+    std::vector<FileItem> chunk;
+    chunk.reserve(std::min(chunkSize, items.size()));
+    for (std::size_t i = 0; i < items.size(); i += chunkSize)
+    {
+        const std::size_t end = std::min(items.size(), i + chunkSize);
+        chunk.assign(std::make_move_iterator(items.begin() + (long)i), std::make_move_iterator(items.begin() + (long)end));
+        if (!sink(chunk)) break;
+    }
+    return true;
+}
+
+/*
+Function: FsBackend::Exchange
+Description: Default for backends without an atomic exchange; callers then fall back to
+             moving the destination aside.
+Parameters:
+  - a: First entry.
+  - b: Second entry.
+Returns:
+  - bool: Always false.
+*/
+bool FsBackend::Exchange(const fs::path&, const fs::path&) const
+{
+    return false;
+}
+
+/*
+Function: FsBackend::RenameBatch
+Description: Default batch rename for backends without directory handles: every entry is
+             renamed by full path, and a target is checked for with Stat before it is used.
+Parameters:
+  - dir: Directory holding every entry of the batch.
+  - ops: Renames to apply, by entry name.
+  - outDone: Output number of entries that carry their new name.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if every rename was applied; false otherwise.
+*/
+bool FsBackend::RenameBatch(const fs::path& dir, const std::vector<RenameOp>& ops, std::size_t& outDone, std::string& outErr) const
+{
+    return ApplyRenameBatch(ops, [&](const std::string& from, const std::string& to, bool noReplace, std::string& err)
+    {
+        FsStat st;
+        if (noReplace && Stat(dir / to, false, st))
+        {
+            err = "File exists";
+            return false;
+        }
+        return Rename(dir / from, dir / to, err);
+    }, outDone, outErr);
+}
+
+/*
+Function: FsBackend::ApplyRenameBatch
+Description: Applies a batch of renames within one directory in two phases. A rename whose
+             target is not the old name of another entry of the batch is done directly;
+             every other entry is first moved to a temporary name, and once all entries have
+             left their old names the temporary names are renamed to the targets. Chains
+             (a to b, b to c) and cycles (a to b, b to a) therefore work, and no rename ever
+             replaces an existing entry. If the first phase fails, what it did is undone;
+             a failure in the second phase moves that entry back to its old name and the
+             remaining renames still go ahead.
+Parameters:
+  - ops: Renames to apply; every from and every to must be distinct.
+  - rename: Renames one entry of the directory.
+  - outDone: Output number of entries that carry their new name.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if every rename was applied; false otherwise.
+*/
+bool FsBackend::ApplyRenameBatch(const std::vector<RenameOp>& ops,
+                                 const RenameInDir& rename,
+                                 std::size_t& outDone,
+                                 std::string& outErr)
+{
+    outDone = 0;
+    outErr.clear();
+
+    std::unordered_set<std::string> sources;
+    sources.reserve(ops.size());
+    for (const RenameOp& op : ops) sources.insert(op.from);
+
+    // temporary name per op, empty for the ones renamed directly
+    const std::string tempPrefix = ".fm-rename-" +
+        std::to_string((long long)std::chrono::steady_clock::now().time_since_epoch().count()) + "-";
+    std::vector<std::string> parked(ops.size());
+
+    std::string err;
+    for (std::size_t i = 0; i < ops.size(); ++i)
+    {
+        const RenameOp& op = ops[i];
+        if (sources.count(op.to)) parked[i] = tempPrefix + std::to_string(i);
+        if (rename(op.from, parked[i].empty() ? op.to : parked[i], true, err))
+        {
+            if (parked[i].empty()) ++outDone;
+            continue;
+        }
+
+        outErr = "Cannot rename " + op.from + " to " + op.to + ": " + err;
+        std::size_t kept = 0;
+        for (std::size_t j = i; j-- > 0;)
+        {
+            const std::string& current = parked[j].empty() ? ops[j].to : parked[j];
+            std::string ignore;
+            if (rename(current, ops[j].from, true, ignore)) continue;
+
+            outErr += "\n" + ops[j].from + " is left as " + current;
+            if (parked[j].empty()) ++kept;
+        }
+        outDone = kept;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < ops.size(); ++i)
+    {
+        if (parked[i].empty()) continue;
+        if (rename(parked[i], ops[i].to, true, err))
+        {
+            ++outDone;
+            continue;
+        }
+
+        if (outErr.empty()) outErr = "Cannot rename " + ops[i].from + " to " + ops[i].to + ": " + err;
+        std::string ignore;
+        if (!rename(parked[i], ops[i].from, true, ignore))
+            outErr += "\n" + ops[i].from + " is left as " + parked[i];
+    }
+    return outErr.empty();
+}
+
+/*
+Function: FsBackend::Flush
+Description: Default for backends that cannot force data to stable storage.
+Parameters:
+  - p: Ignored.
+  - isDir: Ignored.
+Returns:
+  - None
+*/
+void FsBackend::Flush(const fs::path&, bool) const
+{
+}
+
+/*
+Function: MakeDefaultFsBackend
+Description: Returns the fastest backend available on this platform.
+Parameters:
+  - None
+Returns:
+  - std::shared_ptr<FsBackend>: posix-fd backend on Unix-like systems, std otherwise.
+*/
+std::shared_ptr<FsBackend> MakeDefaultFsBackend()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    return std::make_shared<PosixFdBackend>();
+#else
+    return std::make_shared<StdFsBackend>();
+#endif
+}
+
+/*
+Function: MakeFsBackend
+Description: Builds a backend from its name: "posix", "std", or
+             "memory[:<latency_us>[:<bytes_per_second>[:<directory>]]]". A memory backend
+             delays every call by the latency and every copy by its size at the given rate
+             (0 = instant); when a directory is given, its structure and file sizes are
+             mirrored into memory at the same path. It always contains the current working
+             directory, so the browser has somewhere to start.
+Parameters:
+  - spec: Backend name and options.
+  - outErr: Output string populated with an error message for an unknown name or a
+            directory that cannot be mirrored.
+Returns:
+  - std::shared_ptr<FsBackend>: Backend, or nullptr on error.
+*/
+std::shared_ptr<FsBackend> MakeFsBackend(const std::string& spec, std::string& outErr)
+{
+    const std::string name = spec.substr(0, spec.find(':'));
+    const std::string arg = spec.size() > name.size() ? spec.substr(name.size() + 1) : std::string();
+
+    if (name.empty() || name == "default") return MakeDefaultFsBackend();
+    if (name == "std") return std::make_shared<StdFsBackend>();
+#if defined(__unix__) || defined(__APPLE__)
+    if (name == "posix") return std::make_shared<PosixFdBackend>();
+#endif
+    if (name == "memory")
+    {
+        // latency:rate:directory; the directory is the rest, so it may itself contain ':'
+        const std::size_t rateAt = arg.find(':');
+        const std::size_t dirAt = rateAt == std::string::npos ? rateAt : arg.find(':', rateAt + 1);
+        const long long latencyUs = std::strtoll(arg.c_str(), nullptr, 10);
+        const unsigned long long rate = rateAt == std::string::npos
+                                            ? 0 : std::strtoull(arg.c_str() + rateAt + 1, nullptr, 10);
+
+        auto backend = std::make_shared<MemoryFsBackend>();
+        backend->SetLatency(std::chrono::microseconds(latencyUs < 0 ? 0 : latencyUs), rate);
+        if (dirAt != std::string::npos && dirAt + 1 < arg.size())
+        {
+            std::uintmax_t entries = 0;
+            if (!backend->SeedFrom(fs::path(arg.substr(dirAt + 1)), entries, outErr)) return nullptr;
+        }
+        std::error_code ec;
+        backend->CreateDirectories(fs::current_path(ec));
+        return backend;
+    }
+
+    outErr = "Unknown filesystem backend: " + name
+             + " (expected posix, std or memory[:latency_us[:bytes_per_second[:directory]]])";
+    return nullptr;
+}
@@ -0,0 +1,111 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the FsBackend interface, the set of primitive filesystem operations that FileSystemService is built on. Backends implement it with POSIX file-descriptor calls, with the portable C++17 filesystem library, or entirely in memory with configurable latency, so the same higher-level operations can run against each of them and be compared reproducibly.
+February 1, 2026
+*/
+
+#ifndef FSBACKEND_H
+#define FSBACKEND_H
+
+#include "FileSystemService.h"
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class IoScheduler;
+
+// Kind of filesystem entry reported by FsBackend::Stat
+enum class FsEntryType
+{
+    None,
+    File,
+    Directory,
+    Symlink,
+    Other
+};
+
+// Metadata of one entry
+struct FsStat
+{
+    FsEntryType type = FsEntryType::None;
+    std::uintmax_t sizeBytes = 0;
+    std::time_t modified = 0;
+    fs::file_time_type changeStamp{};   // only compared for equality (listing cache validation)
+};
+
+// One rename of a batch; both names are entries of the batch's directory
+struct RenameOp
+{
+    std::string from;
+    std::string to;
+};
+
+// Renames one entry of a batch's directory; noReplace fails instead of replacing an existing to
+using RenameInDir = std::function<bool(const std::string& from, const std::string& to, bool noReplace, std::string& outErr)>;
+
+// Primitive filesystem operations behind FileSystemService
+class FsBackend
+{
+public:
+    virtual ~FsBackend() = default;
+
+    virtual const char* Name() const = 0;
+
+    // Whether paths name real files, so archive browsing, sync and search can use them
+    virtual bool IsLocal() const { return true; }
+
+    // false if p does not exist; followLinks=false reports symlinks themselves
+    virtual bool Stat(const fs::path& p, bool followLinks, FsStat& out) const = 0;
+    virtual bool List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const = 0;
+    // Same entries as List, handed to sink in chunks of at most chunkSize
+    virtual bool ListStream(const fs::path& dir,
+                            unsigned details,
+                            std::size_t chunkSize,
+                            const ListChunkSink& sink,
+                            std::string& outErr) const;
+
+    // attributesFrom (optional) is an existing directory whose permissions are copied
+    virtual bool CreateDirectory(const fs::path& p, const fs::path& attributesFrom, std::string& outErr) const = 0;
+    virtual bool Rename(const fs::path& from, const fs::path& to, std::string& outErr) const = 0;
+    // Atomically swaps two entries; false if unsupported (callers fall back to renames)
+    virtual bool Exchange(const fs::path& a, const fs::path& b) const;
+    // Renames entries of one directory together; a target may be the old name of another
+    // entry of the batch, so chains and cycles work. outDone counts the finished renames.
+    virtual bool RenameBatch(const fs::path& dir, const std::vector<RenameOp>& ops, std::size_t& outDone, std::string& outErr) const;
+    virtual bool RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const = 0;
+
+    virtual bool CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const = 0;
+    virtual bool CopyFile(const fs::path& src,
+                          const fs::path& dst,
+                          IoScheduler& scheduler,
+                          std::uintmax_t& outBytes,
+                          std::uintmax_t& outHoleBytes,
+                          std::string& outErr) const = 0;
+
+    // Makes a newly written file or tree (and its directory entry) durable
+    virtual void Flush(const fs::path& p, bool isDir) const;
+
+    virtual fs::path Canonical(const fs::path& p) const = 0;
+
+protected:
+    // The two-phase batch rename behind every RenameBatch, on top of a per-entry rename
+    static bool ApplyRenameBatch(const std::vector<RenameOp>& ops,
+                                 const RenameInDir& rename,
+                                 std::size_t& outDone,
+                                 std::string& outErr);
+};
+
+// Backend used when none is chosen: posix-fd where available, std::filesystem otherwise
+std::shared_ptr<FsBackend> MakeDefaultFsBackend();
+
+// Builds a backend from "posix", "std" or "memory[:<latency_us>[:<bytes_per_second>[:<directory to mirror>]]]"
+std::shared_ptr<FsBackend> MakeFsBackend(const std::string& spec, std::string& outErr);
+
+#endif // FSBACKEND_H
@@ -0,0 +1,361 @@
+/*
+Parneet Baidwan - 251259638
+Description: The IoScheduler class implementation in this file admits bulk I/O jobs per block device and paces their transfers. Each device starts with a concurrency limit chosen from whether it is rotational, then hill-climbs: once per second of saturated use the limit moves one step in the current direction and reverses when measured throughput drops. A token bucket shared by all jobs on a device enforces the user's bandwidth cap.
+February 1, 2026
+*/
+
+#include "IoScheduler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+#if defined(__linux__)
+#include <sys/sysmacros.h>
+#endif
+
+namespace
+{
+    constexpr auto kWindow = std::chrono::seconds(1);
+    constexpr double kBurstSeconds = 0.25;
+
+    // Limits used until throughput measurements take over
+    constexpr unsigned kRotationalStart = 1;
+    constexpr unsigned kRotationalMax = 4;
+    constexpr unsigned kSolidStateStart = 4;
+    constexpr unsigned kSolidStateMax = 32;
+
+    /*
+    Function: IsRotational
+    Description: Asks sysfs whether the block device behind a device id is a spinning disk.
+                 Partitions are resolved to their parent disk. Unknown devices (network and
+                 virtual filesystems, non-Linux systems) are treated as solid state.
+    Parameters:
+      - device: Device id from st_dev.
+    Returns:
+      - bool: true if the device reports itself as rotational.
+    */
+    bool IsRotational(DeviceId device)
+    {
+#if defined(__linux__)
+        const std::string base = "/sys/dev/block/" + std::to_string(major((dev_t)device)) + ":" +
+                                 std::to_string(minor((dev_t)device));
+        for (const char* suffix : { "/queue/rotational", "/../queue/rotational" })
+        {
+            std::ifstream in(base + suffix);
+            int value = 0;
+            if (in >> value) return value != 0;
+        }
+#else
+        (void)device;
+#endif
+        return false;
+    }
+}
+
+/*
+Function: IoScheduler::Ticket::Ticket
+Description: Move constructor; the moved-from ticket no longer owns any slots.
+Parameters:
+  - other: Ticket to take the slots from.
+Returns:
+  - None
+*/
+IoScheduler::Ticket::Ticket(Ticket&& other) noexcept
+    : m_owner(other.m_owner), m_devices(std::move(other.m_devices))
+{
+    other.m_owner = nullptr;
+    other.m_devices.clear();
+}
+
+/*
+Function: IoScheduler::Ticket::operator=
+Description: Move assignment; releases the slots currently held first.
+Parameters:
+  - other: Ticket to take the slots from.
+Returns:
+  - Ticket&: This ticket.
+*/
+IoScheduler::Ticket& IoScheduler::Ticket::operator=(Ticket&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_owner) m_owner->Release(m_devices);
+        m_owner = other.m_owner;
+        m_devices = std::move(other.m_devices);
+        other.m_owner = nullptr;
+        other.m_devices.clear();
+    }
+    return *this;
+}
+
+/*
+Function: IoScheduler::Ticket::~Ticket
+Description: Releases the device slots held by the ticket.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+IoScheduler::Ticket::~Ticket()
+{
+    if (m_owner) m_owner->Release(m_devices);
+}
+
+/*
+Function: IoScheduler::DeviceOf
+Description: Maps a path to the device that stores it. A path that does not exist yet is
+             resolved through its nearest existing parent.
+Parameters:
+  - p: Path to look up.
+Returns:
+  - DeviceId: st_dev of the path (0 if unknown).
+*/
+DeviceId IoScheduler::DeviceOf(const fs::path& p)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    fs::path probe = p;
+    for (;;)
+    {
+        struct stat st{};
+        if (::stat(probe.c_str(), &st) == 0) return (DeviceId)st.st_dev;
+        if (!probe.has_parent_path() || probe.parent_path() == probe) return 0;
+        probe = probe.parent_path();
+    }
+#else
+    (void)p;
+    return 0;
+#endif
+}
+
+/*
+Function: IoScheduler::StateLocked
+Description: Returns the scheduling state of a device, creating it with limits chosen from the
+             device type on first use. Caller must hold m_mutex.
+Parameters:
+  - device: Device id.
+Returns:
+  - DeviceState&: State of the device.
+*/
+IoScheduler::DeviceState& IoScheduler::StateLocked(DeviceId device)
+{
+    auto it = m_devices.find(device);
+    if (it != m_devices.end()) return *it->second;
+
+    auto st = std::make_unique<DeviceState>();
+    st->rotational = IsRotational(device);
+    st->limit = st->rotational ? kRotationalStart : kSolidStateStart;
+    st->maxLimit = st->rotational ? kRotationalMax : kSolidStateMax;
+    return *m_devices.emplace(device, std::move(st)).first->second;
+}
+
+/*
+Function: IoScheduler::Acquire
+Description: Blocks until every listed device has a free slot, then takes one slot on each.
+             All slots are taken together under one lock, so jobs touching two devices (e.g.
+             a copy between disks) cannot deadlock each other.
+Parameters:
+  - devices: Devices the job will read from or write to (duplicates are ignored).
+Returns:
+  - Ticket: Holds the slots until destroyed.
+*/
+IoScheduler::Ticket IoScheduler::Acquire(std::vector<DeviceId> devices)
+{
+    std::sort(devices.begin(), devices.end());
+    devices.erase(std::unique(devices.begin(), devices.end()), devices.end());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        bool free = true;
+        for (DeviceId d : devices)
+        {
+            DeviceState& st = StateLocked(d);
+            if (st.active >= st.limit)
+            {
+                st.windowSaturated = true;
+                free = false;
+            }
+        }
+        if (free) break;
+        m_slotFreed.wait(lock);
+    }
+
+    for (DeviceId d : devices)
+    {
+        DeviceState& st = StateLocked(d);
+        if (++st.active >= st.limit) st.windowSaturated = true;
+    }
+
+    Ticket t;
+    t.m_owner = this;
+    t.m_devices = std::move(devices);
+    return t;
+}
+
+/*
+Function: IoScheduler::Release
+Description: Returns a ticket's slots and wakes waiting jobs.
+Parameters:
+  - devices: Devices whose slots are released.
+Returns:
+  - None
+*/
+void IoScheduler::Release(const std::vector<DeviceId>& devices)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (DeviceId d : devices)
+        {
+            DeviceState& st = StateLocked(d);
+            if (st.active > 0) --st.active;
+        }
+    }
+    m_slotFreed.notify_all();
+}
+
+/*
+Function: IoScheduler::AdaptLocked
+Description: Closes a measurement window and tunes the device's concurrency limit. Only
+             windows in which the limit was actually reached count: the limit keeps moving in
+             the same direction while throughput improves by more than 5% and reverses when
+             it falls by more than 5%. Caller must hold m_mutex.
+Parameters:
+  - st: Device state.
+  - now: Current time.
+Returns:
+  - None
+*/
+void IoScheduler::AdaptLocked(DeviceState& st, std::chrono::steady_clock::time_point now)
+{
+    const double seconds = std::chrono::duration<double>(now - st.windowStart).count();
+    const double throughput = seconds > 0 ? (double)st.windowBytes / seconds : 0.0;
+
+    // A capped device is limited by the cap, not by concurrency
+    if (st.windowSaturated && m_bandwidthLimit == 0)
+    {
+        if (st.lastThroughput > 0 && throughput < st.lastThroughput * 0.95)
+            st.direction = -st.direction;
+
+        if (st.lastThroughput == 0 || throughput > st.lastThroughput * 1.05 || throughput < st.lastThroughput * 0.95)
+        {
+            const int next = (int)st.limit + st.direction;
+            st.limit = (unsigned)std::clamp(next, 1, (int)st.maxLimit);
+        }
+    }
+
+    st.lastThroughput = throughput;
+    st.windowStart = now;
+    st.windowBytes = 0;
+    st.windowSaturated = st.active >= st.limit;
+    m_slotFreed.notify_all();
+}
+
+/*
+Function: IoScheduler::Transfer
+Description: Accounts for bytes moved on a device. Feeds the throughput measurement and, when
+             a bandwidth cap is set, sleeps the calling thread long enough to keep the device
+             at or below the cap.
+Parameters:
+  - device: Device the bytes were read from or written to.
+  - bytes: Number of bytes just transferred.
+Returns:
+  - None
+*/
+void IoScheduler::Transfer(DeviceId device, std::uint64_t bytes)
+{
+    double waitSeconds = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DeviceState& st = StateLocked(device);
+        const auto now = std::chrono::steady_clock::now();
+
+        st.windowBytes += bytes;
+        if (now - st.windowStart >= kWindow) AdaptLocked(st, now);
+
+        if (m_bandwidthLimit > 0)
+        {
+            const double rate = (double)m_bandwidthLimit;
+            const double elapsed = std::chrono::duration<double>(now - st.refillTime).count();
+            st.refillTime = now;
+            st.tokens = std::min(st.tokens + elapsed * rate, rate * kBurstSeconds);
+            st.tokens -= (double)bytes;
+            if (st.tokens < 0) waitSeconds = -st.tokens / rate;
+        }
+    }
+
+    if (waitSeconds > 0)
+        std::this_thread::sleep_for(std::chrono::duration<double>(waitSeconds));
+}
+
+/*
+Function: IoScheduler::SetBandwidthLimit
+Description: Sets the bandwidth cap applied to each device.
+Parameters:
+  - bytesPerSecond: Cap in bytes per second; 0 removes the cap.
+Returns:
+  - None
+*/
+void IoScheduler::SetBandwidthLimit(std::uint64_t bytesPerSecond)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bandwidthLimit = bytesPerSecond;
+    for (auto& entry : m_devices)
+    {
+        entry.second->tokens = 0.0;
+        entry.second->refillTime = std::chrono::steady_clock::now();
+    }
+}
+
+/*
+Function: IoScheduler::BandwidthLimit
+Description: Returns the current per-device bandwidth cap.
+Parameters:
+  - None
+Returns:
+  - std::uint64_t: Cap in bytes per second (0 = unlimited).
+*/
+std::uint64_t IoScheduler::BandwidthLimit() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bandwidthLimit;
+}
+
+/*
+Function: IoScheduler::MaxParallelism
+Description: Upper bound on useful worker threads for a bulk job: the largest concurrency any
+             device could be tuned to. Workers beyond a device's current limit simply wait
+             in Acquire.
+Parameters:
+  - None
+Returns:
+  - unsigned: Number of worker threads to start.
+*/
+unsigned IoScheduler::MaxParallelism() const
+{
+    return kSolidStateMax;
+}
+
+/*
+Function: IoScheduler::Devices
+Description: Returns the scheduling state of every device seen so far.
+Parameters:
+  - None
+Returns:
+  - std::vector<DeviceIoInfo>: One snapshot per device.
+*/
+std::vector<DeviceIoInfo> IoScheduler::Devices() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<DeviceIoInfo> out;
+    out.reserve(m_devices.size());
+    for (const auto& entry : m_devices)
+    {
+        const DeviceState& st = *entry.second;
+        out.push_back(DeviceIoInfo{ entry.first, st.rotational, st.limit, st.active, st.lastThroughput });
+    }
+    return out;
+}
@@ -0,0 +1,99 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the IoScheduler class which every bulk copy goes through. Paths are mapped to their block device with st_dev, and each device gets its own concurrency limit (tuned automatically from measured throughput, starting lower for rotational disks) and an optional bandwidth cap, so copies to a spinning disk do not thrash it while copies to NVMe still run wide.
+February 1, 2026
+*/
+
+#ifndef IOSCHEDULER_H
+#define IOSCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Identifies a block device (st_dev on POSIX)
+using DeviceId = std::uint64_t;
+
+// Snapshot of one device's scheduling state, for display
+struct DeviceIoInfo
+{
+    DeviceId device = 0;
+    bool rotational = false;
+    unsigned concurrency = 0;
+    unsigned active = 0;
+    double bytesPerSecond = 0.0;
+};
+
+// Per-device admission control and bandwidth limiting for bulk I/O
+class IoScheduler final
+{
+public:
+    // Held while a job runs; releases its device slots when destroyed
+    class Ticket final
+    {
+    public:
+        Ticket() = default;
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&& other) noexcept;
+        ~Ticket();
+
+    private:
+        friend class IoScheduler;
+        IoScheduler* m_owner = nullptr;
+        std::vector<DeviceId> m_devices;
+    };
+
+    IoScheduler() = default;
+    IoScheduler(const IoScheduler&) = delete;
+    IoScheduler& operator=(const IoScheduler&) = delete;
+
+    static DeviceId DeviceOf(const fs::path& p);
+
+    Ticket Acquire(std::vector<DeviceId> devices);
+    void Transfer(DeviceId device, std::uint64_t bytes);
+
+    void SetBandwidthLimit(std::uint64_t bytesPerSecond);
+    std::uint64_t BandwidthLimit() const;
+
+    unsigned MaxParallelism() const;
+    std::vector<DeviceIoInfo> Devices() const;
+
+private:
+    struct DeviceState
+    {
+        bool rotational = false;
+        unsigned limit = 1;
+        unsigned maxLimit = 1;
+        unsigned active = 0;
+        int direction = 1;
+
+        // throughput measurement window
+        std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+        std::uint64_t windowBytes = 0;
+        bool windowSaturated = false;
+        double lastThroughput = 0.0;
+
+        // bandwidth token bucket
+        std::chrono::steady_clock::time_point refillTime = std::chrono::steady_clock::now();
+        double tokens = 0.0;
+    };
+
+    DeviceState& StateLocked(DeviceId device);
+    void Release(const std::vector<DeviceId>& devices);
+    void AdaptLocked(DeviceState& st, std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_slotFreed;
+    std::unordered_map<DeviceId, std::unique_ptr<DeviceState>> m_devices;
+    std::uint64_t m_bandwidthLimit = 0;
+};
+
+#endif // IOSCHEDULER_H
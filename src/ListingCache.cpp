@@ -0,0 +1,186 @@
+/*
+Parneet Baidwan - 251259638
+Description: The ListingCache class implementation in this file keeps recently enumerated directory listings in memory. Lookups are validated against the directory modification time, the least recently used listings are evicted once the total entry budget is exceeded, and every method is guarded by a mutex so the UI thread and the preloader can use it concurrently.
+February 1, 2026
+*/
+
+#include "ListingCache.h"
+
+// Size hints kept; the table starts over when it fills up
+static constexpr std::size_t kMaxSizeHints = 4096;
+
+/*
+Function: ListingCache::ListingCache
+Description: Creates an empty cache that holds at most maxItems FileItem entries across all
+             cached directories (the most recent listing is always kept).
+Parameters:
+  - maxItems: Budget for the total number of cached entries.
+Returns:
+  - None
+*/
+ListingCache::ListingCache(std::size_t maxItems)
+    : m_maxItems(maxItems)
+{
+}
+
+/*
+Function: ListingCache::Lookup
+Description: Returns the cached listing for dir if one exists, was read at the same
+             directory modification time and carries at least the requested extended fields.
+             A stale entry is dropped. A hit marks the entry as most recently used.
+Parameters:
+  - dir: Directory whose listing is requested.
+  - currentMtime: Current last_write_time of the directory.
+  - details: kDetail* fields the caller needs.
+Returns:
+  - DirectoryListing: Cached listing, or nullptr on a miss.
+*/
+DirectoryListing ListingCache::Lookup(const fs::path& dir, const fs::file_time_type& currentMtime, unsigned details)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(dir.string());
+    if (it == m_entries.end()) return nullptr;
+
+    if (it->second.mtime != currentMtime)
+    {
+        m_itemCount -= it->second.listing->size();
+        m_lru.erase(it->second.lruPos);
+        m_entries.erase(it);
+        return nullptr;
+    }
+
+    // read with fewer columns than are shown now; the caller re-lists and replaces it
+    if ((it->second.details & details) != details) return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+    return it->second.listing;
+}
+
+/*
+Function: ListingCache::Store
+Description: Inserts or replaces the listing for dir, records its size as the directory's
+             size hint and evicts least recently used listings until the entry budget is
+             respected again.
+Parameters:
+  - dir: Directory the listing belongs to.
+  - listing: Enumerated entries (must not be null).
+  - mtime: last_write_time of the directory taken before enumeration started.
+  - details: kDetail* fields the listing was read with.
+Returns:
+  - None
+*/
+void ListingCache::Store(const fs::path& dir, DirectoryListing listing, const fs::file_time_type& mtime, unsigned details)
+{
+    if (!listing) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::string key = dir.string();
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        m_itemCount -= it->second.listing->size();
+        m_lru.erase(it->second.lruPos);
+        m_entries.erase(it);
+    }
+
+    if (m_sizeHints.size() >= kMaxSizeHints && !m_sizeHints.count(key)) m_sizeHints.clear();
+    m_sizeHints[key] = listing->size();
+
+    m_lru.push_front(key);
+    m_itemCount += listing->size();
+    m_entries.emplace(key, Entry{ std::move(listing), mtime, details, m_lru.begin() });
+
+    EvictLocked();
+}
+
+/*
+Function: ListingCache::Invalidate
+Description: Removes the listing for dir, if cached. Called after any operation that changes
+             the directory so the next lookup re-enumerates it.
+Parameters:
+  - dir: Directory whose cached listing should be dropped.
+Returns:
+  - None
+*/
+void ListingCache::Invalidate(const fs::path& dir)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(dir.string());
+    if (it == m_entries.end()) return;
+
+    m_itemCount -= it->second.listing->size();
+    m_lru.erase(it->second.lruPos);
+    m_entries.erase(it);
+}
+
+/*
+Function: ListingCache::Contains
+Description: Checks whether a listing for dir is cached, without validating or touching it.
+Parameters:
+  - dir: Directory to test.
+Returns:
+  - bool: true if an entry exists for dir; false otherwise.
+*/
+bool ListingCache::Contains(const fs::path& dir) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.count(dir.string()) != 0;
+}
+
+/*
+Function: ListingCache::SizeHint
+Description: Returns how many entries the last listing stored for dir had, even if that
+             listing has since gone stale, been invalidated or been evicted. Used to reserve
+             room before the directory is enumerated again.
+Parameters:
+  - dir: Directory about to be enumerated.
+Returns:
+  - std::size_t: Entry count of the last listing, or 0 if none was stored recently.
+*/
+std::size_t ListingCache::SizeHint(const fs::path& dir) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_sizeHints.find(dir.string());
+    return it == m_sizeHints.end() ? 0 : it->second;
+}
+
+/*
+Function: ListingCache::Clear
+Description: Drops every cached listing and size hint.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ListingCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_sizeHints.clear();
+    m_itemCount = 0;
+}
+
+/*
+Function: ListingCache::EvictLocked
+Description: Evicts least recently used listings while the entry budget is exceeded. The
+             most recently stored listing is never evicted. Caller must hold m_mutex.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ListingCache::EvictLocked()
+{
+    while (m_itemCount > m_maxItems && m_lru.size() > 1)
+    {
+        auto it = m_entries.find(m_lru.back());
+        m_itemCount -= it->second.listing->size();
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+}
@@ -0,0 +1,54 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the ListingCache class, a thread-safe store of recent directory listings shared by every tab and by the background preloader. Each cached listing remembers the directory modification time it was read at so a stale entry is detected with a single stat, and the cache is bounded by the total number of entries it holds. The entry count of every directory's last listing is kept after the listing itself is dropped, so a re-enumeration can size its vector up front.
+February 1, 2026
+*/
+
+#ifndef LISTINGCACHE_H
+#define LISTINGCACHE_H
+
+#include "FileSystemService.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Least-recently-used cache of directory listings keyed by path
+class ListingCache final
+{
+public:
+    explicit ListingCache(std::size_t maxItems = 500000);
+
+    DirectoryListing Lookup(const fs::path& dir, const fs::file_time_type& currentMtime, unsigned details = 0);
+    void Store(const fs::path& dir, DirectoryListing listing, const fs::file_time_type& mtime, unsigned details = 0);
+    void Invalidate(const fs::path& dir);
+    bool Contains(const fs::path& dir) const;
+    std::size_t SizeHint(const fs::path& dir) const;
+    void Clear();
+
+private:
+    struct Entry
+    {
+        DirectoryListing listing;
+        fs::file_time_type mtime;
+        unsigned details;       // kDetail* fields the listing was read with
+        std::list<std::string>::iterator lruPos;
+    };
+
+    void EvictLocked();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;
+    std::size_t m_itemCount = 0;
+    std::size_t m_maxItems;
+
+    // entry count of the last listing stored per directory; outlives stale and evicted entries
+    std::unordered_map<std::string, std::size_t> m_sizeHints;
+};
+
+#endif // LISTINGCACHE_H
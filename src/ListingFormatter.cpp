@@ -0,0 +1,310 @@
+/*
+Parneet Baidwan - 251259638
+Description: The ListingFormatter class implementation in this file produces the size and date strings for the listing. Dates are split into a cached localized prefix (day, month, year and hour) and a minute/second suffix computed with plain arithmetic, and sizes use std::to_chars instead of printf-style formatting.
+February 1, 2026
+*/
+
+#include "ListingFormatter.h"
+
+#include <charconv>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <grp.h>
+#include <pwd.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // All real time zone offsets and daylight saving transitions fall on quarter hours
+    constexpr std::time_t kBucketSeconds = 15 * 60;
+
+    // Bound on the number of cached prefixes before the cache is dropped
+    constexpr std::size_t kMaxPrefixes = 4096;
+
+    const char* const kDatePrefixFormat = "%A, %B %d, %Y %H:";
+    const char* const kDateFullFormat = "%A, %B %d, %Y %H:%M:%S";
+
+    void AppendTwoDigits(std::string& out, int v)
+    {
+        out.push_back(static_cast<char>('0' + v / 10));
+        out.push_back(static_cast<char>('0' + v % 10));
+    }
+
+    bool LocalTime(std::time_t t, std::tm& out)
+    {
+#if defined(_WIN32)
+        return localtime_s(&out, &t) == 0;
+#else
+        return localtime_r(&t, &out) != nullptr;
+#endif
+    }
+
+    std::string StrFTime(const char* format, const std::tm& tm)
+    {
+        char buf[128];
+        const std::size_t n = std::strftime(buf, sizeof(buf), format, &tm);
+        return std::string(buf, n);
+    }
+}
+
+/*
+Function: ListingFormatter::PrefixFor
+Description: Returns the cached localized prefix for the quarter hour starting at bucketStart,
+             computing it on first use. A bucket is only marked cacheable when its first and
+             last second are in the same local hour and start on a quarter-hour minute, so a
+             daylight saving change or an unusual offset falls back to full formatting.
+Parameters:
+  - bucketStart: First second of the bucket (multiple of 900 seconds since the epoch).
+Returns:
+  - const DatePrefix&: Cached prefix entry for the bucket.
+*/
+const ListingFormatter::DatePrefix& ListingFormatter::PrefixFor(std::time_t bucketStart)
+{
+    auto it = m_prefixes.find(bucketStart);
+    if (it != m_prefixes.end()) return it->second;
+
+    if (m_prefixes.size() >= kMaxPrefixes) m_prefixes.clear();
+
+    DatePrefix prefix;
+    std::tm first{};
+    std::tm last{};
+    if (LocalTime(bucketStart, first) && LocalTime(bucketStart + kBucketSeconds - 1, last))
+    {
+        prefix.cacheable = first.tm_sec == 0 &&
+                           first.tm_min % 15 == 0 &&
+                           last.tm_hour == first.tm_hour &&
+                           last.tm_min == first.tm_min + 14 &&
+                           last.tm_sec == 59;
+        if (prefix.cacheable)
+        {
+            prefix.text = StrFTime(kDatePrefixFormat, first);
+            prefix.firstMinute = first.tm_min;
+        }
+    }
+
+    return m_prefixes.emplace(bucketStart, std::move(prefix)).first->second;
+}
+
+/*
+Function: ListingFormatter::FormatDate
+Description: Formats a timestamp as "Weekday, Month dd, yyyy HH:MM:SS" in local time, matching
+             the previous wxDateTime output. The localized part comes from the prefix cache and
+             only the minutes and seconds are computed per call.
+Parameters:
+  - t: Timestamp to format; values <= 0 produce an empty string.
+Returns:
+  - const std::string&: Formatted text, valid until the next FormatDate call.
+*/
+const std::string& ListingFormatter::FormatDate(std::time_t t)
+{
+    m_dateBuf.clear();
+    if (t <= 0) return m_dateBuf;
+
+    const std::time_t bucketStart = t - t % kBucketSeconds;
+    const DatePrefix& prefix = PrefixFor(bucketStart);
+
+    if (!prefix.cacheable)
+    {
+        std::tm tm{};
+        if (LocalTime(t, tm)) m_dateBuf = StrFTime(kDateFullFormat, tm);
+        return m_dateBuf;
+    }
+
+    const int offset = static_cast<int>(t - bucketStart);
+    m_dateBuf.append(prefix.text);
+    AppendTwoDigits(m_dateBuf, prefix.firstMinute + offset / 60);
+    m_dateBuf.push_back(':');
+    AppendTwoDigits(m_dateBuf, offset % 60);
+    return m_dateBuf;
+}
+
+/*
+Function: ListingFormatter::FormatSize
+Description: Formats a byte count either as a plain integer or, when human-readable sizes are
+             enabled, as a value with one decimal and a binary unit (e.g. "1.5 MB").
+Parameters:
+  - bytes: Size in bytes.
+Returns:
+  - const std::string&: Formatted text, valid until the next FormatSize call.
+*/
+const std::string& ListingFormatter::FormatSize(std::uintmax_t bytes)
+{
+    char buf[32];
+
+    if (!m_humanReadable || bytes < 1024)
+    {
+        const auto res = std::to_chars(buf, buf + sizeof(buf), bytes);
+        m_sizeBuf.assign(buf, res.ptr);
+        if (m_humanReadable) m_sizeBuf.append(" B");
+        return m_sizeBuf;
+    }
+
+    static const char* const kUnits[] = { "KB", "MB", "GB", "TB", "PB", "EB" };
+
+    // Scale in tenths so the decimal digit comes from integer math
+    std::size_t unit = 0;
+    std::uintmax_t scaled = bytes;
+    while (scaled >= 1024 * 1024 && unit + 1 < sizeof(kUnits) / sizeof(kUnits[0]))
+    {
+        scaled /= 1024;
+        ++unit;
+    }
+    std::uintmax_t tenths = (scaled * 10 + 512) / 1024;
+
+    // 1023.95 KB and up rounds to "1024.0"; show it as "1.0" of the next unit instead
+    if (tenths >= 10240 && unit + 1 < sizeof(kUnits) / sizeof(kUnits[0]))
+    {
+        scaled /= 1024;
+        ++unit;
+        tenths = (scaled * 10 + 512) / 1024;
+    }
+
+    auto res = std::to_chars(buf, buf + sizeof(buf), tenths / 10);
+    *res.ptr++ = '.';
+    *res.ptr++ = static_cast<char>('0' + tenths % 10);
+    m_sizeBuf.assign(buf, res.ptr);
+    m_sizeBuf.push_back(' ');
+    m_sizeBuf.append(kUnits[unit]);
+    return m_sizeBuf;
+}
+
+/*
+Function: ListingFormatter::FormatNumber
+Description: Formats an unsigned integer (inode number, link count) without locale grouping.
+Parameters:
+  - value: Number to format.
+Returns:
+  - const std::string&: Formatted text, valid until the next detail formatting call.
+*/
+const std::string& ListingFormatter::FormatNumber(std::uint64_t value)
+{
+    char buf[32];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    m_detailBuf.assign(buf, res.ptr);
+    return m_detailBuf;
+}
+
+/*
+Function: ListingFormatter::UserName
+Description: Returns the account name for a user id, looking it up with getpwuid_r the first
+             time the id is seen and remembering the answer (or the number itself when the
+             id has no account), so a directory owned by one user costs one lookup.
+Parameters:
+  - uid: Numeric user id.
+Returns:
+  - const std::string&: Cached name.
+*/
+const std::string& ListingFormatter::UserName(std::uint32_t uid)
+{
+    auto it = m_users.find(uid);
+    if (it != m_users.end()) return it->second;
+
+    std::string name;
+#if defined(__unix__) || defined(__APPLE__)
+    long bufSize = ::sysconf(_SC_GETPW_R_SIZE_MAX);
+    std::vector<char> buf(bufSize > 0 ? (std::size_t)bufSize : 4096);
+    struct passwd pw{};
+    struct passwd* found = nullptr;
+    if (::getpwuid_r((uid_t)uid, &pw, buf.data(), buf.size(), &found) == 0 && found && found->pw_name)
+        name = found->pw_name;
+#endif
+    if (name.empty()) name = std::to_string(uid);
+    return m_users.emplace(uid, std::move(name)).first->second;
+}
+
+/*
+Function: ListingFormatter::GroupName
+Description: Returns the group name for a group id, cached the same way as UserName.
+Parameters:
+  - gid: Numeric group id.
+Returns:
+  - const std::string&: Cached name.
+*/
+const std::string& ListingFormatter::GroupName(std::uint32_t gid)
+{
+    auto it = m_groups.find(gid);
+    if (it != m_groups.end()) return it->second;
+
+    std::string name;
+#if defined(__unix__) || defined(__APPLE__)
+    long bufSize = ::sysconf(_SC_GETGR_R_SIZE_MAX);
+    std::vector<char> buf(bufSize > 0 ? (std::size_t)bufSize : 4096);
+    struct group gr{};
+    struct group* found = nullptr;
+    if (::getgrgid_r((gid_t)gid, &gr, buf.data(), buf.size(), &found) == 0 && found && found->gr_name)
+        name = found->gr_name;
+#endif
+    if (name.empty()) name = std::to_string(gid);
+    return m_groups.emplace(gid, std::move(name)).first->second;
+}
+
+/*
+Function: ListingFormatter::FormatOwner
+Description: Formats the owner column as "user:group" from cached account names.
+Parameters:
+  - uid: Numeric user id.
+  - gid: Numeric group id.
+Returns:
+  - const std::string&: Formatted text, valid until the next detail formatting call.
+*/
+const std::string& ListingFormatter::FormatOwner(std::uint32_t uid, std::uint32_t gid)
+{
+    m_detailBuf = UserName(uid);
+    m_detailBuf.push_back(':');
+    m_detailBuf.append(GroupName(gid));
+    return m_detailBuf;
+}
+
+/*
+Function: ListingFormatter::FormatMode
+Description: Formats st_mode-style bits the way ls -l does, e.g. "drwxr-xr-x", including the
+             setuid, setgid and sticky markers.
+Parameters:
+  - mode: File type and permission bits.
+Returns:
+  - const std::string&: Formatted text, valid until the next detail formatting call.
+*/
+const std::string& ListingFormatter::FormatMode(std::uint32_t mode)
+{
+    char text[10];
+    switch (mode & 0170000)
+    {
+    case 0040000: text[0] = 'd'; break;
+    case 0120000: text[0] = 'l'; break;
+    case 0020000: text[0] = 'c'; break;
+    case 0060000: text[0] = 'b'; break;
+    case 0010000: text[0] = 'p'; break;
+    case 0140000: text[0] = 's'; break;
+    default:      text[0] = '-'; break;
+    }
+
+    static const char kRwx[] = "rwxrwxrwx";
+    for (int i = 0; i < 9; ++i)
+        text[1 + i] = (mode & (0400u >> i)) ? kRwx[i] : '-';
+
+    // setuid/setgid/sticky replace the execute letter: lower case if also executable
+    if (mode & 04000) text[3] = (mode & 0100) ? 's' : 'S';
+    if (mode & 02000) text[6] = (mode & 0010) ? 's' : 'S';
+    if (mode & 01000) text[9] = (mode & 0001) ? 't' : 'T';
+
+    m_detailBuf.assign(text, sizeof(text));
+    return m_detailBuf;
+}
+
+/*
+Function: ListingFormatter::ClearCache
+Description: Drops every cached date prefix and account name, e.g. after the time zone,
+             locale or user database changes.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void ListingFormatter::ClearCache()
+{
+    m_prefixes.clear();
+    m_users.clear();
+    m_groups.clear();
+}
@@ -0,0 +1,52 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the ListingFormatter class which turns the raw metadata of a FileItem into the text shown in the size, date and optional detail columns. The formatter keeps a cache of localized date prefixes so that rows sharing the same quarter hour do not repeat the calendar work, caches the user and group names behind numeric ids so the account database is consulted once per id, and it formats sizes with a fast integer conversion or with human-readable units.
+February 1, 2026
+*/
+
+#ifndef LISTINGFORMATTER_H
+#define LISTINGFORMATTER_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+
+// Formats the size, date and detail cells of the listing
+class ListingFormatter final
+{
+public:
+    const std::string& FormatDate(std::time_t t);
+    const std::string& FormatSize(std::uintmax_t bytes);
+    const std::string& FormatNumber(std::uint64_t value);
+    const std::string& FormatOwner(std::uint32_t uid, std::uint32_t gid);
+    const std::string& FormatMode(std::uint32_t mode);
+
+    void SetHumanReadableSizes(bool enabled) { m_humanReadable = enabled; }
+    bool HumanReadableSizes() const { return m_humanReadable; }
+
+    void ClearCache();
+
+private:
+    // Localized "Weekday, Month dd, yyyy HH:" prefix of one quarter hour bucket
+    struct DatePrefix
+    {
+        std::string text;
+        int firstMinute = 0;
+        bool cacheable = false;
+    };
+
+    const DatePrefix& PrefixFor(std::time_t bucketStart);
+    const std::string& UserName(std::uint32_t uid);
+    const std::string& GroupName(std::uint32_t gid);
+
+    std::unordered_map<std::time_t, DatePrefix> m_prefixes;
+    std::unordered_map<std::uint32_t, std::string> m_users;
+    std::unordered_map<std::uint32_t, std::string> m_groups;
+    std::string m_dateBuf;
+    std::string m_sizeBuf;
+    std::string m_detailBuf;
+    bool m_humanReadable = false;
+};
+
+#endif // LISTINGFORMATTER_H
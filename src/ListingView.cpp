@@ -0,0 +1,182 @@
+/*
+Parneet Baidwan - 251259638
+Description: The ListingView class implementation in this file draws a tab's file list from its shared listing. Showing a listing only swaps the rows pointer and sets the item count; wxWidgets then asks for the text of the cells it paints, which is formatted into the formatter's reused buffers, so the cost of a refresh no longer grows with the number of entries.
+February 1, 2026
+*/
+
+#include "ListingView.h"
+
+/*
+Function: ListingView::ListingView
+Description: Creates the list with the Name, Type, Size and Date columns and no rows.
+Parameters:
+  - parent: Owning window (the tab notebook).
+  - id: Control id.
+  - format: Formatter for sizes, dates and detail fields; must outlive the list.
+Returns:
+  - None
+*/
+ListingView::ListingView(wxWindow* parent, wxWindowID id, ListingFormatter& format)
+    : wxListCtrl(parent, id, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL),
+      m_format(format)
+{
+    InsertColumn(0, "Name", wxLIST_FORMAT_LEFT, 380);
+    InsertColumn(1, "Type", wxLIST_FORMAT_LEFT, 100);
+    InsertColumn(2, "Size", wxLIST_FORMAT_RIGHT, 130);
+    InsertColumn(3, "Date", wxLIST_FORMAT_LEFT, 320);
+}
+
+/*
+Function: ListingView::ShowListing
+Description: Shows a complete listing, clearing the selection. The list shares the listing
+             with the tab and the listing cache instead of copying its rows.
+Parameters:
+  - listing: Rows to show, in display order; nullptr shows none.
+  - parentRow: Whether a ".." row comes before them.
+Returns:
+  - None
+*/
+void ListingView::ShowListing(DirectoryListing listing, bool parentRow)
+{
+    DeleteAllItems();
+
+    m_listing = std::move(listing);
+    m_rows = m_listing.get();
+    m_parentRow = parentRow;
+    SetItemCount((long)(m_rows ? m_rows->size() : 0) + (m_parentRow ? 1 : 0));
+    Refresh();
+}
+
+/*
+Function: ListingView::ShowPartial
+Description: Shows the entries of a listing that is still being read, keeping the ".." row.
+             The list only borrows rows; the caller must follow up with ShowListing before
+             rows changes again outside a repaint or goes away.
+Parameters:
+  - rows: Entries read so far.
+Returns:
+  - None
+*/
+void ListingView::ShowPartial(const std::vector<FileItem>& rows)
+{
+    m_listing.reset();
+    m_rows = &rows;
+    SetItemCount((long)rows.size() + (m_parentRow ? 1 : 0));
+    Refresh();
+}
+
+/*
+Function: ListingView::SetDetailColumns
+Description: Shows one column for every extended metadata field in details, after the four
+             standard columns.
+Parameters:
+  - details: kDetail* fields to show.
+Returns:
+  - None
+*/
+void ListingView::SetDetailColumns(unsigned details)
+{
+    while (GetColumnCount() > kBaseColumns)
+        DeleteColumn(GetColumnCount() - 1);
+
+    m_detailFields.clear();
+    for (const DetailColumn& col : kDetailColumns)
+    {
+        if (!(details & col.field)) continue;
+        InsertColumn(GetColumnCount(), col.title, col.align, col.width);
+        m_detailFields.push_back(col.field);
+    }
+    Refresh();
+}
+
+/*
+Function: ListingView::ItemAt
+Description: Returns the entry shown in a row.
+Parameters:
+  - row: Row index.
+Returns:
+  - const FileItem*: The entry, or nullptr for the ".." row and rows out of range.
+*/
+const FileItem* ListingView::ItemAt(long row) const
+{
+    if (m_parentRow) --row;
+    if (!m_rows || row < 0 || (std::size_t)row >= m_rows->size()) return nullptr;
+    return &(*m_rows)[(std::size_t)row];
+}
+
+/*
+Function: ListingView::OnGetItemText
+Description: Supplies the text of a cell being drawn: name, type, size and date, followed by
+             the detail columns. A field the backend could not read stays blank.
+Parameters:
+  - item: Row index.
+  - column: Column index.
+Returns:
+  - wxString: Cell text.
+*/
+wxString ListingView::OnGetItemText(long item, long column) const
+{
+    if (m_parentRow && item == 0)
+    {
+        switch (column)
+        {
+        case 0: return "..";
+        case 1: return "Dir";
+        case 2: return "0";
+        }
+        return wxString();
+    }
+
+    const FileItem* entry = ItemAt(item);
+    if (!entry) return wxString();
+
+    switch (column)
+    {
+    case 0:
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        // the name is the tail of the native path; no filename() copy per cell
+        const std::string& native = entry->fullPath.native();
+        const std::size_t slash = native.rfind('/');
+        const std::size_t start = slash == std::string::npos ? 0 : slash + 1;
+        return wxString::FromUTF8(native.data() + start, native.size() - start);
+#else
+        return wxString::FromUTF8(entry->fullPath.filename().u8string());
+#endif
+    }
+    case 1: return entry->isDir ? "Dir" : "File";
+    case 2: return entry->isDir ? wxString("0") : wxString(m_format.FormatSize(entry->sizeBytes));
+    case 3: return wxString(m_format.FormatDate(entry->modified));
+    }
+
+    const std::size_t detail = (std::size_t)(column - kBaseColumns);
+    if (detail >= m_detailFields.size()) return wxString();
+
+    const std::string* text = DetailText(*entry, m_detailFields[detail]);
+    return text ? wxString(*text) : wxString();
+}
+
+/*
+Function: ListingView::DetailText
+Description: Formats one extended metadata field of an entry.
+Parameters:
+  - item: Entry to format.
+  - field: kDetail* field of the column.
+Returns:
+  - const std::string*: Text in the formatter's buffer, valid until the next call; nullptr if
+                        the backend could not read the field.
+*/
+const std::string* ListingView::DetailText(const FileItem& item, unsigned field) const
+{
+    if (!(item.details & field)) return nullptr;
+
+    switch (field)
+    {
+    case kDetailOwner:     return &m_format.FormatOwner(item.uid, item.gid);
+    case kDetailMode:      return &m_format.FormatMode(item.mode);
+    case kDetailInode:     return &m_format.FormatNumber(item.inode);
+    case kDetailLinks:     return &m_format.FormatNumber(item.links);
+    case kDetailAllocated: return &m_format.FormatSize(item.allocatedBytes);
+    default:               return &m_format.FormatDate(item.birthTime);
+    }
+}
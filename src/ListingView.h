@@ -0,0 +1,64 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the ListingView class, the file list of a browsing tab. It is a virtual report list: the rows are never copied into the control but read from the tab's shared listing, and the text of a cell is only formatted when the cell is drawn, so showing or refreshing a directory costs the same few allocations however many entries it has.
+February 1, 2026
+*/
+
+#ifndef LISTINGVIEW_H
+#define LISTINGVIEW_H
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <string>
+#include <vector>
+
+#include "FileSystemService.h"
+#include "ListingFormatter.h"
+
+// Optional column after Name, Type, Size and Date
+struct DetailColumn
+{
+    unsigned field;
+    const char* title;
+    int align;
+    int width;
+};
+
+// Optional columns in display order; same order as the menu ids ID_ColOwner..ID_ColBirthTime
+inline constexpr DetailColumn kDetailColumns[] = {
+    { kDetailOwner,     "Owner",     wxLIST_FORMAT_LEFT,  140 },
+    { kDetailMode,      "Mode",      wxLIST_FORMAT_LEFT,  100 },
+    { kDetailInode,     "Inode",     wxLIST_FORMAT_RIGHT, 110 },
+    { kDetailLinks,     "Links",     wxLIST_FORMAT_RIGHT,  60 },
+    { kDetailAllocated, "Allocated", wxLIST_FORMAT_RIGHT, 130 },
+    { kDetailBirthTime, "Created",   wxLIST_FORMAT_LEFT,  320 },
+};
+
+// Name, Type, Size, Date
+inline constexpr int kBaseColumns = 4;
+
+// Virtual list drawing a tab's rows straight from its listing
+class ListingView final : public wxListCtrl
+{
+public:
+    ListingView(wxWindow* parent, wxWindowID id, ListingFormatter& format);
+
+    void ShowListing(DirectoryListing listing, bool parentRow);
+    void ShowPartial(const std::vector<FileItem>& rows);
+    void SetDetailColumns(unsigned details);
+
+    bool HasParentRow() const { return m_parentRow; }
+    const FileItem* ItemAt(long row) const;
+
+private:
+    wxString OnGetItemText(long item, long column) const override;
+    const std::string* DetailText(const FileItem& item, unsigned field) const;
+
+    ListingFormatter& m_format;
+    DirectoryListing m_listing;                     // owns m_rows once the listing is complete
+    const std::vector<FileItem>* m_rows = nullptr;  // rows drawn; a partial listing while streaming
+    bool m_parentRow = false;                       // row 0 is ".."
+    std::vector<unsigned> m_detailFields;           // kDetail* field of each column after Date
+};
+
+#endif // LISTINGVIEW_H
@@ -7,10 +7,24 @@ February 1, 2026
 
 
 #include "MainFrame.h"
+#include "AllocCounter.h"
+#include "BatchRenameDialog.h"
+#include "ContentSearchFrame.h"
 #include "FileSystemService.h"
+#include "FsBackend.h"
+#include "IoScheduler.h"
+#include "SyncDialog.h"
+#include "TreeSnapshot.h"
+#include "WatchFrame.h"
+#include "ZstdCopy.h"
 
 #include <wx/textdlg.h>
+#include <wx/filedlg.h>
 #include <wx/msgdlg.h>
+#include <wx/progdlg.h>
+#include <wx/textcompleter.h>
+#include <chrono>
+#include <future>
 #include <vector>
 
 // bind event ids to handler methods
@@ -18,21 +32,67 @@ wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     // Controls
     EVT_TEXT_ENTER(MainFrame::ID_Path, MainFrame::OnPathEnter)
     EVT_LIST_ITEM_ACTIVATED(MainFrame::ID_List, MainFrame::OnItemActivated)
+    EVT_NOTEBOOK_PAGE_CHANGED(MainFrame::ID_Tabs, MainFrame::OnTabChanged)
 
     // Menus
+    EVT_MENU(MainFrame::ID_NewTab,   MainFrame::OnMenuNewTab)
+    EVT_MENU(MainFrame::ID_CloseTab, MainFrame::OnMenuCloseTab)
     EVT_MENU(MainFrame::ID_New,     MainFrame::OnMenuNew)
     EVT_MENU(MainFrame::ID_Open,    MainFrame::OnMenuOpen)
     EVT_MENU(MainFrame::ID_Rename,  MainFrame::OnMenuRename)
+    EVT_MENU(MainFrame::ID_BatchRename, MainFrame::OnMenuBatchRename)
     EVT_MENU(MainFrame::ID_Delete,  MainFrame::OnMenuDelete)
 
+    EVT_MENU(MainFrame::ID_Undo,    MainFrame::OnMenuUndo)
     EVT_MENU(MainFrame::ID_Copy,    MainFrame::OnMenuCopy)
     EVT_MENU(MainFrame::ID_Cut,     MainFrame::OnMenuCut)
     EVT_MENU(MainFrame::ID_Paste,   MainFrame::OnMenuPaste)
+    EVT_MENU(MainFrame::ID_PasteCompressed,   MainFrame::OnMenuPasteCompressed)
+    EVT_MENU(MainFrame::ID_PasteDecompressed, MainFrame::OnMenuPasteDecompressed)
+    EVT_MENU(MainFrame::ID_VerifyPastes,      MainFrame::OnMenuVerifyPastes)
 
     EVT_MENU(MainFrame::ID_Refresh, MainFrame::OnMenuRefresh)
+    EVT_MENU(MainFrame::ID_Back,    MainFrame::OnMenuBack)
+    EVT_MENU(MainFrame::ID_Forward, MainFrame::OnMenuForward)
+    EVT_MENU(MainFrame::ID_HumanSizes, MainFrame::OnMenuHumanSizes)
+    EVT_MENU_RANGE(MainFrame::ID_ColOwner, MainFrame::ID_ColBirthTime, MainFrame::OnMenuDetailColumn)
+    EVT_MENU(MainFrame::ID_Sync,    MainFrame::OnMenuSync)
+    EVT_MENU(MainFrame::ID_Bandwidth, MainFrame::OnMenuBandwidth)
+    EVT_MENU(MainFrame::ID_ContentSearch, MainFrame::OnMenuContentSearch)
+    EVT_MENU(MainFrame::ID_Watch,   MainFrame::OnMenuWatch)
+    EVT_MENU(MainFrame::ID_Snapshot, MainFrame::OnMenuSnapshot)
     EVT_MENU(MainFrame::ID_Exit,    MainFrame::OnMenuExit)
+
+    // Window
+    EVT_CLOSE(MainFrame::OnClose)
 wxEND_EVENT_TABLE()
 
+// Path bar completer; owned by the text control, so it shares the index rather than the frame
+class PathCompleter final : public wxTextCompleter
+{
+public:
+    explicit PathCompleter(std::shared_ptr<PathCompletionIndex> index)
+        : m_index(std::move(index))
+    {
+    }
+
+    bool Start(const wxString& prefix) override
+    {
+        m_next = 0;
+        return m_index->Complete(prefix.utf8_string(), m_matches) && !m_matches.empty();
+    }
+
+    wxString GetNext() override
+    {
+        return m_next < m_matches.size() ? wxString::FromUTF8(m_matches[m_next++]) : wxString();
+    }
+
+private:
+    std::shared_ptr<PathCompletionIndex> m_index;
+    std::vector<std::string> m_matches;
+    std::size_t m_next = 0;
+};
+
 /*
 Function: MainFrame::ToWx
 Description: Converts a std::filesystem::path into a wxString suitable for display in the UI.
@@ -47,25 +107,6 @@ wxString MainFrame::ToWx(const fs::path& p)
     return wxString::FromUTF8(p.u8string());
 }
 
-/*
-Function: MainFrame::FormatLongDate
-Description: Converts a time_t timestamp into a human-readable string for the “Date Modified”
-             column. If formatting fails, a fallback string may be produced.
-Parameters:
-  - t: Timestamp (typically last_write_time converted to time_t).
-Returns:
-  - wxString: Formatted date/time string for display.
-*/
-wxString MainFrame::FormatLongDate(std::time_t t)
-{
-    if (t <= 0) return "";
-
-    wxDateTime dt((time_t)t);
-    if (!dt.IsValid()) return "";
-
-    return dt.Format("%A, %B %d, %Y %H:%M:%S");
-}
-
 /*
 Function: MainFrame::ShowError
 Description: Displays an error dialog to the user. Centralizing this logic ensures consistent
@@ -82,8 +123,9 @@ void MainFrame::ShowError(const wxString& title, const wxString& msg)
 }
 
 // constructor
-MainFrame::MainFrame(const wxString& title)
-    : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(980, 620))
+MainFrame::MainFrame(const wxString& title, std::shared_ptr<FsBackend> backend)
+    : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(980, 620)),
+      m_fs(std::move(backend))
 {
     // layout path bar and file list
     BuildUi();
@@ -95,16 +137,245 @@ MainFrame::MainFrame(const wxString& title)
     BuildAccelerators();
 
     CreateStatusBar(1);
-    SetStatusText("Welcome to wxWidgets File Manager!");
+    SetStatusText(wxString::Format("Welcome to wxWidgets File Manager! (%s backend)", m_fs.Backend().Name()));
+
+    // reopen the last session, or start from current working directory
+    if (!RestoreSession())
+    {
+        CreateTab(fs::current_path());
+        SetDirectory(fs::current_path());
+    }
+}
+
+// destructor
+MainFrame::~MainFrame()
+{
+    StopRevalidation();
+    m_pathIndex->Stop();
+}
+
+/*
+Function: MainFrame::RestoreSession
+Description: Reopens the tabs, columns and size format saved when the window last closed. The
+             active tab is painted straight from its saved snapshot, so the window is usable
+             before any directory has been read; the other tabs are filled when first shown.
+             A background thread then checks every snapshot against its directory's current
+             change stamp: a snapshot that is still complete and current is put in the
+             listing cache as is, anything else is read again and its tab refreshed.
+             Only sessions of local backends are restored.
+Parameters:
+  - None
+Returns:
+  - bool: true if at least one tab was restored; false to start afresh.
+*/
+bool MainFrame::RestoreSession()
+{
+    if (!m_fs.Backend().IsLocal()) return false;
+
+    const fs::path file = SessionFile();
+    Session session;
+    std::string err;
+    if (file.empty() || !LoadSession(file, session, err)) return false;
+
+    // view settings first, so the tabs are built with the saved columns
+    m_fs.SetDetailFields(session.detailFields);
+    m_format.SetHumanReadableSizes(session.humanSizes);
+    GetMenuBar()->Check(ID_HumanSizes, session.humanSizes);
+    for (std::size_t i = 0; i < sizeof(kDetailColumns) / sizeof(kDetailColumns[0]); ++i)
+        GetMenuBar()->Check(ID_ColOwner + (int)i, (session.detailFields & kDetailColumns[i].field) != 0);
+
+    // directories that no longer exist are dropped, and the active tab with them
+    std::vector<SessionTab> restored;
+    std::size_t active = 0;
+    for (std::size_t i = 0; i < session.tabs.size(); ++i)
+    {
+        SessionTab& saved = session.tabs[i];
+        if (!m_fs.IsDirectory(saved.dir)) continue;
+        if (i == session.activeTab) active = restored.size();
+
+        CreateTab(saved.dir);
+        ListingView* list = m_tabs.back().list;
+        if ((int)session.columnWidths.size() == list->GetColumnCount())
+        {
+            for (std::size_t col = 0; col < session.columnWidths.size(); ++col)
+                list->SetColumnWidth((int)col, session.columnWidths[col]);
+        }
+        // a snapshot read with other detail fields cannot fill the columns shown now
+        if (saved.details != session.detailFields) saved.listing = nullptr;
+        restored.push_back(std::move(saved));
+    }
+    if (m_tabs.empty()) return false;
+
+    m_notebook->ChangeSelection(active);
+    m_activeTab = active;
+    for (std::size_t i = 0; i < m_tabs.size(); ++i)
+        m_tabs[i].stale = i != active;
+
+    BrowserTab& tab = ActiveTab();
+    m_pathCtrl->SetValue(ToWx(tab.dir));
+    m_recentDirs.push_front(tab.dir);
+    if (DirectoryListing snapshot = restored[active].listing)
+    {
+        ShowRows(tab, snapshot);
+        tab.listing = std::move(snapshot);
+        tab.fromSnapshot = true;
+        m_pathIndex->Add(tab.dir, tab.listing);
+    }
+    else
+    {
+        RefreshListing();
+    }
+
+    // the active tab first, so its revalidation lands soonest
+    std::swap(restored[0], restored[active]);
+    for (SessionTab& saved : restored)
+        RevalidateLater(std::move(saved));
+    return true;
+}
+
+/*
+Function: MainFrame::RevalidateLater
+Description: Queues a listing that was painted without reading its directory (a session
+             snapshot or a history entry) for the background revalidation thread, starting
+             the thread on first use. The result arrives in OnSnapshotChecked.
+Parameters:
+  - snapshot: Directory, listing, change stamp and detail fields of the painted listing;
+              complete is false if the stamp is unknown and the directory must be re-read.
+Returns:
+  - None
+*/
+void MainFrame::RevalidateLater(SessionTab snapshot)
+{
+    std::lock_guard<std::mutex> lock(m_revalidateMutex);
+    if (m_closing) return;
+
+    m_revalidateQueue.push_back(std::move(snapshot));
+    if (!m_revalidator.joinable())
+        m_revalidator = std::thread(&MainFrame::RevalidateLoop, this);
+    m_revalidateWake.notify_one();
+}
+
+/*
+Function: MainFrame::RevalidateLoop
+Description: Body of the revalidation thread. A listing that is complete and still has its
+             directory's change stamp is put in the listing cache as is; any other is read
+             again so that refreshing its tab is a cache hit. Either way the UI thread is told
+             whether the painted listing was current.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void MainFrame::RevalidateLoop()
+{
+    for (;;)
+    {
+        SessionTab snapshot;
+        {
+            std::unique_lock<std::mutex> lock(m_revalidateMutex);
+            m_revalidateWake.wait(lock, [this] { return m_closing || !m_revalidateQueue.empty(); });
+            if (m_closing) return;
+            snapshot = std::move(m_revalidateQueue.front());
+            m_revalidateQueue.pop_front();
+        }
+
+        const bool current = snapshot.complete && snapshot.details == m_fs.DetailFields() &&
+                             m_fs.AdoptListing(snapshot.dir, snapshot.listing, snapshot.stamp);
+        if (!current)
+        {
+            std::string listErr;
+            m_fs.ListDirectoryCached(snapshot.dir, true, listErr);
+        }
+        CallAfter([this, dir = snapshot.dir, current]() { OnSnapshotChecked(dir, current); });
+    }
+}
 
-    // start from current working directory
-    SetDirectory(fs::current_path());
+/*
+Function: MainFrame::StopRevalidation
+Description: Stops the revalidation thread, dropping checks still queued, and waits for it.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void MainFrame::StopRevalidation()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_revalidateMutex);
+        m_closing = true;
+        m_revalidateWake.notify_all();
+    }
+    if (m_revalidator.joinable()) m_revalidator.join();
+}
+
+/*
+Function: MainFrame::OnSnapshotChecked
+Description: Receives the revalidation result of one restored directory on the UI thread. A
+             tab still showing an outdated snapshot is refreshed at once if it is active and
+             when it is next shown otherwise.
+Parameters:
+  - dir: Restored directory that was checked.
+  - current: true if the snapshot still matched the directory.
+Returns:
+  - None
+*/
+void MainFrame::OnSnapshotChecked(const fs::path& dir, bool current)
+{
+    for (std::size_t i = 0; i < m_tabs.size(); ++i)
+    {
+        BrowserTab& tab = m_tabs[i];
+        if (!tab.fromSnapshot || tab.dir != dir) continue;
+
+        tab.fromSnapshot = false;
+        if (current) continue;
+        if (i == m_activeTab) RefreshListing();
+        else tab.stale = true;
+    }
+}
+
+/*
+Function: MainFrame::SaveCurrentSession
+Description: Saves the open tabs, the active tab, the column choice and widths and the size
+             format, with a snapshot of every tab's listing that is still current in the
+             listing cache. Failing to save is not reported; the next launch starts afresh.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void MainFrame::SaveCurrentSession()
+{
+    const fs::path file = SessionFile();
+    if (!m_fs.Backend().IsLocal() || file.empty() || m_tabs.empty()) return;
+
+    Session session;
+    session.activeTab = m_activeTab;
+    session.detailFields = m_fs.DetailFields();
+    session.humanSizes = m_format.HumanReadableSizes();
+
+    ListingView* list = ActiveTab().list;
+    for (int col = 0; col < list->GetColumnCount(); ++col)
+        session.columnWidths.push_back(list->GetColumnWidth(col));
+
+    for (const BrowserTab& tab : m_tabs)
+    {
+        SessionTab saved;
+        saved.dir = tab.dir;
+        saved.listing = m_fs.SnapshotListing(tab.dir, saved.stamp);
+        saved.details = session.detailFields;
+        saved.complete = saved.listing != nullptr;
+        session.tabs.push_back(std::move(saved));
+    }
+
+    std::string err;
+    SaveSession(file, session, err);
 }
 
 /*
 Function: MainFrame::BuildUi
-Description: Constructs the main window UI: directory path bar, file list control, layout,
-             and status bar. This is called once during frame creation.
+Description: Constructs the main window UI: directory path bar, the tab notebook holding one
+             file list per tab, layout, and status bar. This is called once during frame
+             creation; the first tab is created by the constructor.
 Parameters:
   - None
 Returns:
@@ -114,7 +385,7 @@ void MainFrame::BuildUi()
 {
     auto* panel = new wxPanel(this);
 
-    // oath bar
+    // path bar
     m_pathCtrl = new wxTextCtrl(
         panel,
         ID_Path,
@@ -123,28 +394,93 @@ void MainFrame::BuildUi()
         wxDefaultSize,
         wxTE_PROCESS_ENTER
     );
+    m_pathCtrl->AutoComplete(new PathCompleter(m_pathIndex));
+    m_pathIndex->SetLookupDone([this](const std::string& typed)
+    {
+        CallAfter([this, typed]() { OnPathLookupDone(typed); });
+    });
 
-    // list
-    m_listCtrl = new wxListCtrl(
-        panel,
-        ID_List,
-        wxDefaultPosition,
-        wxDefaultSize,
-        wxLC_REPORT | wxLC_SINGLE_SEL
-    );
-
-    // columns: Name, Type, Size, Date
-    m_listCtrl->InsertColumn(0, "Name", wxLIST_FORMAT_LEFT, 380);
-    m_listCtrl->InsertColumn(1, "Type", wxLIST_FORMAT_LEFT, 100);
-    m_listCtrl->InsertColumn(2, "Size", wxLIST_FORMAT_RIGHT, 130);
-    m_listCtrl->InsertColumn(3, "Date", wxLIST_FORMAT_LEFT, 320);
+    // tabs, one list per page
+    m_notebook = new wxNotebook(panel, ID_Tabs);
 
     auto* sizer = new wxBoxSizer(wxVERTICAL);
     sizer->Add(m_pathCtrl, 0, wxEXPAND | wxALL, 10);
-    sizer->Add(m_listCtrl, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+    sizer->Add(m_notebook, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
     panel->SetSizer(sizer);
 }
 
+/*
+Function: MainFrame::CreateTab
+Description: Adds a new tab with its own file list and makes it the active tab. All tabs share
+             the FileSystemService listing cache, so opening a directory that another tab
+             already shows does not enumerate it again.
+Parameters:
+  - dir: Directory the new tab starts in.
+Returns:
+  - None
+*/
+void MainFrame::CreateTab(const fs::path& dir)
+{
+    // columns: Name, Type, Size, Date and the detail columns selected in View > Columns
+    auto* list = new ListingView(m_notebook, ID_List, m_format);
+    list->SetDetailColumns(m_fs.DetailFields());
+
+    // hovering a folder preloads it
+    list->Bind(wxEVT_MOTION, &MainFrame::OnListMotion, this);
+
+    BrowserTab tab;
+    tab.list = list;
+    tab.dir = dir;
+    m_tabs.push_back(tab);
+    m_activeTab = m_tabs.size() - 1;
+
+    m_notebook->AddPage(list, ToWx(dir.filename().empty() ? dir : dir.filename()), true);
+}
+
+/*
+Function: MainFrame::CloseActiveTab
+Description: Closes the active tab unless it is the last one, then activates the tab the
+             notebook selects next.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void MainFrame::CloseActiveTab()
+{
+    if (m_tabs.size() <= 1) return;
+
+    const std::size_t closing = m_activeTab;
+    m_tabs.erase(m_tabs.begin() + (long)closing);
+    m_activeTab = 0;
+    m_notebook->DeletePage(closing);
+
+    const int sel = m_notebook->GetSelection();
+    m_activeTab = (sel >= 0 && (std::size_t)sel < m_tabs.size()) ? (std::size_t)sel : 0;
+    m_pathCtrl->SetValue(ToWx(CurrentDir()));
+}
+
+/*
+Function: MainFrame::PreloadNeighbours
+Description: Hints the background preloader with the directories the user is likely to open
+             next from the current one: its parent and the recently visited directories.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void MainFrame::PreloadNeighbours()
+{
+    for (const auto& recent : m_recentDirs)
+    {
+        if (recent != CurrentDir()) m_preloader.Request(recent);
+    }
+
+    // requested last so it is served first
+    if (CurrentDir().has_parent_path() && CurrentDir() != CurrentDir().root_path())
+        m_preloader.Request(CurrentDir().parent_path());
+}
+
 /*
 Function: MainFrame::BuildMenus
 Description: Creates the menu bar and all menu items required for file operations (open, new
@@ -159,26 +495,58 @@ void MainFrame::BuildMenus()
 {
 
     auto* fileMenu = new wxMenu;
+    fileMenu->Append(ID_NewTab,   "New Tab\tCtrl+T");
+    fileMenu->Append(ID_CloseTab, "Close Tab\tCtrl+W");
+    fileMenu->AppendSeparator();
     fileMenu->Append(ID_New,    "New...\tCtrl+N");
     fileMenu->Append(ID_Open,   "Open...\tCtrl+O");
     fileMenu->AppendSeparator();
     fileMenu->Append(ID_Rename, "Rename...\tCtrl+E");
+    fileMenu->Append(ID_BatchRename, "Batch Rename...\tCtrl+Shift+E");
     fileMenu->Append(ID_Delete, "Delete...\tDel");
     fileMenu->AppendSeparator();
     fileMenu->Append(ID_Exit,   "Exit\tCtrl+Q");
 
     auto* editMenu = new wxMenu;
+    editMenu->Append(ID_Undo,  "Undo Delete\tCtrl+Z");
+    editMenu->AppendSeparator();
     editMenu->Append(ID_Copy,  "Copy\tCtrl+C");
     editMenu->Append(ID_Cut,   "Cut\tCtrl+X");
     editMenu->Append(ID_Paste, "Paste\tCtrl+V");
+    editMenu->AppendSeparator();
+    editMenu->Append(ID_PasteCompressed,   "Paste Compressed (.zst)\tCtrl+Shift+V");
+    editMenu->Append(ID_PasteDecompressed, "Paste Decompressed\tCtrl+Alt+V");
+    editMenu->AppendSeparator();
+    editMenu->AppendCheckItem(ID_VerifyPastes, "Verify Pasted Copies");
 
     auto* viewMenu = new wxMenu;
     viewMenu->Append(ID_Refresh, "Refresh\tF5");
+    viewMenu->Append(ID_Back,    "Back\tAlt+Left");
+    viewMenu->Append(ID_Forward, "Forward\tAlt+Right");
+    viewMenu->AppendSeparator();
+    viewMenu->AppendCheckItem(ID_HumanSizes, "Human-readable Sizes");
+
+    auto* columnsMenu = new wxMenu;
+    for (std::size_t i = 0; i < sizeof(kDetailColumns) / sizeof(kDetailColumns[0]); ++i)
+        columnsMenu->AppendCheckItem(ID_ColOwner + (int)i, kDetailColumns[i].title);
+    viewMenu->AppendSubMenu(columnsMenu, "Columns");
+
+    auto* toolsMenu = new wxMenu;
+    toolsMenu->Append(ID_ContentSearch, "Search Contents...\tCtrl+Shift+F");
+    toolsMenu->Append(ID_Watch, "Watch Directories...");
+    toolsMenu->Append(ID_Snapshot, "Export Tree Snapshot...");
+    toolsMenu->Append(ID_Sync, "Compare / Sync...");
+    toolsMenu->Append(ID_Bandwidth, "I/O Bandwidth Limit...");
 
     auto* menuBar = new wxMenuBar;
     menuBar->Append(fileMenu, "&File");
     menuBar->Append(editMenu, "&Edit");
     menuBar->Append(viewMenu, "&View");
+    menuBar->Append(toolsMenu, "&Tools");
+
+    // Compressed pastes need a build with zstd
+    menuBar->Enable(ID_PasteCompressed, ZstdCopySupported());
+    menuBar->Enable(ID_PasteDecompressed, ZstdCopySupported());
 
     SetMenuBar(menuBar);
 }
@@ -196,16 +564,24 @@ void MainFrame::BuildAccelerators()
 {
     std::vector<wxAcceleratorEntry> entries;
 
+    entries.emplace_back(wxACCEL_CTRL, (int)'T', ID_NewTab);
+    entries.emplace_back(wxACCEL_CTRL, (int)'W', ID_CloseTab);
     entries.emplace_back(wxACCEL_CTRL, (int)'N', ID_New);
     entries.emplace_back(wxACCEL_CTRL, (int)'O', ID_Open);
     entries.emplace_back(wxACCEL_CTRL, (int)'E', ID_Rename);
+    entries.emplace_back(wxACCEL_CTRL | wxACCEL_SHIFT, (int)'E', ID_BatchRename);
     entries.emplace_back(wxACCEL_CTRL, (int)'Q', ID_Exit);
 
+    entries.emplace_back(wxACCEL_CTRL, (int)'Z', ID_Undo);
     entries.emplace_back(wxACCEL_CTRL, (int)'C', ID_Copy);
     entries.emplace_back(wxACCEL_CTRL, (int)'X', ID_Cut);
     entries.emplace_back(wxACCEL_CTRL, (int)'V', ID_Paste);
+    entries.emplace_back(wxACCEL_CTRL | wxACCEL_SHIFT, (int)'V', ID_PasteCompressed);
+    entries.emplace_back(wxACCEL_CTRL | wxACCEL_ALT, (int)'V', ID_PasteDecompressed);
 
     entries.emplace_back(0, WXK_F5, ID_Refresh);
+    entries.emplace_back(wxACCEL_ALT, WXK_LEFT, ID_Back);
+    entries.emplace_back(wxACCEL_ALT, WXK_RIGHT, ID_Forward);
     entries.emplace_back(0, WXK_DELETE, ID_Delete);
 
     wxAcceleratorTable table((int)entries.size(), &entries[0]);
@@ -214,8 +590,9 @@ void MainFrame::BuildAccelerators()
 
 /*
 Function: MainFrame::SetDirectory
-Description: Attempts to change the active directory being displayed. Updates the path bar
-             and refreshes the listing. If the directory is invalid, an error dialog may be
+Description: Attempts to change the directory shown in the active tab. Updates the path bar,
+             the tab title and the listing, then asks the preloader to warm the cache for the
+             likely next directories. If the directory is invalid, an error dialog may be
              shown and the previous directory remains active.
 Parameters:
   - dir: Target directory path to switch to.
@@ -224,58 +601,260 @@ Returns:
 */
 void MainFrame::SetDirectory(const fs::path& dir)
 {
-    if (!FileSystemService::Exists(dir) || !FileSystemService::IsDirectory(dir))
+    if (!m_fs.IsBrowsable(dir))
     {
         ShowError("Invalid Path", "Not a directory:\n" + ToWx(dir));
         return;
     }
 
-    m_currentDir = FileSystemService::CanonicalOrSame(dir);
-    m_pathCtrl->SetValue(ToWx(m_currentDir));
+    BrowserTab& tab = ActiveTab();
+    const fs::path target = m_fs.CanonicalOrSame(dir);
+    if (target != tab.dir) tab.history.Visit(CaptureState(tab));
+
+    tab.dir = target;
+    tab.hoverRow = -1;
+    m_pathCtrl->SetValue(ToWx(tab.dir));
+    m_notebook->SetPageText(m_activeTab, ToWx(tab.dir.filename().empty() ? tab.dir : tab.dir.filename()));
     RefreshListing();
+
+    PreloadNeighbours();
+    RememberDirectory(tab.dir);
 }
 
 /*
-Function: MainFrame::RefreshListing
-Description: Rebuilds the file list display for the current directory. Uses FileSystemService
-             to retrieve file metadata, clears the list control, optionally inserts a ".."
-             entry for parent navigation, and populates rows with name/type/size/date.
-             Failures (e.g., permission errors) are surfaced to the user.
+Function: MainFrame::RememberDirectory
+Description: Moves a directory to the front of the recently visited list the preloader is
+             hinted with.
 Parameters:
+  - dir: Directory just shown.
+Returns:
   - None
+*/
+void MainFrame::RememberDirectory(const fs::path& dir)
+{
+    // most recent first
+    for (auto it = m_recentDirs.begin(); it != m_recentDirs.end(); ++it)
+    {
+        if (*it == dir)
+        {
+            m_recentDirs.erase(it);
+            break;
+        }
+    }
+    m_recentDirs.push_front(dir);
+    if (m_recentDirs.size() > 8) m_recentDirs.pop_back();
+}
+
+/*
+Function: MainFrame::CaptureState
+Description: Records how a tab shows its directory, for the navigation history: the listing,
+             the first visible row and the selected entry. The listing's change stamp is only
+             recorded if it is the listing the cache holds for the directory right now;
+             otherwise it will be re-read when the entry is shown again.
+Parameters:
+  - tab: Tab about to leave its directory.
+Returns:
+  - HistoryEntry: State of the tab.
+*/
+HistoryEntry MainFrame::CaptureState(const BrowserTab& tab) const
+{
+    HistoryEntry entry;
+    entry.dir = tab.dir;
+    entry.listing = tab.listing;
+    entry.details = m_fs.DetailFields();
+    entry.topRow = tab.list->GetTopItem();
+
+    const long sel = tab.list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    if (sel != -1) entry.selected = tab.list->GetItemText(sel).ToStdString();
+
+    fs::file_time_type stamp;
+    if (entry.listing && m_fs.SnapshotListing(tab.dir, stamp) == entry.listing)
+    {
+        entry.stamp = stamp;
+        entry.stampKnown = true;
+    }
+    return entry;
+}
+
+/*
+Function: MainFrame::GoHistory
+Description: Steps the active tab back or forward through its navigation history.
+Parameters:
+  - forward: true for Forward, false for Back.
 Returns:
   - None
 */
-void MainFrame::RefreshListing()
+void MainFrame::GoHistory(bool forward)
 {
-    m_listCtrl->DeleteAllItems();
+    BrowserTab& tab = ActiveTab();
+    HistoryEntry target;
+    const bool moved = forward ? tab.history.Forward(CaptureState(tab), target)
+                               : tab.history.Back(CaptureState(tab), target);
+    if (moved) ShowHistoryEntry(target);
+}
+
+/*
+Function: MainFrame::ShowHistoryEntry
+Description: Shows a directory from the navigation history in the active tab. If the entry
+             still holds its listing it is painted straight away, with the scroll position
+             and selection the user left, and checked against the directory's change stamp
+             in the background (see RevalidateLater); otherwise the directory is listed
+             through the cache as usual.
+Parameters:
+  - entry: History entry to show.
+Returns:
+  - None
+*/
+void MainFrame::ShowHistoryEntry(const HistoryEntry& entry)
+{
+    BrowserTab& tab = ActiveTab();
+    tab.dir = entry.dir;
+    m_pathCtrl->SetValue(ToWx(tab.dir));
+    m_notebook->SetPageText(m_activeTab, ToWx(tab.dir.filename().empty() ? tab.dir : tab.dir.filename()));
 
-    if (m_currentDir.has_parent_path() && m_currentDir != m_currentDir.root_path())
+    if (entry.listing && entry.details == m_fs.DetailFields())
     {
-        const long idx = m_listCtrl->InsertItem(m_listCtrl->GetItemCount(), "..");
-        m_listCtrl->SetItem(idx, 1, "Dir");
-        m_listCtrl->SetItem(idx, 2, "0");
-        m_listCtrl->SetItem(idx, 3, "");
+        ShowRows(tab, entry.listing);
+        tab.listing = entry.listing;
+        tab.fromSnapshot = true;
+        m_pathIndex->Add(tab.dir, tab.listing);
+
+        SessionTab check;
+        check.dir = entry.dir;
+        check.listing = entry.listing;
+        check.stamp = entry.stamp;
+        check.details = entry.details;
+        check.complete = entry.stampKnown;
+        RevalidateLater(std::move(check));
     }
+    else
+    {
+        RefreshListing();
+    }
+    RestoreView(tab, entry.topRow, entry.selected);
+
+    PreloadNeighbours();
+    RememberDirectory(tab.dir);
+}
 
+/*
+Function: MainFrame::RestoreView
+Description: Scrolls a tab's list so that a row is at the top again and re-selects an entry by
+             name. The row of the entry is found in the tab's listing, not by asking the list
+             control for the text of every row.
+Parameters:
+  - tab: Tab whose list was just filled.
+  - topRow: Row to show first.
+  - selected: Name of the entry to select; empty for none.
+Returns:
+  - None
+*/
+void MainFrame::RestoreView(BrowserTab& tab, long topRow, const std::string& selected)
+{
+    ListingView* list = tab.list;
+    const long count = list->GetItemCount();
+    if (count == 0) return;
+
+    // scroll past the row first so it ends up at the top rather than the bottom
+    topRow = std::max(0L, std::min(topRow, count - 1));
+    list->EnsureVisible(std::min(count - 1, topRow + std::max(1, list->GetCountPerPage()) - 1));
+    list->EnsureVisible(topRow);
+
+    if (selected.empty() || !tab.listing) return;
+    const long offset = list->HasParentRow() ? 1 : 0;
+    long row = -1;
+    if (selected == "..")
+    {
+        if (offset) row = 0;
+    }
+    else
+    {
+        for (std::size_t i = 0; i < tab.listing->size(); ++i)
+        {
+            if ((*tab.listing)[i].fullPath.filename() == selected)
+            {
+                row = (long)i + offset;
+                break;
+            }
+        }
+    }
+    if (row != -1)
+        list->SetItemState(row, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+}
+
+/*
+Function: MainFrame::RefreshListing
+Description: Shows the listing of the active tab's directory. Uses FileSystemService's shared
+             listing cache (validated by directory mtime) to retrieve file metadata and hands
+             the listing to the tab's virtual list, which formats only the rows on screen, so a
+             refresh allocates the same small amount however large the directory is. When the
+             directory has to be enumerated, the entries read so far are painted while the
+             rest is read. Failures (e.g., permission errors) are surfaced to the user.
+Parameters:
+  - rescan: If true, bypass the cache and enumerate the directory again.
+Returns:
+  - None
+*/
+void MainFrame::RefreshListing(bool rescan)
+{
+#ifdef FM_COUNT_ALLOCS
+    const std::uint64_t allocsBefore = AllocationCount();
+#endif
+
+    BrowserTab& tab = ActiveTab();
+    ListingView* list = tab.list;
+    ShowRows(tab, nullptr);
+
+    // A fresh enumeration is painted as it is read: the first chunk at once, then every
+    // quarter second while a huge directory is still being read
+    auto lastPaint = std::chrono::steady_clock::now() - std::chrono::seconds(1);
     std::string err;
-    const auto items = m_fs.ListDirectory(m_currentDir, err);
+    tab.listing = m_fs.ListDirectoryCached(tab.dir, !rescan, err, [&](const std::vector<FileItem>& soFar)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastPaint >= std::chrono::milliseconds(250))
+        {
+            list->ShowPartial(soFar);
+            list->Update();
+            lastPaint = now;
+        }
+        return true;
+    });
     if (!err.empty())
     {
+        // the list may still point into the abandoned listing
+        ShowRows(tab, nullptr);
         ShowError("Listing Error", wxString::FromUTF8(err));
         return;
     }
 
-    // populate rows
-    for (const auto& item : items)
-    {
-        const wxString name = ToWx(item.fullPath.filename());
+    ShowRows(tab, tab.listing);
+    m_pathIndex->Add(tab.dir, tab.listing);
 
-        const long idx = m_listCtrl->InsertItem(m_listCtrl->GetItemCount(), name);
-        m_listCtrl->SetItem(idx, 1, item.isDir ? "Dir" : "File");
-        m_listCtrl->SetItem(idx, 2, item.isDir ? "0" : wxString::Format("%llu", (unsigned long long)item.sizeBytes));
-        m_listCtrl->SetItem(idx, 3, FormatLongDate(item.modified));
-    }
+#ifdef FM_COUNT_ALLOCS
+    const std::uint64_t allocs = AllocationCount() - allocsBefore;
+    SetStatusText(wxString::Format("Listed %zu entries with %llu allocations", tab.listing->size(), (unsigned long long)allocs));
+#endif
+}
+
+/*
+Function: MainFrame::ShowRows
+Description: Shows a listing in a tab's list, after the ".." row that leads to the parent
+             directory unless the tab shows a root directory, and resets the tab's row state.
+Parameters:
+  - tab: Tab whose rows are replaced.
+  - listing: Entries to show; nullptr leaves only the ".." row.
+Returns:
+  - None
+*/
+void MainFrame::ShowRows(BrowserTab& tab, DirectoryListing listing)
+{
+    tab.hoverRow = -1;
+    tab.stale = false;
+    tab.fromSnapshot = false;
+
+    const bool parentRow = tab.dir.has_parent_path() && tab.dir != tab.dir.root_path();
+    tab.list->ShowListing(std::move(listing), parentRow);
 }
 
 /*
@@ -290,14 +869,16 @@ Returns:
 */
 std::optional<fs::path> MainFrame::GetSelectedPath() const
 {
-    const long sel = m_listCtrl->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    const ListingView* list = ActiveTab().list;
+    const long sel = list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
     if (sel == -1) return std::nullopt;
 
-    const wxString name = m_listCtrl->GetItemText(sel);
-    if (name == "..")
-        return m_currentDir.parent_path();
+    if (sel == 0 && list->HasParentRow())
+        return CurrentDir().parent_path();
 
-    return m_currentDir / fs::path(name.ToStdString());
+    const FileItem* item = list->ItemAt(sel);
+    if (!item) return std::nullopt;
+    return item->fullPath;
 }
 
 /*
@@ -319,7 +900,7 @@ void MainFrame::DoNew()
     if (nameWx.empty()) return;
 
     std::string err;
-    if (!m_fs.CreateDirectory(m_currentDir, nameWx.ToStdString(), err))
+    if (!m_fs.CreateDirectory(CurrentDir(), nameWx.ToStdString(), err))
     {
         ShowError("New Directory", wxString::FromUTF8(err));
         return;
@@ -331,9 +912,9 @@ void MainFrame::DoNew()
 
 /*
 Function: MainFrame::DoOpen
-Description: Opens the selected item. If a directory is selected, navigates into it by calling
-             SetDirectory. If a file is selected, launches it using the system default
-             application through wxWidgets. Displays an informational dialog if nothing is
+Description: Opens the selected item. If a directory or a supported archive is selected,
+             navigates into it by calling SetDirectory. If a file is selected, launches it
+             using the system default application through wxWidgets. Displays an informational dialog if nothing is
              selected.
 Parameters:
   - None
@@ -351,13 +932,20 @@ void MainFrame::DoOpen()
 
     const fs::path target = *sp;
 
-    // go into the directory or laungh the file
-    if (FileSystemService::IsDirectory(target))
+    // go into the directory (or archive) or laungh the file
+    if (m_fs.IsBrowsable(target))
     {
         SetDirectory(target);
         return;
     }
 
+    if (m_fs.IsInArchive(target))
+    {
+        wxMessageBox("Files inside an archive cannot be opened directly.\nCopy and paste them into a folder first.",
+                     "Open", wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+
     if (!wxLaunchDefaultApplication(ToWx(target)))
     {
         ShowError("Open Failed", "Could not open file with the default application.");
@@ -402,12 +990,41 @@ void MainFrame::DoRename()
     RefreshListing();
 }
 
+/*
+Function: MainFrame::DoBatchRename
+Description: Opens the batch rename dialog for the current directory, working on its listing
+             from the shared cache, and refreshes the listing if anything was renamed.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void MainFrame::DoBatchRename()
+{
+    std::string err;
+    DirectoryListing listing = m_fs.ListDirectoryCached(CurrentDir(), true, err);
+    if (!listing)
+    {
+        ShowError("Batch Rename", wxString::FromUTF8(err));
+        return;
+    }
+
+    BatchRenameDialog dlg(this, m_fs, CurrentDir(), std::move(listing));
+    dlg.ShowModal();
+    if (dlg.Renamed() == 0) return;
+
+    SetStatusText(wxString::Format("Renamed %zu entries", dlg.Renamed()));
+    RefreshListing();
+}
+
 /*
 Function: MainFrame::DoDelete
-Description: Deletes the selected file or directory after prompting for confirmation. Uses
-             FileSystemService to remove files/directories (recursive for directories if
-             supported). Refreshes the listing after successful deletion and shows errors
-             if the operation fails (e.g., permissions).
+Description: Deletes the selected file or directory after prompting for confirmation. The item
+             is moved to the trash, which is instant even for huge trees and can be undone
+             with Undo Delete; only if that is not possible (no trash for this filesystem, the
+             item is already in the trash, ...) is the user asked to delete permanently.
+             Refreshes the listing after successful deletion and shows errors if the
+             operation fails (e.g., permissions).
 Parameters:
   - None
 Returns:
@@ -423,8 +1040,27 @@ void MainFrame::DoDelete()
     }
 
     const fs::path target = *sp;
+    std::string err;
+
+    if (m_fs.HasTrash())
+    {
+        const wxString msg =
+            "Move to the trash:\n" + ToWx(target) +
+            "\n\nYou can bring it back with Edit > Undo Delete (Ctrl+Z).";
+
+        if (wxMessageBox(msg, "Confirm Delete", wxYES_NO | wxYES_DEFAULT | wxICON_QUESTION, this) != wxYES)
+            return;
+
+        if (m_fs.MoveToTrash(target, err))
+        {
+            SetStatusText("Moved to trash: " + ToWx(target.filename()) + " | Ctrl+Z to undo");
+            RefreshListing();
+            return;
+        }
+    }
 
     const wxString msg =
+        (err.empty() ? wxString() : wxString::FromUTF8(err) + "\n\n") +
         "Are you sure you want to delete:\n" + ToWx(target) +
         "\n\nThis cannot be undone.";
 
@@ -432,7 +1068,6 @@ void MainFrame::DoDelete()
         return;
 
     std::uintmax_t removed = 0;
-    std::string err;
     if (!m_fs.RemoveRecursive(target, removed, err))
     {
         ShowError("Delete", wxString::FromUTF8(err));
@@ -472,15 +1107,21 @@ void MainFrame::DoCopy(bool cut)
 /*
 Function: MainFrame::DoPaste
 Description: Completes a copy/cut operation by pasting the clipboard item into the current
-             directory. If a target with the same name exists, prompts the user for overwrite.
-             Calls FileSystemService to perform the copy/move. On success clears clipboard and
+             directory, optionally compressing files to .zst or decompressing .zst files on
+             the way. If a target with the same name exists, prompts the user for overwrite.
+             Calls FileSystemService to perform the copy/move; overwrites are staged and
+             swapped atomically, so a failed paste leaves the old destination intact. The
+             paste runs on a worker thread; if it takes longer than a moment, a progress
+             dialog shows the files and the raw and compressed bytes done so far. With
+             "Verify Pasted Copies" checked, every copied file is read back and compared,
+             and files that differ are listed in the error. On success clears clipboard and
              updates status bar; on failure shows an error dialog.
 Parameters:
-  - None
+  - transform: Compression applied to the pasted files.
 Returns:
   - None
 */
-void MainFrame::DoPaste()
+void MainFrame::DoPaste(PasteTransform transform)
 {
     if (!m_clip.hasItem)
     {
@@ -488,10 +1129,14 @@ void MainFrame::DoPaste()
         return;
     }
 
-    const fs::path dest = m_currentDir / m_clip.source.filename();
-    bool overwrite = false;
+    PasteOptions opts;
+    opts.transform = transform;
+    opts.verify = m_verifyPastes;
+    const VirtualClipboard clip = m_clip;
+    const fs::path destDir = CurrentDir();
+    const fs::path dest = m_fs.PasteTarget(clip, destDir, opts);
 
-    if (FileSystemService::Exists(dest))
+    if (m_fs.Exists(dest))
     {
         const wxString q =
             "Destination already exists:\n" + ToWx(dest) +
@@ -500,11 +1145,39 @@ void MainFrame::DoPaste()
         if (wxMessageBox(q, "Overwrite?", wxYES_NO | wxNO_DEFAULT | wxICON_WARNING, this) != wxYES)
             return;
 
-        overwrite = true;
+        opts.overwriteExisting = true;
     }
 
+    PasteProgress progress;
+    opts.progress = &progress;
+    PasteStats stats;
     std::string err;
-    if (!m_fs.PasteInto(m_clip, m_currentDir, overwrite, err))
+    auto task = std::async(std::launch::async, [&]
+    {
+        return m_fs.PasteInto(clip, destDir, opts, stats, err);
+    });
+
+    // Quick pastes finish before any dialog would appear
+    if (task.wait_for(std::chrono::milliseconds(300)) != std::future_status::ready)
+    {
+        wxProgressDialog dlg("Paste", "Pasting " + ToWx(clip.source.filename()) + "...", 100, this,
+                             wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME);
+        while (task.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+        {
+            wxString text = wxString::Format("%llu file(s) done", (unsigned long long)progress.filesCopied.load());
+            if (transform != PasteTransform::None)
+            {
+                const wxString raw = m_format.FormatSize(progress.rawBytes.load());
+                const wxString packed = m_format.FormatSize(progress.compressedBytes.load());
+                text += " | " + raw + " raw, " + packed + " compressed";
+            }
+            if (opts.verify)
+                text += wxString::Format(" | %llu verified", (unsigned long long)progress.filesVerified.load());
+            dlg.Pulse(text);
+        }
+    }
+
+    if (!task.get())
     {
         ShowError("Paste", wxString::FromUTF8(err));
         return;
@@ -512,14 +1185,35 @@ void MainFrame::DoPaste()
 
     // Assignment expectation: clipboard clears after paste
     m_clip.Clear();
-    SetStatusText("Paste complete | Clipboard cleared");
+    if (clip.isCut)
+    {
+        SetStatusText("Paste complete | Clipboard cleared");
+    }
+    else
+    {
+        wxString summary = wxString::Format("Paste complete (%llu file(s), %s",
+                                            (unsigned long long)stats.filesCopied,
+                                            wxString(m_format.FormatSize(stats.bytesCopied)));
+        if (stats.rawBytes > 0)
+        {
+            const wxString raw = m_format.FormatSize(stats.rawBytes);
+            const wxString packed = m_format.FormatSize(stats.compressedBytes);
+            summary += "; " + raw + " raw / " + packed + " compressed";
+        }
+        if (stats.holeBytes > 0)
+            summary += "; " + wxString(m_format.FormatSize(stats.holeBytes)) + " of holes kept sparse";
+        if (opts.verify)
+            summary += wxString::Format("; %llu verified", (unsigned long long)stats.filesVerified);
+        SetStatusText(summary + ") | Clipboard cleared");
+    }
     RefreshListing();
 }
 
 /*
 Function: MainFrame::DoRefresh
-Description: Refreshes the file listing for the current directory by calling RefreshListing.
-             Used for the Refresh menu item and F5 accelerator.
+Description: Refreshes the file listing for the current directory by calling RefreshListing,
+             bypassing the listing cache so external changes are always picked up. Used for
+             the Refresh menu item and F5 accelerator.
 Parameters:
   - None
 Returns:
@@ -527,7 +1221,7 @@ Returns:
 */
 void MainFrame::DoRefresh()
 {
-    RefreshListing();
+    RefreshListing(true);
 }
 
 /*
@@ -548,6 +1242,26 @@ void MainFrame::OnPathEnter(wxCommandEvent&)
     SetDirectory(fs::path(text.ToStdString()));
 }
 
+/*
+Function: MainFrame::OnPathLookupDone
+Description: Called on the GUI thread once the path completion index has listed a directory
+             it could not suggest from while the user typed. If the path bar still holds that
+             text, it is set again so the text control asks its completer once more and shows
+             the suggestions without waiting for another keystroke.
+Parameters:
+  - typed: Text of the path bar when the lookup was queued, UTF-8.
+Returns:
+  - None
+*/
+void MainFrame::OnPathLookupDone(const std::string& typed)
+{
+    const wxString current = m_pathCtrl->GetValue();
+    if (current.utf8_string() != typed) return;
+
+    m_pathCtrl->SetValue(current);
+    m_pathCtrl->SetInsertionPointEnd();
+}
+
 /*
 Function: MainFrame::OnItemActivated
 Description: Event handler for double-click/activation on a list item. This mirrors “Open”:
@@ -562,6 +1276,94 @@ void MainFrame::OnItemActivated(wxListEvent&)
     DoOpen();
 }
 
+/*
+Function: MainFrame::OnTabChanged
+Description: Event handler for switching tabs. Makes the selected tab active and shows its
+             directory in the path bar. The tab's list normally already holds its rows, but a
+             paste, delete or sync in another tab may have changed its directory since, so its
+             listing is revalidated through the cache: one stat when nothing changed, and the
+             rows are replaced only if the listing did. A tab restored from the session that
+             has not been shown yet, or whose snapshot turned out outdated, is refreshed.
+Parameters:
+  - event: Notebook event carrying the newly selected page.
+Returns:
+  - None
+*/
+void MainFrame::OnTabChanged(wxBookCtrlEvent& event)
+{
+    const int sel = event.GetSelection();
+    if (sel < 0 || (std::size_t)sel >= m_tabs.size()) return;
+
+    m_activeTab = (std::size_t)sel;
+    m_pathCtrl->SetValue(ToWx(CurrentDir()));
+
+    BrowserTab& tab = ActiveTab();
+    if (tab.stale)
+    {
+        RefreshListing();
+        return;
+    }
+    std::string err;
+    if (m_fs.ListDirectoryCached(tab.dir, true, err) != tab.listing) RefreshListing();
+}
+
+/*
+Function: MainFrame::OnListMotion
+Description: Mouse handler for the file lists. When the pointer moves onto a new folder row,
+             that folder is handed to the preloader so opening it is instant.
+Parameters:
+  - event: Mouse event with the pointer position inside the list.
+Returns:
+  - None
+*/
+void MainFrame::OnListMotion(wxMouseEvent& event)
+{
+    event.Skip();
+
+    BrowserTab& tab = ActiveTab();
+    int flags = 0;
+    const long row = tab.list->HitTest(event.GetPosition(), flags);
+    if (row == tab.hoverRow) return;
+
+    tab.hoverRow = row;
+    if (row < 0 || !(flags & wxLIST_HITTEST_ONITEM)) return;
+
+    // the ".." row has no entry
+    const FileItem* item = tab.list->ItemAt(row);
+    if (!item || !item->isDir) return;
+
+    m_preloader.Request(item->fullPath);
+}
+
+/*
+Function: MainFrame::OnMenuNewTab
+Description: Menu event handler for “New Tab”. Opens a tab on the current directory; the
+             listing comes from the shared cache.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuNewTab(wxCommandEvent&)
+{
+    const fs::path dir = CurrentDir();
+    CreateTab(dir);
+    SetDirectory(dir);
+}
+
+/*
+Function: MainFrame::OnMenuCloseTab
+Description: Menu event handler for “Close Tab”. Delegates to CloseActiveTab().
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuCloseTab(wxCommandEvent&)
+{
+    CloseActiveTab();
+}
+
 /*
 Function: MainFrame::OnMenuNew
 Description: Menu event handler for “New Directory”. Delegates to DoNew().
@@ -601,6 +1403,19 @@ void MainFrame::OnMenuRename(wxCommandEvent&)
     DoRename(); 
 }
 
+/*
+Function: MainFrame::OnMenuBatchRename
+Description: Menu event handler for “Batch Rename”. Delegates to DoBatchRename().
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuBatchRename(wxCommandEvent&)
+{
+    DoBatchRename();
+}
+
 /*
 Function: MainFrame::OnMenuDelete
 Description: Menu event handler for “Delete”. Delegates to DoDelete().
@@ -627,6 +1442,29 @@ void MainFrame::OnMenuCopy(wxCommandEvent&)
     DoCopy(false); 
 }
 
+/*
+Function: MainFrame::OnMenuUndo
+Description: Menu event handler for “Undo Delete”. Restores the item most recently moved to the
+             trash and refreshes the listing.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuUndo(wxCommandEvent&)
+{
+    fs::path restored;
+    std::string err;
+    if (!m_fs.UndoDelete(restored, err))
+    {
+        ShowError("Undo Delete", wxString::FromUTF8(err));
+        return;
+    }
+
+    SetStatusText("Restored: " + ToWx(restored));
+    RefreshListing();
+}
+
 /*
 Function: MainFrame::OnMenuCut
 Description: Menu event handler for “Cut”. Marks selection for move by calling DoCopy(true).
@@ -653,6 +1491,48 @@ void MainFrame::OnMenuPaste(wxCommandEvent&)
     DoPaste(); 
 }
 
+/*
+Function: MainFrame::OnMenuPasteCompressed
+Description: Menu event handler for “Paste Compressed”. Pastes the copied item with every file
+             compressed into a .zst file.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuPasteCompressed(wxCommandEvent&)
+{
+    DoPaste(PasteTransform::Compress);
+}
+
+/*
+Function: MainFrame::OnMenuPasteDecompressed
+Description: Menu event handler for “Paste Decompressed”. Pastes the copied item with every
+             .zst file expanded back to its original contents and name.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuPasteDecompressed(wxCommandEvent&)
+{
+    DoPaste(PasteTransform::Decompress);
+}
+
+/*
+Function: MainFrame::OnMenuVerifyPastes
+Description: Menu event handler for “Verify Pasted Copies”. Turns read-back verification of
+             pasted copies on or off.
+Parameters:
+  - event: wxWidgets menu command event carrying the new check state.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuVerifyPastes(wxCommandEvent& event)
+{
+    m_verifyPastes = event.IsChecked();
+}
+
 /*
 Function: MainFrame::OnMenuRefresh
 Description: Menu event handler for “Refresh”. Delegates to DoRefresh().
@@ -666,6 +1546,254 @@ void MainFrame::OnMenuRefresh(wxCommandEvent&)
     DoRefresh(); 
 }
 
+/*
+Function: MainFrame::OnMenuBack
+Description: Menu event handler for “Back” (Alt+Left). Returns the active tab to the directory
+             it showed before.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuBack(wxCommandEvent&)
+{
+    GoHistory(false);
+}
+
+/*
+Function: MainFrame::OnMenuForward
+Description: Menu event handler for “Forward” (Alt+Right). Undoes the last Back.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuForward(wxCommandEvent&)
+{
+    GoHistory(true);
+}
+
+/*
+Function: MainFrame::OnMenuHumanSizes
+Description: Menu event handler for “Human-readable Sizes”. Switches the size column between
+             raw byte counts and KB/MB/GB units. The lists format their cells when they are
+             drawn, so the rows already held are only repainted; nothing is listed again.
+Parameters:
+  - event: wxWidgets menu command event carrying the new check state.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuHumanSizes(wxCommandEvent& event)
+{
+    m_format.SetHumanReadableSizes(event.IsChecked());
+    for (BrowserTab& tab : m_tabs) tab.list->Refresh();
+}
+
+/*
+Function: MainFrame::OnMenuDetailColumn
+Description: Menu event handler for the View > Columns items. Adds or removes the column of
+             one extended metadata field in every tab and re-lists the active directory so
+             the field is read; the other tabs are marked stale and re-listed when shown, so
+             they do not show the new column empty. Hidden fields are not read at all.
+Parameters:
+  - event: wxWidgets menu command event carrying the item id and new check state.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuDetailColumn(wxCommandEvent& event)
+{
+    const unsigned field = kDetailColumns[event.GetId() - ID_ColOwner].field;
+    unsigned details = m_fs.DetailFields();
+    details = event.IsChecked() ? (details | field) : (details & ~field);
+    m_fs.SetDetailFields(details);
+
+    for (BrowserTab& tab : m_tabs)
+    {
+        tab.list->SetDetailColumns(details);
+        tab.stale = true;
+    }
+    RefreshListing();
+}
+
+/*
+Function: MainFrame::OnMenuSync
+Description: Menu event handler for “Compare / Sync”. Opens the sync dialog with the current
+             directory as source and the next tab's directory (if any) as target, then
+             refreshes the listing in case the sync changed it. The target tab revalidates
+             its rows when it is shown (see OnTabChanged).
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuSync(wxCommandEvent&)
+{
+    const fs::path target = m_tabs.size() > 1 ? m_tabs[(m_activeTab + 1) % m_tabs.size()].dir : CurrentDir();
+
+    SyncDialog dlg(this, m_fs, CurrentDir(), target);
+    dlg.ShowModal();
+    RefreshListing();
+}
+
+/*
+Function: MainFrame::OnMenuContentSearch
+Description: Menu event handler for “Search Contents”. Opens a content search window rooted at
+             the current directory; the search runs in the background while the user keeps
+             browsing.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuContentSearch(wxCommandEvent&)
+{
+    if (!m_fs.Backend().IsLocal())
+    {
+        ShowError("Search Contents", "Content search needs a backend on the local filesystem.");
+        return;
+    }
+
+    auto* frame = new ContentSearchFrame(this, CurrentDir());
+    frame->Show(true);
+}
+
+/*
+Function: MainFrame::OnMenuWatch
+Description: Menu event handler for “Watch Directories”. Opens the watch dashboard for the
+             current directory, which shows the directories below it that are changing and
+             how fast.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuWatch(wxCommandEvent&)
+{
+    if (!m_fs.Backend().IsLocal())
+    {
+        ShowError("Watch Directories", "Watching needs a backend on the local filesystem.");
+        return;
+    }
+
+    auto* frame = new WatchFrame(this, CurrentDir());
+    frame->Show(true);
+}
+
+/*
+Function: MainFrame::OnMenuSnapshot
+Description: Menu event handler for “Export Tree Snapshot”. Asks where to save, then writes a
+             snapshot of everything below the current directory (staying on its filesystem)
+             in the background with a cancellable progress dialog. The saved .fmsnap file can
+             be opened like a folder to browse the snapshot read-only.
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuSnapshot(wxCommandEvent&)
+{
+    const fs::path root = CurrentDir();
+    if (!m_fs.Backend().IsLocal() || m_fs.IsInArchive(root))
+    {
+        ShowError("Export Tree Snapshot", "Snapshots are taken of directories on the local filesystem.");
+        return;
+    }
+
+    const fs::path name = root.filename().empty() ? fs::path("root") : root.filename();
+    wxFileDialog saveDlg(this, "Export Tree Snapshot", ToWx(root.parent_path()),
+                         ToWx(name) + kSnapshotSuffix, "Tree snapshots (*.fmsnap)|*.fmsnap",
+                         wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (saveDlg.ShowModal() != wxID_OK)
+        return;
+    const fs::path dst = fs::u8path(saveDlg.GetPath().utf8_string());
+
+    std::atomic<bool> cancel{ false };
+    SnapshotOptions opts;
+    opts.sameDevice = true;
+    opts.cancel = &cancel;
+    SnapshotProgress progress;
+    SnapshotStats stats;
+    std::string err;
+    auto task = std::async(std::launch::async, [&]
+    {
+        return WriteTreeSnapshot(root, dst, opts, &progress, stats, err);
+    });
+
+    if (task.wait_for(std::chrono::milliseconds(300)) != std::future_status::ready)
+    {
+        wxProgressDialog dlg("Export Tree Snapshot", "Walking " + ToWx(root) + "...", 100, this,
+                             wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME | wxPD_CAN_ABORT);
+        while (task.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+        {
+            const wxString text = wxString::Format("%llu entries | ", (unsigned long long)progress.entries.load()) +
+                                  wxString(m_format.FormatSize(progress.bytesWritten.load())) + " written";
+            if (!dlg.Pulse(text))
+                cancel = true;
+        }
+    }
+
+    if (!task.get())
+    {
+        ShowError("Export Tree Snapshot", wxString::FromUTF8(err));
+        return;
+    }
+    if (stats.cancelled)
+    {
+        SetStatusText("Snapshot export cancelled");
+        return;
+    }
+
+    wxString summary = wxString::Format("Snapshot of %llu entries (%llu directories) saved to ",
+                                        (unsigned long long)stats.entries,
+                                        (unsigned long long)stats.directories);
+    summary += ToWx(dst) + " (" + wxString(m_format.FormatSize(stats.fileBytes)) + ")";
+    if (stats.unreadable > 0)
+        summary += wxString::Format(" | %llu unreadable directories left empty", (unsigned long long)stats.unreadable);
+    SetStatusText(summary);
+    if (dst.parent_path() == root)
+        RefreshListing();
+}
+
+/*
+Function: MainFrame::OnMenuBandwidth
+Description: Menu event handler for “I/O Bandwidth Limit”. Shows the per-device concurrency the
+             scheduler has tuned so far and asks for a per-device bandwidth cap in MB/s for
+             bulk copies (0 = unlimited).
+Parameters:
+  - event: wxWidgets menu command event.
+Returns:
+  - None
+*/
+void MainFrame::OnMenuBandwidth(wxCommandEvent&)
+{
+    IoScheduler& scheduler = m_fs.Scheduler();
+
+    wxString prompt = "Bandwidth cap per device for copies, in MB/s (0 = unlimited):";
+    for (const auto& dev : scheduler.Devices())
+    {
+        prompt += wxString::Format("\n  device %llu (%s): %u parallel, %.1f MB/s last",
+                                   (unsigned long long)dev.device,
+                                   dev.rotational ? "HDD" : "SSD",
+                                   dev.concurrency,
+                                   dev.bytesPerSecond / (1024.0 * 1024.0));
+    }
+
+    const unsigned long long currentMb = scheduler.BandwidthLimit() / (1024 * 1024);
+    wxTextEntryDialog dlg(this, prompt, "I/O Bandwidth Limit", wxString::Format("%llu", currentMb));
+    if (dlg.ShowModal() != wxID_OK) return;
+
+    unsigned long long mb = 0;
+    if (!dlg.GetValue().Trim(true).Trim(false).ToULongLong(&mb))
+    {
+        ShowError("I/O Bandwidth Limit", "Enter a whole number of MB/s.");
+        return;
+    }
+
+    scheduler.SetBandwidthLimit((std::uint64_t)mb * 1024 * 1024);
+    SetStatusText(mb == 0 ? wxString("Copy bandwidth: unlimited")
+                          : wxString::Format("Copy bandwidth capped at %llu MB/s per device", mb));
+}
+
 /*
 Function: MainFrame::OnMenuExit
 Description: Menu event handler for “Exit”. Closes the application window cleanly.
@@ -678,3 +1806,21 @@ void MainFrame::OnMenuExit(wxCommandEvent&)
 { 
     Close(true); 
 }
+
+/*
+Function: MainFrame::OnClose
+Description: Window close handler. Stops the background revalidation and path lookups, saves
+             the session for the next launch, then lets the frame be destroyed.
+Parameters:
+  - event: wxWidgets close event.
+Returns:
+  - None
+*/
+void MainFrame::OnClose(wxCloseEvent& event)
+{
+    StopRevalidation();
+    m_pathIndex->Stop();
+
+    SaveCurrentSession();
+    event.Skip();
+}
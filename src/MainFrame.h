@@ -10,10 +10,23 @@ February 1, 2026
 
 #include <wx/wx.h>
 #include <wx/listctrl.h>
+#include <wx/notebook.h>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
+#include <vector>
 
+#include "DirectoryPreloader.h"
 #include "FileSystemService.h"
+#include "ListingFormatter.h"
+#include "ListingView.h"
+#include "NavigationHistory.h"
+#include "PathCompletionIndex.h"
+#include "Session.h"
 
 
 
@@ -22,35 +35,89 @@ namespace fs = std::filesystem;
 
 
 
+// One browsing tab: its own list control, directory and listing
+struct BrowserTab
+{
+    ListingView* list = nullptr;
+    fs::path dir;
+    DirectoryListing listing;
+    long hoverRow = -1;
+    bool stale = false;         // rows missing or out of date; refreshed when the tab is shown
+    bool fromSnapshot = false;  // rows painted from a saved listing, not yet revalidated
+    NavigationHistory history;
+};
+
 class MainFrame final : public wxFrame
 {
 public:
-    explicit MainFrame(const wxString& title);
+    MainFrame(const wxString& title, std::shared_ptr<FsBackend> backend = nullptr);
+    ~MainFrame() override;
 
 private:
     wxTextCtrl* m_pathCtrl = nullptr;
-    wxListCtrl* m_listCtrl = nullptr;
+    wxNotebook* m_notebook = nullptr;
+
+    std::vector<BrowserTab> m_tabs;
+    std::size_t m_activeTab = 0;
+    std::deque<fs::path> m_recentDirs;
 
-    fs::path m_currentDir;
     VirtualClipboard m_clip;
     FileSystemService m_fs;
+    DirectoryPreloader m_preloader{ m_fs };
+    // path bar completions; shared with the completer the path control owns
+    std::shared_ptr<PathCompletionIndex> m_pathIndex = std::make_shared<PathCompletionIndex>(m_fs);
+    ListingFormatter m_format;
+    bool m_verifyPastes = false;
+
+    // Checks listings painted without reading the directory (restored session, history)
+    // against the real directories; started on first use
+    std::thread m_revalidator;
+    std::mutex m_revalidateMutex;
+    std::condition_variable m_revalidateWake;
+    std::deque<SessionTab> m_revalidateQueue;
+    bool m_closing = false;     // guarded by m_revalidateMutex
 
     // menu and control ids
     enum
     {
         ID_Path = wxID_HIGHEST + 1,
         ID_List,
+        ID_Tabs,
+
+        ID_NewTab,
+        ID_CloseTab,
 
         ID_New,
         ID_Open,
         ID_Rename,
+        ID_BatchRename,
         ID_Delete,
 
+        ID_Undo,
         ID_Copy,
         ID_Cut,
         ID_Paste,
+        ID_PasteCompressed,
+        ID_PasteDecompressed,
+        ID_VerifyPastes,
 
         ID_Refresh,
+        ID_Back,
+        ID_Forward,
+        ID_HumanSizes,
+        // optional detail columns, in kDetailColumns order
+        ID_ColOwner,
+        ID_ColMode,
+        ID_ColInode,
+        ID_ColLinks,
+        ID_ColAllocated,
+        ID_ColBirthTime,
+
+        ID_Sync,
+        ID_Bandwidth,
+        ID_ContentSearch,
+        ID_Watch,
+        ID_Snapshot,
         ID_Exit
     };
 
@@ -58,37 +125,77 @@ private:
     void BuildMenus();
     void BuildAccelerators();
 
+    BrowserTab& ActiveTab() { return m_tabs[m_activeTab]; }
+    const BrowserTab& ActiveTab() const { return m_tabs[m_activeTab]; }
+    const fs::path& CurrentDir() const { return ActiveTab().dir; }
+    void CreateTab(const fs::path& dir);
+    bool RestoreSession();
+    void SaveCurrentSession();
+    void RevalidateLater(SessionTab snapshot);
+    void RevalidateLoop();
+    void StopRevalidation();
+    void OnSnapshotChecked(const fs::path& dir, bool current);
+    void OnPathLookupDone(const std::string& typed);
+    void CloseActiveTab();
+    void PreloadNeighbours();
+
     void SetDirectory(const fs::path& dir);
-    void RefreshListing();
+    void RememberDirectory(const fs::path& dir);
+    HistoryEntry CaptureState(const BrowserTab& tab) const;
+    void GoHistory(bool forward);
+    void ShowHistoryEntry(const HistoryEntry& entry);
+    void RestoreView(BrowserTab& tab, long topRow, const std::string& selected);
+    void RefreshListing(bool rescan = false);
+    void ShowRows(BrowserTab& tab, DirectoryListing listing);
     std::optional<fs::path> GetSelectedPath() const;
 
     void DoNew();
     void DoOpen();
     void DoRename();
+    void DoBatchRename();
     void DoDelete();
     void DoCopy(bool cut);
-    void DoPaste();
+    void DoPaste(PasteTransform transform = PasteTransform::None);
     void DoRefresh();
 
     // event handlers
     void OnPathEnter(wxCommandEvent& event);
     void OnItemActivated(wxListEvent& event);
+    void OnTabChanged(wxBookCtrlEvent& event);
+    void OnListMotion(wxMouseEvent& event);
+
+    void OnMenuNewTab(wxCommandEvent& event);
+    void OnMenuCloseTab(wxCommandEvent& event);
 
     void OnMenuNew(wxCommandEvent& event);
     void OnMenuOpen(wxCommandEvent& event);
     void OnMenuRename(wxCommandEvent& event);
+    void OnMenuBatchRename(wxCommandEvent& event);
     void OnMenuDelete(wxCommandEvent& event);
 
+    void OnMenuUndo(wxCommandEvent& event);
     void OnMenuCopy(wxCommandEvent& event);
     void OnMenuCut(wxCommandEvent& event);
     void OnMenuPaste(wxCommandEvent& event);
+    void OnMenuPasteCompressed(wxCommandEvent& event);
+    void OnMenuPasteDecompressed(wxCommandEvent& event);
+    void OnMenuVerifyPastes(wxCommandEvent& event);
 
     void OnMenuRefresh(wxCommandEvent& event);
+    void OnMenuBack(wxCommandEvent& event);
+    void OnMenuForward(wxCommandEvent& event);
+    void OnMenuHumanSizes(wxCommandEvent& event);
+    void OnMenuDetailColumn(wxCommandEvent& event);
+    void OnMenuSync(wxCommandEvent& event);
+    void OnMenuBandwidth(wxCommandEvent& event);
+    void OnMenuContentSearch(wxCommandEvent& event);
+    void OnMenuWatch(wxCommandEvent& event);
+    void OnMenuSnapshot(wxCommandEvent& event);
     void OnMenuExit(wxCommandEvent& event);
+    void OnClose(wxCloseEvent& event);
 
     // ui utilities
     static wxString ToWx(const fs::path& p);
-    static wxString FormatLongDate(std::time_t t);
     void ShowError(const wxString& title, const wxString& msg);
 
     wxDECLARE_EVENT_TABLE();
@@ -0,0 +1,663 @@
+/*
+Parneet Baidwan - 251259638
+Description: The MemoryFsBackend class in this file implements an in-memory filesystem backend. Entries live in one sorted map keyed by normalized absolute path, so a directory's children and subtree are contiguous ranges; file contents are not stored, only sizes. Every operation sleeps for the configured latency (and copies for their size at the configured rate) before touching the map, which makes timings of higher-level operations repeatable.
+February 1, 2026
+*/
+
+#include "MemoryFsBackend.h"
+#include "IoScheduler.h"
+
+#include <thread>
+
+namespace
+{
+    // Fixed device id so memory copies get their own scheduler slot
+    constexpr DeviceId kMemoryDevice = 0x6d656d6f7279ull;
+
+    // Timestamps are this epoch plus the logical clock, in seconds
+    constexpr std::time_t kEpoch = 1767225600;   // 2026-01-01 00:00 UTC
+
+    constexpr int kMaxLinkHops = 8;
+}
+
+/*
+Function: MemoryFsBackend::MemoryFsBackend
+Description: Creates an empty filesystem containing only the root directory.
+Parameters:
+  - latency: Delay added to every operation.
+  - bytesPerSecond: Simulated transfer rate for file copies (0 = instant).
+Returns:
+  - None
+*/
+MemoryFsBackend::MemoryFsBackend(std::chrono::microseconds latency, std::uint64_t bytesPerSecond)
+{
+    SetLatency(latency, bytesPerSecond);
+    Node root;
+    root.type = FsEntryType::Directory;
+    m_nodes.emplace("/", root);
+}
+
+/*
+Function: MemoryFsBackend::SetLatency
+Description: Changes the simulated per-operation latency and copy rate.
+Parameters:
+  - latency: Delay added to every operation.
+  - bytesPerSecond: Simulated transfer rate for file copies (0 = instant).
+Returns:
+  - None
+*/
+void MemoryFsBackend::SetLatency(std::chrono::microseconds latency, std::uint64_t bytesPerSecond)
+{
+    m_latencyUs = latency.count();
+    m_bytesPerSecond = bytesPerSecond;
+}
+
+/*
+Function: MemoryFsBackend::Key
+Description: Normalizes a path into a map key: absolute, lexically normal, '/' separated and
+             without a trailing slash.
+Parameters:
+  - p: Path to normalize.
+Returns:
+  - std::string: Map key.
+*/
+std::string MemoryFsBackend::Key(const fs::path& p)
+{
+    const fs::path abs = p.has_root_directory() ? p : fs::path("/") / p;
+    std::string key = abs.lexically_normal().generic_string();
+    while (key.size() > 1 && key.back() == '/') key.pop_back();
+    return key;
+}
+
+std::string MemoryFsBackend::ParentKey(const std::string& key)
+{
+    const std::size_t slash = key.rfind('/');
+    if (key == "/" || slash == std::string::npos) return std::string();
+    return slash == 0 ? std::string("/") : key.substr(0, slash);
+}
+
+std::string MemoryFsBackend::ChildPrefix(const std::string& key)
+{
+    return key == "/" ? key : key + "/";
+}
+
+/*
+Function: MemoryFsBackend::Delay
+Description: Sleeps for the configured latency plus the transfer time of bytes. Called before
+             the map lock is taken, so concurrent operations overlap like real I/O.
+Parameters:
+  - bytes: Bytes transferred by the operation.
+Returns:
+  - None
+*/
+void MemoryFsBackend::Delay(std::uint64_t bytes) const
+{
+    std::int64_t us = m_latencyUs;
+    const std::uint64_t rate = m_bytesPerSecond;
+    if (rate > 0 && bytes > 0) us += (std::int64_t)(bytes * 1000000.0 / (double)rate);
+    if (us > 0) std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+bool MemoryFsBackend::IsDirLocked(const std::string& key) const
+{
+    auto it = m_nodes.find(key);
+    return it != m_nodes.end() && it->second.type == FsEntryType::Directory;
+}
+
+/*
+Function: MemoryFsBackend::AddLocked
+Description: Inserts a new entry below an existing directory and advances the clock, which
+             also changes the parent's modification stamp.
+Parameters:
+  - key: Key of the new entry.
+  - node: Entry to insert.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the entry was added; false otherwise.
+*/
+bool MemoryFsBackend::AddLocked(const std::string& key, Node node, std::string& outErr) const
+{
+    if (m_nodes.count(key))
+    {
+        outErr = "File exists: " + key;
+        return false;
+    }
+    const std::string parent = ParentKey(key);
+    if (!IsDirLocked(parent))
+    {
+        outErr = "No such directory: " + parent;
+        return false;
+    }
+
+    node.stamp = ++m_clock;
+    m_nodes[parent].stamp = m_clock;
+    m_nodes.emplace(key, std::move(node));
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::TakeSubtreeLocked
+Description: Removes an entry and everything below it from the map and returns them.
+Parameters:
+  - key: Root of the subtree.
+Returns:
+  - NodeMap: Removed entries, keyed as before.
+*/
+MemoryFsBackend::NodeMap MemoryFsBackend::TakeSubtreeLocked(const std::string& key) const
+{
+    NodeMap out;
+    auto self = m_nodes.find(key);
+    if (self == m_nodes.end()) return out;
+    out.insert(m_nodes.extract(self));
+
+    const std::string prefix = ChildPrefix(key);
+    for (auto it = m_nodes.lower_bound(prefix);
+         it != m_nodes.end() && it->first.compare(0, prefix.size(), prefix) == 0;)
+    {
+        out.insert(m_nodes.extract(it++));
+    }
+    return out;
+}
+
+/*
+Function: MemoryFsBackend::PutSubtreeLocked
+Description: Inserts a subtree taken with TakeSubtreeLocked under a new root key.
+Parameters:
+  - fromKey: Root key the entries were taken from.
+  - toKey: New root key.
+  - nodes: Entries to insert (consumed).
+Returns:
+  - None
+*/
+void MemoryFsBackend::PutSubtreeLocked(const std::string& fromKey, const std::string& toKey, NodeMap& nodes) const
+{
+    for (auto& kv : nodes) m_nodes[toKey + kv.first.substr(fromKey.size())] = std::move(kv.second);
+    nodes.clear();
+}
+
+/*
+Function: MemoryFsBackend::CreateDirectories
+Description: Creates a directory and any missing parents, without latency. Used to seed the
+             filesystem.
+Parameters:
+  - p: Directory to create.
+Returns:
+  - bool: true if the directory exists afterwards; false if a file is in the way.
+*/
+bool MemoryFsBackend::CreateDirectories(const fs::path& p)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::string key = Key(p);
+
+    std::size_t pos = 1;
+    while (pos <= key.size())
+    {
+        std::size_t next = key.find('/', pos);
+        if (next == std::string::npos) next = key.size();
+        const std::string part = key.substr(0, next);
+        pos = next + 1;
+
+        auto it = m_nodes.find(part);
+        if (it != m_nodes.end())
+        {
+            if (it->second.type != FsEntryType::Directory) return false;
+            continue;
+        }
+        Node dir;
+        dir.type = FsEntryType::Directory;
+        std::string err;
+        if (!AddLocked(part, dir, err)) return false;
+    }
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::AddFile
+Description: Creates a file of the given size (and its parent directories), without latency.
+             Used to seed the filesystem.
+Parameters:
+  - p: File to create.
+  - sizeBytes: Reported file size.
+Returns:
+  - bool: true if the file was added; false otherwise.
+*/
+bool MemoryFsBackend::AddFile(const fs::path& p, std::uintmax_t sizeBytes)
+{
+    if (!CreateDirectories(fs::path(ParentKey(Key(p))))) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Node file;
+    file.sizeBytes = sizeBytes;
+    std::string err;
+    return AddLocked(Key(p), file, err);
+}
+
+/*
+Function: MemoryFsBackend::SeedFrom
+Description: Mirrors a directory of the real filesystem at the same absolute path: every
+             directory, file size and symlink target below it is added, without latency, so
+             the same tree can be timed on a real backend and on this one.
+Parameters:
+  - realDir: Directory on disk to mirror.
+  - outEntries: Output count of entries added below realDir.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the tree was mirrored; false otherwise.
+*/
+bool MemoryFsBackend::SeedFrom(const fs::path& realDir, std::uintmax_t& outEntries, std::string& outErr)
+{
+    outEntries = 0;
+    std::error_code ec;
+    const fs::path root = fs::canonical(realDir, ec);
+    if (ec || !fs::is_directory(root, ec))
+    {
+        outErr = "Cannot seed from " + realDir.string() + ": not a directory";
+        return false;
+    }
+    if (!CreateDirectories(root))
+    {
+        outErr = "Cannot seed from " + realDir.string() + ": a file is in the way";
+        return false;
+    }
+
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        const fs::directory_entry& entry = *it;
+        bool added = false;
+        if (entry.is_symlink(ec))
+        {
+            if (!CreateDirectories(entry.path().parent_path())) break;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Node link;
+            link.type = FsEntryType::Symlink;
+            link.linkTarget = fs::read_symlink(entry.path(), ec).string();
+            std::string err;
+            added = AddLocked(Key(entry.path()), link, err);
+        }
+        else if (entry.is_directory(ec))
+            added = CreateDirectories(entry.path());
+        else
+            added = AddFile(entry.path(), entry.is_regular_file(ec) ? entry.file_size(ec) : 0);
+        if (added) ++outEntries;
+    }
+    if (ec)
+    {
+        outErr = "Cannot seed from " + realDir.string() + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::Stat
+Description: Looks up an entry, following up to eight levels of symlinks if asked.
+Parameters:
+  - p: Path to inspect.
+  - followLinks: If false, a symlink is reported as such instead of its target.
+  - out: Output metadata.
+Returns:
+  - bool: true if the entry exists; false otherwise (also for a dangling link).
+*/
+bool MemoryFsBackend::Stat(const fs::path& p, bool followLinks, FsStat& out) const
+{
+    Delay(0);
+    out = FsStat{};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string key = Key(p);
+    for (int hops = 0;; hops++)
+    {
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end()) return false;
+
+        const Node& n = it->second;
+        if (followLinks && n.type == FsEntryType::Symlink)
+        {
+            if (hops >= kMaxLinkHops) return false;
+            const fs::path target(n.linkTarget);
+            key = target.has_root_directory() ? Key(target) : Key(fs::path(ParentKey(key)) / target);
+            continue;
+        }
+
+        out.type = n.type;
+        out.sizeBytes = n.type == FsEntryType::File ? n.sizeBytes : 0;
+        out.modified = kEpoch + (std::time_t)n.stamp;
+        out.changeStamp = fs::file_time_type(fs::file_time_type::duration((fs::file_time_type::rep)n.stamp));
+        return true;
+    }
+}
+
+/*
+Function: MemoryFsBackend::List
+Description: Lists a directory by walking its range of the sorted map; whole subdirectory
+             ranges are skipped with one lookup each, so the cost does not depend on how
+             deep the tree below is.
+Parameters:
+  - dir: Directory to enumerate.
+  - details: Extended fields requested; the in-memory tree keeps none of them.
+  - outItems: Output entries.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was listed; false otherwise.
+*/
+bool MemoryFsBackend::List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const
+{
+    (void)details;
+    Delay(0);
+    outItems.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::string key = Key(dir);
+    if (!IsDirLocked(key))
+    {
+        outErr = "Not a directory: " + dir.string();
+        return false;
+    }
+
+    const std::string prefix = ChildPrefix(key);
+    for (auto it = m_nodes.lower_bound(prefix);
+         it != m_nodes.end() && it->first.compare(0, prefix.size(), prefix) == 0;)
+    {
+        const std::string name = it->first.substr(prefix.size());
+        if (name.empty())
+        {
+            ++it;
+            continue;
+        }
+
+        const std::size_t slash = name.find('/');
+        if (slash != std::string::npos)
+        {
+            // inside a subdirectory: jump past its whole range ('0' follows '/')
+            it = m_nodes.lower_bound(prefix + name.substr(0, slash) + '0');
+            continue;
+        }
+
+        const Node* n = &it->second;
+        if (n->type == FsEntryType::Symlink)
+        {
+            const fs::path target(n->linkTarget);
+            auto t = m_nodes.find(target.has_root_directory() ? Key(target) : Key(fs::path(key) / target));
+            n = t != m_nodes.end() ? &t->second : nullptr;
+        }
+
+        FileItem item;
+        item.fullPath = dir / fs::u8path(name);
+        if (n)
+        {
+            item.isDir = n->type == FsEntryType::Directory;
+            item.sizeBytes = n->type == FsEntryType::File ? n->sizeBytes : 0;
+            item.modified = kEpoch + (std::time_t)n->stamp;
+        }
+        outItems.push_back(std::move(item));
+        ++it;
+    }
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::CreateDirectory
+Description: Creates one directory below an existing one.
+Parameters:
+  - p: Directory to create.
+  - attributesFrom: Ignored; the memory backend keeps no permissions.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was created; false otherwise.
+*/
+bool MemoryFsBackend::CreateDirectory(const fs::path& p, const fs::path&, std::string& outErr) const
+{
+    Delay(0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Node dir;
+    dir.type = FsEntryType::Directory;
+    if (!AddLocked(Key(p), dir, outErr))
+    {
+        outErr = "Create directory failed: " + outErr;
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::Rename
+Description: Moves an entry and its subtree to a new key with POSIX rename semantics: an
+             existing target of the same kind is replaced if it is a file or an empty
+             directory.
+Parameters:
+  - from: Existing entry.
+  - to: New path.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the entry was renamed; false otherwise.
+*/
+bool MemoryFsBackend::Rename(const fs::path& from, const fs::path& to, std::string& outErr) const
+{
+    Delay(0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::string fromKey = Key(from);
+    const std::string toKey = Key(to);
+    auto src = m_nodes.find(fromKey);
+    if (src == m_nodes.end())
+    {
+        outErr = "No such file or directory";
+        return false;
+    }
+    if (fromKey == toKey) return true;
+    if (fromKey == "/" || toKey.compare(0, ChildPrefix(fromKey).size(), ChildPrefix(fromKey)) == 0)
+    {
+        outErr = "Invalid argument";
+        return false;
+    }
+    if (!IsDirLocked(ParentKey(toKey)))
+    {
+        outErr = "No such directory: " + ParentKey(toKey);
+        return false;
+    }
+
+    auto dst = m_nodes.find(toKey);
+    if (dst != m_nodes.end())
+    {
+        const bool srcDir = src->second.type == FsEntryType::Directory;
+        const bool dstDir = dst->second.type == FsEntryType::Directory;
+        if (srcDir != dstDir)
+        {
+            outErr = dstDir ? "Is a directory" : "Not a directory";
+            return false;
+        }
+        auto child = m_nodes.lower_bound(ChildPrefix(toKey));
+        if (dstDir && child != m_nodes.end() && child->first.compare(0, toKey.size() + 1, ChildPrefix(toKey)) == 0)
+        {
+            outErr = "Directory not empty";
+            return false;
+        }
+        m_nodes.erase(dst);
+    }
+
+    NodeMap moved = TakeSubtreeLocked(fromKey);
+    moved.begin()->second.stamp = ++m_clock;
+    PutSubtreeLocked(fromKey, toKey, moved);
+    m_nodes[ParentKey(fromKey)].stamp = m_clock;
+    m_nodes[ParentKey(toKey)].stamp = m_clock;
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::Exchange
+Description: Atomically swaps two entries (and their subtrees) under the map lock.
+Parameters:
+  - a: First entry.
+  - b: Second entry.
+Returns:
+  - bool: true if the entries were swapped; false otherwise.
+*/
+bool MemoryFsBackend::Exchange(const fs::path& a, const fs::path& b) const
+{
+    Delay(0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::string aKey = Key(a);
+    const std::string bKey = Key(b);
+    if (aKey == bKey || aKey == "/" || bKey == "/") return false;
+    if (!m_nodes.count(aKey) || !m_nodes.count(bKey)) return false;
+    if (aKey.compare(0, ChildPrefix(bKey).size(), ChildPrefix(bKey)) == 0 ||
+        bKey.compare(0, ChildPrefix(aKey).size(), ChildPrefix(aKey)) == 0)
+        return false;
+
+    NodeMap aNodes = TakeSubtreeLocked(aKey);
+    NodeMap bNodes = TakeSubtreeLocked(bKey);
+    PutSubtreeLocked(aKey, bKey, aNodes);
+    PutSubtreeLocked(bKey, aKey, bNodes);
+
+    ++m_clock;
+    m_nodes[ParentKey(aKey)].stamp = m_clock;
+    m_nodes[ParentKey(bKey)].stamp = m_clock;
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::RemoveAll
+Description: Deletes an entry and its subtree. A missing entry is not an error.
+Parameters:
+  - p: Entry to delete.
+  - outRemoved: Output number of entries removed.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if everything was removed; false otherwise.
+*/
+bool MemoryFsBackend::RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const
+{
+    Delay(0);
+    outRemoved = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::string key = Key(p);
+    if (key == "/")
+    {
+        outErr = "Cannot remove the root directory.";
+        return false;
+    }
+
+    outRemoved = TakeSubtreeLocked(key).size();
+    if (outRemoved > 0) m_nodes[ParentKey(key)].stamp = ++m_clock;
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::CopySymlink
+Description: Recreates a symlink entry at a new path.
+Parameters:
+  - src: Existing symlink.
+  - dst: Path of the new link.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the link was created; false otherwise.
+*/
+bool MemoryFsBackend::CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const
+{
+    Delay(0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_nodes.find(Key(src));
+    if (it == m_nodes.end() || it->second.type != FsEntryType::Symlink)
+    {
+        outErr = "Copy failed for " + src.string() + ": not a symlink";
+        return false;
+    }
+    Node link = it->second;
+    if (!AddLocked(Key(dst), link, outErr))
+    {
+        outErr = "Copy failed for " + src.string() + ": " + outErr;
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::CopyFile
+Description: Copies a file entry. The simulated transfer time is spent outside the map lock
+             and reported to the I/O scheduler under a dedicated device id, so bandwidth caps
+             and concurrency limits apply to memory copies as well.
+Parameters:
+  - src: Source file.
+  - dst: Destination path (must not exist).
+  - scheduler: I/O scheduler pacing the copy.
+  - outBytes: Output number of bytes copied.
+  - outHoleBytes: Output number of bytes of holes left unwritten; always 0.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the file was copied; false otherwise.
+*/
+bool MemoryFsBackend::CopyFile(const fs::path& src,
+                               const fs::path& dst,
+                               IoScheduler& scheduler,
+                               std::uintmax_t& outBytes,
+                               std::uintmax_t& outHoleBytes,
+                               std::string& outErr) const
+{
+    outBytes = 0;
+    outHoleBytes = 0;
+    IoScheduler::Ticket ticket = scheduler.Acquire({ kMemoryDevice });
+
+    const std::string srcKey = Key(src);
+    const std::string dstKey = Key(dst);
+    std::uintmax_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_nodes.find(srcKey);
+        if (it == m_nodes.end() || it->second.type != FsEntryType::File)
+        {
+            outErr = "Cannot open " + src.string() + ": not a regular file";
+            return false;
+        }
+        if (m_nodes.count(dstKey))
+        {
+            outErr = "Cannot create " + dst.string() + ": File exists";
+            return false;
+        }
+        size = it->second.sizeBytes;
+    }
+
+    Delay(size);
+    scheduler.Transfer(kMemoryDevice, size);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Node file;
+    file.sizeBytes = size;
+    if (!AddLocked(dstKey, file, outErr))
+    {
+        outErr = "Cannot create " + dst.string() + ": " + outErr;
+        return false;
+    }
+    outBytes = size;
+    return true;
+}
+
+/*
+Function: MemoryFsBackend::Flush
+Description: Nothing is persisted; only the latency of a flush is simulated.
+Parameters:
+  - p: Ignored.
+  - isDir: Ignored.
+Returns:
+  - None
+*/
+void MemoryFsBackend::Flush(const fs::path&, bool) const
+{
+    Delay(0);
+}
+
+/*
+Function: MemoryFsBackend::Canonical
+Description: Returns the normalized absolute form of a path.
+Parameters:
+  - p: Path to normalize.
+Returns:
+  - fs::path: Normalized path.
+*/
+fs::path MemoryFsBackend::Canonical(const fs::path& p) const
+{
+    return fs::path(Key(p));
+}
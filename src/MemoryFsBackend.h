@@ -0,0 +1,83 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the MemoryFsBackend class, an in-memory filesystem for reproducible measurements. It keeps only the tree structure and file sizes, advances a logical clock on every change so results are deterministic, and delays every operation by a configurable latency (plus an optional transfer time per byte) to model different storage.
+February 1, 2026
+*/
+
+#ifndef MEMORYFSBACKEND_H
+#define MEMORYFSBACKEND_H
+
+#include "FsBackend.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+// Deterministic in-memory backend with injectable latency
+class MemoryFsBackend final : public FsBackend
+{
+public:
+    explicit MemoryFsBackend(std::chrono::microseconds latency = std::chrono::microseconds(0),
+                             std::uint64_t bytesPerSecond = 0);
+
+    const char* Name() const override { return "memory"; }
+    bool IsLocal() const override { return false; }
+
+    void SetLatency(std::chrono::microseconds latency, std::uint64_t bytesPerSecond);
+
+    // Seeding helpers (no latency applied)
+    bool CreateDirectories(const fs::path& p);
+    bool AddFile(const fs::path& p, std::uintmax_t sizeBytes);
+    bool SeedFrom(const fs::path& realDir, std::uintmax_t& outEntries, std::string& outErr);
+
+    bool Stat(const fs::path& p, bool followLinks, FsStat& out) const override;
+    bool List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const override;
+
+    bool CreateDirectory(const fs::path& p, const fs::path& attributesFrom, std::string& outErr) const override;
+    bool Rename(const fs::path& from, const fs::path& to, std::string& outErr) const override;
+    bool Exchange(const fs::path& a, const fs::path& b) const override;
+    bool RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const override;
+
+    bool CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const override;
+    bool CopyFile(const fs::path& src,
+                  const fs::path& dst,
+                  IoScheduler& scheduler,
+                  std::uintmax_t& outBytes,
+                  std::uintmax_t& outHoleBytes,
+                  std::string& outErr) const override;
+
+    void Flush(const fs::path& p, bool isDir) const override;
+
+    fs::path Canonical(const fs::path& p) const override;
+
+private:
+    struct Node
+    {
+        FsEntryType type = FsEntryType::File;
+        std::uintmax_t sizeBytes = 0;
+        std::uint64_t stamp = 0;
+        std::string linkTarget;
+    };
+
+    using NodeMap = std::map<std::string, Node>;
+
+    static std::string Key(const fs::path& p);
+    static std::string ParentKey(const std::string& key);
+    static std::string ChildPrefix(const std::string& key);
+
+    void Delay(std::uint64_t bytes) const;
+    bool IsDirLocked(const std::string& key) const;
+    bool AddLocked(const std::string& key, Node node, std::string& outErr) const;
+    NodeMap TakeSubtreeLocked(const std::string& key) const;
+    void PutSubtreeLocked(const std::string& fromKey, const std::string& toKey, NodeMap& nodes) const;
+
+    mutable std::mutex m_mutex;
+    mutable NodeMap m_nodes;            // sorted, so a directory's subtree is one range
+    mutable std::uint64_t m_clock = 0;  // logical time, advanced by every change
+
+    std::atomic<std::int64_t> m_latencyUs{ 0 };
+    std::atomic<std::uint64_t> m_bytesPerSecond{ 0 };
+};
+
+#endif // MEMORYFSBACKEND_H
@@ -0,0 +1,133 @@
+/*
+Parneet Baidwan - 251259638
+Description: The NavigationHistory class in this file keeps a tab's back and forward stacks. Visiting a directory pushes the one being left and clears the forward stack; going back or forward moves the current directory onto the opposite stack. After every change the listings held are trimmed, oldest first, to the configured number of entries, counting a listing shared by several history entries only once.
+February 1, 2026
+*/
+
+#include "NavigationHistory.h"
+
+#include <unordered_set>
+
+/*
+Function: NavigationHistory::NavigationHistory
+Description: Creates an empty history.
+Parameters:
+  - maxEntries: Directories kept on each stack.
+  - maxListedItems: Total listing entries the history may hold.
+Returns:
+  - None
+*/
+NavigationHistory::NavigationHistory(std::size_t maxEntries, std::size_t maxListedItems)
+    : m_maxEntries(maxEntries), m_maxListedItems(maxListedItems)
+{
+}
+
+/*
+Function: NavigationHistory::Visit
+Description: Records the directory being left for a new one: it becomes the most recent back
+             entry and the forward stack is cleared.
+Parameters:
+  - leaving: State of the directory being left.
+Returns:
+  - None
+*/
+void NavigationHistory::Visit(HistoryEntry leaving)
+{
+    m_forward.clear();
+    Push(m_back, std::move(leaving));
+    Trim();
+}
+
+/*
+Function: NavigationHistory::Back
+Description: Steps back: the current directory goes onto the forward stack and the most recent
+             back entry is returned.
+Parameters:
+  - current: State of the directory shown now.
+  - outTarget: Output entry to show.
+Returns:
+  - bool: true if there was an entry to go back to; false otherwise.
+*/
+bool NavigationHistory::Back(HistoryEntry current, HistoryEntry& outTarget)
+{
+    if (m_back.empty()) return false;
+
+    outTarget = std::move(m_back.back());
+    m_back.pop_back();
+    Push(m_forward, std::move(current));
+    Trim();
+    return true;
+}
+
+/*
+Function: NavigationHistory::Forward
+Description: Steps forward again after Back.
+Parameters:
+  - current: State of the directory shown now.
+  - outTarget: Output entry to show.
+Returns:
+  - bool: true if there was an entry to go forward to; false otherwise.
+*/
+bool NavigationHistory::Forward(HistoryEntry current, HistoryEntry& outTarget)
+{
+    if (m_forward.empty()) return false;
+
+    outTarget = std::move(m_forward.back());
+    m_forward.pop_back();
+    Push(m_back, std::move(current));
+    Trim();
+    return true;
+}
+
+/*
+Function: NavigationHistory::Push
+Description: Adds an entry on top of a stack, dropping the oldest one beyond the entry limit.
+Parameters:
+  - stack: Back or forward stack.
+  - entry: Entry to add.
+Returns:
+  - None
+*/
+void NavigationHistory::Push(std::deque<HistoryEntry>& stack, HistoryEntry entry)
+{
+    stack.push_back(std::move(entry));
+    while (stack.size() > m_maxEntries) stack.pop_front();
+}
+
+/*
+Function: NavigationHistory::Trim
+Description: Keeps the listings of the entries closest to the current directory (the top of
+             both stacks, alternating) until the item budget is used up, and drops the
+             listings of all older entries.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void NavigationHistory::Trim()
+{
+    std::unordered_set<const std::vector<FileItem>*> counted;
+    std::size_t used = 0;
+    bool full = false;
+
+    auto keep = [&](HistoryEntry& entry)
+    {
+        if (!entry.listing || counted.count(entry.listing.get())) return;
+        if (full || used + entry.listing->size() > m_maxListedItems)
+        {
+            full = true;
+            entry.listing = nullptr;
+            return;
+        }
+        used += entry.listing->size();
+        counted.insert(entry.listing.get());
+    };
+
+    auto back = m_back.rbegin();
+    auto forward = m_forward.rbegin();
+    while (back != m_back.rend() || forward != m_forward.rend())
+    {
+        if (back != m_back.rend()) keep(*back++);
+        if (forward != m_forward.rend()) keep(*forward++);
+    }
+}
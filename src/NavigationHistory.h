@@ -0,0 +1,52 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the NavigationHistory class, the back/forward history of one tab. Every entry remembers the directory together with the listing it showed, the change stamp that listing was read at, the scroll position and the selected entry, so going back or forward can repaint the directory at once and revalidate it afterwards. The listings held by the history are bounded by their total number of entries; the oldest entries give up their listing first and keep only their directory.
+February 1, 2026
+*/
+
+#ifndef NAVIGATIONHISTORY_H
+#define NAVIGATIONHISTORY_H
+
+#include "FileSystemService.h"
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+// A directory as the user left it
+struct HistoryEntry
+{
+    fs::path dir;
+    DirectoryListing listing;           // null once dropped to stay within the bound
+    fs::file_time_type stamp{};         // change stamp of dir the listing was read at
+    bool stampKnown = false;            // false: the listing must be re-read to be trusted
+    unsigned details = 0;               // kDetail* fields the listing was read with
+    long topRow = 0;                    // first visible row
+    std::string selected;               // name of the selected entry, empty if none
+};
+
+// Back and forward stacks of one tab
+class NavigationHistory final
+{
+public:
+    explicit NavigationHistory(std::size_t maxEntries = 50, std::size_t maxListedItems = 100000);
+
+    void Visit(HistoryEntry leaving);
+    bool Back(HistoryEntry current, HistoryEntry& outTarget);
+    bool Forward(HistoryEntry current, HistoryEntry& outTarget);
+
+    bool CanGoBack() const { return !m_back.empty(); }
+    bool CanGoForward() const { return !m_forward.empty(); }
+
+private:
+    void Push(std::deque<HistoryEntry>& stack, HistoryEntry entry);
+    void Trim();
+
+    // most recent entry at the back of each deque
+    std::deque<HistoryEntry> m_back;
+    std::deque<HistoryEntry> m_forward;
+    std::size_t m_maxEntries;
+    std::size_t m_maxListedItems;
+};
+
+#endif // NAVIGATIONHISTORY_H
@@ -0,0 +1,316 @@
+/*
+Parneet Baidwan - 251259638
+Description: The PathCompletionIndex class implementation in this file answers path bar completions from a sorted list of subdirectory names per directory, found with a binary search on the typed prefix. Listings the tabs have shown are indexed on a worker thread, which also lists directories that are not indexed yet; those lookups wait until the user has stopped typing for a moment, and only the most recent one is kept.
+February 1, 2026
+*/
+
+#include "PathCompletionIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Quiet time after the last keystroke before an unknown directory is listed
+    constexpr std::chrono::milliseconds kLookupDelay(80);
+    // Directories whose names are kept, least recently used dropped first
+    constexpr std::size_t kMaxIndexedDirs = 128;
+    // Listings waiting to be indexed; older ones are dropped
+    constexpr std::size_t kMaxPending = 16;
+    // Suggestions returned for one prefix
+    constexpr std::size_t kMaxMatches = 200;
+
+#ifdef _WIN32
+    constexpr const char* kSeparators = "/\\";
+#else
+    constexpr const char* kSeparators = "/";
+#endif
+
+    /*
+    Function: IndexKey
+    Description: Key a directory is indexed under: its normal form without a trailing
+                 separator, so "/usr/" and "/usr" are the same directory.
+    Parameters:
+      - dir: Directory path.
+    Returns:
+      - std::string: UTF-8 key.
+    */
+    std::string IndexKey(const fs::path& dir)
+    {
+        fs::path normal = dir.lexically_normal();
+        if (!normal.has_filename() && normal != normal.root_path()) normal = normal.parent_path();
+        return normal.u8string();
+    }
+}
+
+/*
+Function: PathCompletionIndex::PathCompletionIndex
+Description: Starts the indexing and lookup thread.
+Parameters:
+  - fs: Filesystem service used to list directories; must outlive the index or Stop must be
+        called first.
+Returns:
+  - None
+*/
+PathCompletionIndex::PathCompletionIndex(const FileSystemService& fs)
+    : m_fs(fs)
+{
+    m_thread = std::thread(&PathCompletionIndex::Run, this);
+}
+
+/*
+Function: PathCompletionIndex::~PathCompletionIndex
+Description: Stops the worker thread if Stop has not been called.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+PathCompletionIndex::~PathCompletionIndex()
+{
+    Stop();
+}
+
+/*
+Function: PathCompletionIndex::Stop
+Description: Drops pending work and joins the worker thread. Names already indexed are still
+             offered by Complete, but nothing new is listed.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void PathCompletionIndex::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_pending.clear();
+        m_lookup.clear();
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+/*
+Function: PathCompletionIndex::SetLookupDone
+Description: Sets the callback told when a directory Complete had to queue has been indexed,
+             so the caller can ask for completions again. It runs on the worker thread.
+Parameters:
+  - onDone: Callback receiving the text that was typed; nullptr for none.
+Returns:
+  - None
+*/
+void PathCompletionIndex::SetLookupDone(LookupDoneSink onDone)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_onLookupDone = std::move(onDone);
+}
+
+/*
+Function: PathCompletionIndex::Add
+Description: Hands a listing a tab has shown to the worker thread to be indexed. Does nothing
+             if the directory is already indexed from this same listing.
+Parameters:
+  - dir: Directory the listing belongs to.
+  - listing: Listing of dir.
+Returns:
+  - None
+*/
+void PathCompletionIndex::Add(const fs::path& dir, DirectoryListing listing)
+{
+    if (!listing || dir.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) return;
+
+        auto it = m_nodes.find(IndexKey(dir));
+        if (it != m_nodes.end() && it->second.source.lock() == listing) return;
+
+        m_pending.emplace_back(dir, std::move(listing));
+        if (m_pending.size() > kMaxPending) m_pending.pop_front();
+    }
+    m_cv.notify_one();
+}
+
+/*
+Function: PathCompletionIndex::Complete
+Description: Suggests completions for a typed absolute path: every indexed subdirectory of the
+             typed parent whose name starts with the last component, followed by a separator.
+             Hidden entries are only offered once the component starts with a dot. If the
+             parent is not indexed it is queued for listing and nothing is suggested yet (the
+             lookup-done callback is told once it has been indexed); if exactly one name
+             matches, that directory is queued too, ready for the next component.
+Parameters:
+  - typed: Text of the path bar, UTF-8.
+  - outMatches: Output full paths to suggest, sorted.
+Returns:
+  - bool: true if the parent directory was indexed; false otherwise.
+*/
+bool PathCompletionIndex::Complete(const std::string& typed, std::vector<std::string>& outMatches)
+{
+    outMatches.clear();
+
+    const std::size_t cut = typed.find_last_of(kSeparators);
+    if (cut == std::string::npos) return false;
+
+    const std::string parent = typed.substr(0, cut + 1);
+    const std::string leaf = typed.substr(cut + 1);
+    if (!fs::u8path(parent).is_absolute()) return false;
+
+    const std::string key = IndexKey(fs::u8path(parent));
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end())
+    {
+        RequestLookup(key);
+        m_waitingKey = key;
+        m_waitingTyped = typed;
+        return false;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+
+    const std::vector<std::string>& names = it->second.names;
+    const bool hidden = !leaf.empty() && leaf[0] == '.';
+    for (auto n = std::lower_bound(names.begin(), names.end(), leaf);
+         n != names.end() && n->compare(0, leaf.size(), leaf) == 0 && outMatches.size() < kMaxMatches; ++n)
+    {
+        if (!hidden && !n->empty() && (*n)[0] == '.') continue;
+        outMatches.push_back(parent + *n + kSeparators[0]);
+    }
+
+    if (outMatches.size() == 1)
+    {
+        const std::string next = IndexKey(fs::u8path(outMatches.front()));
+        if (m_nodes.find(next) == m_nodes.end()) RequestLookup(next);
+    }
+    return true;
+}
+
+/*
+Function: PathCompletionIndex::RequestLookup
+Description: Makes a directory the one to list once typing pauses, replacing any earlier
+             request and restarting the delay. Asking again for the directory already
+             requested keeps its delay, so typing more of the same component does not put
+             the lookup off. The caller holds m_mutex.
+Parameters:
+  - key: Index key of the directory.
+Returns:
+  - None
+*/
+void PathCompletionIndex::RequestLookup(const std::string& key)
+{
+    if (m_stop || m_lookup == key) return;
+
+    m_lookup = key;
+    m_lookupDue = std::chrono::steady_clock::now() + kLookupDelay;
+    m_cv.notify_one();
+}
+
+/*
+Function: PathCompletionIndex::Store
+Description: Indexes the subdirectory names of a listing, dropping the least recently used
+             directory once the index is full. The names are sorted before m_mutex is taken.
+Parameters:
+  - key: Index key of the directory.
+  - listing: Listing of the directory.
+Returns:
+  - None
+*/
+void PathCompletionIndex::Store(const std::string& key, const DirectoryListing& listing)
+{
+    std::vector<std::string> names;
+    for (const FileItem& item : *listing)
+    {
+        if (item.isDir) names.push_back(item.fullPath.filename().u8string());
+    }
+    std::sort(names.begin(), names.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end())
+    {
+        m_lru.push_front(key);
+        it = m_nodes.emplace(key, Node{}).first;
+        it->second.lru = m_lru.begin();
+    }
+    else
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    }
+    it->second.names = std::move(names);
+    it->second.source = listing;
+
+    while (m_nodes.size() > kMaxIndexedDirs)
+    {
+        m_nodes.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+}
+
+/*
+Function: PathCompletionIndex::Run
+Description: Worker loop. Indexes listings handed over by Add as they arrive; when none are
+             waiting, lists the requested directory once its delay has passed. The listing
+             goes through the listing cache, so a directory a tab has read recently costs a
+             stat. Indexing the directory Complete is waiting for calls the lookup-done
+             callback, outside the lock.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void PathCompletionIndex::Run()
+{
+    for (;;)
+    {
+        fs::path dir;
+        DirectoryListing listing;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_pending.empty() || !m_lookup.empty(); });
+            if (m_stop) return;
+
+            if (!m_pending.empty())
+            {
+                dir = std::move(m_pending.front().first);
+                listing = std::move(m_pending.front().second);
+                m_pending.pop_front();
+            }
+            else if (std::chrono::steady_clock::now() < m_lookupDue)
+            {
+                // each keystroke moves the deadline; check again when it passes
+                m_cv.wait_until(lock, m_lookupDue);
+                continue;
+            }
+            else
+            {
+                dir = fs::u8path(m_lookup);
+                m_lookup.clear();
+            }
+        }
+
+        if (!listing)
+        {
+            if (!m_fs.IsDirectory(dir)) continue;
+
+            std::string err;
+            listing = m_fs.ListDirectoryCached(dir, true, err);
+            if (!listing) continue;
+        }
+        const std::string key = IndexKey(dir);
+        Store(key, listing);
+
+        std::string typed;
+        LookupDoneSink onDone;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (key != m_waitingKey || !m_onLookupDone) continue;
+            m_waitingKey.clear();
+            typed = std::move(m_waitingTyped);
+            onDone = m_onLookupDone;
+        }
+        onDone(typed);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the PathCompletionIndex class which suggests completions for a path being typed into the path bar. It keeps a sorted index of the subdirectory names of recently listed directories, so a suggestion is a binary search away, and lists directories it does not know yet on a background thread once the user pauses typing, so completion never waits on a slow mount.
+February 1, 2026
+*/
+
+#ifndef PATHCOMPLETIONINDEX_H
+#define PATHCOMPLETIONINDEX_H
+
+#include "FileSystemService.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Prefix index of subdirectory names per directory, filled from listings and a lookup thread
+class PathCompletionIndex final
+{
+public:
+    // Called from the worker thread with the text Complete could not answer, once the
+    // directory it was waiting for has been indexed
+    using LookupDoneSink = std::function<void(const std::string& typed)>;
+
+    explicit PathCompletionIndex(const FileSystemService& fs);
+    ~PathCompletionIndex();
+
+    PathCompletionIndex(const PathCompletionIndex&) = delete;
+    PathCompletionIndex& operator=(const PathCompletionIndex&) = delete;
+
+    void SetLookupDone(LookupDoneSink onDone);
+    void Add(const fs::path& dir, DirectoryListing listing);
+    bool Complete(const std::string& typed, std::vector<std::string>& outMatches);
+    void Stop();
+
+private:
+    struct Node
+    {
+        std::vector<std::string> names;                         // subdirectory names, sorted
+        std::weak_ptr<const std::vector<FileItem>> source;      // listing they were taken from
+        std::list<std::string>::iterator lru;                   // position in m_lru
+    };
+
+    void RequestLookup(const std::string& key);
+    void Store(const std::string& key, const DirectoryListing& listing);
+    void Run();
+
+    const FileSystemService& m_fs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::unordered_map<std::string, Node> m_nodes;
+    std::list<std::string> m_lru;                                   // most recently used first
+    std::deque<std::pair<fs::path, DirectoryListing>> m_pending;    // listings still to index
+    std::string m_lookup;                                           // directory to list, empty if none
+    std::chrono::steady_clock::time_point m_lookupDue;
+    std::string m_waitingKey;                                       // directory Complete could not answer
+    std::string m_waitingTyped;                                     // text typed then
+    LookupDoneSink m_onLookupDone;
+    bool m_stop = false;
+
+    std::thread m_thread;
+};
+
+#endif // PATHCOMPLETIONINDEX_H
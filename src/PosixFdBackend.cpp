@@ -0,0 +1,648 @@
+/*
+Parneet Baidwan - 251259638
+Description: The PosixFdBackend class in this file implements the filesystem backend with POSIX file-descriptor calls. Listing opens the directory once and stats every entry relative to it, so the kernel never resolves the full path again, and can hand the entries out in chunks while the directory is still being read; recursive removal walks the tree with openat and unlinkat; and staged pastes are swapped in with an atomic rename exchange where the platform offers one.
+February 1, 2026
+*/
+
+#include "PosixFdBackend.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "FileCopy.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/stdio.h>
+#endif
+
+namespace
+{
+    std::string ErrnoText()
+    {
+        return std::generic_category().message(errno);
+    }
+
+    /*
+    Function: FillStat
+    Description: Converts a struct stat into FsStat. The change stamp is built from the
+                 nanosecond mtime so that it changes whenever the directory does.
+    Parameters:
+      - st: Result of stat/fstatat.
+      - out: Output metadata.
+    Returns:
+      - None
+    */
+    void FillStat(const struct stat& st, FsStat& out)
+    {
+        if (S_ISLNK(st.st_mode)) out.type = FsEntryType::Symlink;
+        else if (S_ISDIR(st.st_mode)) out.type = FsEntryType::Directory;
+        else if (S_ISREG(st.st_mode)) out.type = FsEntryType::File;
+        else out.type = FsEntryType::Other;
+
+        out.sizeBytes = S_ISREG(st.st_mode) ? (std::uintmax_t)st.st_size : 0;
+        out.modified = st.st_mtime;
+
+#if defined(__APPLE__)
+        const long nsec = st.st_mtimespec.tv_nsec;
+#else
+        const long nsec = st.st_mtim.tv_nsec;
+#endif
+        out.changeStamp = fs::file_time_type(std::chrono::duration_cast<fs::file_time_type::duration>(
+            std::chrono::seconds(st.st_mtime) + std::chrono::nanoseconds(nsec)));
+    }
+
+    /*
+    Function: RenameAt
+    Description: Renames an entry of a directory descriptor. With noReplace an existing target
+                 is never replaced: renameat2(RENAME_NOREPLACE) on Linux and
+                 renameatx_np(RENAME_EXCL) on macOS, or a check before the rename where the
+                 filesystem does not support those.
+    Parameters:
+      - dirFd: Directory descriptor.
+      - from: Entry name.
+      - to: New entry name.
+      - noReplace: Fail if to exists.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the entry was renamed; false otherwise.
+    */
+    bool RenameAt(int dirFd, const char* from, const char* to, bool noReplace, std::string& outErr)
+    {
+        if (noReplace)
+        {
+#if defined(__linux__) && defined(RENAME_NOREPLACE)
+            if (::renameat2(dirFd, from, dirFd, to, RENAME_NOREPLACE) == 0) return true;
+            if (errno != EINVAL && errno != ENOSYS)
+            {
+                outErr = ErrnoText();
+                return false;
+            }
+#elif defined(__APPLE__) && defined(RENAME_EXCL)
+            if (::renameatx_np(dirFd, from, dirFd, to, RENAME_EXCL) == 0) return true;
+            if (errno != ENOTSUP)
+            {
+                outErr = ErrnoText();
+                return false;
+            }
+#endif
+            struct stat st{};
+            if (::fstatat(dirFd, to, &st, AT_SYMLINK_NOFOLLOW) == 0)
+            {
+                outErr = std::generic_category().message(EEXIST);
+                return false;
+            }
+        }
+
+        if (::renameat(dirFd, from, dirFd, to) != 0)
+        {
+            outErr = ErrnoText();
+            return false;
+        }
+        return true;
+    }
+
+    /*
+    Function: RemoveAt
+    Description: Deletes the entry name below the directory descriptor parentFd, recursing
+                 into directories through descriptors opened with O_NOFOLLOW so a symlink is
+                 never followed out of the tree.
+    Parameters:
+      - parentFd: Directory descriptor (or AT_FDCWD).
+      - name: Entry name (or a full path with AT_FDCWD).
+      - removed: Incremented for every entry removed.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the entry is gone; false otherwise.
+    */
+    bool RemoveAt(int parentFd, const char* name, std::uintmax_t& removed, std::string& outErr)
+    {
+        struct stat st{};
+        if (::fstatat(parentFd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+            return errno == ENOENT;
+
+        if (S_ISDIR(st.st_mode))
+        {
+            const int fd = ::openat(parentFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd < 0)
+            {
+                outErr = std::string("Cannot open ") + name + ": " + ErrnoText();
+                return false;
+            }
+            DIR* d = ::fdopendir(fd);
+            if (!d)
+            {
+                ::close(fd);
+                outErr = std::string("Cannot open ") + name + ": " + ErrnoText();
+                return false;
+            }
+
+            // collect first so deleting does not disturb the directory stream
+            std::vector<std::string> children;
+            while (const dirent* de = ::readdir(d))
+            {
+                if (std::strcmp(de->d_name, ".") == 0 || std::strcmp(de->d_name, "..") == 0) continue;
+                children.emplace_back(de->d_name);
+            }
+
+            bool ok = true;
+            for (const std::string& child : children)
+            {
+                if (!RemoveAt(::dirfd(d), child.c_str(), removed, outErr))
+                {
+                    ok = false;
+                    break;
+                }
+            }
+            ::closedir(d);
+            if (!ok) return false;
+
+            if (::unlinkat(parentFd, name, AT_REMOVEDIR) != 0)
+            {
+                outErr = std::string("Cannot remove ") + name + ": " + ErrnoText();
+                return false;
+            }
+        }
+        else if (::unlinkat(parentFd, name, 0) != 0)
+        {
+            outErr = std::string("Cannot remove ") + name + ": " + ErrnoText();
+            return false;
+        }
+
+        removed++;
+        return true;
+    }
+
+    /*
+    Function: FillItemFromStat
+    Description: Fills a listing row from a struct stat, copying only the extended fields
+                 that were asked for.
+    Parameters:
+      - st: Result of fstatat.
+      - details: kDetail* fields wanted.
+      - item: Row to fill.
+    Returns:
+      - None
+    */
+    void FillItemFromStat(const struct stat& st, unsigned details, FileItem& item)
+    {
+        item.isDir = S_ISDIR(st.st_mode);
+        item.sizeBytes = S_ISREG(st.st_mode) ? (std::uintmax_t)st.st_size : 0;
+        item.modified = st.st_mtime;
+        if (details == 0) return;
+
+        item.uid = (std::uint32_t)st.st_uid;
+        item.gid = (std::uint32_t)st.st_gid;
+        item.mode = (std::uint32_t)st.st_mode;
+        item.inode = (std::uint64_t)st.st_ino;
+        item.links = (std::uint64_t)st.st_nlink;
+        item.allocatedBytes = (std::uintmax_t)st.st_blocks * 512;
+        item.details = details & ~kDetailBirthTime;
+#if defined(__APPLE__)
+        item.birthTime = st.st_birthtimespec.tv_sec;
+        item.details |= details & kDetailBirthTime;
+#endif
+    }
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    // Set once statx turns out to be missing (kernels before 4.11)
+    std::atomic<bool> g_noStatx{ false };
+
+    /*
+    Function: StatxEntry
+    Description: Reads one listing row with a single statx call. Only the fields the listing
+                 shows are requested, so a filesystem that has to fetch metadata remotely
+                 does no extra work for columns that are hidden; a field the filesystem
+                 cannot provide (e.g. a birth time) is left unflagged.
+    Parameters:
+      - dirFd: Directory descriptor.
+      - name: Entry name relative to dirFd.
+      - details: kDetail* fields wanted.
+      - item: Row to fill.
+    Returns:
+      - bool: true if the entry was read; false on failure (errno is set).
+    */
+    bool StatxEntry(int dirFd, const char* name, unsigned details, FileItem& item)
+    {
+        unsigned mask = STATX_TYPE | STATX_SIZE | STATX_MTIME;
+        if (details & kDetailOwner) mask |= STATX_UID | STATX_GID;
+        if (details & kDetailMode) mask |= STATX_MODE;
+        if (details & kDetailInode) mask |= STATX_INO;
+        if (details & kDetailLinks) mask |= STATX_NLINK;
+        if (details & kDetailAllocated) mask |= STATX_BLOCKS;
+        if (details & kDetailBirthTime) mask |= STATX_BTIME;
+
+        struct statx sx{};
+        if (::statx(dirFd, name, AT_STATX_SYNC_AS_STAT, mask, &sx) != 0) return false;
+
+        item.isDir = S_ISDIR(sx.stx_mode);
+        item.sizeBytes = S_ISREG(sx.stx_mode) ? (std::uintmax_t)sx.stx_size : 0;
+        item.modified = (std::time_t)sx.stx_mtime.tv_sec;
+        if (details == 0) return true;
+
+        const auto has = [&](unsigned bits) { return (sx.stx_mask & bits) == bits; };
+        if ((details & kDetailOwner) && has(STATX_UID | STATX_GID))
+        {
+            item.uid = sx.stx_uid;
+            item.gid = sx.stx_gid;
+            item.details |= kDetailOwner;
+        }
+        if ((details & kDetailMode) && has(STATX_TYPE | STATX_MODE))
+        {
+            item.mode = sx.stx_mode;
+            item.details |= kDetailMode;
+        }
+        if ((details & kDetailInode) && has(STATX_INO))
+        {
+            item.inode = sx.stx_ino;
+            item.details |= kDetailInode;
+        }
+        if ((details & kDetailLinks) && has(STATX_NLINK))
+        {
+            item.links = sx.stx_nlink;
+            item.details |= kDetailLinks;
+        }
+        if ((details & kDetailAllocated) && has(STATX_BLOCKS))
+        {
+            item.allocatedBytes = (std::uintmax_t)sx.stx_blocks * 512;
+            item.details |= kDetailAllocated;
+        }
+        if ((details & kDetailBirthTime) && has(STATX_BTIME))
+        {
+            item.birthTime = (std::time_t)sx.stx_btime.tv_sec;
+            item.details |= kDetailBirthTime;
+        }
+        return true;
+    }
+#endif
+}
+
+/*
+Function: PosixFdBackend::Stat
+Description: Reads an entry's metadata with one fstatat call.
+Parameters:
+  - p: Path to inspect.
+  - followLinks: If false, a symlink is reported as such instead of its target.
+  - out: Output metadata.
+Returns:
+  - bool: true if the entry exists; false otherwise.
+*/
+bool PosixFdBackend::Stat(const fs::path& p, bool followLinks, FsStat& out) const
+{
+    out = FsStat{};
+    struct stat st{};
+    if (::fstatat(AT_FDCWD, p.c_str(), &st, followLinks ? 0 : AT_SYMLINK_NOFOLLOW) != 0) return false;
+    FillStat(st, out);
+    return true;
+}
+
+/*
+Function: PosixFdBackend::List
+Description: Reads a whole directory listing into a vector (see ListStream).
+Parameters:
+  - dir: Directory to enumerate.
+  - details: kDetail* fields to read in addition to type, size and modification time.
+  - outItems: Output entries.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was listed; false otherwise.
+*/
+bool PosixFdBackend::List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const
+{
+    outItems.clear();
+    return ListStream(dir, details, kListChunkEntries, [&](std::vector<FileItem>& chunk)
+    {
+        outItems.insert(outItems.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+        return true;
+    }, outErr);
+}
+
+/*
+Function: PosixFdBackend::ListStream
+Description: Enumerates a directory through one open descriptor, handing the entries to the
+             sink in chunks as readdir returns them, so only one chunk is held at a time.
+             Each entry is stat'ed once relative to that descriptor (following links, as the
+             listing always has), with statx on Linux so that only the requested extended
+             fields are fetched and the birth time is available, and with fstatat elsewhere;
+             a dangling link is listed as an empty file.
+Parameters:
+  - dir: Directory to enumerate.
+  - details: kDetail* fields to read in addition to type, size and modification time.
+  - chunkSize: Maximum number of entries per chunk.
+  - sink: Receives the chunks; returning false stops early.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was listed (or the sink stopped early); false otherwise.
+*/
+bool PosixFdBackend::ListStream(const fs::path& dir,
+                                unsigned details,
+                                std::size_t chunkSize,
+                                const ListChunkSink& sink,
+                                std::string& outErr) const
+{
+    const int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno == ENOENT || errno == ENOTDIR) outErr = "Not a directory: " + dir.string();
+        else outErr = "Cannot iterate directory: " + ErrnoText();
+        return false;
+    }
+    DIR* d = ::fdopendir(fd);
+    if (!d)
+    {
+        ::close(fd);
+        outErr = "Cannot iterate directory: " + ErrnoText();
+        return false;
+    }
+
+    if (chunkSize == 0) chunkSize = kListChunkEntries;
+    std::vector<FileItem> chunk;
+    chunk.reserve(chunkSize);
+    bool wanted = true;
+
+    // entry paths are built in one exactly sized string each rather than with operator/
+    std::string prefix = dir.native();
+    if (prefix.empty() || prefix.back() != '/') prefix += '/';
+
+    while (const dirent* de = ::readdir(d))
+    {
+        if (std::strcmp(de->d_name, ".") == 0 || std::strcmp(de->d_name, "..") == 0) continue;
+
+        chunk.emplace_back();
+        FileItem& item = chunk.back();
+        const std::size_t nameLen = std::strlen(de->d_name);
+        std::string full;
+        full.reserve(prefix.size() + nameLen);
+        full.append(prefix).append(de->d_name, nameLen);
+        item.fullPath = fs::path(std::move(full));
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+        bool done = false;
+        if (!g_noStatx.load(std::memory_order_relaxed))
+        {
+            done = StatxEntry(::dirfd(d), de->d_name, details, item) || errno != ENOSYS;
+            if (!done) g_noStatx.store(true, std::memory_order_relaxed);
+        }
+        if (!done)
+#endif
+        {
+            struct stat st{};
+            if (::fstatat(::dirfd(d), de->d_name, &st, 0) == 0)
+                FillItemFromStat(st, details, item);
+        }
+
+        if (chunk.size() >= chunkSize)
+        {
+            wanted = sink(chunk);
+            chunk.clear();
+            if (!wanted) break;
+        }
+    }
+
+    if (wanted && !chunk.empty()) sink(chunk);
+    ::closedir(d);
+    return true;
+}
+
+/*
+Function: PosixFdBackend::CreateDirectory
+Description: Creates one directory with mkdir, optionally giving it the permission bits of
+             another directory.
+Parameters:
+  - p: Directory to create.
+  - attributesFrom: Existing directory to copy permissions from, or empty.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was created; false otherwise.
+*/
+bool PosixFdBackend::CreateDirectory(const fs::path& p, const fs::path& attributesFrom, std::string& outErr) const
+{
+    mode_t mode = 0777;
+    struct stat st{};
+    const bool copyMode = !attributesFrom.empty() && ::stat(attributesFrom.c_str(), &st) == 0;
+    if (copyMode) mode = st.st_mode & 07777;
+
+    if (::mkdir(p.c_str(), mode) != 0)
+    {
+        outErr = "Create directory failed: " + ErrnoText();
+        return false;
+    }
+    if (copyMode) ::chmod(p.c_str(), mode);   // not reduced by the umask
+    return true;
+}
+
+/*
+Function: PosixFdBackend::Rename
+Description: Renames or moves an entry within a filesystem with rename().
+Parameters:
+  - from: Existing entry.
+  - to: New path.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the entry was renamed; false otherwise.
+*/
+bool PosixFdBackend::Rename(const fs::path& from, const fs::path& to, std::string& outErr) const
+{
+    if (::rename(from.c_str(), to.c_str()) != 0)
+    {
+        outErr = ErrnoText();
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: PosixFdBackend::Exchange
+Description: Atomically swaps two entries with renameat2(RENAME_EXCHANGE) on Linux or
+             renamex_np(RENAME_SWAP) on macOS.
+Parameters:
+  - a: First entry.
+  - b: Second entry.
+Returns:
+  - bool: true if the entries were swapped; false if unsupported or failed.
+*/
+bool PosixFdBackend::Exchange(const fs::path& a, const fs::path& b) const
+{
+#if defined(__linux__) && defined(RENAME_EXCHANGE)
+    return ::renameat2(AT_FDCWD, a.c_str(), AT_FDCWD, b.c_str(), RENAME_EXCHANGE) == 0;
+#elif defined(__APPLE__) && defined(RENAME_SWAP)
+    return ::renamex_np(a.c_str(), b.c_str(), RENAME_SWAP) == 0;
+#else
+    (void)a;
+    (void)b;
+    return false;
+#endif
+}
+
+/*
+Function: PosixFdBackend::RenameBatch
+Description: Renames entries of one directory together (see FsBackend::ApplyRenameBatch). The
+             directory is opened once and every rename is made relative to its descriptor,
+             so no path is resolved again however large the batch is.
+Parameters:
+  - dir: Directory holding every entry of the batch.
+  - ops: Renames to apply, by entry name.
+  - outDone: Output number of entries that carry their new name.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if every rename was applied; false otherwise.
+*/
+bool PosixFdBackend::RenameBatch(const fs::path& dir, const std::vector<RenameOp>& ops, std::size_t& outDone, std::string& outErr) const
+{
+    outDone = 0;
+    const int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+    {
+        outErr = "Cannot open " + dir.string() + ": " + ErrnoText();
+        return false;
+    }
+
+    const bool ok = ApplyRenameBatch(ops, [dirFd](const std::string& from, const std::string& to, bool noReplace, std::string& err)
+    {
+        return RenameAt(dirFd, from.c_str(), to.c_str(), noReplace, err);
+    }, outDone, outErr);
+
+    ::close(dirFd);
+    return ok;
+}
+
+/*
+Function: PosixFdBackend::RemoveAll
+Description: Deletes a file, symlink or directory tree with openat/unlinkat. A missing entry
+             counts as removed, as with std::filesystem::remove_all.
+Parameters:
+  - p: Entry to delete.
+  - outRemoved: Output number of entries removed.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if everything was removed; false otherwise.
+*/
+bool PosixFdBackend::RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const
+{
+    outRemoved = 0;
+    return RemoveAt(AT_FDCWD, p.c_str(), outRemoved, outErr);
+}
+
+/*
+Function: PosixFdBackend::CopySymlink
+Description: Recreates a symlink (not its target) at a new path with readlink/symlink.
+Parameters:
+  - src: Existing symlink.
+  - dst: Path of the new link.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the link was created; false otherwise.
+*/
+bool PosixFdBackend::CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const
+{
+    std::string target(256, '\0');
+    for (;;)
+    {
+        const ssize_t n = ::readlink(src.c_str(), &target[0], target.size());
+        if (n < 0)
+        {
+            outErr = "Copy failed for " + src.string() + ": " + ErrnoText();
+            return false;
+        }
+        if ((std::size_t)n < target.size())
+        {
+            target.resize((std::size_t)n);
+            break;
+        }
+        target.resize(target.size() * 2);
+    }
+
+    if (::symlink(target.c_str(), dst.c_str()) != 0)
+    {
+        outErr = "Copy failed for " + src.string() + ": " + ErrnoText();
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: PosixFdBackend::CopyFile
+Description: Copies one regular file with the shared chunked copy routine (copy_file_range
+             on Linux), paced by the I/O scheduler.
+Parameters:
+  - src: Source file.
+  - dst: Destination path (must not exist).
+  - scheduler: I/O scheduler pacing the copy.
+  - outBytes: Output number of bytes copied.
+  - outHoleBytes: Output number of bytes of holes left unwritten.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the file was copied; false otherwise.
+*/
+bool PosixFdBackend::CopyFile(const fs::path& src,
+                              const fs::path& dst,
+                              IoScheduler& scheduler,
+                              std::uintmax_t& outBytes,
+                              std::uintmax_t& outHoleBytes,
+                              std::string& outErr) const
+{
+    return CopyRegularFile(src, dst, scheduler, outBytes, outHoleBytes, outErr);
+}
+
+/*
+Function: PosixFdBackend::Flush
+Description: Makes a staged copy durable before it replaces the destination. Instead of one
+             fsync per file, a staged directory is flushed with a single syncfs() of its
+             filesystem (Linux) and a staged file with one fsync; the parent directory is
+             fsync'ed so the staging entry itself is on disk.
+Parameters:
+  - p: Staged file or directory.
+  - isDir: Whether p is a directory tree.
+Returns:
+  - None
+*/
+void PosixFdBackend::Flush(const fs::path& p, bool isDir) const
+{
+    const int fd = ::open(p.c_str(), O_RDONLY | (isDir ? O_DIRECTORY : 0));
+    if (fd >= 0)
+    {
+#if defined(__linux__)
+        if (isDir) ::syncfs(fd);
+        else ::fsync(fd);
+#else
+        if (isDir) ::sync();
+        else ::fsync(fd);
+#endif
+        ::close(fd);
+    }
+
+    const int dirFd = ::open(p.parent_path().c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0)
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+/*
+Function: PosixFdBackend::Canonical
+Description: Resolves a path with realpath(), or returns it unchanged if that fails.
+Parameters:
+  - p: Path to resolve.
+Returns:
+  - fs::path: Canonical path on success, otherwise p.
+*/
+fs::path PosixFdBackend::Canonical(const fs::path& p) const
+{
+    char* resolved = ::realpath(p.c_str(), nullptr);
+    if (!resolved) return p;
+    fs::path result(resolved);
+    std::free(resolved);
+    return result;
+}
+
+#endif
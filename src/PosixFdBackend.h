@@ -0,0 +1,49 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the PosixFdBackend class, the fast filesystem backend for Unix-like systems. It works directly with file descriptors: directories are enumerated with readdir and entries are inspected with fstatat relative to the open directory, trees are removed with unlinkat, and files are copied with the kernel-side copy routine.
+February 1, 2026
+*/
+
+#ifndef POSIXFDBACKEND_H
+#define POSIXFDBACKEND_H
+
+#include "FsBackend.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Backend using POSIX *at() calls on open directory descriptors
+class PosixFdBackend final : public FsBackend
+{
+public:
+    const char* Name() const override { return "posix"; }
+
+    bool Stat(const fs::path& p, bool followLinks, FsStat& out) const override;
+    bool List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const override;
+    bool ListStream(const fs::path& dir,
+                    unsigned details,
+                    std::size_t chunkSize,
+                    const ListChunkSink& sink,
+                    std::string& outErr) const override;
+
+    bool CreateDirectory(const fs::path& p, const fs::path& attributesFrom, std::string& outErr) const override;
+    bool Rename(const fs::path& from, const fs::path& to, std::string& outErr) const override;
+    bool Exchange(const fs::path& a, const fs::path& b) const override;
+    bool RenameBatch(const fs::path& dir, const std::vector<RenameOp>& ops, std::size_t& outDone, std::string& outErr) const override;
+    bool RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const override;
+
+    bool CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const override;
+    bool CopyFile(const fs::path& src,
+                  const fs::path& dst,
+                  IoScheduler& scheduler,
+                  std::uintmax_t& outBytes,
+                  std::uintmax_t& outHoleBytes,
+                  std::string& outErr) const override;
+
+    void Flush(const fs::path& p, bool isDir) const override;
+
+    fs::path Canonical(const fs::path& p) const override;
+};
+
+#endif
+
+#endif // POSIXFDBACKEND_H
@@ -0,0 +1,355 @@
+/*
+Parneet Baidwan - 251259638
+Description: The session persistence in this file writes the saved session as one small binary file: a magic and version header followed by variable-length integers, with each listing snapshot stored as names relative to its directory. The file is written beside its final name and renamed over it, so a crash while saving leaves the previous session intact, and a file that is truncated, from another version or otherwise malformed is simply not restored.
+February 1, 2026
+*/
+
+#include "Session.h"
+#include "AppPaths.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <system_error>
+
+namespace
+{
+    const char kMagic[4] = { 'F', 'M', 'S', 'S' };
+    constexpr unsigned char kVersion = 1;
+
+    constexpr std::uint64_t kFlagHumanSizes = 1u << 0;
+
+    // Appends the fields of the session file to a byte buffer
+    class Writer
+    {
+    public:
+        void Byte(unsigned char b) { m_out.push_back((char)b); }
+
+        void Varint(std::uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                Byte((unsigned char)(v | 0x80));
+                v >>= 7;
+            }
+            Byte((unsigned char)v);
+        }
+
+        // Signed values are zigzag encoded so small negatives stay short
+        void Signed(std::int64_t v) { Varint(((std::uint64_t)v << 1) ^ (std::uint64_t)(v >> 63)); }
+
+        void String(const std::string& s)
+        {
+            Varint(s.size());
+            m_out.append(s);
+        }
+
+        std::string& Buffer() { return m_out; }
+
+    private:
+        std::string m_out;
+    };
+
+    // Reads the fields back; every read fails once the data runs out or is malformed
+    class Reader
+    {
+    public:
+        explicit Reader(const std::string& in) : m_in(in) {}
+
+        bool Byte(unsigned char& b)
+        {
+            if (m_pos >= m_in.size()) return false;
+            b = (unsigned char)m_in[m_pos++];
+            return true;
+        }
+
+        bool Varint(std::uint64_t& v)
+        {
+            v = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                unsigned char b;
+                if (!Byte(b)) return false;
+                v |= (std::uint64_t)(b & 0x7f) << shift;
+                if (!(b & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool Signed(std::int64_t& v)
+        {
+            std::uint64_t u;
+            if (!Varint(u)) return false;
+            v = (std::int64_t)(u >> 1) ^ -(std::int64_t)(u & 1);
+            return true;
+        }
+
+        bool String(std::string& s)
+        {
+            std::uint64_t n;
+            if (!Varint(n) || n > Remaining()) return false;
+            s.assign(m_in, m_pos, (std::size_t)n);
+            m_pos += (std::size_t)n;
+            return true;
+        }
+
+        std::size_t Remaining() const { return m_in.size() - m_pos; }
+
+    private:
+        const std::string& m_in;
+        std::size_t m_pos = 0;
+    };
+
+    void WriteItem(Writer& w, const FileItem& item)
+    {
+        w.String(item.fullPath.filename().string());
+        w.Byte(item.isDir ? 1 : 0);
+        w.Varint(item.sizeBytes);
+        w.Signed(item.modified);
+        w.Varint(item.details);
+        if (item.details & kDetailOwner)
+        {
+            w.Varint(item.uid);
+            w.Varint(item.gid);
+        }
+        if (item.details & kDetailMode) w.Varint(item.mode);
+        if (item.details & kDetailInode) w.Varint(item.inode);
+        if (item.details & kDetailLinks) w.Varint(item.links);
+        if (item.details & kDetailAllocated) w.Varint(item.allocatedBytes);
+        if (item.details & kDetailBirthTime) w.Signed(item.birthTime);
+    }
+
+    bool ReadItem(Reader& r, const fs::path& dir, FileItem& item)
+    {
+        std::string name;
+        unsigned char isDir;
+        std::uint64_t size, details;
+        std::int64_t modified;
+        if (!r.String(name) || name.empty() || !r.Byte(isDir) || !r.Varint(size) ||
+            !r.Signed(modified) || !r.Varint(details))
+            return false;
+
+        item.fullPath = dir / name;
+        item.isDir = isDir != 0;
+        item.sizeBytes = (std::uintmax_t)size;
+        item.modified = (std::time_t)modified;
+        item.details = (unsigned)details & kDetailAll;
+
+        std::uint64_t v;
+        std::int64_t t;
+        if (item.details & kDetailOwner)
+        {
+            if (!r.Varint(v)) return false;
+            item.uid = (std::uint32_t)v;
+            if (!r.Varint(v)) return false;
+            item.gid = (std::uint32_t)v;
+        }
+        if (item.details & kDetailMode)
+        {
+            if (!r.Varint(v)) return false;
+            item.mode = (std::uint32_t)v;
+        }
+        if (item.details & kDetailInode)
+        {
+            if (!r.Varint(v)) return false;
+            item.inode = v;
+        }
+        if (item.details & kDetailLinks)
+        {
+            if (!r.Varint(v)) return false;
+            item.links = v;
+        }
+        if (item.details & kDetailAllocated)
+        {
+            if (!r.Varint(v)) return false;
+            item.allocatedBytes = (std::uintmax_t)v;
+        }
+        if (item.details & kDetailBirthTime)
+        {
+            if (!r.Signed(t)) return false;
+            item.birthTime = (std::time_t)t;
+        }
+        return true;
+    }
+
+    bool ReadTab(Reader& r, SessionTab& tab)
+    {
+        std::string dir;
+        unsigned char hasSnapshot;
+        if (!r.String(dir) || dir.empty() || !r.Byte(hasSnapshot)) return false;
+        tab.dir = dir;
+        if (!hasSnapshot) return true;
+
+        std::int64_t stamp;
+        std::uint64_t details, count;
+        unsigned char complete;
+        if (!r.Signed(stamp) || !r.Varint(details) || !r.Byte(complete) || !r.Varint(count))
+            return false;
+        // Every entry takes at least five bytes, which bounds a corrupt count
+        if (count > kSessionSnapshotEntries || count * 5 > r.Remaining()) return false;
+
+        tab.stamp = fs::file_time_type(fs::file_time_type::duration(stamp));
+        tab.details = (unsigned)details & kDetailAll;
+        tab.complete = complete != 0;
+
+        auto items = std::make_shared<std::vector<FileItem>>((std::size_t)count);
+        for (FileItem& item : *items)
+        {
+            if (!ReadItem(r, tab.dir, item)) return false;
+        }
+        tab.listing = std::move(items);
+        return true;
+    }
+}
+
+/*
+Function: SessionFile
+Description: Returns the path of the saved session inside the per-user data directory.
+Parameters:
+  - None
+Returns:
+  - fs::path: Session file, or an empty path if there is no data directory.
+*/
+fs::path SessionFile()
+{
+    const fs::path base = AppDataDirectory();
+    if (base.empty()) return fs::path();
+    return base / "session.bin";
+}
+
+/*
+Function: SaveSession
+Description: Writes a session to disk. Snapshots longer than kSessionSnapshotEntries are cut
+             to their first entries and marked incomplete. The data is written to a temporary
+             file next to the target and renamed over it, creating the directory if needed.
+Parameters:
+  - file: Session file to write.
+  - session: Session to save.
+  - outErr: Output string populated with an error message if saving fails; cleared on success.
+Returns:
+  - bool: true if the session was saved; false otherwise.
+*/
+bool SaveSession(const fs::path& file, const Session& session, std::string& outErr)
+{
+    outErr.clear();
+
+    Writer w;
+    w.Buffer().append(kMagic, sizeof(kMagic));
+    w.Byte(kVersion);
+    w.Varint(session.humanSizes ? kFlagHumanSizes : 0);
+    w.Varint(session.detailFields);
+    w.Varint(session.activeTab);
+    w.Varint(session.columnWidths.size());
+    for (int width : session.columnWidths) w.Signed(width);
+
+    w.Varint(session.tabs.size());
+    for (const SessionTab& tab : session.tabs)
+    {
+        w.String(tab.dir.string());
+        w.Byte(tab.listing ? 1 : 0);
+        if (!tab.listing) continue;
+
+        const std::size_t count = std::min(tab.listing->size(), kSessionSnapshotEntries);
+        w.Signed((std::int64_t)tab.stamp.time_since_epoch().count());
+        w.Varint(tab.details);
+        w.Byte(tab.complete && count == tab.listing->size() ? 1 : 0);
+        w.Varint(count);
+        for (std::size_t i = 0; i < count; ++i) WriteItem(w, (*tab.listing)[i]);
+    }
+
+    std::error_code ec;
+    fs::create_directories(file.parent_path(), ec);
+
+    fs::path tmp = file;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            outErr = "Cannot write " + tmp.string();
+            return false;
+        }
+        out.write(w.Buffer().data(), (std::streamsize)w.Buffer().size());
+        if (!out.flush())
+        {
+            outErr = "Cannot write " + tmp.string();
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tmp, file, ec);
+    if (ec)
+    {
+        outErr = ec.message();
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: LoadSession
+Description: Reads a session saved by SaveSession. Nothing is returned unless the whole file
+             is well formed.
+Parameters:
+  - file: Session file to read.
+  - outSession: Output session.
+  - outErr: Output string populated with an error message if loading fails; cleared on success.
+Returns:
+  - bool: true if a session was read; false otherwise.
+*/
+bool LoadSession(const fs::path& file, Session& outSession, std::string& outErr)
+{
+    outErr.clear();
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+    {
+        outErr = "No saved session";
+        return false;
+    }
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(kMagic) + 1 || data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0 ||
+        (unsigned char)data[sizeof(kMagic)] != kVersion)
+    {
+        outErr = "Unrecognized session file";
+        return false;
+    }
+
+    Reader r(data);
+    unsigned char skip;
+    for (std::size_t i = 0; i <= sizeof(kMagic); ++i) r.Byte(skip);
+
+    Session session;
+    std::uint64_t flags, details, active, columns, tabs;
+    bool ok = r.Varint(flags) && r.Varint(details) && r.Varint(active) && r.Varint(columns) &&
+              columns <= r.Remaining();
+    for (std::uint64_t i = 0; ok && i < columns; ++i)
+    {
+        std::int64_t width = 0;
+        ok = r.Signed(width);
+        session.columnWidths.push_back((int)width);
+    }
+    ok = ok && r.Varint(tabs) && tabs <= r.Remaining();
+    for (std::uint64_t i = 0; ok && i < tabs; ++i)
+    {
+        SessionTab tab;
+        ok = ReadTab(r, tab);
+        session.tabs.push_back(std::move(tab));
+    }
+    if (!ok || session.tabs.empty())
+    {
+        outErr = "Damaged session file";
+        return false;
+    }
+
+    session.humanSizes = (flags & kFlagHumanSizes) != 0;
+    session.detailFields = (unsigned)details & kDetailAll;
+    session.activeTab = active < session.tabs.size() ? (std::size_t)active : 0;
+    outSession = std::move(session);
+    return true;
+}
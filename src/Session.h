@@ -0,0 +1,48 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the saved session of the file manager: the open tabs and the active one, the chosen columns and their widths, and a compact snapshot of each tab's listing. The session is written when the window closes and read at launch, so the last directory can be painted from its snapshot straight away while the real directories are revalidated in the background.
+February 1, 2026
+*/
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "FileSystemService.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Entries kept in one tab's snapshot; larger listings are saved truncated
+static constexpr std::size_t kSessionSnapshotEntries = 4000;
+
+// One tab of a saved session
+struct SessionTab
+{
+    fs::path dir;
+    DirectoryListing listing;           // snapshot, or null if none was current
+    fs::file_time_type stamp{};         // change stamp of dir the snapshot was read at
+    unsigned details = 0;               // kDetail* fields the snapshot holds
+    bool complete = false;              // the snapshot holds every entry of dir
+};
+
+// Everything restored at launch
+struct Session
+{
+    std::vector<SessionTab> tabs;
+    std::size_t activeTab = 0;
+    unsigned detailFields = 0;
+    bool humanSizes = false;
+    std::vector<int> columnWidths;      // widths of the listing columns, in display order
+};
+
+// Where the session is kept; empty if there is no per-user data directory
+fs::path SessionFile();
+
+bool SaveSession(const fs::path& file, const Session& session, std::string& outErr);
+bool LoadSession(const fs::path& file, Session& outSession, std::string& outErr);
+
+#endif // SESSION_H
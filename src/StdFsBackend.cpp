@@ -0,0 +1,335 @@
+/*
+Parneet Baidwan - 251259638
+Description: The StdFsBackend class in this file implements the filesystem backend with the C++17 filesystem library only. Every operation maps directly onto std::filesystem calls and reports errors through std::error_code, which keeps it portable at the cost of extra path lookups and per-entry system calls.
+February 1, 2026
+*/
+
+#include "StdFsBackend.h"
+#include "IoScheduler.h"
+
+#include <chrono>
+#include <iterator>
+
+/*
+Function: ToTimeT
+Description: Converts a std::filesystem::file_time_type into a std::time_t. This is used to
+             display last-modified timestamps in a portable way by translating from the
+             filesystem clock to system_clock. Conversion can be sensitive to platform clock
+             differences, so this function centralizes the logic.
+Parameters:
+  - ftime: Filesystem timestamp (file_time_type) to convert.
+Returns:
+  - std::time_t: Converted timestamp suitable for formatting and display.
+*/
+static std::time_t ToTimeT(const fs::file_time_type& ftime)
+{
+    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now()
+    );
+    return std::chrono::system_clock::to_time_t(sctp);
+}
+
+/*
+Function: StdFsBackend::Stat
+Description: Reads the type, size and modification time of an entry.
+Parameters:
+  - p: Path to inspect.
+  - followLinks: If false, a symlink is reported as such instead of its target.
+  - out: Output metadata.
+Returns:
+  - bool: true if the entry exists; false otherwise.
+*/
+bool StdFsBackend::Stat(const fs::path& p, bool followLinks, FsStat& out) const
+{
+    out = FsStat{};
+    std::error_code ec;
+    const fs::file_status st = followLinks ? fs::status(p, ec) : fs::symlink_status(p, ec);
+    if (!fs::exists(st)) return false;
+
+    if (fs::is_symlink(st)) out.type = FsEntryType::Symlink;
+    else if (fs::is_directory(st)) out.type = FsEntryType::Directory;
+    else if (fs::is_regular_file(st)) out.type = FsEntryType::File;
+    else out.type = FsEntryType::Other;
+
+    if (out.type == FsEntryType::File)
+    {
+        out.sizeBytes = fs::file_size(p, ec);
+        if (ec) out.sizeBytes = 0;
+    }
+
+    // last_write_time follows links; a dangling link keeps a zero time
+    const fs::file_time_type t = fs::last_write_time(p, ec);
+    if (!ec)
+    {
+        out.changeStamp = t;
+        out.modified = ToTimeT(t);
+    }
+    return true;
+}
+
+/*
+Function: StdFsBackend::List
+Description: Reads a whole directory listing into a vector (see ListStream).
+Parameters:
+  - dir: Directory to enumerate.
+  - details: kDetail* fields to read in addition to type, size and modification time.
+  - outItems: Output entries.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was listed; false otherwise.
+*/
+bool StdFsBackend::List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const
+{
+    outItems.clear();
+    return ListStream(dir, details, kListChunkEntries, [&](std::vector<FileItem>& chunk)
+    {
+        outItems.insert(outItems.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+        return true;
+    }, outErr);
+}
+
+/*
+Function: StdFsBackend::ListStream
+Description: Enumerates a directory with directory_iterator, reading the metadata of every
+             entry the way the original listing code did (links are followed) and handing
+             the entries to the sink in chunks. The portable library only exposes
+             permissions and link counts, so those are the only extended fields filled,
+             each with its own call and only when asked for.
+Parameters:
+  - dir: Directory to enumerate.
+  - details: kDetail* fields to read in addition to type, size and modification time.
+  - chunkSize: Maximum number of entries per chunk.
+  - sink: Receives the chunks; returning false stops early.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was listed (or the sink stopped early); false otherwise.
+*/
+bool StdFsBackend::ListStream(const fs::path& dir,
+                              unsigned details,
+                              std::size_t chunkSize,
+                              const ListChunkSink& sink,
+                              std::string& outErr) const
+{
+    std::error_code ec;
+    if (!fs::exists(dir, ec) || !fs::is_directory(dir, ec))
+    {
+        outErr = "Not a directory: " + dir.string();
+        return false;
+    }
+
+    fs::directory_iterator it(dir, ec);
+    if (ec)
+    {
+        outErr = "Cannot iterate directory: " + ec.message();
+        return false;
+    }
+
+    if (chunkSize == 0) chunkSize = kListChunkEntries;
+    std::vector<FileItem> chunk;
+    chunk.reserve(chunkSize);
+    bool wanted = true;
+
+    for (const auto& entry : it)
+    {
+        chunk.emplace_back();
+        FileItem& item = chunk.back();
+        item.fullPath = entry.path();
+
+        std::error_code e2;
+        item.isDir = entry.is_directory(e2);
+        if (e2) item.isDir = false;
+
+        if (!item.isDir)
+        {
+            std::error_code e3;
+            item.sizeBytes = fs::file_size(item.fullPath, e3);
+            if (e3) item.sizeBytes = 0;
+        }
+
+        std::error_code e4;
+        auto t = fs::last_write_time(item.fullPath, e4);
+        item.modified = e4 ? 0 : ToTimeT(t);
+
+        if (details & kDetailMode)
+        {
+            std::error_code e5;
+            const fs::file_status st = entry.status(e5);
+            if (!e5)
+            {
+                // rebuild st_mode-style bits so the formatter can treat every backend alike
+                std::uint32_t type = 0;
+                if (fs::is_directory(st)) type = 0040000;
+                else if (fs::is_regular_file(st)) type = 0100000;
+                item.mode = type | ((std::uint32_t)st.permissions() & 07777);
+                item.details |= kDetailMode;
+            }
+        }
+        if (details & kDetailLinks)
+        {
+            std::error_code e6;
+            const std::uintmax_t links = entry.hard_link_count(e6);
+            if (!e6)
+            {
+                item.links = links;
+                item.details |= kDetailLinks;
+            }
+        }
+
+        if (chunk.size() >= chunkSize)
+        {
+            wanted = sink(chunk);
+            chunk.clear();
+            if (!wanted) break;
+        }
+    }
+
+    if (wanted && !chunk.empty()) sink(chunk);
+    return true;
+}
+
+/*
+Function: StdFsBackend::CreateDirectory
+Description: Creates one directory, optionally copying the permissions of another.
+Parameters:
+  - p: Directory to create.
+  - attributesFrom: Existing directory to copy attributes from, or empty.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the directory was created; false otherwise.
+*/
+bool StdFsBackend::CreateDirectory(const fs::path& p, const fs::path& attributesFrom, std::string& outErr) const
+{
+    std::error_code ec;
+    const bool ok = attributesFrom.empty() ? fs::create_directory(p, ec) : fs::create_directory(p, attributesFrom, ec);
+    if (!ok || ec)
+    {
+        outErr = "Create directory failed: " + (ec ? ec.message() : std::string("already exists"));
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: StdFsBackend::Rename
+Description: Renames or moves an entry within a filesystem.
+Parameters:
+  - from: Existing entry.
+  - to: New path.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the entry was renamed; false otherwise.
+*/
+bool StdFsBackend::Rename(const fs::path& from, const fs::path& to, std::string& outErr) const
+{
+    std::error_code ec;
+    fs::rename(from, to, ec);
+    if (ec)
+    {
+        outErr = ec.message();
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: StdFsBackend::RemoveAll
+Description: Deletes a file, symlink or directory tree.
+Parameters:
+  - p: Entry to delete.
+  - outRemoved: Output number of entries removed.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if everything was removed; false otherwise.
+*/
+bool StdFsBackend::RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const
+{
+    std::error_code ec;
+    outRemoved = fs::remove_all(p, ec);
+    if (ec)
+    {
+        outRemoved = 0;
+        outErr = ec.message();
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: StdFsBackend::CopySymlink
+Description: Recreates a symlink (not its target) at a new path.
+Parameters:
+  - src: Existing symlink.
+  - dst: Path of the new link.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the link was created; false otherwise.
+*/
+bool StdFsBackend::CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const
+{
+    std::error_code ec;
+    fs::copy_symlink(src, dst, ec);
+    if (ec)
+    {
+        outErr = "Copy failed for " + src.string() + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+/*
+Function: StdFsBackend::CopyFile
+Description: Copies one regular file with std::filesystem::copy_file, admitted by the I/O
+             scheduler. The copy is one call, so the whole size is reported to the scheduler
+             at the end.
+Parameters:
+  - src: Source file.
+  - dst: Destination path (must not exist).
+  - scheduler: I/O scheduler admitting the copy.
+  - outBytes: Output number of bytes copied.
+  - outHoleBytes: Output number of bytes of holes left unwritten; always 0, as copy_file does
+                  not report them.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the file was copied; false otherwise.
+*/
+bool StdFsBackend::CopyFile(const fs::path& src,
+                            const fs::path& dst,
+                            IoScheduler& scheduler,
+                            std::uintmax_t& outBytes,
+                            std::uintmax_t& outHoleBytes,
+                            std::string& outErr) const
+{
+    outBytes = 0;
+    outHoleBytes = 0;
+    const DeviceId srcDev = IoScheduler::DeviceOf(src);
+    const DeviceId dstDev = IoScheduler::DeviceOf(dst.parent_path());
+    IoScheduler::Ticket ticket = scheduler.Acquire({ srcDev, dstDev });
+
+    std::error_code ec;
+    fs::copy_file(src, dst, fs::copy_options::none, ec);
+    if (ec)
+    {
+        outErr = "Copy failed for " + src.string() + ": " + ec.message();
+        return false;
+    }
+
+    outBytes = fs::file_size(dst, ec);
+    scheduler.Transfer(srcDev, outBytes);
+    if (dstDev != srcDev) scheduler.Transfer(dstDev, outBytes);
+    return true;
+}
+
+/*
+Function: StdFsBackend::Canonical
+Description: Resolves a path to its canonical form, or returns it unchanged if that fails.
+Parameters:
+  - p: Path to resolve.
+Returns:
+  - fs::path: Canonical path on success, otherwise p.
+*/
+fs::path StdFsBackend::Canonical(const fs::path& p) const
+{
+    std::error_code ec;
+    fs::path c = fs::canonical(p, ec);
+    return ec ? p : c;
+}
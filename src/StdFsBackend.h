@@ -0,0 +1,41 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the StdFsBackend class, the portable filesystem backend built only on the C++17 filesystem library. It runs on every platform the application supports and serves as the reference implementation for the faster platform backends.
+February 1, 2026
+*/
+
+#ifndef STDFSBACKEND_H
+#define STDFSBACKEND_H
+
+#include "FsBackend.h"
+
+// Portable backend using std::filesystem
+class StdFsBackend final : public FsBackend
+{
+public:
+    const char* Name() const override { return "std"; }
+
+    bool Stat(const fs::path& p, bool followLinks, FsStat& out) const override;
+    bool List(const fs::path& dir, unsigned details, std::vector<FileItem>& outItems, std::string& outErr) const override;
+    bool ListStream(const fs::path& dir,
+                    unsigned details,
+                    std::size_t chunkSize,
+                    const ListChunkSink& sink,
+                    std::string& outErr) const override;
+
+    bool CreateDirectory(const fs::path& p, const fs::path& attributesFrom, std::string& outErr) const override;
+    bool Rename(const fs::path& from, const fs::path& to, std::string& outErr) const override;
+    bool RemoveAll(const fs::path& p, std::uintmax_t& outRemoved, std::string& outErr) const override;
+
+    bool CopySymlink(const fs::path& src, const fs::path& dst, std::string& outErr) const override;
+    bool CopyFile(const fs::path& src,
+                  const fs::path& dst,
+                  IoScheduler& scheduler,
+                  std::uintmax_t& outBytes,
+                  std::uintmax_t& outHoleBytes,
+                  std::string& outErr) const override;
+
+    fs::path Canonical(const fs::path& p) const override;
+};
+
+#endif // STDFSBACKEND_H
@@ -0,0 +1,186 @@
+/*
+Parneet Baidwan - 251259638
+Description: The SyncDialog class in this file builds the compare/sync window. The user picks the source and target directories and the comparison options, runs a comparison to see every added, changed and removed entry, and can then apply a one-way sync that only copies what differs.
+February 1, 2026
+*/
+
+#include "SyncDialog.h"
+
+#include <wx/msgdlg.h>
+
+// bind event ids to handler methods
+wxBEGIN_EVENT_TABLE(SyncDialog, wxDialog)
+    EVT_BUTTON(SyncDialog::ID_Compare, SyncDialog::OnCompare)
+    EVT_BUTTON(SyncDialog::ID_Sync,    SyncDialog::OnSync)
+wxEND_EVENT_TABLE()
+
+/*
+Function: SyncDialog::SyncDialog
+Description: Builds the dialog: source and target path fields, option checkboxes, the result
+             list (change, path, size) and the Compare/Sync buttons. Sync stays disabled until
+             a comparison has been made.
+Parameters:
+  - parent: Owning window.
+  - fs: Filesystem service used by the sync engine.
+  - source: Initial source directory.
+  - target: Initial target directory.
+Returns:
+  - None
+*/
+SyncDialog::SyncDialog(wxWindow* parent, const FileSystemService& fs, const fs::path& source, const fs::path& target)
+    : wxDialog(parent, wxID_ANY, "Compare / Sync", wxDefaultPosition, wxSize(820, 560), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_engine(fs)
+{
+    m_sourceCtrl = new wxTextCtrl(this, wxID_ANY, wxString::FromUTF8(source.u8string()));
+    m_targetCtrl = new wxTextCtrl(this, wxID_ANY, wxString::FromUTF8(target.u8string()));
+    m_contentCheck = new wxCheckBox(this, wxID_ANY, "Compare contents (hash files with equal size and date)");
+    m_deleteCheck = new wxCheckBox(this, wxID_ANY, "Delete target entries missing from source");
+    m_deleteCheck->SetValue(true);
+
+    m_resultList = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    m_resultList->InsertColumn(0, "Change", wxLIST_FORMAT_LEFT, 100);
+    m_resultList->InsertColumn(1, "Path", wxLIST_FORMAT_LEFT, 520);
+    m_resultList->InsertColumn(2, "Size", wxLIST_FORMAT_RIGHT, 130);
+
+    m_summary = new wxStaticText(this, wxID_ANY, "Press Compare to list differences.");
+    m_syncButton = new wxButton(this, ID_Sync, "Sync");
+    m_syncButton->Enable(false);
+
+    auto* paths = new wxFlexGridSizer(2, 5, 5);
+    paths->AddGrowableCol(1, 1);
+    paths->Add(new wxStaticText(this, wxID_ANY, "Source:"), 0, wxALIGN_CENTER_VERTICAL);
+    paths->Add(m_sourceCtrl, 1, wxEXPAND);
+    paths->Add(new wxStaticText(this, wxID_ANY, "Target:"), 0, wxALIGN_CENTER_VERTICAL);
+    paths->Add(m_targetCtrl, 1, wxEXPAND);
+
+    auto* buttons = new wxBoxSizer(wxHORIZONTAL);
+    buttons->Add(m_summary, 1, wxALIGN_CENTER_VERTICAL);
+    buttons->Add(new wxButton(this, ID_Compare, "Compare"), 0, wxLEFT, 5);
+    buttons->Add(m_syncButton, 0, wxLEFT, 5);
+    buttons->Add(new wxButton(this, wxID_CANCEL, "Close"), 0, wxLEFT, 5);
+
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(paths, 0, wxEXPAND | wxALL, 10);
+    sizer->Add(m_contentCheck, 0, wxLEFT | wxRIGHT, 10);
+    sizer->Add(m_deleteCheck, 0, wxLEFT | wxRIGHT | wxTOP, 10);
+    sizer->Add(m_resultList, 1, wxEXPAND | wxALL, 10);
+    sizer->Add(buttons, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+    SetSizer(sizer);
+}
+
+/*
+Function: SyncDialog::ReadOptions
+Description: Builds the sync options from the dialog checkboxes.
+Parameters:
+  - None
+Returns:
+  - SyncOptions: Options for Compare and Apply.
+*/
+SyncOptions SyncDialog::ReadOptions() const
+{
+    SyncOptions opts;
+    opts.compareContent = m_contentCheck->GetValue();
+    opts.deleteRemoved = m_deleteCheck->GetValue();
+    return opts;
+}
+
+/*
+Function: SyncDialog::ShowEntries
+Description: Fills the result list with the last comparison and updates the summary line.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void SyncDialog::ShowEntries()
+{
+    m_resultList->Freeze();
+    m_resultList->DeleteAllItems();
+
+    std::size_t added = 0, changed = 0, removed = 0;
+    for (const auto& e : m_entries)
+    {
+        const char* label = "Added";
+        if (e.change == SyncChange::Changed) { label = "Changed"; ++changed; }
+        else if (e.change == SyncChange::Removed) { label = "Removed"; ++removed; }
+        else ++added;
+
+        const wxString path = wxString::FromUTF8(e.relPath.u8string()) + (e.isDir ? "/" : "");
+        const long idx = m_resultList->InsertItem(m_resultList->GetItemCount(), label);
+        m_resultList->SetItem(idx, 1, path);
+        m_resultList->SetItem(idx, 2, e.isDir ? wxString("") : wxString::Format("%llu", (unsigned long long)e.sizeBytes));
+    }
+
+    m_resultList->Thaw();
+    m_summary->SetLabel(wxString::Format("%zu added, %zu changed, %zu removed", added, changed, removed));
+}
+
+/*
+Function: SyncDialog::OnCompare
+Description: Button handler for “Compare”. Compares the two trees and lists the differences;
+             errors are shown in a dialog.
+Parameters:
+  - event: wxWidgets button command event.
+Returns:
+  - None
+*/
+void SyncDialog::OnCompare(wxCommandEvent&)
+{
+    m_comparedSource = fs::path(m_sourceCtrl->GetValue().ToStdString());
+    m_comparedTarget = fs::path(m_targetCtrl->GetValue().ToStdString());
+
+    std::string err;
+    wxBusyCursor busy;
+    if (!m_engine.Compare(m_comparedSource, m_comparedTarget, ReadOptions(), m_entries, err))
+    {
+        m_entries.clear();
+        ShowEntries();
+        m_syncButton->Enable(false);
+        wxMessageBox(wxString::FromUTF8(err), "Compare", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    ShowEntries();
+    m_syncButton->Enable(!m_entries.empty());
+}
+
+/*
+Function: SyncDialog::OnSync
+Description: Button handler for “Sync”. After confirmation, applies the last comparison to the
+             target, reports what was written, and compares again so the list shows what (if
+             anything) still differs.
+Parameters:
+  - event: wxWidgets button command event.
+Returns:
+  - None
+*/
+void SyncDialog::OnSync(wxCommandEvent& event)
+{
+    const wxString q = wxString::Format("Apply %zu change(s) to:\n", m_entries.size()) +
+                       wxString::FromUTF8(m_comparedTarget.u8string()) + "\n\nThe target will mirror the source.";
+    if (wxMessageBox(q, "Confirm Sync", wxYES_NO | wxNO_DEFAULT | wxICON_WARNING, this) != wxYES)
+        return;
+
+    SyncStats stats;
+    std::string err;
+    bool ok;
+    {
+        wxBusyCursor busy;
+        ok = m_engine.Apply(m_comparedSource, m_comparedTarget, m_entries, ReadOptions(), stats, err);
+    }
+
+    const wxString report = wxString::Format(
+        "%llu file(s) copied, %llu updated by delta, %llu removed, %llu special file(s) skipped.\n"
+        "%llu bytes written, %llu bytes reused.",
+        (unsigned long long)stats.filesCopied, (unsigned long long)stats.filesDelta,
+        (unsigned long long)stats.entriesRemoved, (unsigned long long)stats.entriesSkipped,
+        (unsigned long long)stats.bytesWritten,
+        (unsigned long long)stats.bytesReused);
+
+    if (!ok)
+        wxMessageBox(wxString::FromUTF8(err) + "\n\n" + report, "Sync", wxOK | wxICON_ERROR, this);
+    else
+        wxMessageBox(report, "Sync", wxOK | wxICON_INFORMATION, this);
+
+    OnCompare(event);
+}
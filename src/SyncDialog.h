@@ -0,0 +1,50 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the SyncDialog class, the window used to compare a source directory with a target directory, review the added, changed and removed entries, and then mirror the source onto the target with SyncEngine.
+February 1, 2026
+*/
+
+#ifndef SYNCDIALOG_H
+#define SYNCDIALOG_H
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <vector>
+
+#include "SyncEngine.h"
+
+class SyncDialog final : public wxDialog
+{
+public:
+    SyncDialog(wxWindow* parent, const FileSystemService& fs, const fs::path& source, const fs::path& target);
+
+private:
+    wxTextCtrl* m_sourceCtrl = nullptr;
+    wxTextCtrl* m_targetCtrl = nullptr;
+    wxCheckBox* m_contentCheck = nullptr;
+    wxCheckBox* m_deleteCheck = nullptr;
+    wxListCtrl* m_resultList = nullptr;
+    wxStaticText* m_summary = nullptr;
+    wxButton* m_syncButton = nullptr;
+
+    SyncEngine m_engine;
+    std::vector<SyncEntry> m_entries;
+    fs::path m_comparedSource;
+    fs::path m_comparedTarget;
+
+    enum
+    {
+        ID_Compare = wxID_HIGHEST + 1,
+        ID_Sync
+    };
+
+    SyncOptions ReadOptions() const;
+    void ShowEntries();
+
+    void OnCompare(wxCommandEvent& event);
+    void OnSync(wxCommandEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+#endif // SYNCDIALOG_H
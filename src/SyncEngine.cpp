@@ -0,0 +1,787 @@
+/*
+Parneet Baidwan - 251259638
+Description: The SyncEngine class implementation in this file walks two directory trees through FileSystemService, reports which entries were added, changed or removed, and applies a one-way sync. New and changed files are copied in parallel through a temporary sibling and renamed into place. Large changed files are patched rsync-style: the target is summarized by per-block rolling and strong checksums and only the source ranges with no matching block are written.
+February 1, 2026
+*/
+
+#include "SyncEngine.h"
+#include "Checksum.h"
+#include "FsBackend.h"
+#include "IoScheduler.h"
+#include "ThreadUtil.h"
+#include "TreeWalker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FM_HAVE_POSIX_IO 1
+#endif
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace
+{
+    // Accumulated across worker threads while applying a sync
+    struct SharedStats
+    {
+        std::atomic<std::uintmax_t> filesCopied{ 0 };
+        std::atomic<std::uintmax_t> filesDelta{ 0 };
+        std::atomic<std::uintmax_t> bytesWritten{ 0 };
+        std::atomic<std::uintmax_t> bytesReused{ 0 };
+    };
+
+    // One file to bring up to date
+    struct CopyJob
+    {
+        fs::path rel;
+        bool targetExists = false;
+        bool symlink = false;       // recreate the link instead of copying what it points to
+    };
+
+    fs::path TempSibling(const fs::path& p)
+    {
+        return p.parent_path() / ("." + p.filename().string() + ".fm-sync.tmp");
+    }
+
+#ifdef FM_HAVE_POSIX_IO
+    // Piece of the new file: either bytes of the source or a block already in the target
+    struct DeltaOp
+    {
+        bool literal = true;
+        std::uint64_t from = 0;     // source offset (literal) or target offset (block)
+        std::uint64_t length = 0;
+        std::uint64_t outOffset = 0;
+    };
+
+    struct BlockSig
+    {
+        std::uint64_t strong = 0;
+        std::uint64_t offset = 0;
+    };
+
+    // Closes a file descriptor on scope exit
+    struct FdGuard
+    {
+        int fd = -1;
+        ~FdGuard() { if (fd >= 0) ::close(fd); }
+    };
+
+    bool WriteAll(int fd, const unsigned char* data, std::uint64_t len, std::uint64_t offset)
+    {
+        while (len > 0)
+        {
+            const ssize_t n = ::pwrite(fd, data, (std::size_t)std::min<std::uint64_t>(len, 1u << 30), (off_t)offset);
+            if (n <= 0) return false;
+            data += n;
+            len -= (std::uint64_t)n;
+            offset += (std::uint64_t)n;
+        }
+        return true;
+    }
+
+    bool ReadAll(int fd, unsigned char* data, std::size_t len, std::uint64_t offset)
+    {
+        while (len > 0)
+        {
+            const ssize_t n = ::pread(fd, data, len, (off_t)offset);
+            if (n <= 0) return false;
+            data += n;
+            len -= (std::size_t)n;
+            offset += (std::uint64_t)n;
+        }
+        return true;
+    }
+
+    void AppendOp(std::vector<DeltaOp>& ops, bool literal, std::uint64_t from, std::uint64_t length, std::uint64_t outOffset)
+    {
+        if (length == 0) return;
+        if (!ops.empty())
+        {
+            DeltaOp& last = ops.back();
+            if (last.literal == literal && last.from + last.length == from)
+            {
+                last.length += length;
+                return;
+            }
+        }
+        ops.push_back(DeltaOp{ literal, from, length, outOffset });
+    }
+
+    // Sliding window over a file read with pread. The source is read rather than mapped, so a
+    // file truncated while it is scanned ends the delta with a read error instead of SIGBUS.
+    class SourceWindow
+    {
+    public:
+        SourceWindow(int fd, std::uint64_t length, std::size_t capacity)
+            : m_fd(fd), m_length(length), m_buf(capacity)
+        {
+        }
+
+        // Bytes [pos, pos + n) of the file, or nullptr if they cannot be read; n <= capacity
+        const unsigned char* At(std::uint64_t pos, std::size_t n)
+        {
+            if (pos >= m_start && pos + n <= m_start + m_filled) return m_buf.data() + (pos - m_start);
+            if (pos + n > m_length) return nullptr;
+
+            m_start = pos;
+            m_filled = (std::size_t)std::min<std::uint64_t>(m_buf.size(), m_length - pos);
+            if (!ReadAll(m_fd, m_buf.data(), m_filled, pos))
+            {
+                m_filled = 0;
+                return nullptr;
+            }
+            return m_buf.data();
+        }
+
+    private:
+        int m_fd;
+        std::uint64_t m_length;
+        std::vector<unsigned char> m_buf;
+        std::uint64_t m_start = 0;
+        std::size_t m_filled = 0;
+    };
+
+    // Bytes of the source the scan window holds at least
+    constexpr std::size_t kWindowBytes = 4u << 20;
+
+    bool CopyRange(int in, std::uint64_t from, std::uint64_t length, int out, std::uint64_t to,
+                   std::vector<unsigned char>& buf)
+    {
+        for (std::uint64_t done = 0; done < length; )
+        {
+            const std::size_t n = (std::size_t)std::min<std::uint64_t>(buf.size(), length - done);
+            if (!ReadAll(in, buf.data(), n, from + done) || !WriteAll(out, buf.data(), n, to + done)) return false;
+            done += n;
+        }
+        return true;
+    }
+
+    /*
+    Function: DeltaUpdate
+    Description: Brings an existing target file up to date with the source by transferring only
+                 the ranges that have no identical block in the target. Target blocks are
+                 indexed by a rolling weak checksum and XXH64; the source is scanned with the
+                 rolling checksum one byte at a time. The new file is built in a temporary
+                 sibling and renamed over the target, so, as with a full copy, readers never
+                 see a half-written target. If every reused block stays at its offset and the
+                 filesystem can clone files (FICLONE), the sibling starts as a clone of the
+                 target and only the changed ranges are written; otherwise it is assembled
+                 from target blocks and source literals.
+    Parameters:
+      - src: Source file.
+      - dst: Existing target file.
+      - blockSize: Block size of the delta.
+      - outWritten: Output number of bytes written to disk.
+      - outReused: Output number of bytes taken from the existing target.
+    Returns:
+      - bool: true on success; false if the caller should fall back to a full copy.
+    */
+    bool DeltaUpdate(const fs::path& src, const fs::path& dst, std::size_t blockSize,
+                     std::uintmax_t& outWritten, std::uintmax_t& outReused)
+    {
+        FdGuard srcFd{ ::open(src.c_str(), O_RDONLY) };
+        FdGuard dstFd{ ::open(dst.c_str(), O_RDONLY) };
+        if (srcFd.fd < 0 || dstFd.fd < 0) return false;
+
+        struct stat srcSt{};
+        struct stat dstSt{};
+        if (::fstat(srcFd.fd, &srcSt) != 0 || ::fstat(dstFd.fd, &dstSt) != 0) return false;
+
+        const std::uint64_t srcLen = (std::uint64_t)srcSt.st_size;
+        const std::uint64_t dstLen = (std::uint64_t)dstSt.st_size;
+        if (srcLen < blockSize || dstLen < blockSize) return false;
+        ::posix_fadvise(srcFd.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        // Signatures of every full block of the target
+        std::unordered_map<std::uint32_t, std::vector<BlockSig>> sigs;
+        sigs.reserve((std::size_t)(dstLen / blockSize));
+        std::vector<unsigned char> block(blockSize);
+        for (std::uint64_t off = 0; off + blockSize <= dstLen; off += blockSize)
+        {
+            if (!ReadAll(dstFd.fd, block.data(), blockSize, off)) return false;
+            RollingChecksum weak;
+            weak.Reset(block.data(), blockSize);
+            sigs[weak.Value()].push_back(BlockSig{ Hash64::Of(block.data(), blockSize), off });
+        }
+
+        // Scan the source for blocks the target already has
+        SourceWindow source(srcFd.fd, srcLen, std::max(kWindowBytes, 2 * blockSize));
+        std::vector<DeltaOp> ops;
+        std::uint64_t pos = 0;
+        std::uint64_t literalStart = 0;
+        RollingChecksum rolling;
+        const unsigned char* data = source.At(0, blockSize);
+        if (!data) return false;
+        rolling.Reset(data, blockSize);
+
+        while (pos + blockSize <= srcLen)
+        {
+            const BlockSig* match = nullptr;
+            auto it = sigs.find(rolling.Value());
+            if (it != sigs.end())
+            {
+                data = source.At(pos, blockSize);
+                if (!data) return false;
+                const std::uint64_t strong = Hash64::Of(data, blockSize);
+                for (const BlockSig& sig : it->second)
+                {
+                    if (sig.strong != strong) continue;
+                    if (!match || sig.offset == pos) match = &sig;
+                    if (sig.offset == pos) break;
+                }
+            }
+
+            if (match)
+            {
+                AppendOp(ops, true, literalStart, pos - literalStart, literalStart);
+                AppendOp(ops, false, match->offset, blockSize, pos);
+                pos += blockSize;
+                literalStart = pos;
+                if (pos + blockSize <= srcLen)
+                {
+                    data = source.At(pos, blockSize);
+                    if (!data) return false;
+                    rolling.Reset(data, blockSize);
+                }
+                continue;
+            }
+
+            if (pos + blockSize >= srcLen) break;
+            data = source.At(pos, blockSize + 1);
+            if (!data) return false;
+            rolling.Roll(data[0], data[blockSize]);
+            ++pos;
+        }
+        AppendOp(ops, true, literalStart, srcLen - literalStart, literalStart);
+
+        std::uint64_t literalBytes = 0;
+        bool inPlace = true;
+        for (const DeltaOp& op : ops)
+        {
+            if (op.literal) literalBytes += op.length;
+            else if (op.from != op.outOffset) inPlace = false;
+        }
+
+        const fs::path tmp = TempSibling(dst);
+        FdGuard tmpFd{ ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, srcSt.st_mode & 07777) };
+        bool ok = tmpFd.fd >= 0;
+
+        bool cloned = false;
+#if defined(__linux__) && defined(FICLONE)
+        cloned = ok && inPlace && ::ioctl(tmpFd.fd, FICLONE, dstFd.fd) == 0;
+#endif
+        for (const DeltaOp& op : ops)
+        {
+            if (!ok) break;
+            if (op.literal)
+                ok = CopyRange(srcFd.fd, op.from, op.length, tmpFd.fd, op.outOffset, block);
+            else if (!cloned)
+                ok = CopyRange(dstFd.fd, op.from, op.length, tmpFd.fd, op.outOffset, block);
+        }
+        ok = ok && ::ftruncate(tmpFd.fd, (off_t)srcLen) == 0;
+
+        std::error_code ec;
+        if (ok) fs::rename(tmp, dst, ec);
+        if (!ok || ec)
+        {
+            fs::remove(tmp, ec);
+            return false;
+        }
+
+        outWritten = cloned ? literalBytes : srcLen;
+        outReused = srcLen - literalBytes;
+        return true;
+    }
+#endif
+
+    /*
+    Function: CopyLink
+    Description: Recreates a symbolic link at the destination, pointing where the source link
+                 points, through a temporary sibling renamed into place.
+    Parameters:
+      - src: Source link.
+      - dst: Destination path (replaced if it exists and is not a directory).
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the link was created; false otherwise.
+    */
+    bool CopyLink(const fs::path& src, const fs::path& dst, std::string& outErr)
+    {
+        const fs::path tmp = TempSibling(dst);
+        std::error_code ec;
+        fs::remove(tmp, ec);
+
+        fs::copy_symlink(src, tmp, ec);
+        if (!ec) fs::rename(tmp, dst, ec);
+        if (ec)
+        {
+            std::error_code ignore;
+            fs::remove(tmp, ignore);
+            outErr = "Link copy failed for " + src.string() + ": " + ec.message();
+            return false;
+        }
+        return true;
+    }
+
+    /*
+    Function: LinkStatus
+    Description: Reads an entry's own type without following a symbolic link, and the link's
+                 target if it is one.
+    Parameters:
+      - p: Entry to inspect.
+      - outTarget: Output target of the link; cleared if p is not a link.
+    Returns:
+      - fs::file_type: Type of the entry itself (not_found if it cannot be read).
+    */
+    fs::file_type LinkStatus(const fs::path& p, std::string& outTarget)
+    {
+        std::error_code ec;
+        const fs::file_type type = fs::symlink_status(p, ec).type();
+        outTarget.clear();
+        if (type == fs::file_type::symlink) outTarget = fs::read_symlink(p, ec).native();
+        return type;
+    }
+
+    /*
+    Function: FullCopy
+    Description: Copies a whole file into a temporary sibling of the destination through the
+                 service's I/O scheduler and renames it into place, so readers never see a
+                 half-written target.
+    Parameters:
+      - fsService: Filesystem service performing the copy.
+      - src: Source file.
+      - dst: Destination file (replaced if it exists).
+      - outBytes: Output number of bytes copied.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the copy succeeded; false otherwise.
+    */
+    bool FullCopy(const FileSystemService& fsService, const fs::path& src, const fs::path& dst,
+                  std::uintmax_t& outBytes, std::string& outErr)
+    {
+        const fs::path tmp = TempSibling(dst);
+        std::error_code ec;
+        fs::remove(tmp, ec);
+
+        if (!fsService.CopyFile(src, tmp, outBytes, outErr))
+        {
+            fs::remove(tmp, ec);
+            return false;
+        }
+
+        fs::rename(tmp, dst, ec);
+        if (ec)
+        {
+            std::error_code ignore;
+            fs::remove(tmp, ignore);
+            outErr = "Copy failed for " + src.string() + ": " + ec.message();
+            return false;
+        }
+        return true;
+    }
+}
+
+/*
+Function: SyncEngine::SyncEngine
+Description: Creates a sync engine that enumerates directories through the given service and
+             invalidates its listing cache for every directory it changes.
+Parameters:
+  - fs: Filesystem service; must outlive the engine.
+Returns:
+  - None
+*/
+SyncEngine::SyncEngine(const FileSystemService& fs)
+    : m_fs(fs)
+{
+}
+
+/*
+Function: SyncEngine::CompareDir
+Description: Compares one directory level of the source and target trees and recurses into
+             directories present on both sides. The target level is indexed by name and the
+             source level is streamed against that index chunk by chunk, so only one of the
+             two listings is ever held in full; directories present on both sides are
+             descended into once the source level has been read. Entries are typed without
+             following links: a link is never descended into (so a link to an ancestor
+             cannot make the comparison loop) and two links differ when their targets do.
+             Regular files with the same size and mtime are collected in outSameMeta so
+             Compare can hash them if requested.
+Parameters:
+  - source: Source directory.
+  - target: Target directory.
+  - rel: Path of this level relative to the tree roots.
+  - outEntries: Differences found are appended here.
+  - outSameMeta: Files whose metadata matches are appended here.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if both directories could be listed; false otherwise.
+*/
+bool SyncEngine::CompareDir(const fs::path& source,
+                            const fs::path& target,
+                            const fs::path& rel,
+                            std::vector<SyncEntry>& outEntries,
+                            std::vector<SyncEntry>& outSameMeta,
+                            std::string& outErr) const
+{
+    const auto dstItems = m_fs.ListDirectory(target, outErr);
+    if (!outErr.empty()) return false;
+
+    std::unordered_map<std::string, const FileItem*> dstByName;
+    dstByName.reserve(dstItems.size());
+    for (const auto& item : dstItems)
+        dstByName.emplace(item.fullPath.filename().string(), &item);
+
+    // directories on both sides, compared after this level so only one listing is open
+    std::vector<std::pair<std::string, const FileItem*>> bothDirs;
+    std::string srcLink;
+    std::string dstLink;
+
+    const bool listed = m_fs.ListDirectoryStream(source, [&](const std::vector<FileItem>& chunk)
+    {
+        for (const auto& item : chunk)
+        {
+            std::string name = item.fullPath.filename().string();
+            const fs::file_type srcType = LinkStatus(item.fullPath, srcLink);
+            const bool srcDir = srcType == fs::file_type::directory;
+
+            auto it = dstByName.find(name);
+            if (it == dstByName.end())
+            {
+                outEntries.push_back(SyncEntry{ rel / name, SyncChange::Added, srcDir, item.sizeBytes });
+                continue;
+            }
+
+            const FileItem& other = *it->second;
+            dstByName.erase(it);
+            const fs::file_type dstType = LinkStatus(other.fullPath, dstLink);
+
+            if (srcDir && dstType == fs::file_type::directory)
+            {
+                bothDirs.emplace_back(std::move(name), &other);
+                continue;
+            }
+
+            SyncEntry entry{ rel / name, SyncChange::Changed, srcDir, item.sizeBytes };
+            if (srcType != dstType || (srcType == fs::file_type::symlink && srcLink != dstLink))
+                outEntries.push_back(entry);
+            else if (srcType != fs::file_type::regular)
+                continue;
+            else if (item.sizeBytes != other.sizeBytes || item.modified != other.modified)
+                outEntries.push_back(entry);
+            else
+                outSameMeta.push_back(entry);
+        }
+        return true;
+    }, outErr);
+    if (!listed) return false;
+
+    for (const auto& left : dstByName)
+    {
+        const FileItem& item = *left.second;
+        const bool dir = LinkStatus(item.fullPath, dstLink) == fs::file_type::directory;
+        outEntries.push_back(SyncEntry{ rel / left.first, SyncChange::Removed, dir, item.sizeBytes });
+    }
+
+    for (const auto& dir : bothDirs)
+    {
+        if (!CompareDir(source / dir.first, dir.second->fullPath, rel / dir.first, outEntries, outSameMeta, outErr))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+Function: SyncEngine::Compare
+Description: Lists the differences between the source and target trees. Entries are added,
+             changed (different type, size, mtime or link target, or different content hash
+             when opts.compareContent is set) or removed (present only in the target). A new
+             or removed directory is reported once, not per child. Content hashes are
+             computed in parallel.
+Parameters:
+  - source: Root of the source tree.
+  - target: Root of the target tree.
+  - opts: Comparison options.
+  - outEntries: Output list of differences, sorted by path.
+  - outErr: Output string populated with an error message if comparison fails; cleared on success.
+Returns:
+  - bool: true if the comparison completed; false otherwise.
+*/
+bool SyncEngine::Compare(const fs::path& source,
+                         const fs::path& target,
+                         const SyncOptions& opts,
+                         std::vector<SyncEntry>& outEntries,
+                         std::string& outErr) const
+{
+    outErr.clear();
+    outEntries.clear();
+
+    // hashing and block deltas read the files directly
+    if (!m_fs.Backend().IsLocal())
+    {
+        outErr = "Sync needs a backend on the local filesystem.";
+        return false;
+    }
+
+    if (!m_fs.IsDirectory(source) || !m_fs.IsDirectory(target))
+    {
+        outErr = "Both source and target must be directories.";
+        return false;
+    }
+
+    const fs::path src = m_fs.CanonicalOrSame(source);
+    const fs::path dst = m_fs.CanonicalOrSame(target);
+    if (src == dst)
+    {
+        outErr = "Source and target are the same directory.";
+        return false;
+    }
+
+    std::vector<SyncEntry> sameMeta;
+    if (!CompareDir(src, dst, fs::path(), outEntries, sameMeta, outErr))
+        return false;
+
+    if (opts.compareContent && !sameMeta.empty())
+    {
+        std::vector<char> differs(sameMeta.size(), 0);
+        ParallelFor(sameMeta.size(), opts.threads, [&](std::size_t i)
+        {
+            std::uint64_t a = 0;
+            std::uint64_t b = 0;
+            std::string err;
+            const bool ok = HashFileContents(src / sameMeta[i].relPath, a, err) &&
+                            HashFileContents(dst / sameMeta[i].relPath, b, err);
+            differs[i] = (!ok || a != b) ? 1 : 0;
+        });
+
+        for (std::size_t i = 0; i < sameMeta.size(); ++i)
+        {
+            if (differs[i]) outEntries.push_back(sameMeta[i]);
+        }
+    }
+
+    std::sort(outEntries.begin(), outEntries.end(), [](const SyncEntry& a, const SyncEntry& b)
+    {
+        return a.relPath < b.relPath;
+    });
+    return true;
+}
+
+/*
+Function: SyncEngine::Apply
+Description: Makes the target tree mirror the source for the given differences. Removed
+             entries are deleted (if opts.deleteRemoved), entries whose type changed are
+             replaced, new directories are created, and every new or changed file is copied in
+             parallel. Changed files of at least opts.deltaMinSize are updated with a block
+             delta; other files are copied whole. Symbolic links are recreated as links
+             rather than copied through; FIFOs, sockets and devices are skipped and counted
+             in outStats.entriesSkipped, since reading one could block or never end. Copied
+             files get the source mtime so the next comparison sees them as equal.
+Parameters:
+  - source: Root of the source tree.
+  - target: Root of the target tree.
+  - entries: Differences returned by Compare for the same roots.
+  - opts: Sync options.
+  - outStats: Output totals of the work done.
+  - outErr: Output string populated with an error message if any entry failed; cleared on success.
+Returns:
+  - bool: true if every entry was applied; false otherwise.
+*/
+bool SyncEngine::Apply(const fs::path& source,
+                       const fs::path& target,
+                       const std::vector<SyncEntry>& entries,
+                       const SyncOptions& opts,
+                       SyncStats& outStats,
+                       std::string& outErr) const
+{
+    outErr.clear();
+    outStats = SyncStats{};
+    if (!m_fs.Backend().IsLocal())
+    {
+        outErr = "Sync needs a backend on the local filesystem.";
+        return false;
+    }
+
+    const fs::path src = m_fs.CanonicalOrSame(source);
+    const fs::path dst = m_fs.CanonicalOrSame(target);
+
+    std::set<fs::path> touchedDirs{ dst };
+    std::vector<CopyJob> jobs;
+    std::vector<std::string> errors;
+    std::error_code ec;
+
+    for (const SyncEntry& e : entries)
+    {
+        const fs::path from = src / e.relPath;
+        const fs::path to = dst / e.relPath;
+        touchedDirs.insert(to.parent_path());
+
+        if (e.change == SyncChange::Removed)
+        {
+            if (!opts.deleteRemoved) continue;
+            const std::uintmax_t n = fs::remove_all(to, ec);
+            if (ec) errors.push_back("Remove failed for " + to.string() + ": " + ec.message());
+            else outStats.entriesRemoved += n;
+            touchedDirs.insert(to);
+            continue;
+        }
+
+        const fs::file_status fromStatus = fs::symlink_status(from, ec);
+        const bool symlink = fs::is_symlink(fromStatus);
+        if (fs::is_other(fromStatus))
+        {
+            outStats.entriesSkipped++;
+            continue;
+        }
+
+        // A file replaced by a directory or the other way round, or a target link replaced by
+        // anything but a link, is removed first so nothing is written through the link
+        bool targetExists = e.change == SyncChange::Changed;
+        const fs::file_status toStatus = fs::symlink_status(to, ec);
+        const bool replaceDir = fs::is_symlink(toStatus) ? !symlink
+                                                         : fs::is_directory(toStatus) != (e.isDir && !symlink);
+        if (targetExists && replaceDir)
+        {
+            outStats.entriesRemoved += fs::remove_all(to, ec);
+            if (ec)
+            {
+                errors.push_back("Remove failed for " + to.string() + ": " + ec.message());
+                continue;
+            }
+            targetExists = false;
+        }
+
+        if (!e.isDir || symlink)
+        {
+            jobs.push_back(CopyJob{ e.relPath, targetExists, symlink });
+            continue;
+        }
+
+        fs::create_directories(to, ec);
+        touchedDirs.insert(to);
+
+        // a new directory is expanded with the parallel walker; each directory is reported
+        // before its children, so it exists before anything is created inside it. Links are
+        // not followed by the walk and are recreated as links; special files are skipped.
+        const std::size_t fromLen = from.native().size() + 1;
+        std::mutex walkMutex;
+        TreeWalkOptions walkOpts;
+        walkOpts.threads = opts.threads;
+        walkOpts.statEntries = false;
+        TreeWalkCallbacks callbacks;
+        callbacks.onEntry = [&](const WalkEntry& w)
+        {
+            const fs::path rel = e.relPath / fs::path(w.path.native().substr(fromLen));
+            std::error_code e2;
+            if (w.type == FsEntryType::Directory)
+            {
+                fs::create_directories(dst / rel, e2);
+                std::lock_guard<std::mutex> lock(walkMutex);
+                touchedDirs.insert(dst / rel);
+            }
+            else if (w.type == FsEntryType::Other)
+            {
+                std::lock_guard<std::mutex> lock(walkMutex);
+                outStats.entriesSkipped++;
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(walkMutex);
+                jobs.push_back(CopyJob{ rel, false, w.type == FsEntryType::Symlink });
+            }
+        };
+        callbacks.onError = [&](const fs::path& dir, const std::string& msg)
+        {
+            std::lock_guard<std::mutex> lock(walkMutex);
+            errors.push_back("Cannot read " + dir.string() + ": " + msg);
+        };
+        TreeWalkStats walkStats;
+        std::string walkErr;
+        if (!m_fs.WalkTree(from, walkOpts, callbacks, walkStats, walkErr))
+            errors.push_back("Cannot read " + from.string() + ": " + walkErr);
+    }
+
+    SharedStats shared;
+    std::mutex errMutex;
+    ParallelFor(jobs.size(), opts.threads, [&](std::size_t i)
+    {
+        const CopyJob& job = jobs[i];
+        const fs::path from = src / job.rel;
+        const fs::path to = dst / job.rel;
+        std::string err;
+
+        if (job.symlink)
+        {
+            if (CopyLink(from, to, err))
+            {
+                shared.filesCopied++;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(errMutex);
+            errors.push_back(err);
+            return;
+        }
+
+        std::error_code e2;
+        const std::uintmax_t size = fs::file_size(from, e2);
+        const auto mtime = fs::last_write_time(from, e2);
+
+        bool done = false;
+#ifdef FM_HAVE_POSIX_IO
+        if (!e2 && job.targetExists && size >= opts.deltaMinSize)
+        {
+            std::uintmax_t written = 0;
+            std::uintmax_t reused = 0;
+            IoScheduler& scheduler = m_fs.Scheduler();
+            const DeviceId dev = IoScheduler::DeviceOf(to);
+            IoScheduler::Ticket ticket = scheduler.Acquire({ IoScheduler::DeviceOf(from), dev });
+            done = DeltaUpdate(from, to, opts.deltaBlockSize, written, reused);
+            if (done)
+            {
+                scheduler.Transfer(dev, written);
+                shared.filesDelta++;
+                shared.bytesWritten += written;
+                shared.bytesReused += reused;
+            }
+        }
+#endif
+        std::uintmax_t copied = 0;
+        if (!done && !FullCopy(m_fs, from, to, copied, err))
+        {
+            std::lock_guard<std::mutex> lock(errMutex);
+            errors.push_back(err);
+            return;
+        }
+        if (!done)
+        {
+            shared.filesCopied++;
+            shared.bytesWritten += copied;
+        }
+
+        if (!e2) fs::last_write_time(to, mtime, e2);
+    });
+
+    outStats.filesCopied = shared.filesCopied;
+    outStats.filesDelta = shared.filesDelta;
+    outStats.bytesWritten = shared.bytesWritten;
+    outStats.bytesReused = shared.bytesReused;
+
+    for (const auto& dir : touchedDirs) m_fs.InvalidateListing(dir);
+
+    if (!errors.empty())
+    {
+        outErr = std::to_string(errors.size()) + " item(s) failed. First error: " + errors.front();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the SyncEngine class and its data structures, which compare a source tree with a target tree and mirror the source onto the target in one direction. Differences are detected by size and modification time (optionally by content hash), changed files are copied in parallel, and large files that already exist at the target are updated by transferring only the blocks that differ.
+February 1, 2026
+*/
+
+#ifndef SYNCENGINE_H
+#define SYNCENGINE_H
+
+#include "FileSystemService.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Kind of difference between the source and the target tree
+enum class SyncChange
+{
+    Added,
+    Changed,
+    Removed
+};
+
+// One difference found by SyncEngine::Compare, relative to the tree roots
+struct SyncEntry
+{
+    fs::path relPath;
+    SyncChange change = SyncChange::Added;
+    bool isDir = false;
+    std::uintmax_t sizeBytes = 0;
+};
+
+// Settings for comparing and applying a sync
+struct SyncOptions
+{
+    bool compareContent = false;                  // hash files whose size and mtime match
+    bool deleteRemoved = true;                    // delete target entries missing from the source
+    unsigned threads = 0;                         // 0 = one per hardware thread
+    std::uintmax_t deltaMinSize = 16u << 20;      // files at least this large use block deltas
+    std::size_t deltaBlockSize = 64u << 10;
+};
+
+// Totals reported after SyncEngine::Apply
+struct SyncStats
+{
+    std::uintmax_t filesCopied = 0;
+    std::uintmax_t filesDelta = 0;
+    std::uintmax_t entriesRemoved = 0;
+    std::uintmax_t entriesSkipped = 0;            // FIFOs, sockets and devices, never copied
+    std::uintmax_t bytesWritten = 0;
+    std::uintmax_t bytesReused = 0;
+};
+
+// One-way tree comparison and synchronization
+class SyncEngine final
+{
+public:
+    explicit SyncEngine(const FileSystemService& fs);
+
+    bool Compare(const fs::path& source,
+                 const fs::path& target,
+                 const SyncOptions& opts,
+                 std::vector<SyncEntry>& outEntries,
+                 std::string& outErr) const;
+
+    bool Apply(const fs::path& source,
+               const fs::path& target,
+               const std::vector<SyncEntry>& entries,
+               const SyncOptions& opts,
+               SyncStats& outStats,
+               std::string& outErr) const;
+
+private:
+    bool CompareDir(const fs::path& source,
+                    const fs::path& target,
+                    const fs::path& rel,
+                    std::vector<SyncEntry>& outEntries,
+                    std::vector<SyncEntry>& outSameMeta,
+                    std::string& outErr) const;
+
+    const FileSystemService& m_fs;
+};
+
+#endif // SYNCENGINE_H
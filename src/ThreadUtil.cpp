@@ -0,0 +1,94 @@
+/*
+Parneet Baidwan - 251259638
+Description: The thread helper implementation in this file adjusts the scheduling priority of background threads. On Linux the calling thread is moved to SCHED_IDLE and its I/O priority is lowered, on macOS it gets the background QoS class, and failures are ignored because priority is only a hint. It also implements ParallelFor, which hands out loop indices to a fixed set of threads through an atomic counter.
+February 1, 2026
+*/
+
+#include "ThreadUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#endif
+
+/*
+Function: SetCurrentThreadIdlePriority
+Description: Lowers the CPU (and on Linux, I/O) priority of the calling thread so it only runs
+             when nothing else wants the CPU or the disk. Errors are ignored.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void SetCurrentThreadIdlePriority()
+{
+#if defined(__linux__)
+    sched_param param{};
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+    // ioprio_set(IOPRIO_WHO_PROCESS, this thread, IOPRIO_CLASS_IDLE)
+    constexpr int kIoprioWhoProcess = 1;
+    constexpr int kIoprioClassIdle = 3;
+    constexpr int kIoprioClassShift = 13;
+    syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, kIoprioClassIdle << kIoprioClassShift);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#endif
+}
+
+/*
+Function: DefaultWorkerCount
+Description: Chooses a worker count for parallel file jobs from the hardware concurrency.
+Parameters:
+  - None
+Returns:
+  - unsigned: Number of threads to use (at least 1).
+*/
+unsigned DefaultWorkerCount()
+{
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 4 : hw;
+}
+
+/*
+Function: ParallelFor
+Description: Executes fn for every index in [0, count) using up to `threads` threads (the
+             calling thread is one of them). Indices are claimed dynamically so uneven job
+             sizes (e.g. one huge file among small ones) still balance. fn must not throw.
+Parameters:
+  - count: Number of jobs.
+  - threads: Maximum number of threads; 0 selects DefaultWorkerCount().
+  - fn: Job body, called once per index.
+Returns:
+  - None
+*/
+void ParallelFor(std::size_t count, unsigned threads, const std::function<void(std::size_t)>& fn)
+{
+    if (count == 0) return;
+    if (threads == 0) threads = DefaultWorkerCount();
+    threads = (unsigned)std::min<std::size_t>(threads, count);
+
+    std::atomic<std::size_t> next{ 0 };
+    auto worker = [&]()
+    {
+        for (std::size_t i = next++; i < count; i = next++)
+            fn(i);
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+}
@@ -0,0 +1,22 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares small helpers shared by the background worker threads of the file manager, such as lowering a thread's scheduling priority so speculative or cleanup work never competes with the user interface or foreground file operations, and a simple parallel loop for independent per-file jobs.
+February 1, 2026
+*/
+
+#ifndef THREADUTIL_H
+#define THREADUTIL_H
+
+#include <cstddef>
+#include <functional>
+
+// Moves the calling thread to idle scheduling priority (best effort)
+void SetCurrentThreadIdlePriority();
+
+// Number of worker threads to use when the caller passes 0
+unsigned DefaultWorkerCount();
+
+// Runs fn(0..count-1) on up to `threads` threads and waits for all of them
+void ParallelFor(std::size_t count, unsigned threads, const std::function<void(std::size_t)>& fn);
+
+#endif // THREADUTIL_H
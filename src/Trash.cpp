@@ -0,0 +1,450 @@
+/*
+Parneet Baidwan - 251259638
+Description: The Trash class implementation in this file moves deleted items into a per-volume trash directory (the user's data directory when it is on the same volume, otherwise a hidden .fm-trash-<uid> directory at the top of the volume) with a single rename. Every move, restore and purge is appended as one line to a journal; replaying the journal at startup rebuilds the list of items that can still be restored. The oldest items beyond the undo depth, and items older than a week, are handed to the idle-priority background purger.
+February 1, 2026
+*/
+
+#include "Trash.h"
+#include "BackgroundPurger.h"
+#include "FsBackend.h"
+#include "IoScheduler.h"
+
+#include <fstream>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Deletes that can be undone, and how long trashed items are kept at most
+    constexpr std::size_t kUndoDepth = 32;
+    constexpr std::time_t kRetentionSeconds = 7 * 24 * 60 * 60;
+
+    const char* const kTrashPrefix = ".fm-trash-";
+
+    std::string UserTag()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return std::to_string((unsigned long)::getuid());
+#else
+        return "user";
+#endif
+    }
+
+    long ProcessTag()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return (long)::getpid();
+#else
+        return 0;
+#endif
+    }
+
+    // Makes a journal field safe to store between tabs on one line
+    std::string Escape(const std::string& s)
+    {
+        std::string out;
+        out.reserve(s.size());
+        for (char c : s)
+        {
+            switch (c)
+            {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c; break;
+            }
+        }
+        return out;
+    }
+
+    std::string Unescape(const std::string& s)
+    {
+        std::string out;
+        out.reserve(s.size());
+        for (std::size_t i = 0; i < s.size(); ++i)
+        {
+            if (s[i] != '\\' || i + 1 == s.size())
+            {
+                out += s[i];
+                continue;
+            }
+            const char c = s[++i];
+            out += c == 't' ? '\t' : c == 'n' ? '\n' : c == 'r' ? '\r' : c;
+        }
+        return out;
+    }
+
+    // One journal line: op, id, time, original, trashed
+    std::string FormatRecord(char op, const TrashEntry& e)
+    {
+        return std::string(1, op) + '\t' + e.id + '\t' + std::to_string((long long)e.deleted) + '\t' +
+               Escape(e.original.string()) + '\t' + Escape(e.trashed.string()) + '\n';
+    }
+
+    /*
+    Function: ParseRecord
+    Description: Splits one journal line back into its fields.
+    Parameters:
+      - line: Journal line without the newline.
+      - outOp: Output operation (T = trashed, R = restored, P = purged).
+      - outEntry: Output entry.
+    Returns:
+      - bool: true if the line is well formed; false (e.g. for a torn last line) otherwise.
+    */
+    bool ParseRecord(const std::string& line, char& outOp, TrashEntry& outEntry)
+    {
+        std::vector<std::string> fields;
+        std::size_t start = 0;
+        for (;;)
+        {
+            const std::size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+            if (tab == std::string::npos) break;
+            start = tab + 1;
+        }
+        if (fields.size() != 5 || fields[0].size() != 1 || fields[1].empty()) return false;
+
+        outOp = fields[0][0];
+        outEntry.id = fields[1];
+        try
+        {
+            outEntry.deleted = (std::time_t)std::stoll(fields[2]);
+        }
+        catch (...)
+        {
+            return false;
+        }
+        outEntry.original = fs::path(Unescape(fields[3]));
+        outEntry.trashed = fs::path(Unescape(fields[4]));
+        return true;
+    }
+
+    bool PathExists(const fs::path& p)
+    {
+        std::error_code ec;
+        return fs::exists(fs::symlink_status(p, ec));
+    }
+}
+
+/*
+Function: Trash::Trash
+Description: Opens the trash journal in dataDir and replays it, so deletes from earlier
+             sessions can still be undone.
+Parameters:
+  - backend: Local backend performing the renames.
+  - purger: Background purger that reclaims trashed items.
+  - dataDir: Per-user data directory holding the journal and the home trash.
+Returns:
+  - None
+*/
+Trash::Trash(std::shared_ptr<FsBackend> backend, std::shared_ptr<BackgroundPurger> purger, fs::path dataDir)
+    : m_backend(std::move(backend)),
+      m_purger(std::move(purger)),
+      m_dataDir(std::move(dataDir)),
+      m_journal(m_dataDir / "trash.journal")
+{
+    Replay();
+}
+
+/*
+Function: Trash::TrashDirectoryFor
+Description: Picks the trash directory on the same volume as target, so moving target there
+             is a rename: the home trash in the data directory if it shares the volume,
+             otherwise .fm-trash-<uid> in the topmost directory of target's volume.
+Parameters:
+  - target: Item about to be deleted.
+Returns:
+  - fs::path: Trash directory (may not exist yet).
+*/
+fs::path Trash::TrashDirectoryFor(const fs::path& target) const
+{
+    const fs::path parent = target.parent_path();
+    const DeviceId device = IoScheduler::DeviceOf(parent);
+
+    const fs::path home = m_dataDir / "trash";
+    if (IoScheduler::DeviceOf(home) == device) return home;
+
+    fs::path top = parent;
+    while (top.has_parent_path() && top.parent_path() != top && IoScheduler::DeviceOf(top.parent_path()) == device)
+        top = top.parent_path();
+    return top / (kTrashPrefix + UserTag());
+}
+
+/*
+Function: Trash::IsTrashPath
+Description: Tells whether p is inside a trash directory or the data directory, where a
+             delete has to be permanent.
+Parameters:
+  - p: Path to test.
+Returns:
+  - bool: true if p belongs to the trash; false otherwise.
+*/
+bool Trash::IsTrashPath(const fs::path& p) const
+{
+    const fs::path normal = p.lexically_normal();
+    for (const fs::path& part : normal)
+    {
+        if (part.string().rfind(kTrashPrefix, 0) == 0) return true;
+    }
+
+    const fs::path rel = normal.lexically_relative(m_dataDir.lexically_normal());
+    return !rel.empty() && *rel.begin() != "..";
+}
+
+/*
+Function: Trash::AppendLocked
+Description: Appends one record to the journal. Caller must hold m_mutex.
+Parameters:
+  - op: T (moved to trash), R (restored) or P (purged).
+  - entry: Item the record is about.
+Returns:
+  - bool: true if the record was written; false otherwise.
+*/
+bool Trash::AppendLocked(char op, const TrashEntry& entry)
+{
+    std::error_code ec;
+    fs::create_directories(m_dataDir, ec);
+
+    std::ofstream out(m_journal, std::ios::app | std::ios::binary);
+    out << FormatRecord(op, entry);
+    out.flush();
+    return (bool)out;
+}
+
+/*
+Function: Trash::PurgeLocked
+Description: Gives up on restoring an entry: journals the purge and queues the trashed data
+             for deletion at idle priority. Caller must hold m_mutex.
+Parameters:
+  - entry: Entry to reclaim.
+Returns:
+  - None
+*/
+void Trash::PurgeLocked(const TrashEntry& entry)
+{
+    AppendLocked('P', entry);
+    m_purger->Enqueue(entry.trashed);
+}
+
+/*
+Function: Trash::Replay
+Description: Rebuilds the restorable entries from the journal. Entries whose trashed data has
+             disappeared are dropped, entries past the retention time or the undo depth are
+             purged, and purges that were journaled but did not finish (e.g. the application
+             exited first) are queued again. A torn last line is terminated so the next
+             record starts on its own line, and a journal mostly made of dead records is
+             rewritten with just the live entries.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void Trash::Replay()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::ifstream in(m_journal, std::ios::binary);
+    if (!in) return;
+
+    std::vector<TrashEntry> order;
+    std::unordered_map<std::string, std::size_t> indexOf;
+    std::vector<bool> alive;
+    std::vector<fs::path> purged;
+    std::size_t records = 0;
+    bool torn = false;
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        // a last line without newline was cut short by a crash
+        torn = in.eof();
+        char op = 0;
+        TrashEntry e;
+        if (!ParseRecord(line, op, e)) continue;
+        ++records;
+
+        if (op == 'T')
+        {
+            indexOf[e.id] = order.size();
+            order.push_back(std::move(e));
+            alive.push_back(true);
+            continue;
+        }
+
+        const auto it = indexOf.find(e.id);
+        if (it != indexOf.end()) alive[it->second] = false;
+        if (op == 'P') purged.push_back(e.trashed);
+    }
+    in.close();
+    if (torn)
+    {
+        std::ofstream out(m_journal, std::ios::app | std::ios::binary);
+        out << '\n';
+    }
+
+    for (const fs::path& p : purged)
+    {
+        if (PathExists(p)) m_purger->Enqueue(p);
+    }
+
+    const std::time_t cutoff = std::time(nullptr) - kRetentionSeconds;
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        if (!alive[i] || !PathExists(order[i].trashed)) continue;
+        if (order[i].deleted < cutoff)
+            PurgeLocked(order[i]);
+        else
+            m_live.push_back(order[i]);
+    }
+    while (m_live.size() > kUndoDepth)
+    {
+        PurgeLocked(m_live.front());
+        m_live.erase(m_live.begin());
+    }
+
+    if (records > 4 * m_live.size() + 64)
+    {
+        const fs::path tmp = m_journal.string() + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc | std::ios::binary);
+            for (const TrashEntry& e : m_live) out << FormatRecord('T', e);
+            out.flush();
+            if (!out) return;
+        }
+        std::error_code ec;
+        fs::rename(tmp, m_journal, ec);
+    }
+}
+
+/*
+Function: Trash::MoveToTrash
+Description: Deletes target by renaming it into the trash directory of its volume. The move is
+             journaled before the rename, so a crash in between leaves a record whose data is
+             missing (dropped on the next replay) rather than trashed data nobody knows about.
+             When more than the undo depth of items are in the trash, the oldest is purged.
+Parameters:
+  - target: File or directory to delete.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if target is now in the trash; false otherwise (target unchanged).
+*/
+bool Trash::MoveToTrash(const fs::path& target, std::string& outErr)
+{
+    outErr.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (IsTrashPath(target))
+    {
+        outErr = "Items in the trash can only be deleted permanently.";
+        return false;
+    }
+
+    const fs::path dir = TrashDirectoryFor(target);
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+    {
+        outErr = "Cannot create trash directory " + dir.string() + ": " + ec.message();
+        return false;
+    }
+    fs::permissions(dir, fs::perms::owner_all, fs::perm_options::replace, ec);
+
+    TrashEntry entry;
+    entry.deleted = std::time(nullptr);
+    entry.id = std::to_string((long long)entry.deleted) + "-" + std::to_string(ProcessTag()) + "-" + std::to_string(m_counter++);
+    entry.original = target;
+    entry.trashed = dir / entry.id;
+
+    if (!AppendLocked('T', entry))
+    {
+        outErr = "Cannot write the trash journal " + m_journal.string();
+        return false;
+    }
+
+    std::string err;
+    if (!m_backend->Rename(target, entry.trashed, err))
+    {
+        AppendLocked('P', entry);
+        outErr = "Cannot move to the trash: " + err;
+        return false;
+    }
+
+    m_live.push_back(entry);
+    while (m_live.size() > kUndoDepth)
+    {
+        PurgeLocked(m_live.front());
+        m_live.erase(m_live.begin());
+    }
+    return true;
+}
+
+/*
+Function: Trash::UndoLast
+Description: Restores the most recently trashed item to its original path, recreating missing
+             parent directories. Refuses to overwrite anything that has since been created at
+             that path.
+Parameters:
+  - outRestored: Output entry that was restored.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the item is back in place; false otherwise.
+*/
+bool Trash::UndoLast(TrashEntry& outRestored, std::string& outErr)
+{
+    outErr.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_live.empty())
+    {
+        outErr = "Nothing to undo.";
+        return false;
+    }
+
+    const TrashEntry entry = m_live.back();
+    if (!PathExists(entry.trashed))
+    {
+        AppendLocked('P', entry);
+        m_live.pop_back();
+        outErr = "The trashed copy of " + entry.original.string() + " no longer exists.";
+        return false;
+    }
+    if (PathExists(entry.original))
+    {
+        outErr = "Cannot restore " + entry.original.string() + ": something with that name exists now.";
+        return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(entry.original.parent_path(), ec);
+
+    std::string err;
+    if (!m_backend->Rename(entry.trashed, entry.original, err))
+    {
+        outErr = "Cannot restore " + entry.original.string() + ": " + err;
+        return false;
+    }
+
+    AppendLocked('R', entry);
+    m_live.pop_back();
+    outRestored = entry;
+    return true;
+}
+
+/*
+Function: Trash::Last
+Description: Returns the item that UndoLast would restore.
+Parameters:
+  - None
+Returns:
+  - std::optional<TrashEntry>: The most recent restorable entry, if any.
+*/
+std::optional<TrashEntry> Trash::Last() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_live.empty()) return std::nullopt;
+    return m_live.back();
+}
@@ -0,0 +1,62 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the Trash class, which turns deletes into a rename into a trash directory on the same volume and records every such move in an append-only journal. Because nothing is copied, deleting even a huge tree is instant; the data is reclaimed later by the background purger, and until then the most recent deletes can be undone by replaying the journal backwards.
+February 1, 2026
+*/
+
+#ifndef TRASH_H
+#define TRASH_H
+
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class BackgroundPurger;
+class FsBackend;
+
+// One item moved to the trash, as recorded in the journal
+struct TrashEntry
+{
+    std::string id;
+    fs::path original;
+    fs::path trashed;
+    std::time_t deleted = 0;
+};
+
+// Rename-based trash with an undo journal
+class Trash final
+{
+public:
+    Trash(std::shared_ptr<FsBackend> backend, std::shared_ptr<BackgroundPurger> purger, fs::path dataDir);
+
+    Trash(const Trash&) = delete;
+    Trash& operator=(const Trash&) = delete;
+
+    bool MoveToTrash(const fs::path& target, std::string& outErr);
+    bool UndoLast(TrashEntry& outRestored, std::string& outErr);
+    std::optional<TrashEntry> Last() const;
+
+private:
+    fs::path TrashDirectoryFor(const fs::path& target) const;
+    bool IsTrashPath(const fs::path& p) const;
+    bool AppendLocked(char op, const TrashEntry& entry);
+    void Replay();
+    void PurgeLocked(const TrashEntry& entry);
+
+    std::shared_ptr<FsBackend> m_backend;
+    std::shared_ptr<BackgroundPurger> m_purger;
+    fs::path m_dataDir;
+    fs::path m_journal;
+
+    mutable std::mutex m_mutex;
+    std::vector<TrashEntry> m_live;     // oldest first; the back is undone first
+    unsigned m_counter = 0;
+};
+
+#endif // TRASH_H
@@ -0,0 +1,1207 @@
+/*
+Parneet Baidwan - 251259638
+Description: The tree snapshot export and reader in this file store a directory tree column by column. Every walker thread encodes the entries it finds into its own block (parent directory numbers, kinds, front-coded names, varint sizes and delta-encoded modification times, each column optionally zstd-compressed) and appends the block to the file when it is full, so the export runs at the speed of the parallel walk with memory bounded by one block per thread. The reader maps the file, builds a small index of which entry runs belong to which directory from the parent columns alone, in parallel across blocks, and decodes the remaining columns of a block only when a directory in it is listed.
+February 1, 2026
+*/
+
+#include "TreeSnapshot.h"
+#include "ThreadUtil.h"
+#include "TreeWalker.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <list>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef FM_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FM_HAVE_POSIX_IO 1
+#endif
+
+/*
+File layout (integers little-endian):
+
+  header    "FMSNAP01", u32 version, u32 flags
+  blocks    u32 entries, u32 raw size and u32 stored size of every column, the columns
+  footer    u32 root length, root path (UTF-8), i64 creation time, u64 entries,
+            u64 directories, u32 blocks, u64 offset of every block
+  trailer   u64 footer offset, "FMSNAP01"
+
+Directories are numbered 1, 2, ... by the walk; the root is 0. Columns of a block, one value
+per entry unless noted:
+
+  parent    zigzag varint of the change in the parent's number (siblings cost one byte)
+  kind      one byte: file, directory, link or other
+  dirId     directories only: zigzag varint of the change in the directory's own number
+  name      varint bytes shared with the previous name, varint suffix length, suffix
+  size      varint
+  mtime     zigzag varint of the change in the modification time
+
+The running values start from zero in every block, so blocks decode independently. A column
+whose stored size differs from its raw size is zstd-compressed.
+*/
+
+namespace
+{
+    constexpr char kMagic[8] = { 'F', 'M', 'S', 'N', 'A', 'P', '0', '1' };
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::uint32_t kFlagCompressed = 1;
+    constexpr std::size_t kHeaderSize = 16;
+    constexpr std::size_t kTrailerSize = 16;
+    // Entries per block; bounds the export's memory per walker thread
+    constexpr std::uint32_t kBlockEntries = 65536;
+    // Bounds a reader applies to a block's decoded columns: no varint is longer than 10 bytes
+    // and no name longer than PATH_MAX
+    constexpr std::uint64_t kMaxVarintBytes = 10;
+    constexpr std::uint64_t kMaxNameBytes = 4096;
+    constexpr int kZstdLevel = 3;
+    // Progress is published in steps of this many entries, not per entry
+    constexpr std::uint32_t kProgressStep = 1024;
+    // Decoded blocks and resolved directory paths the reader keeps
+    constexpr std::size_t kCachedBlocks = 16;
+    constexpr std::size_t kMaxCachedPaths = 4096;
+
+    enum Column { ColParent, ColKind, ColDirId, ColName, ColSize, ColMtime, kColumnCount };
+
+    enum Kind : std::uint8_t { KindFile, KindDir, KindLink, KindOther };
+
+    void PutU32(std::string& out, std::uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i) out.push_back((char)(v >> (8 * i)));
+    }
+
+    void PutU64(std::string& out, std::uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i) out.push_back((char)(v >> (8 * i)));
+    }
+
+    void PutVarint(std::string& out, std::uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back((char)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((char)v);
+    }
+
+    std::uint64_t Zigzag(std::int64_t v) { return ((std::uint64_t)v << 1) ^ (std::uint64_t)(v >> 63); }
+    std::int64_t Unzigzag(std::uint64_t v) { return (std::int64_t)(v >> 1) ^ -(std::int64_t)(v & 1); }
+
+    // Bounds-checked reader over a byte range; every read fails past the end
+    class ByteReader
+    {
+    public:
+        ByteReader(const unsigned char* data, std::size_t size) : m_data(data), m_size(size) {}
+
+        bool Varint(std::uint64_t& out)
+        {
+            std::uint64_t v = 0;
+            for (int shift = 0; shift < 64 && m_pos < m_size; shift += 7)
+            {
+                const unsigned char b = m_data[m_pos++];
+                v |= (std::uint64_t)(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                {
+                    out = v;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool U32(std::uint32_t& out)
+        {
+            if (m_size - m_pos < 4) return false;
+            out = 0;
+            for (int i = 0; i < 4; ++i) out |= (std::uint32_t)m_data[m_pos++] << (8 * i);
+            return true;
+        }
+
+        bool U64(std::uint64_t& out)
+        {
+            if (m_size - m_pos < 8) return false;
+            out = 0;
+            for (int i = 0; i < 8; ++i) out |= (std::uint64_t)m_data[m_pos++] << (8 * i);
+            return true;
+        }
+
+        bool Bytes(std::size_t n, const unsigned char*& out)
+        {
+            if (m_size - m_pos < n) return false;
+            out = m_data + m_pos;
+            m_pos += n;
+            return true;
+        }
+
+    private:
+        const unsigned char* m_data;
+        std::size_t m_size;
+        std::size_t m_pos = 0;
+    };
+
+    /*
+    Function: EntryName
+    Description: Returns the last component of a walked path without building a new path.
+    Parameters:
+      - p: Path of the entry.
+      - scratch: Storage for the name where the native form is not UTF-8.
+    Returns:
+      - std::string_view: UTF-8 name, valid while p and scratch are.
+    */
+    std::string_view EntryName(const fs::path& p, std::string& scratch)
+    {
+#ifdef FM_HAVE_POSIX_IO
+        (void)scratch;
+        const std::string& native = p.native();
+        const std::size_t slash = native.rfind('/');
+        return slash == std::string::npos ? std::string_view(native) : std::string_view(native).substr(slash + 1);
+#else
+        scratch = p.filename().u8string();
+        return scratch;
+#endif
+    }
+
+    // ---------------------------------------------------------------- export
+
+    // Columns of the block one walker thread is filling
+    struct BlockBuilder
+    {
+        std::string columns[kColumnCount];
+        std::string packed[kColumnCount];      // compressed columns while sealing
+        std::string block;                      // the sealed block
+        std::string prevName;
+        std::string nameScratch;
+        std::uint32_t entries = 0;
+        std::uint64_t prevParent = 0;
+        std::uint64_t prevDirId = 0;
+        std::int64_t prevMtime = 0;
+    };
+
+    // Appends the blocks of all walker threads to one snapshot file
+    class SnapshotWriter
+    {
+    public:
+        SnapshotWriter(std::FILE* out, unsigned workers, bool compress, SnapshotProgress* progress)
+            : m_out(out), m_compress(compress), m_progress(progress), m_builders(workers)
+        {
+        }
+
+        bool Start();
+        void Add(const WalkEntry& entry);
+        bool Finish(const fs::path& root, std::string& outErr);
+        bool Failed() const { return m_failed.load(std::memory_order_relaxed); }
+        std::uint64_t Directories() const { return m_lastDirId.load(); }
+        std::uint64_t Entries() const { return m_entries.load(); }
+
+    private:
+        void Seal(BlockBuilder& b);
+        void WriteLocked(const std::string& bytes);
+
+        std::FILE* m_out;
+        bool m_compress;
+        SnapshotProgress* m_progress;
+        std::vector<BlockBuilder> m_builders;   // one per walker thread
+
+        std::mutex m_fileMutex;
+        std::uint64_t m_offset = 0;                 // guarded by m_fileMutex
+        std::vector<std::uint64_t> m_blockOffsets;  // guarded by m_fileMutex
+        std::string m_error;                        // guarded by m_fileMutex
+        std::atomic<bool> m_failed{ false };
+        std::atomic<std::uint64_t> m_entries{ 0 };
+        std::atomic<std::uint64_t> m_lastDirId{ 0 };
+    };
+
+    /*
+    Function: SnapshotWriter::Start
+    Description: Writes the file header.
+    Parameters:
+      - None
+    Returns:
+      - bool: true if it was written; false otherwise.
+    */
+    bool SnapshotWriter::Start()
+    {
+        std::string header(kMagic, sizeof(kMagic));
+        PutU32(header, kVersion);
+        PutU32(header, m_compress ? kFlagCompressed : 0);
+
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        WriteLocked(header);
+        return !Failed();
+    }
+
+    /*
+    Function: SnapshotWriter::Add
+    Description: Encodes one entry into the block of the walker thread that found it and
+                 seals the block once it is full. Called concurrently from the walker threads,
+                 each on its own block.
+    Parameters:
+      - entry: Entry found by the walk.
+    Returns:
+      - None
+    */
+    void SnapshotWriter::Add(const WalkEntry& entry)
+    {
+        if (Failed()) return;
+        BlockBuilder& b = m_builders[entry.worker];
+
+        PutVarint(b.columns[ColParent], Zigzag((std::int64_t)(entry.parentId - b.prevParent)));
+        b.prevParent = entry.parentId;
+
+        Kind kind = KindOther;
+        switch (entry.type)
+        {
+        case FsEntryType::File:      kind = KindFile; break;
+        case FsEntryType::Directory: kind = KindDir; break;
+        case FsEntryType::Symlink:   kind = KindLink; break;
+        default:                     break;
+        }
+        b.columns[ColKind].push_back((char)kind);
+
+        if (kind == KindDir)
+        {
+            PutVarint(b.columns[ColDirId], Zigzag((std::int64_t)(entry.dirId - b.prevDirId)));
+            b.prevDirId = entry.dirId;
+
+            std::uint64_t last = m_lastDirId.load(std::memory_order_relaxed);
+            while (entry.dirId > last && !m_lastDirId.compare_exchange_weak(last, entry.dirId)) {}
+        }
+
+        // front coding: siblings sorted or not, names in one directory share long prefixes
+        const std::string_view name = EntryName(entry.path, b.nameScratch);
+        std::size_t shared = 0;
+        const std::size_t limit = std::min(name.size(), b.prevName.size());
+        while (shared < limit && name[shared] == b.prevName[shared]) ++shared;
+        PutVarint(b.columns[ColName], shared);
+        PutVarint(b.columns[ColName], name.size() - shared);
+        b.columns[ColName].append(name.data() + shared, name.size() - shared);
+        b.prevName.assign(name.data(), name.size());
+
+        PutVarint(b.columns[ColSize], entry.sizeBytes);
+        PutVarint(b.columns[ColMtime], Zigzag((std::int64_t)entry.modified - b.prevMtime));
+        b.prevMtime = (std::int64_t)entry.modified;
+
+        ++b.entries;
+        if (b.entries % kProgressStep == 0)
+        {
+            m_entries += kProgressStep;
+            if (m_progress) m_progress->entries += kProgressStep;
+        }
+        if (b.entries == kBlockEntries) Seal(b);
+    }
+
+    /*
+    Function: SnapshotWriter::Seal
+    Description: Compresses the columns of a block (on the calling walker thread, so blocks
+                 are compressed in parallel), appends the block to the file and starts an
+                 empty one. A column is kept uncompressed when compression does not shrink it.
+    Parameters:
+      - b: Block to seal; must hold at least one entry.
+    Returns:
+      - None
+    */
+    void SnapshotWriter::Seal(BlockBuilder& b)
+    {
+        const std::uint32_t rest = b.entries % kProgressStep;
+        m_entries += rest;
+        if (m_progress) m_progress->entries += rest;
+
+        bool packed[kColumnCount] = {};
+#ifdef FM_HAVE_ZSTD
+        if (m_compress)
+        {
+            for (int c = 0; c < kColumnCount; ++c)
+            {
+                const std::string& raw = b.columns[c];
+                if (raw.empty()) continue;
+
+                b.packed[c].resize(ZSTD_compressBound(raw.size()));
+                const std::size_t n = ZSTD_compress(&b.packed[c][0], b.packed[c].size(), raw.data(), raw.size(), kZstdLevel);
+                if (ZSTD_isError(n) || n >= raw.size()) continue;
+                b.packed[c].resize(n);
+                packed[c] = true;
+            }
+        }
+#endif
+
+        b.block.clear();
+        PutU32(b.block, b.entries);
+        for (int c = 0; c < kColumnCount; ++c)
+        {
+            PutU32(b.block, (std::uint32_t)b.columns[c].size());
+            PutU32(b.block, (std::uint32_t)(packed[c] ? b.packed[c].size() : b.columns[c].size()));
+        }
+        for (int c = 0; c < kColumnCount; ++c)
+            b.block += packed[c] ? b.packed[c] : b.columns[c];
+
+        {
+            std::lock_guard<std::mutex> lock(m_fileMutex);
+            m_blockOffsets.push_back(m_offset);
+            WriteLocked(b.block);
+        }
+        if (m_progress) m_progress->bytesWritten += b.block.size();
+
+        for (std::string& column : b.columns) column.clear();
+        b.prevName.clear();
+        b.entries = 0;
+        b.prevParent = 0;
+        b.prevDirId = 0;
+        b.prevMtime = 0;
+    }
+
+    /*
+    Function: SnapshotWriter::WriteLocked
+    Description: Appends bytes to the file; the first failure is remembered and stops the
+                 export. The caller holds m_fileMutex.
+    Parameters:
+      - bytes: Data to append.
+    Returns:
+      - None
+    */
+    void SnapshotWriter::WriteLocked(const std::string& bytes)
+    {
+        if (Failed()) return;
+        if (std::fwrite(bytes.data(), 1, bytes.size(), m_out) != bytes.size())
+        {
+            m_error = std::string("Cannot write the snapshot: ") + std::strerror(errno);
+            m_failed = true;
+            return;
+        }
+        m_offset += bytes.size();
+    }
+
+    /*
+    Function: SnapshotWriter::Finish
+    Description: Seals the partly filled blocks once the walk is over and writes the footer
+                 with the block offsets and the trailer pointing at it.
+    Parameters:
+      - root: Directory the snapshot was taken of.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the whole file was written; false otherwise.
+    */
+    bool SnapshotWriter::Finish(const fs::path& root, std::string& outErr)
+    {
+        for (BlockBuilder& b : m_builders)
+        {
+            if (b.entries > 0) Seal(b);
+        }
+
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        const std::string rootName = root.u8string();
+        const std::uint64_t footerOffset = m_offset;
+
+        std::string footer;
+        PutU32(footer, (std::uint32_t)rootName.size());
+        footer += rootName;
+        PutU64(footer, (std::uint64_t)(std::int64_t)std::time(nullptr));
+        PutU64(footer, m_entries.load());
+        PutU64(footer, m_lastDirId.load());
+        PutU32(footer, (std::uint32_t)m_blockOffsets.size());
+        for (std::uint64_t offset : m_blockOffsets) PutU64(footer, offset);
+        PutU64(footer, footerOffset);
+        footer.append(kMagic, sizeof(kMagic));
+        WriteLocked(footer);
+
+        if (Failed()) outErr = m_error;
+        return !Failed();
+    }
+
+    // ---------------------------------------------------------------- reader
+
+    // Read-only view of a whole file, mapped where the platform allows it
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile()
+        {
+#ifdef FM_HAVE_POSIX_IO
+            if (m_map) ::munmap(m_map, m_size);
+#endif
+        }
+
+        bool Open(const fs::path& p, std::string& outErr)
+        {
+#ifdef FM_HAVE_POSIX_IO
+            const int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                outErr = "Cannot open " + p.string() + ": " + std::strerror(errno);
+                return false;
+            }
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+            {
+                outErr = "Not a tree snapshot: " + p.string();
+                ::close(fd);
+                return false;
+            }
+            m_size = (std::size_t)st.st_size;
+            void* map = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (map == MAP_FAILED)
+            {
+                outErr = "Cannot map " + p.string() + ": " + std::strerror(errno);
+                m_size = 0;
+                return false;
+            }
+            m_map = map;
+            m_data = static_cast<const unsigned char*>(map);
+            return true;
+#else
+            std::FILE* f = std::fopen(p.string().c_str(), "rb");
+            if (!f)
+            {
+                outErr = "Cannot open " + p.string();
+                return false;
+            }
+            std::error_code ec;
+            m_copy.resize((std::size_t)fs::file_size(p, ec));
+            const bool ok = !ec && std::fread(m_copy.data(), 1, m_copy.size(), f) == m_copy.size();
+            std::fclose(f);
+            if (!ok)
+            {
+                outErr = "Cannot read " + p.string();
+                return false;
+            }
+            m_data = m_copy.data();
+            m_size = m_copy.size();
+            return true;
+#endif
+        }
+
+        const unsigned char* Data() const { return m_data; }
+        std::size_t Size() const { return m_size; }
+
+    private:
+#ifdef FM_HAVE_POSIX_IO
+        void* m_map = nullptr;
+#else
+        std::vector<unsigned char> m_copy;
+#endif
+        const unsigned char* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    // Columns of one block, pointing into the mapping or, once decompressed, into scratch
+    struct BlockColumns
+    {
+        std::uint32_t entries = 0;
+        const unsigned char* data[kColumnCount] = {};
+        std::size_t size[kColumnCount] = {};
+        std::string scratch[kColumnCount];
+    };
+
+    // Fully decoded block, kept while directories in it are browsed
+    struct DecodedBlock
+    {
+        std::vector<std::uint8_t> kinds;
+        std::vector<std::uint64_t> dirIds;      // 0 for entries that are not directories
+        std::vector<std::uint64_t> sizes;
+        std::vector<std::int64_t> mtimes;
+        std::vector<std::uint32_t> nameEnds;    // end of every name in names
+        std::string names;
+
+        std::string_view Name(std::uint32_t i) const
+        {
+            const std::uint32_t start = i ? nameEnds[i - 1] : 0;
+            return std::string_view(names).substr(start, nameEnds[i] - start);
+        }
+    };
+
+    // Entries of one directory that sit next to each other in one block
+    struct Run
+    {
+        std::uint64_t parent;
+        std::uint32_t block;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    // Position of an entry
+    struct EntryRef
+    {
+        std::uint32_t block = 0;
+        std::uint32_t index = 0;
+    };
+
+    // An entry found by path
+    struct Found
+    {
+        std::shared_ptr<const DecodedBlock> block;      // null for the root
+        std::uint32_t index = 0;
+        std::uint64_t dirId = 0;                        // the directory's number, if it is one
+        bool isDir = true;
+    };
+
+    // Snapshot file served as a read-only volume
+    class SnapshotVolume final : public VfsProvider
+    {
+    public:
+        bool Open(const fs::path& file, std::string& outErr);
+
+        bool Stat(const fs::path& inner, FileItem& outItem) const override;
+        bool List(const fs::path& mountedAt,
+                  const fs::path& inner,
+                  std::vector<FileItem>& outItems,
+                  std::string& outErr) const override;
+        bool Extract(const fs::path& inner,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     PasteStats& outStats,
+                     std::string& outErr) const override;
+
+    private:
+        bool ReadBlock(std::uint32_t index, std::initializer_list<Column> wanted, BlockColumns& out) const;
+        bool IndexBlock(std::uint32_t index, std::vector<Run>& outRuns);
+        std::shared_ptr<const DecodedBlock> Block(std::uint32_t index) const;
+        bool FindChild(std::uint64_t parent, std::string_view name, Found& out) const;
+        bool Find(const fs::path& inner, Found& out) const;
+
+        MappedFile m_file;
+        std::uint64_t m_footerOffset = 0;
+        std::time_t m_created = 0;
+        std::vector<std::uint64_t> m_blockOffsets;
+        std::vector<Run> m_runs;                // sorted by parent
+        std::vector<EntryRef> m_dirs;           // by directory number; [0] is the root
+
+        mutable std::mutex m_cacheMutex;
+        mutable std::list<std::pair<std::uint32_t, std::shared_ptr<const DecodedBlock>>> m_blocks;
+        mutable std::unordered_map<std::string, std::uint64_t> m_dirByPath;
+    };
+
+    /*
+    Function: SnapshotVolume::Open
+    Description: Maps a snapshot, checks its header, trailer and footer, and indexes it: the
+                 parent, kind and directory number columns of every block are decoded in
+                 parallel into the runs of entries each directory has and the position of every
+                 directory entry. Names, sizes and times are left in the file until listed.
+                 The footer's counts are checked against the blocks before anything is sized
+                 from them.
+    Parameters:
+      - file: Snapshot file.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the snapshot can be browsed; false otherwise.
+    */
+    bool SnapshotVolume::Open(const fs::path& file, std::string& outErr)
+    {
+        if (!m_file.Open(file, outErr)) return false;
+
+        const std::string corrupt = "Not a tree snapshot, or a damaged one: " + file.string();
+        const unsigned char* data = m_file.Data();
+        const std::size_t size = m_file.Size();
+        if (size < kHeaderSize + kTrailerSize
+            || std::memcmp(data, kMagic, sizeof(kMagic)) != 0
+            || std::memcmp(data + size - sizeof(kMagic), kMagic, sizeof(kMagic)) != 0)
+        {
+            outErr = corrupt;
+            return false;
+        }
+
+        ByteReader header(data + sizeof(kMagic), kHeaderSize - sizeof(kMagic));
+        std::uint32_t version = 0;
+        std::uint32_t flags = 0;
+        header.U32(version);
+        header.U32(flags);
+        if (version != kVersion)
+        {
+            outErr = "Unsupported tree snapshot version " + std::to_string(version) + ": " + file.string();
+            return false;
+        }
+#ifndef FM_HAVE_ZSTD
+        if (flags & kFlagCompressed)
+        {
+            outErr = "This snapshot is compressed, and this build was made without zstd: " + file.string();
+            return false;
+        }
+#endif
+
+        ByteReader trailer(data + size - kTrailerSize, 8);
+        trailer.U64(m_footerOffset);
+        if (m_footerOffset < kHeaderSize || m_footerOffset > size - kTrailerSize)
+        {
+            outErr = corrupt;
+            return false;
+        }
+
+        ByteReader footer(data + m_footerOffset, size - kTrailerSize - m_footerOffset);
+        std::uint32_t rootLen = 0;
+        const unsigned char* root = nullptr;
+        std::uint64_t created = 0;
+        std::uint64_t entries = 0;
+        std::uint64_t directories = 0;
+        std::uint32_t blocks = 0;
+        if (!footer.U32(rootLen) || !footer.Bytes(rootLen, root) || !footer.U64(created)
+            || !footer.U64(entries) || !footer.U64(directories) || !footer.U32(blocks)
+            || directories > entries || entries > (std::uint64_t)blocks * kBlockEntries
+            || (std::uint64_t)blocks * 8 > m_footerOffset)
+        {
+            outErr = corrupt;
+            return false;
+        }
+        m_created = (std::time_t)(std::int64_t)created;
+
+        m_blockOffsets.resize(blocks);
+        std::uint64_t next = kHeaderSize;      // blocks are stored in ascending order
+        for (std::uint64_t& offset : m_blockOffsets)
+        {
+            if (!footer.U64(offset) || offset < next || offset >= m_footerOffset)
+            {
+                outErr = corrupt;
+                return false;
+            }
+            next = offset + 1;
+        }
+
+        // the blocks' own entry counts must add up to the footer's, so the directory table
+        // below is sized from counts the blocks back up
+        std::uint64_t blockEntries = 0;
+        for (std::size_t i = 0; i < m_blockOffsets.size(); ++i)
+        {
+            const std::uint64_t end = i + 1 < m_blockOffsets.size() ? m_blockOffsets[i + 1] : m_footerOffset;
+            ByteReader block(data + m_blockOffsets[i], (std::size_t)(end - m_blockOffsets[i]));
+            std::uint32_t count = 0;
+            if (!block.U32(count) || count == 0 || count > kBlockEntries)
+            {
+                outErr = corrupt;
+                return false;
+            }
+            blockEntries += count;
+        }
+        if (blockEntries != entries)
+        {
+            outErr = corrupt;
+            return false;
+        }
+
+        try
+        {
+            m_dirs.assign((std::size_t)directories + 1, EntryRef{});
+        }
+        catch (const std::bad_alloc&)
+        {
+            outErr = "Not enough memory to open " + file.string();
+            return false;
+        }
+        std::vector<std::vector<Run>> runs(blocks);
+        std::atomic<bool> damaged{ false };
+        ParallelFor(blocks, DefaultWorkerCount(), [&](std::size_t i)
+        {
+            if (!damaged && !IndexBlock((std::uint32_t)i, runs[i])) damaged = true;
+        });
+        if (damaged)
+        {
+            outErr = corrupt;
+            return false;
+        }
+
+        std::size_t total = 0;
+        for (const auto& r : runs) total += r.size();
+        m_runs.reserve(total);
+        for (auto& r : runs) m_runs.insert(m_runs.end(), r.begin(), r.end());
+        std::stable_sort(m_runs.begin(), m_runs.end(), [](const Run& a, const Run& b) { return a.parent < b.parent; });
+        return true;
+    }
+
+    /*
+    Function: SnapshotVolume::ReadBlock
+    Description: Locates the columns of a block and decompresses the ones asked for.
+    Parameters:
+      - index: Block number.
+      - wanted: Columns to make readable.
+      - out: Output columns.
+    Returns:
+      - bool: true if the block is intact; false otherwise.
+    */
+    bool SnapshotVolume::ReadBlock(std::uint32_t index, std::initializer_list<Column> wanted, BlockColumns& out) const
+    {
+        const std::uint64_t begin = m_blockOffsets[index];
+        const std::uint64_t end = index + 1 < m_blockOffsets.size() ? m_blockOffsets[index + 1] : m_footerOffset;
+        ByteReader reader(m_file.Data() + begin, (std::size_t)(end - begin));
+
+        std::uint32_t raw[kColumnCount] = {};
+        std::uint32_t stored[kColumnCount] = {};
+        if (!reader.U32(out.entries) || out.entries == 0 || out.entries > kBlockEntries) return false;
+        for (int c = 0; c < kColumnCount; ++c)
+        {
+            if (!reader.U32(raw[c]) || !reader.U32(stored[c])) return false;
+
+            // a column cannot decode to more than its entries can take up
+            const std::uint64_t perEntry = c == ColKind ? 1
+                                         : c == ColName ? 2 * kMaxVarintBytes + kMaxNameBytes
+                                                        : kMaxVarintBytes;
+            if (raw[c] > perEntry * out.entries) return false;
+        }
+
+        const unsigned char* payload[kColumnCount] = {};
+        for (int c = 0; c < kColumnCount; ++c)
+        {
+            if (!reader.Bytes(stored[c], payload[c])) return false;
+        }
+
+        for (Column c : wanted)
+        {
+            out.size[c] = raw[c];
+            if (stored[c] == raw[c])
+            {
+                out.data[c] = payload[c];
+                continue;
+            }
+#ifdef FM_HAVE_ZSTD
+            out.scratch[c].resize(raw[c]);
+            const std::size_t n = ZSTD_decompress(&out.scratch[c][0], raw[c], payload[c], stored[c]);
+            if (ZSTD_isError(n) || n != raw[c]) return false;
+            out.data[c] = reinterpret_cast<const unsigned char*>(out.scratch[c].data());
+#else
+            return false;
+#endif
+        }
+        return true;
+    }
+
+    /*
+    Function: SnapshotVolume::IndexBlock
+    Description: Reads the parent, kind and directory number columns of one block, records
+                 where every directory entry sits and splits the block into runs of siblings.
+                 Blocks are indexed in parallel; each writes only its own directories' slots.
+    Parameters:
+      - index: Block number.
+      - outRuns: Output runs of the block, in block order.
+    Returns:
+      - bool: true if the block is intact; false otherwise.
+    */
+    bool SnapshotVolume::IndexBlock(std::uint32_t index, std::vector<Run>& outRuns)
+    {
+        BlockColumns cols;
+        if (!ReadBlock(index, { ColParent, ColKind, ColDirId }, cols)) return false;
+        if (cols.size[ColKind] != cols.entries) return false;
+
+        ByteReader parents(cols.data[ColParent], cols.size[ColParent]);
+        ByteReader dirIds(cols.data[ColDirId], cols.size[ColDirId]);
+        const std::uint64_t lastDir = m_dirs.size() - 1;
+        std::uint64_t parent = 0;
+        std::uint64_t dirId = 0;
+
+        for (std::uint32_t e = 0; e < cols.entries; ++e)
+        {
+            std::uint64_t delta = 0;
+            if (!parents.Varint(delta)) return false;
+            parent += (std::uint64_t)Unzigzag(delta);
+            if (parent > lastDir) return false;
+
+            if (outRuns.empty() || outRuns.back().parent != parent)
+                outRuns.push_back(Run{ parent, index, e, 0 });
+            ++outRuns.back().count;
+
+            if (cols.data[ColKind][e] == KindDir)
+            {
+                if (!dirIds.Varint(delta)) return false;
+                dirId += (std::uint64_t)Unzigzag(delta);
+                if (dirId == 0 || dirId > lastDir) return false;
+                m_dirs[dirId] = EntryRef{ index, e };
+            }
+        }
+        return true;
+    }
+
+    /*
+    Function: SnapshotVolume::Block
+    Description: Returns a block with every column decoded, from a small cache of the most
+                 recently browsed blocks. Decoding happens outside the cache lock.
+    Parameters:
+      - index: Block number.
+    Returns:
+      - std::shared_ptr<const DecodedBlock>: Decoded block, or nullptr if it is damaged.
+    */
+    std::shared_ptr<const DecodedBlock> SnapshotVolume::Block(std::uint32_t index) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+            {
+                if (it->first != index) continue;
+                m_blocks.splice(m_blocks.begin(), m_blocks, it);
+                return it->second;
+            }
+        }
+
+        BlockColumns cols;
+        if (!ReadBlock(index, { ColKind, ColDirId, ColName, ColSize, ColMtime }, cols)) return nullptr;
+        if (cols.size[ColKind] != cols.entries) return nullptr;
+
+        auto block = std::make_shared<DecodedBlock>();
+        block->kinds.assign(cols.data[ColKind], cols.data[ColKind] + cols.entries);
+        block->dirIds.assign(cols.entries, 0);
+        block->sizes.resize(cols.entries);
+        block->mtimes.resize(cols.entries);
+        block->nameEnds.resize(cols.entries);
+        block->names.reserve(cols.size[ColName]);
+
+        ByteReader dirIds(cols.data[ColDirId], cols.size[ColDirId]);
+        ByteReader names(cols.data[ColName], cols.size[ColName]);
+        ByteReader sizes(cols.data[ColSize], cols.size[ColSize]);
+        ByteReader mtimes(cols.data[ColMtime], cols.size[ColMtime]);
+        std::uint64_t dirId = 0;
+        std::int64_t mtime = 0;
+        std::size_t prevStart = 0;
+        std::size_t prevLen = 0;
+
+        for (std::uint32_t e = 0; e < cols.entries; ++e)
+        {
+            std::uint64_t v = 0;
+            if (block->kinds[e] == KindDir)
+            {
+                if (!dirIds.Varint(v)) return nullptr;
+                dirId += (std::uint64_t)Unzigzag(v);
+                block->dirIds[e] = dirId;
+            }
+
+            std::uint64_t shared = 0;
+            std::uint64_t suffixLen = 0;
+            const unsigned char* suffix = nullptr;
+            if (!names.Varint(shared) || !names.Varint(suffixLen) || shared > prevLen
+                || !names.Bytes((std::size_t)suffixLen, suffix))
+                return nullptr;
+            const std::size_t start = block->names.size();
+            block->names.append(block->names, prevStart, (std::size_t)shared);
+            block->names.append(reinterpret_cast<const char*>(suffix), (std::size_t)suffixLen);
+            block->nameEnds[e] = (std::uint32_t)block->names.size();
+            prevStart = start;
+            prevLen = block->names.size() - start;
+
+            if (!sizes.Varint(block->sizes[e]) || !mtimes.Varint(v)) return nullptr;
+            mtime += Unzigzag(v);
+            block->mtimes[e] = mtime;
+        }
+
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_blocks.emplace_front(index, block);
+        if (m_blocks.size() > kCachedBlocks) m_blocks.pop_back();
+        return block;
+    }
+
+    /*
+    Function: SnapshotVolume::FindChild
+    Description: Looks for an entry by name among the children of a directory, scanning the
+                 directory's runs.
+    Parameters:
+      - parent: Number of the directory.
+      - name: Name to find.
+      - out: Output entry.
+    Returns:
+      - bool: true if the directory has an entry with that name; false otherwise.
+    */
+    bool SnapshotVolume::FindChild(std::uint64_t parent, std::string_view name, Found& out) const
+    {
+        auto run = std::lower_bound(m_runs.begin(), m_runs.end(), parent,
+                                    [](const Run& r, std::uint64_t p) { return r.parent < p; });
+        for (; run != m_runs.end() && run->parent == parent; ++run)
+        {
+            std::shared_ptr<const DecodedBlock> block = Block(run->block);
+            if (!block) return false;
+
+            for (std::uint32_t i = run->first; i < run->first + run->count; ++i)
+            {
+                if (block->Name(i) != name) continue;
+                out.isDir = block->kinds[i] == KindDir;
+                out.dirId = block->dirIds[i];
+                out.index = i;
+                out.block = std::move(block);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    Function: SnapshotVolume::Find
+    Description: Resolves a path inside the volume one component at a time from the root.
+                 Directories resolved before are remembered by path, so browsing deeper only
+                 resolves the new component.
+    Parameters:
+      - inner: Path inside the volume ("" for its root).
+      - out: Output entry.
+    Returns:
+      - bool: true if the path exists in the snapshot; false otherwise.
+    */
+    bool SnapshotVolume::Find(const fs::path& inner, Found& out) const
+    {
+        out = Found{};
+        std::string key;
+        for (const fs::path& part : inner)
+        {
+            const std::string name = part.u8string();
+            if (name.empty() || name == "." || name == "/") continue;
+            if (!out.isDir) return false;
+
+            const std::string parentKey = key;
+            key += '/';
+            key += name;
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                auto cached = m_dirByPath.find(key);
+                if (cached != m_dirByPath.end())
+                {
+                    out.dirId = cached->second;
+                    out.block = nullptr;
+                    continue;
+                }
+            }
+
+            if (!FindChild(out.dirId, name, out)) return false;
+            if (out.isDir)
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                if (m_dirByPath.size() >= kMaxCachedPaths) m_dirByPath.clear();
+                m_dirByPath.emplace(key, out.dirId);
+            }
+        }
+
+        // a directory taken from the path cache is looked up by its number
+        if (out.dirId != 0 && !out.block)
+        {
+            const EntryRef ref = m_dirs[out.dirId];
+            out.block = Block(ref.block);
+            out.index = ref.index;
+            if (!out.block) return false;
+        }
+        return true;
+    }
+
+    /*
+    Function: SnapshotVolume::Stat
+    Description: Looks up an entry of the snapshot; the root is reported as a directory with
+                 the time the snapshot was taken.
+    Parameters:
+      - inner: Path inside the volume.
+      - outItem: Output metadata (fullPath is left empty).
+    Returns:
+      - bool: true if the entry exists; false otherwise.
+    */
+    bool SnapshotVolume::Stat(const fs::path& inner, FileItem& outItem) const
+    {
+        outItem = FileItem{};
+        Found found;
+        if (!Find(inner, found)) return false;
+
+        outItem.isDir = found.isDir;
+        if (!found.block)
+        {
+            outItem.modified = m_created;
+            return true;
+        }
+        outItem.sizeBytes = found.isDir ? 0 : found.block->sizes[found.index];
+        outItem.modified = (std::time_t)found.block->mtimes[found.index];
+        return true;
+    }
+
+    /*
+    Function: SnapshotVolume::List
+    Description: Lists the entries recorded for a directory of the snapshot. Only the blocks
+                 holding its runs are decoded; the live filesystem is never touched.
+    Parameters:
+      - mountedAt: Path under which the directory is shown (snapshot path plus inner).
+      - inner: Directory inside the volume.
+      - outItems: Output listing.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if inner is a directory of the snapshot; false otherwise.
+    */
+    bool SnapshotVolume::List(const fs::path& mountedAt,
+                              const fs::path& inner,
+                              std::vector<FileItem>& outItems,
+                              std::string& outErr) const
+    {
+        outItems.clear();
+        Found found;
+        if (!Find(inner, found) || !found.isDir)
+        {
+            outErr = "Not a directory in the snapshot: " + inner.generic_string();
+            return false;
+        }
+
+        auto first = std::lower_bound(m_runs.begin(), m_runs.end(), found.dirId,
+                                      [](const Run& r, std::uint64_t p) { return r.parent < p; });
+        auto last = first;
+        std::size_t count = 0;
+        for (; last != m_runs.end() && last->parent == found.dirId; ++last) count += last->count;
+        outItems.reserve(count);
+
+        for (auto run = first; run != last; ++run)
+        {
+            std::shared_ptr<const DecodedBlock> block = Block(run->block);
+            if (!block)
+            {
+                outErr = "Damaged block in the snapshot";
+                outItems.clear();
+                return false;
+            }
+
+            for (std::uint32_t i = run->first; i < run->first + run->count; ++i)
+            {
+                const std::string_view name = block->Name(i);
+                FileItem item;
+                item.fullPath = mountedAt / fs::u8path(name.begin(), name.end());
+                item.isDir = block->kinds[i] == KindDir;
+                item.sizeBytes = item.isDir ? 0 : block->sizes[i];
+                item.modified = (std::time_t)block->mtimes[i];
+                outItems.push_back(std::move(item));
+            }
+        }
+        return true;
+    }
+
+    /*
+    Function: SnapshotVolume::Extract
+    Description: Snapshots hold names and metadata only, so nothing can be copied out of them.
+    Parameters:
+      - inner: Entry inside the volume.
+      - dst: Destination path.
+      - scheduler: Unused.
+      - outStats: Unused.
+      - outErr: Output string populated with the reason.
+    Returns:
+      - bool: Always false.
+    */
+    bool SnapshotVolume::Extract(const fs::path& inner,
+                                 const fs::path&,
+                                 IoScheduler&,
+                                 PasteStats&,
+                                 std::string& outErr) const
+    {
+        outErr = "A tree snapshot records names and metadata only; " + inner.generic_string() + " cannot be copied out of it.";
+        return false;
+    }
+}
+
+/*
+Function: WriteTreeSnapshot
+Description: Walks everything below root on the parallel tree walker and writes it as a tree
+             snapshot. Each walker thread encodes and compresses its own blocks, and blocks
+             are appended to the file as they fill, so memory use does not grow with the size
+             of the tree. The snapshot is written next to dst under a ".part" name and renamed
+             over dst once complete; a failed or cancelled export leaves dst untouched.
+             Directories that cannot be read appear as empty directories.
+Parameters:
+  - root: Directory to take the snapshot of.
+  - dst: Snapshot file to write.
+  - opts: Walk and compression options.
+  - progress: Optional live counters.
+  - outStats: Output totals.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - bool: true if the snapshot was written or the export was cancelled; false otherwise.
+*/
+bool WriteTreeSnapshot(const fs::path& root,
+                       const fs::path& dst,
+                       const SnapshotOptions& opts,
+                       SnapshotProgress* progress,
+                       SnapshotStats& outStats,
+                       std::string& outErr)
+{
+    outErr.clear();
+    outStats = SnapshotStats{};
+
+    fs::path part = dst;
+    part += ".part";
+    std::FILE* out = std::fopen(part.string().c_str(), "wb");
+    if (!out)
+    {
+        outErr = "Cannot create " + part.string() + ": " + std::strerror(errno);
+        return false;
+    }
+
+#ifdef FM_HAVE_ZSTD
+    const bool compress = opts.compress;
+#else
+    const bool compress = false;
+#endif
+
+    std::atomic<bool> stop{ false };
+    TreeWalkOptions walkOpts;
+    walkOpts.threads = TreeWalkThreads(root, opts.threads);
+    walkOpts.sameDevice = opts.sameDevice;
+    walkOpts.cancel = &stop;
+
+    SnapshotWriter writer(out, walkOpts.threads, compress, progress);
+    TreeWalkCallbacks callbacks;
+    callbacks.onEntry = [&](const WalkEntry& entry)
+    {
+        if ((opts.cancel && opts.cancel->load(std::memory_order_relaxed)) || writer.Failed())
+        {
+            stop = true;
+            return;
+        }
+        writer.Add(entry);
+    };
+
+    TreeWalkStats walkStats;
+    bool ok = writer.Start() && WalkTree(root, walkOpts, callbacks, walkStats, outErr);
+    const bool cancelled = ok && !writer.Failed() && opts.cancel && opts.cancel->load();
+    // Finish also reports a write failure that stopped the walk
+    if (!cancelled && (ok || writer.Failed())) ok = writer.Finish(root, outErr);
+
+    if (std::fclose(out) != 0 && ok)
+    {
+        outErr = std::string("Cannot write the snapshot: ") + std::strerror(errno);
+        ok = false;
+    }
+
+    std::error_code ec;
+    outStats.cancelled = ok && cancelled;
+    if (!ok || cancelled)
+    {
+        fs::remove(part, ec);
+        return ok;
+    }
+
+    fs::rename(part, dst, ec);
+    if (ec)
+    {
+        outErr = "Cannot move the snapshot into place at " + dst.string() + ": " + ec.message();
+        fs::remove(part, ec);
+        return false;
+    }
+
+    outStats.entries = writer.Entries();
+    outStats.directories = writer.Directories();
+    outStats.unreadable = walkStats.errors;
+    outStats.fileBytes = fs::file_size(dst, ec);
+    return true;
+}
+
+/*
+Function: OpenTreeSnapshot
+Description: Opens a snapshot file as a read-only virtual volume.
+Parameters:
+  - snapshot: Snapshot file.
+  - outErr: Output string populated with an error message on failure.
+Returns:
+  - std::shared_ptr<VfsProvider>: Provider of the volume, or nullptr on failure.
+*/
+std::shared_ptr<VfsProvider> OpenTreeSnapshot(const fs::path& snapshot, std::string& outErr)
+{
+    auto volume = std::make_shared<SnapshotVolume>();
+    if (!volume->Open(snapshot, outErr)) return nullptr;
+    return volume;
+}
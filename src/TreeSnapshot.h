@@ -0,0 +1,60 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the tree snapshot export and its reader. An export walks a directory tree in parallel and writes the name, type, size and modification time of every entry to one compact binary file meant for offline analysis; the reader maps such a file into memory and serves it to the file manager as a read-only virtual volume, so a snapshot of a whole disk can be browsed without touching the disk it was taken from.
+February 1, 2026
+*/
+
+#ifndef TREESNAPSHOT_H
+#define TREESNAPSHOT_H
+
+#include "VfsProvider.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// File name suffix of tree snapshots; files with it are browsed as virtual volumes
+inline constexpr const char* kSnapshotSuffix = ".fmsnap";
+
+// How a snapshot is taken
+struct SnapshotOptions
+{
+    unsigned threads = 0;           // walker threads; 0 = TreeWalkThreads default
+    bool sameDevice = false;        // stay on the root's filesystem
+    bool compress = true;           // zstd-compress the columns (needs a zstd build)
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+// Live counters an export updates while it runs; safe to poll from another thread
+struct SnapshotProgress
+{
+    std::atomic<std::uint64_t> entries{ 0 };
+    std::atomic<std::uint64_t> bytesWritten{ 0 };
+};
+
+// Totals of a finished export
+struct SnapshotStats
+{
+    std::uint64_t entries = 0;
+    std::uint64_t directories = 0;
+    std::uint64_t unreadable = 0;       // directories that could not be read and are left empty
+    std::uint64_t fileBytes = 0;        // snapshot file size
+    bool cancelled = false;
+};
+
+// Writes a snapshot of everything below root to dst; dst is only replaced on success
+bool WriteTreeSnapshot(const fs::path& root,
+                       const fs::path& dst,
+                       const SnapshotOptions& opts,
+                       SnapshotProgress* progress,
+                       SnapshotStats& outStats,
+                       std::string& outErr);
+
+// Opens a snapshot written by WriteTreeSnapshot as a read-only virtual volume
+std::shared_ptr<VfsProvider> OpenTreeSnapshot(const fs::path& snapshot, std::string& outErr);
+
+#endif // TREESNAPSHOT_H
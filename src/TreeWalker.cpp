@@ -0,0 +1,716 @@
+/*
+Parneet Baidwan - 251259638
+Description: The tree walker in this file visits a directory tree on a pool of threads. Every directory is one task; a thread pushes the subdirectories it finds onto its own queue and keeps working depth-first from the newest end, while idle threads steal from the oldest end of the other queues, which hands them the large subtrees near the top and keeps every core busy. Directories are opened with openat relative to their parent's still-open descriptor, entries are typed from the directory entry itself when no metadata is needed, and on network filesystems more threads are used because the walk is bound by round trips rather than by the CPU. Backends that are not the real filesystem are walked with the same scheduling through their listing calls.
+February 1, 2026
+*/
+
+#include "TreeWalker.h"
+#include "StdFsBackend.h"
+#include "ThreadUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/vfs.h>
+#elif defined(__APPLE__)
+#include <sys/mount.h>
+#include <sys/param.h>
+#endif
+#define FM_HAVE_POSIX_IO 1
+#endif
+
+namespace
+{
+    // Directories kept open so their children can be opened relative to them; beyond this
+    // children are opened by full path, which keeps the walk well inside the descriptor limit
+    constexpr int kMaxHeldDirs = 256;
+    // Upper bound on threads when the tree is on a network filesystem
+    constexpr unsigned kMaxRemoteThreads = 64;
+    // How long an idle thread sleeps before looking for work again
+    constexpr auto kIdleWait = std::chrono::milliseconds(2);
+    // Independently locked parts of the set of visited directories
+    constexpr std::size_t kVisitedShards = 16;
+
+#ifdef FM_HAVE_POSIX_IO
+    // An open directory whose children are opened relative to it; closed with its last user
+    struct HeldDir
+    {
+        HeldDir(DIR* d, std::atomic<int>& count) : dir(d), held(count) { ++held; }
+        ~HeldDir()
+        {
+            ::closedir(dir);
+            --held;
+        }
+
+        HeldDir(const HeldDir&) = delete;
+        HeldDir& operator=(const HeldDir&) = delete;
+
+        DIR* dir;
+        std::atomic<int>& held;
+    };
+#endif
+
+    // One directory to read
+    struct DirTask
+    {
+        fs::path path;
+        unsigned depth = 0;
+        std::uint64_t id = 0;               // dirId of the directory; 0 for the root
+#ifdef FM_HAVE_POSIX_IO
+        std::shared_ptr<HeldDir> parent;    // null: open by full path
+#endif
+    };
+
+    // Identity of a directory for loop detection
+    struct DirId
+    {
+        std::uint64_t device;
+        std::uint64_t inode;
+
+        bool operator==(const DirId& o) const { return device == o.device && inode == o.inode; }
+    };
+
+    struct DirIdHash
+    {
+        std::size_t operator()(const DirId& id) const
+        {
+            return (std::size_t)(id.inode * 0x9E3779B97F4A7C15ull ^ id.device);
+        }
+    };
+
+    // One part of the visited set
+    struct VisitedShard
+    {
+        std::mutex mutex;
+        std::unordered_set<DirId, DirIdHash> ids;
+        std::unordered_set<std::string> paths;      // backends without inode numbers
+    };
+
+    // Per-thread task queue; the owner works at the back, thieves take from the front
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<DirTask> tasks;
+    };
+
+    /*
+    Class: Walk
+    Description: State shared by the threads of one WalkTree call: the per-thread queues, the
+                 count of tasks not yet finished (the walk ends when it reaches zero), the
+                 visited directories and the running totals.
+    */
+    class Walk
+    {
+    public:
+        Walk(const TreeWalkOptions& opts, const TreeWalkCallbacks& callbacks, const FsBackend* backend, unsigned threads)
+            : m_opts(opts), m_callbacks(callbacks), m_backend(backend), m_queues(threads)
+        {
+            for (auto& q : m_queues) q = std::make_unique<WorkerQueue>();
+        }
+
+        void Run(const fs::path& root, std::uint64_t rootDevice, std::uint64_t rootInode);
+        void Totals(TreeWalkStats& out) const;
+
+    private:
+        void Worker(unsigned worker);
+        void Push(unsigned worker, DirTask task);
+        bool Take(unsigned worker, DirTask& out);
+        void ReadBackend(unsigned worker, DirTask& task);
+#ifdef FM_HAVE_POSIX_IO
+        void ReadPosix(unsigned worker, DirTask& task);
+#endif
+        void Report(const WalkEntry& entry) const;
+        bool Enter(const WalkEntry& entry);
+        bool FirstVisit(const DirId& id);
+        bool FirstVisit(const std::string& canonical);
+        void Error(const fs::path& dir, const std::string& message);
+        bool Cancelled() const { return m_opts.cancel && m_opts.cancel->load(std::memory_order_relaxed); }
+
+        const TreeWalkOptions& m_opts;
+        const TreeWalkCallbacks& m_callbacks;
+        const FsBackend* m_backend;
+        std::uint64_t m_rootDevice = 0;
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::atomic<std::size_t> m_pending{ 0 };
+        std::mutex m_idleMutex;
+        std::condition_variable m_idleCv;
+
+        VisitedShard m_visited[kVisitedShards];
+        std::atomic<int> m_held{ 0 };
+
+        std::atomic<std::uint64_t> m_directories{ 0 };
+        std::atomic<std::uint64_t> m_entries{ 0 };
+        std::atomic<std::uint64_t> m_errors{ 0 };
+        std::atomic<std::uint64_t> m_loops{ 0 };
+        std::atomic<std::uint64_t> m_lastDirId{ 0 };
+    };
+
+    /*
+    Function: Walk::Run
+    Description: Queues the root and runs one worker per queue (the calling thread is one of
+                 them) until every task has finished or the walk is cancelled.
+    Parameters:
+      - root: Directory to walk.
+      - rootDevice: Device of the root, for sameDevice.
+      - rootInode: Inode of the root, so a link back to it is detected.
+    Returns:
+      - None
+    */
+    void Walk::Run(const fs::path& root, std::uint64_t rootDevice, std::uint64_t rootInode)
+    {
+        m_rootDevice = rootDevice;
+        if (m_opts.followSymlinks)
+        {
+            if (m_backend) FirstVisit(m_backend->Canonical(root).string());
+            else FirstVisit(DirId{ rootDevice, rootInode });
+        }
+
+        DirTask first;
+        first.path = root;
+        Push(0, std::move(first));
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < (unsigned)m_queues.size(); ++t)
+            pool.emplace_back([this, t]() { Worker(t); });
+        Worker(0);
+        for (auto& th : pool) th.join();
+
+        // tasks left behind by a cancelled walk
+        for (auto& q : m_queues) q->tasks.clear();
+    }
+
+    /*
+    Function: Walk::Totals
+    Description: Copies the running totals into the caller's statistics.
+    Parameters:
+      - out: Statistics to fill.
+    Returns:
+      - None
+    */
+    void Walk::Totals(TreeWalkStats& out) const
+    {
+        out.directories = m_directories;
+        out.entries = m_entries;
+        out.errors = m_errors;
+        out.loopsSkipped = m_loops;
+        out.threads = (unsigned)m_queues.size();
+        out.cancelled = Cancelled();
+    }
+
+    /*
+    Function: Walk::Worker
+    Description: Body of one walker thread: reads directories from its own queue or stolen
+                 from others, and sleeps briefly when there is nothing to take while other
+                 threads are still reading. Returns when no task is left anywhere.
+    Parameters:
+      - worker: Index of this thread's queue.
+    Returns:
+      - None
+    */
+    void Walk::Worker(unsigned worker)
+    {
+        DirTask task;
+        for (;;)
+        {
+            if (Cancelled()) return;
+
+            if (Take(worker, task))
+            {
+#ifdef FM_HAVE_POSIX_IO
+                if (!m_backend) ReadPosix(worker, task);
+                else
+#endif
+                ReadBackend(worker, task);
+
+                task = DirTask{};       // releases the parent directory
+                if (m_pending.fetch_sub(1) == 1) m_idleCv.notify_all();
+                continue;
+            }
+
+            if (m_pending.load() == 0) return;
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_idleCv.wait_for(lock, kIdleWait);
+        }
+    }
+
+    /*
+    Function: Walk::Push
+    Description: Adds a directory to the back of a thread's own queue and wakes an idle thread
+                 so it can steal it.
+    Parameters:
+      - worker: Queue to add to.
+      - task: Directory to read.
+    Returns:
+      - None
+    */
+    void Walk::Push(unsigned worker, DirTask task)
+    {
+        m_pending.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(m_queues[worker]->mutex);
+            m_queues[worker]->tasks.push_back(std::move(task));
+        }
+        m_idleCv.notify_one();
+    }
+
+    /*
+    Function: Walk::Take
+    Description: Takes the newest task of the thread's own queue (depth-first, so the parent
+                 descriptor is still warm), or else steals the oldest task of another queue,
+                 which is the closest to the root and so likely the largest subtree.
+    Parameters:
+      - worker: Index of the calling thread.
+      - out: Task taken.
+    Returns:
+      - bool: true if a task was taken; false if every queue is empty.
+    */
+    bool Walk::Take(unsigned worker, DirTask& out)
+    {
+        {
+            WorkerQueue& own = *m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                out = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        const std::size_t n = m_queues.size();
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            WorkerQueue& victim = *m_queues[(worker + i) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    Function: Walk::Report
+    Description: Passes an entry to onEntry unless the filter rejects it.
+    Parameters:
+      - entry: Entry found.
+    Returns:
+      - None
+    */
+    void Walk::Report(const WalkEntry& entry) const
+    {
+        if (!m_callbacks.onEntry) return;
+        if (m_callbacks.filter && !m_callbacks.filter(entry)) return;
+        m_callbacks.onEntry(entry);
+    }
+
+    /*
+    Function: Walk::Enter
+    Description: Decides whether a directory is read: the caller's descend hook may prune it,
+                 sameDevice keeps the walk on the root's filesystem, and when links are
+                 followed a directory already entered (a link loop or a second link to the
+                 same place) is skipped.
+    Parameters:
+      - entry: Directory found.
+    Returns:
+      - bool: true if the directory should be read; false otherwise.
+    */
+    bool Walk::Enter(const WalkEntry& entry)
+    {
+        if (m_callbacks.descend && !m_callbacks.descend(entry)) return false;
+        if (m_opts.sameDevice && !m_backend && entry.device != m_rootDevice) return false;
+        if (!m_opts.followSymlinks) return true;
+
+        const bool first = m_backend ? FirstVisit(m_backend->Canonical(entry.path).string())
+                                     : FirstVisit(DirId{ entry.device, entry.inode });
+        if (!first) m_loops++;
+        return first;
+    }
+
+    /*
+    Function: Walk::FirstVisit
+    Description: Records a directory by device and inode.
+    Parameters:
+      - id: Directory identity.
+    Returns:
+      - bool: true if it had not been recorded before; false otherwise.
+    */
+    bool Walk::FirstVisit(const DirId& id)
+    {
+        VisitedShard& shard = m_visited[DirIdHash()(id) % kVisitedShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.ids.insert(id).second;
+    }
+
+    /*
+    Function: Walk::FirstVisit
+    Description: Records a directory by canonical path, for backends without inode numbers.
+    Parameters:
+      - canonical: Canonical path of the directory.
+    Returns:
+      - bool: true if it had not been recorded before; false otherwise.
+    */
+    bool Walk::FirstVisit(const std::string& canonical)
+    {
+        VisitedShard& shard = m_visited[std::hash<std::string>()(canonical) % kVisitedShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.paths.insert(canonical).second;
+    }
+
+    /*
+    Function: Walk::Error
+    Description: Counts a directory that could not be read and reports it to onError.
+    Parameters:
+      - dir: Directory.
+      - message: Reason.
+    Returns:
+      - None
+    */
+    void Walk::Error(const fs::path& dir, const std::string& message)
+    {
+        m_errors++;
+        if (m_callbacks.onError) m_callbacks.onError(dir, message);
+    }
+
+    /*
+    Function: Walk::ReadBackend
+    Description: Reads one directory through an FsBackend (the memory backend, or the portable
+                 backend where POSIX calls are missing). Every entry is stat'ed without
+                 following links to tell links from what they point at.
+    Parameters:
+      - worker: Index of the calling thread.
+      - task: Directory to read.
+    Returns:
+      - None
+    */
+    void Walk::ReadBackend(unsigned worker, DirTask& task)
+    {
+        m_directories++;
+
+        std::string err;
+        const bool listed = m_backend->ListStream(task.path, 0, kListChunkEntries, [&](const std::vector<FileItem>& chunk)
+        {
+            for (const FileItem& item : chunk)
+            {
+                if (Cancelled()) return false;
+
+                WalkEntry entry;
+                entry.path = item.fullPath;
+                entry.depth = task.depth + 1;
+                entry.worker = worker;
+                entry.parentId = task.id;
+
+                FsStat st;
+                if (!m_backend->Stat(entry.path, false, st)) continue;     // vanished meanwhile
+                entry.type = st.type;
+                if (m_opts.statEntries)
+                {
+                    entry.sizeBytes = st.sizeBytes;
+                    entry.modified = st.modified;
+                }
+                if (entry.type == FsEntryType::Symlink && m_opts.followSymlinks && item.isDir)
+                    entry.type = FsEntryType::Directory;
+                if (entry.type == FsEntryType::Directory) entry.dirId = ++m_lastDirId;
+
+                m_entries++;
+                Report(entry);
+                if (entry.type == FsEntryType::Directory && Enter(entry))
+                {
+                    DirTask child;
+                    child.path = std::move(entry.path);
+                    child.depth = entry.depth;
+                    child.id = entry.dirId;
+                    Push(worker, std::move(child));
+                }
+            }
+            return true;
+        }, err);
+
+        if (!listed) Error(task.path, err);
+    }
+
+#ifdef FM_HAVE_POSIX_IO
+    /*
+    Function: FillFromStat
+    Description: Copies the metadata of a struct stat into a walk entry.
+    Parameters:
+      - st: Result of fstatat.
+      - withTimes: Whether size and modification time are wanted.
+      - entry: Entry to fill.
+    Returns:
+      - None
+    */
+    void FillFromStat(const struct stat& st, bool withTimes, WalkEntry& entry)
+    {
+        if (S_ISLNK(st.st_mode)) entry.type = FsEntryType::Symlink;
+        else if (S_ISDIR(st.st_mode)) entry.type = FsEntryType::Directory;
+        else if (S_ISREG(st.st_mode)) entry.type = FsEntryType::File;
+        else entry.type = FsEntryType::Other;
+
+        entry.device = (std::uint64_t)st.st_dev;
+        entry.inode = (std::uint64_t)st.st_ino;
+        if (withTimes)
+        {
+            entry.sizeBytes = S_ISREG(st.st_mode) ? (std::uintmax_t)st.st_size : 0;
+            entry.modified = st.st_mtime;
+        }
+    }
+
+    /*
+    Function: TypeFromDirent
+    Description: Reads the entry type the kernel stores in the directory itself, which costs
+                 no extra call (on NFS it arrives with the READDIR reply).
+    Parameters:
+      - de: Directory entry.
+    Returns:
+      - FsEntryType: Type, or None when the filesystem does not provide it.
+    */
+    FsEntryType TypeFromDirent(const dirent* de)
+    {
+#if defined(DT_DIR) && defined(DT_UNKNOWN)
+        switch (de->d_type)
+        {
+        case DT_DIR: return FsEntryType::Directory;
+        case DT_REG: return FsEntryType::File;
+        case DT_LNK: return FsEntryType::Symlink;
+        case DT_UNKNOWN: return FsEntryType::None;
+        default: return FsEntryType::Other;
+        }
+#else
+        (void)de;
+        return FsEntryType::None;
+#endif
+    }
+
+    /*
+    Function: Walk::ReadPosix
+    Description: Reads one directory on the real filesystem. The directory is opened with
+                 openat relative to its parent when the parent is still held open (so the
+                 kernel does not resolve the whole path again), and stays open itself while
+                 its subdirectories are queued. An entry is only stat'ed when its metadata is
+                 wanted, its type is not in the directory entry, or link following, loop
+                 detection or the same-device rule needs its identity.
+    Parameters:
+      - worker: Index of the calling thread.
+      - task: Directory to read.
+    Returns:
+      - None
+    */
+    void Walk::ReadPosix(unsigned worker, DirTask& task)
+    {
+        // O_NOFOLLOW keeps a child swapped for a link after it was listed from being entered;
+        // the root itself may be a link, as it is for every other walk
+        const bool noFollow = !m_opts.followSymlinks && task.depth > 0;
+        const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (noFollow ? O_NOFOLLOW : 0);
+        const int fd = task.parent ? ::openat(::dirfd(task.parent->dir), task.path.filename().c_str(), flags)
+                                   : ::open(task.path.c_str(), flags);
+        task.parent.reset();
+        if (fd < 0)
+        {
+            Error(task.path, std::generic_category().message(errno));
+            return;
+        }
+        DIR* d = ::fdopendir(fd);
+        if (!d)
+        {
+            Error(task.path, std::generic_category().message(errno));
+            ::close(fd);
+            return;
+        }
+        const auto self = std::make_shared<HeldDir>(d, m_held);
+        const int dfd = ::dirfd(d);
+        m_directories++;
+
+        while (const dirent* de = ::readdir(d))
+        {
+            if (std::strcmp(de->d_name, ".") == 0 || std::strcmp(de->d_name, "..") == 0) continue;
+            if (Cancelled()) return;
+
+            WalkEntry entry;
+            entry.path = task.path / de->d_name;
+            entry.depth = task.depth + 1;
+            entry.worker = worker;
+            entry.parentId = task.id;
+            entry.inode = (std::uint64_t)de->d_ino;
+            entry.type = TypeFromDirent(de);
+
+            const bool needStat = m_opts.statEntries
+                || entry.type == FsEntryType::None
+                || (entry.type == FsEntryType::Symlink && m_opts.followSymlinks)
+                || (entry.type == FsEntryType::Directory && (m_opts.sameDevice || m_opts.followSymlinks));
+            if (needStat)
+            {
+                struct stat st{};
+                if (::fstatat(dfd, de->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;    // vanished meanwhile
+                FillFromStat(st, m_opts.statEntries, entry);
+
+                struct stat target{};
+                if (entry.type == FsEntryType::Symlink && m_opts.followSymlinks
+                    && ::fstatat(dfd, de->d_name, &target, 0) == 0 && S_ISDIR(target.st_mode))
+                {
+                    FillFromStat(target, m_opts.statEntries, entry);
+                }
+            }
+
+            if (entry.type == FsEntryType::Directory) entry.dirId = ++m_lastDirId;
+
+            m_entries++;
+            Report(entry);
+            if (entry.type == FsEntryType::Directory && Enter(entry))
+            {
+                DirTask child;
+                child.path = std::move(entry.path);
+                child.depth = entry.depth;
+                child.id = entry.dirId;
+                if (m_held.load(std::memory_order_relaxed) < kMaxHeldDirs) child.parent = self;
+                Push(worker, std::move(child));
+            }
+        }
+    }
+
+    /*
+    Function: IsRemoteFilesystem
+    Description: Tells whether a path is on a network filesystem (NFS, SMB/CIFS, AFS, or a
+                 FUSE mount, which is usually remote), where each directory read waits on a
+                 round trip.
+    Parameters:
+      - p: Path to test.
+    Returns:
+      - bool: true if the filesystem is known to be remote; false otherwise.
+    */
+    bool IsRemoteFilesystem(const fs::path& p)
+    {
+#if defined(__linux__)
+        struct statfs sf{};
+        if (::statfs(p.c_str(), &sf) != 0) return false;
+        switch ((unsigned long)sf.f_type)
+        {
+        case 0x6969UL:          // NFS
+        case 0x517BUL:          // SMB
+        case 0xFF534D42UL:      // CIFS
+        case 0xFE534D42UL:      // SMB2
+        case 0x5346414FUL:      // AFS
+        case 0x65735546UL:      // FUSE
+            return true;
+        default:
+            return false;
+        }
+#elif defined(__APPLE__)
+        struct statfs sf{};
+        if (::statfs(p.c_str(), &sf) != 0) return false;
+        const std::string type = sf.f_fstypename;
+        return type == "nfs" || type == "smbfs" || type == "afpfs" || type == "webdav" || type == "osxfuse";
+#else
+        (void)p;
+        return false;
+#endif
+    }
+#endif
+}
+
+/*
+Function: TreeWalkThreads
+Description: Chooses the number of walker threads. Local trees use one thread per core; trees
+             on a network filesystem use four per core (up to 64), since there the threads
+             mostly wait for the server and more requests in flight hide its latency.
+Parameters:
+  - root: Directory that will be walked.
+  - requested: Thread count asked for; 0 chooses automatically.
+Returns:
+  - unsigned: Number of threads (at least 1).
+*/
+unsigned TreeWalkThreads(const fs::path& root, unsigned requested)
+{
+    if (requested != 0) return requested;
+
+    const unsigned cores = DefaultWorkerCount();
+#ifdef FM_HAVE_POSIX_IO
+    if (IsRemoteFilesystem(root)) return std::min(cores * 4, kMaxRemoteThreads);
+#else
+    (void)root;
+#endif
+    return cores;
+}
+
+/*
+Function: WalkTree
+Description: Visits every entry below root in parallel and passes each one to the callbacks
+             from the walker threads. Entries are not visited in any particular order, except
+             that a directory is always reported before its children. Symlinks are reported
+             as links and not entered unless opts.followSymlinks is set, in which case a
+             directory reached a second time is skipped. Directories that cannot be read are
+             reported to onError and the walk continues.
+Parameters:
+  - root: Directory to walk.
+  - opts: Traversal options.
+  - callbacks: Filter, pruning and result hooks.
+  - outStats: Output totals of the walk.
+  - outErr: Output string populated with an error message if root cannot be walked; cleared on success.
+  - backend: Backend to list through, or null for the real filesystem.
+Returns:
+  - bool: true if the walk ran (even if cancelled or some directories failed); false otherwise.
+*/
+bool WalkTree(const fs::path& root,
+              const TreeWalkOptions& opts,
+              const TreeWalkCallbacks& callbacks,
+              TreeWalkStats& outStats,
+              std::string& outErr,
+              const FsBackend* backend)
+{
+    outErr.clear();
+    outStats = TreeWalkStats{};
+
+#ifndef FM_HAVE_POSIX_IO
+    static const StdFsBackend portable;
+    if (!backend) backend = &portable;
+#endif
+
+    std::uint64_t rootDevice = 0;
+    std::uint64_t rootInode = 0;
+    bool isDir = false;
+#ifdef FM_HAVE_POSIX_IO
+    if (!backend)
+    {
+        struct stat st{};
+        isDir = ::stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        rootDevice = (std::uint64_t)st.st_dev;
+        rootInode = (std::uint64_t)st.st_ino;
+    }
+    else
+#endif
+    {
+        FsStat st;
+        isDir = backend->Stat(root, true, st) && st.type == FsEntryType::Directory;
+    }
+    if (!isDir)
+    {
+        outErr = "Not a directory: " + root.string();
+        return false;
+    }
+
+    const unsigned threads = backend ? (opts.threads ? opts.threads : DefaultWorkerCount())
+                                     : TreeWalkThreads(root, opts.threads);
+    Walk walk(opts, callbacks, backend, threads);
+    walk.Run(root, rootDevice, rootInode);
+    walk.Totals(outStats);
+    return true;
+}
@@ -0,0 +1,83 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the parallel tree walker, the one primitive behind every recursive job of the file manager (content search, sync, sizes and duplicate detection). A pool of threads visits the tree one directory per task, each thread working on its own queue and stealing the oldest, widest directories from the others when it runs dry. Every directory is numbered as it is found and every entry carries the number of its parent, so callers can rebuild the tree without comparing paths. On Unix-like systems directories are opened relative to their parent's descriptor, and symlink loops are cut by remembering the device and inode of every directory entered.
+February 1, 2026
+*/
+
+#ifndef TREEWALKER_H
+#define TREEWALKER_H
+
+#include "FsBackend.h"
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// One entry found by WalkTree
+struct WalkEntry
+{
+    fs::path path;
+    FsEntryType type = FsEntryType::None;   // a followed link to a directory is a Directory
+    std::uintmax_t sizeBytes = 0;           // 0 unless statEntries
+    std::time_t modified = 0;               // 0 unless statEntries
+    std::uint64_t device = 0;               // 0 if the entry was not stat'ed
+    std::uint64_t inode = 0;                // 0 for backends without inode numbers
+    unsigned depth = 0;                     // 1 for the children of the root
+    unsigned worker = 0;                    // walker thread index, for per-thread scratch state
+    std::uint64_t dirId = 0;                // directories: 1, 2, ... in the order reported
+    std::uint64_t parentId = 0;             // dirId of the directory it was found in; root is 0
+};
+
+// How WalkTree traverses the tree
+struct TreeWalkOptions
+{
+    unsigned threads = 0;               // 0 = TreeWalkThreads(root, 0)
+    bool followSymlinks = false;        // enter linked directories; loops are cut by (device, inode)
+    bool sameDevice = false;            // do not enter other mounted filesystems
+    bool statEntries = true;            // false: types come from the directory entry where the
+                                        // filesystem provides them and sizes/times stay 0
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+// Caller hooks of WalkTree; all may be called concurrently from the walker threads
+struct TreeWalkCallbacks
+{
+    // Whether to report an entry to onEntry (null = all); directories are still entered
+    std::function<bool(const WalkEntry&)> filter;
+    // Whether to enter a directory (null = all); false prunes its whole subtree
+    std::function<bool(const WalkEntry&)> descend;
+    // Receives every reported entry; a directory is reported before any of its children
+    std::function<void(const WalkEntry&)> onEntry;
+    // Receives directories that could not be read (null = skipped silently)
+    std::function<void(const fs::path&, const std::string&)> onError;
+};
+
+// Totals of one walk
+struct TreeWalkStats
+{
+    std::uint64_t directories = 0;      // directories read
+    std::uint64_t entries = 0;          // entries seen (reported or not)
+    std::uint64_t errors = 0;           // directories that could not be read
+    std::uint64_t loopsSkipped = 0;     // directories reached again through a link
+    unsigned threads = 0;
+    bool cancelled = false;
+};
+
+// Threads to walk root with: the core count, or more on network filesystems where the
+// walk waits on round trips rather than on the CPU
+unsigned TreeWalkThreads(const fs::path& root, unsigned requested);
+
+// Walks everything below root (not root itself); backend null = the real filesystem
+bool WalkTree(const fs::path& root,
+              const TreeWalkOptions& opts,
+              const TreeWalkCallbacks& callbacks,
+              TreeWalkStats& outStats,
+              std::string& outErr,
+              const FsBackend* backend = nullptr);
+
+#endif // TREEWALKER_H
@@ -0,0 +1,43 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the VfsProvider interface through which FileSystemService browses containers that are not real directories, such as archives. A provider is opened for one container file and answers listing and lookup requests for paths inside it, and extracts entries directly to the real filesystem when they are pasted elsewhere.
+February 1, 2026
+*/
+
+#ifndef VFSPROVIDER_H
+#define VFSPROVIDER_H
+
+#include "FileSystemService.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class IoScheduler;
+
+// Read-only view of the contents of one container file
+class VfsProvider
+{
+public:
+    virtual ~VfsProvider() = default;
+
+    // Metadata of the entry at inner ("" is the container root); false if there is none
+    virtual bool Stat(const fs::path& inner, FileItem& outItem) const = 0;
+
+    // Children of the directory at inner; item paths are built below mountedAt
+    virtual bool List(const fs::path& mountedAt,
+                      const fs::path& inner,
+                      std::vector<FileItem>& outItems,
+                      std::string& outErr) const = 0;
+
+    // Writes the entry at inner (recursively for directories) to dst, which must not exist
+    virtual bool Extract(const fs::path& inner,
+                         const fs::path& dst,
+                         IoScheduler& scheduler,
+                         PasteStats& outStats,
+                         std::string& outErr) const = 0;
+};
+
+#endif // VFSPROVIDER_H
@@ -0,0 +1,293 @@
+/*
+Parneet Baidwan - 251259638
+Description: The WatchFrame class in this file builds the directory watch dashboard. It starts and stops the background DirectoryWatcher, and once a second sorts the per-directory change rates into a virtual list, prepends the newest events to the event log and reports the watch mode and any directories left unwatched by the inotify watch limit in the status bar.
+February 1, 2026
+*/
+
+#include "WatchFrame.h"
+
+#include <wx/msgdlg.h>
+#include <algorithm>
+
+namespace
+{
+    // Seconds the rates are averaged over
+    constexpr unsigned kRateWindowSeconds = 10;
+    // Event log rows kept; older ones scroll off the bottom
+    constexpr long kMaxLogRows = 500;
+
+    const char* KindName(WatchEventKind kind)
+    {
+        switch (kind)
+        {
+        case WatchEventKind::Created:  return "Created";
+        case WatchEventKind::Modified: return "Modified";
+        case WatchEventKind::Deleted:  return "Deleted";
+        }
+        return "";
+    }
+}
+
+// Rate list (directory, events/s, bytes/s, totals) drawn from the latest rates on demand
+class WatchRateList final : public wxListCtrl
+{
+public:
+    WatchRateList(wxWindow* parent, const std::vector<WatchDirRate>& rates)
+        : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL),
+          m_rates(rates)
+    {
+        InsertColumn(0, "Directory", wxLIST_FORMAT_LEFT, 420);
+        InsertColumn(1, "Events/s", wxLIST_FORMAT_RIGHT, 90);
+        InsertColumn(2, "Bytes/s", wxLIST_FORMAT_RIGHT, 110);
+        InsertColumn(3, "Created", wxLIST_FORMAT_RIGHT, 90);
+        InsertColumn(4, "Modified", wxLIST_FORMAT_RIGHT, 90);
+        InsertColumn(5, "Deleted", wxLIST_FORMAT_RIGHT, 90);
+        m_format.SetHumanReadableSizes(true);
+    }
+
+private:
+    wxString OnGetItemText(long item, long column) const override
+    {
+        if (item < 0 || (std::size_t)item >= m_rates.size()) return wxString();
+
+        const WatchDirRate& rate = m_rates[(std::size_t)item];
+        switch (column)
+        {
+        case 0: return wxString::FromUTF8(rate.dir.u8string());
+        case 1: return wxString::Format("%.1f", rate.eventsPerSec);
+        case 2: return wxString::FromUTF8(m_format.FormatSize((std::uintmax_t)rate.bytesPerSec)) + "/s";
+        case 3: return wxString::FromUTF8(m_format.FormatNumber(rate.created));
+        case 4: return wxString::FromUTF8(m_format.FormatNumber(rate.modified));
+        case 5: return wxString::FromUTF8(m_format.FormatNumber(rate.deleted));
+        }
+        return wxString();
+    }
+
+    const std::vector<WatchDirRate>& m_rates;
+    mutable ListingFormatter m_format;
+};
+
+// bind event ids to handler methods
+wxBEGIN_EVENT_TABLE(WatchFrame, wxFrame)
+    EVT_TEXT_ENTER(WatchFrame::ID_Root, WatchFrame::OnStart)
+    EVT_BUTTON(WatchFrame::ID_Start, WatchFrame::OnStart)
+    EVT_TIMER(WatchFrame::ID_Refresh, WatchFrame::OnRefreshTimer)
+wxEND_EVENT_TABLE()
+
+/*
+Function: WatchFrame::WatchFrame
+Description: Builds the dashboard: the directory field, the Watch/Stop button, the rate list
+             and the event log.
+Parameters:
+  - parent: Owning window.
+  - root: Directory suggested for watching.
+Returns:
+  - None
+*/
+WatchFrame::WatchFrame(wxWindow* parent, const fs::path& root)
+    : wxFrame(parent, wxID_ANY, "Watch Directories", wxDefaultPosition, wxSize(980, 700)),
+      m_refreshTimer(this, ID_Refresh)
+{
+    auto* panel = new wxPanel(this);
+
+    m_rootCtrl = new wxTextCtrl(panel, ID_Root, wxString::FromUTF8(root.u8string()), wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+    m_startButton = new wxButton(panel, ID_Start, "Watch");
+
+    m_rateList = new WatchRateList(panel, m_rates);
+
+    m_logList = new wxListCtrl(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    m_logList->InsertColumn(0, "Time", wxLIST_FORMAT_LEFT, 90);
+    m_logList->InsertColumn(1, "Event", wxLIST_FORMAT_LEFT, 90);
+    m_logList->InsertColumn(2, "Path", wxLIST_FORMAT_LEFT, 640);
+    m_logList->InsertColumn(3, "Grew By", wxLIST_FORMAT_RIGHT, 110);
+    m_format.SetHumanReadableSizes(true);
+
+    auto* top = new wxBoxSizer(wxHORIZONTAL);
+    top->Add(new wxStaticText(panel, wxID_ANY, "Directory:"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    top->Add(m_rootCtrl, 1, wxEXPAND | wxRIGHT, 5);
+    top->Add(m_startButton, 0);
+
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(top, 0, wxEXPAND | wxALL, 10);
+    sizer->Add(new wxStaticText(panel, wxID_ANY, wxString::Format("Busiest directories (last %u seconds)", kRateWindowSeconds)), 0, wxLEFT | wxRIGHT, 10);
+    sizer->Add(m_rateList, 3, wxEXPAND | wxALL, 10);
+    sizer->Add(new wxStaticText(panel, wxID_ANY, "Latest events"), 0, wxLEFT | wxRIGHT, 10);
+    sizer->Add(m_logList, 2, wxEXPAND | wxALL, 10);
+    panel->SetSizer(sizer);
+
+    CreateStatusBar(1);
+    SetStatusText("Choose a directory and press Watch.");
+}
+
+/*
+Function: WatchFrame::~WatchFrame
+Description: Stops the watch before the window (and the lists reading it) goes away.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+WatchFrame::~WatchFrame()
+{
+    m_refreshTimer.Stop();
+    m_watcher.Stop();
+}
+
+/*
+Function: WatchFrame::StartWatch
+Description: Clears the dashboard and starts watching the directory in the field.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void WatchFrame::StartWatch()
+{
+    StopWatch();
+
+    m_rates.clear();
+    m_rateList->SetItemCount(0);
+    m_logList->DeleteAllItems();
+
+    std::string err;
+    m_root = fs::u8path(m_rootCtrl->GetValue().utf8_string());
+    if (!m_watcher.Start(m_root, err))
+    {
+        wxMessageBox(wxString::FromUTF8(err), "Watch Directories", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    m_startButton->SetLabel("Stop");
+    SetStatusText("Setting up watches...");
+    m_refreshTimer.Start(1000);
+}
+
+/*
+Function: WatchFrame::StopWatch
+Description: Stops a running watch; the dashboard keeps its last figures.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void WatchFrame::StopWatch()
+{
+    if (!m_watcher.Running()) return;
+
+    m_watcher.Stop();
+    m_refreshTimer.Stop();
+    UpdateDashboard();
+    m_startButton->SetLabel("Watch");
+}
+
+/*
+Function: WatchFrame::UpdateDashboard
+Description: Pulls the current rates and the new events from the watcher. Directories are
+             sorted busiest first (events, then bytes per second, then total events); new
+             events go to the top of the log, which is cut to its row limit.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void WatchFrame::UpdateDashboard()
+{
+    m_watcher.Rates(kRateWindowSeconds, m_rates);
+    std::sort(m_rates.begin(), m_rates.end(), [](const WatchDirRate& a, const WatchDirRate& b)
+    {
+        if (a.eventsPerSec != b.eventsPerSec) return a.eventsPerSec > b.eventsPerSec;
+        if (a.bytesPerSec != b.bytesPerSec) return a.bytesPerSec > b.bytesPerSec;
+        return a.created + a.modified + a.deleted > b.created + b.modified + b.deleted;
+    });
+    m_rateList->SetItemCount((long)m_rates.size());
+    m_rateList->Refresh();
+
+    m_watcher.DrainLog(m_logBatch);
+    if (!m_logBatch.empty())
+    {
+        const std::size_t first = m_logBatch.size() > (std::size_t)kMaxLogRows ? m_logBatch.size() - kMaxLogRows : 0;
+
+        m_logList->Freeze();
+        for (std::size_t i = first; i < m_logBatch.size(); ++i)
+        {
+            const WatchLogEntry& entry = m_logBatch[i];
+            const long row = m_logList->InsertItem(0, wxDateTime(entry.time).Format("%H:%M:%S"));
+            m_logList->SetItem(row, 1, KindName(entry.kind));
+            m_logList->SetItem(row, 2, wxString::FromUTF8(entry.path.u8string()));
+            m_logList->SetItem(row, 3, entry.bytes ? wxString::FromUTF8(m_format.FormatSize(entry.bytes)) : wxString());
+        }
+        while (m_logList->GetItemCount() > kMaxLogRows) m_logList->DeleteItem(m_logList->GetItemCount() - 1);
+        m_logList->Thaw();
+    }
+
+    UpdateStatus();
+}
+
+/*
+Function: WatchFrame::UpdateStatus
+Description: Shows how the tree is watched and the event totals in the status bar. With
+             inotify, directories left unwatched because the watch limit was reached are
+             reported together with the setting that raises the limit.
+Parameters:
+  - None
+Returns:
+  - None
+*/
+void WatchFrame::UpdateStatus()
+{
+    const WatchStatus status = m_watcher.Status();
+    if (!status.error.empty())
+    {
+        m_refreshTimer.Stop();
+        m_startButton->SetLabel("Watch");
+        SetStatusText(wxString::FromUTF8(status.error));
+        return;
+    }
+
+    wxString text = status.running ? "Watching " : "Stopped watching ";
+    text += wxString::FromUTF8(m_root.u8string());
+    if (status.fanotify)
+        text += " (fanotify, whole filesystem)";
+    else
+        text += wxString::Format(" (inotify, %llu directories)", (unsigned long long)status.watchedDirs);
+    text += wxString::Format(": %llu events", (unsigned long long)status.events);
+
+    if (status.overflows)
+        text += wxString::Format(", %llu queue overflows (events lost)", (unsigned long long)status.overflows);
+    if (status.unwatchedDirs)
+        text += wxString::Format(". Watch limit of %llu reached: at least %llu directories not watched; raise fs.inotify.max_user_watches",
+                                 (unsigned long long)status.watchLimit, (unsigned long long)status.unwatchedDirs);
+    SetStatusText(text);
+}
+
+/*
+Function: WatchFrame::OnStart
+Description: Handler for the Watch/Stop button and Enter in the directory field. Starts a new
+             watch, or stops the running one when the button reads “Stop”.
+Parameters:
+  - event: wxWidgets command event.
+Returns:
+  - None
+*/
+void WatchFrame::OnStart(wxCommandEvent& event)
+{
+    if (m_watcher.Running() && event.GetId() == ID_Start)
+    {
+        StopWatch();
+        return;
+    }
+    StartWatch();
+}
+
+/*
+Function: WatchFrame::OnRefreshTimer
+Description: Timer handler; delegates to UpdateDashboard().
+Parameters:
+  - event: wxWidgets timer event.
+Returns:
+  - None
+*/
+void WatchFrame::OnRefreshTimer(wxTimerEvent&)
+{
+    UpdateDashboard();
+}
@@ -0,0 +1,57 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the WatchFrame class, the dashboard window of the directory watch. It shows, for every directory below the watched root that has changed, its events and bytes per second over the last seconds together with its created, modified and deleted totals, busiest first, above a log of the latest events. A timer pulls both from the background DirectoryWatcher once a second.
+February 1, 2026
+*/
+
+#ifndef WATCHFRAME_H
+#define WATCHFRAME_H
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <wx/timer.h>
+#include <vector>
+
+#include "DirectoryWatcher.h"
+#include "ListingFormatter.h"
+
+class WatchRateList;
+
+class WatchFrame final : public wxFrame
+{
+public:
+    WatchFrame(wxWindow* parent, const fs::path& root);
+    ~WatchFrame() override;
+
+private:
+    wxTextCtrl* m_rootCtrl = nullptr;
+    wxButton* m_startButton = nullptr;
+    WatchRateList* m_rateList = nullptr;
+    wxListCtrl* m_logList = nullptr;
+    wxTimer m_refreshTimer;
+
+    DirectoryWatcher m_watcher;
+    std::vector<WatchDirRate> m_rates;
+    std::vector<WatchLogEntry> m_logBatch;
+    ListingFormatter m_format;
+    fs::path m_root;
+
+    enum
+    {
+        ID_Root = wxID_HIGHEST + 1,
+        ID_Start,
+        ID_Refresh
+    };
+
+    void StartWatch();
+    void StopWatch();
+    void UpdateDashboard();
+    void UpdateStatus();
+
+    void OnStart(wxCommandEvent& event);
+    void OnRefreshTimer(wxTimerEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+#endif // WATCHFRAME_H
@@ -0,0 +1,636 @@
+/*
+Parneet Baidwan - 251259638
+Description: The compressed copies in this file move one file through a read -> zstd -> write pipeline. A reader thread fills fixed-size blocks from the source, the calling thread compresses (or decompresses) them, and a writer thread drains the output blocks to the destination. The stages hand blocks to each other through small bounded queues and recycle them through free lists, so memory stays constant no matter how large the file is and a slow stage simply makes the others wait. When built without zstd (ZSTD=0) both copies report that the feature is unavailable.
+February 1, 2026
+*/
+
+#include "ZstdCopy.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#ifdef FM_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FM_HAVE_POSIX_IO 1
+#else
+#include <cstdio>
+#endif
+
+#ifdef FM_HAVE_ZSTD
+namespace
+{
+    // Block size handed between stages, and how many blocks each queue may hold
+    constexpr std::size_t kBlock = 1u << 20;
+    constexpr std::size_t kDepth = 4;
+
+    // A fixed-size buffer and the number of valid bytes in it
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size = 0;
+    };
+
+    // Bounded blocking queue connecting two pipeline stages
+    class Channel
+    {
+    public:
+        /*
+        Function: Channel::Push
+        Description: Appends a block, waiting while the queue is full.
+        Parameters:
+          - block: Block to hand to the next stage.
+        Returns:
+          - bool: true if queued; false if the pipeline was aborted.
+        */
+        bool Push(Block block)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [&] { return m_aborted || m_items.size() < kDepth; });
+            if (m_aborted) return false;
+            m_items.push_back(std::move(block));
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        /*
+        Function: Channel::Pop
+        Description: Takes the oldest block, waiting while the queue is empty and still open.
+        Parameters:
+          - out: Receives the block.
+        Returns:
+          - bool: true if a block was taken; false at end of stream or after an abort.
+        */
+        bool Pop(Block& out)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [&] { return m_aborted || m_closed || !m_items.empty(); });
+            if (m_aborted || m_items.empty()) return false;
+            out = std::move(m_items.front());
+            m_items.pop_front();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        // No more blocks will be pushed; Pop drains what is left, then returns false
+        void Close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_notEmpty.notify_all();
+        }
+
+        // Wakes every waiter and makes Push and Pop fail from now on
+        void Abort()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_aborted = true;
+            m_items.clear();
+            m_notEmpty.notify_all();
+            m_notFull.notify_all();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::deque<Block> m_items;
+        bool m_closed = false;
+        bool m_aborted = false;
+    };
+
+    // Queues and error state shared by the three stages of one copy
+    struct Pipeline
+    {
+        Channel inFree, inFull, outFree, outFull;
+        std::atomic<bool> failed{ false };
+        std::mutex errMutex;
+        std::string err;
+
+        Pipeline()
+        {
+            for (std::size_t i = 0; i < kDepth; ++i)
+            {
+                inFree.Push(Block{ std::unique_ptr<char[]>(new char[kBlock]), 0 });
+                outFree.Push(Block{ std::unique_ptr<char[]>(new char[kBlock]), 0 });
+            }
+        }
+
+        // Records the first error and unblocks every stage
+        void Fail(std::string message)
+        {
+            {
+                std::lock_guard<std::mutex> lock(errMutex);
+                if (failed.exchange(true)) return;
+                err = std::move(message);
+            }
+            inFree.Abort();
+            inFull.Abort();
+            outFree.Abort();
+            outFull.Abort();
+        }
+    };
+
+#ifdef FM_HAVE_POSIX_IO
+    // Owns a file descriptor
+    struct FileHandle
+    {
+        int fd = -1;
+        ~FileHandle() { if (fd >= 0) ::close(fd); }
+    };
+
+    std::string ErrnoMessage(const char* what, const fs::path& p)
+    {
+        return std::string(what) + " " + p.string() + ": " + std::generic_category().message(errno);
+    }
+
+    /*
+    Function: OpenPair
+    Description: Opens the source for reading and creates the destination with the source's
+                 permission bits.
+    Parameters:
+      - src, dst: Source file and destination path (dst must not exist).
+      - in, out: Receive the open handles.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if both files are open; false otherwise.
+    */
+    bool OpenPair(const fs::path& src, const fs::path& dst, FileHandle& in, FileHandle& out, std::string& outErr)
+    {
+        in.fd = ::open(src.c_str(), O_RDONLY);
+        if (in.fd < 0)
+        {
+            outErr = ErrnoMessage("Cannot open", src);
+            return false;
+        }
+        struct stat st{};
+        if (::fstat(in.fd, &st) != 0)
+        {
+            outErr = ErrnoMessage("Cannot stat", src);
+            return false;
+        }
+        out.fd = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_EXCL, st.st_mode & 07777);
+        if (out.fd < 0)
+        {
+            outErr = ErrnoMessage("Cannot create", dst);
+            return false;
+        }
+        return true;
+    }
+
+    // Reads up to size bytes; returns the count, 0 at end of file, -1 on error
+    long ReadSome(FileHandle& f, char* buf, std::size_t size)
+    {
+        for (;;)
+        {
+            const ssize_t n = ::read(f.fd, buf, size);
+            if (n >= 0 || errno != EINTR) return (long)n;
+        }
+    }
+
+    bool WriteAll(FileHandle& f, const char* buf, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t n = ::write(f.fd, buf, size);
+            if (n < 0)
+            {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            buf += n;
+            size -= (std::size_t)n;
+        }
+        return true;
+    }
+
+    bool CloseOutput(FileHandle& f)
+    {
+        const int rc = ::close(f.fd);
+        f.fd = -1;
+        return rc == 0;
+    }
+#else
+    // Owns a stdio stream
+    struct FileHandle
+    {
+        std::FILE* fp = nullptr;
+        ~FileHandle() { if (fp) std::fclose(fp); }
+    };
+
+    bool OpenPair(const fs::path& src, const fs::path& dst, FileHandle& in, FileHandle& out, std::string& outErr)
+    {
+        in.fp = std::fopen(src.string().c_str(), "rb");
+        if (!in.fp)
+        {
+            outErr = "Cannot open " + src.string();
+            return false;
+        }
+        std::error_code ec;
+        if (fs::exists(dst, ec))
+        {
+            outErr = "Cannot create " + dst.string() + ": file exists";
+            return false;
+        }
+        out.fp = std::fopen(dst.string().c_str(), "wb");
+        if (!out.fp)
+        {
+            outErr = "Cannot create " + dst.string();
+            return false;
+        }
+        return true;
+    }
+
+    long ReadSome(FileHandle& f, char* buf, std::size_t size)
+    {
+        const std::size_t n = std::fread(buf, 1, size, f.fp);
+        return (n == 0 && std::ferror(f.fp)) ? -1 : (long)n;
+    }
+
+    bool WriteAll(FileHandle& f, const char* buf, std::size_t size)
+    {
+        return std::fwrite(buf, 1, size, f.fp) == size;
+    }
+
+    bool CloseOutput(FileHandle& f)
+    {
+        const int rc = std::fclose(f.fp);
+        f.fp = nullptr;
+        return rc == 0;
+    }
+#endif
+
+    /*
+    Function: ReaderStage
+    Description: First pipeline stage. Fills free blocks from the source until end of file,
+                 reporting each block to the scheduler for the source device.
+    Parameters:
+      - p: Pipeline the stage belongs to.
+      - in: Open source file.
+      - src: Source path, for error messages.
+      - scheduler, device: Scheduler and device charged for the reads.
+    Returns:
+      - None
+    */
+    void ReaderStage(Pipeline& p, FileHandle& in, const fs::path& src, IoScheduler& scheduler, DeviceId device)
+    {
+        Block block;
+        while (p.inFree.Pop(block))
+        {
+            const long n = ReadSome(in, block.data.get(), kBlock);
+            if (n < 0)
+            {
+                p.Fail("Read failed for " + src.string());
+                return;
+            }
+            if (n == 0) break;
+
+            block.size = (std::size_t)n;
+            scheduler.Transfer(device, (std::uint64_t)n);
+            if (!p.inFull.Push(std::move(block))) return;
+        }
+        p.inFull.Close();
+    }
+
+    /*
+    Function: WriterStage
+    Description: Last pipeline stage. Writes output blocks to the destination in order and
+                 returns them to the free list.
+    Parameters:
+      - p: Pipeline the stage belongs to.
+      - out: Open destination file.
+      - dst: Destination path, for error messages.
+      - scheduler, device: Scheduler and device charged for the writes.
+      - onWritten: Called with the size of every block written.
+      - written: Receives the total number of bytes written.
+    Returns:
+      - None
+    */
+    void WriterStage(Pipeline& p,
+                     FileHandle& out,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     DeviceId device,
+                     const std::function<void(std::uint64_t)>& onWritten,
+                     std::uint64_t& written)
+    {
+        Block block;
+        while (p.outFull.Pop(block))
+        {
+            if (!WriteAll(out, block.data.get(), block.size))
+            {
+                p.Fail("Write failed for " + dst.string());
+                return;
+            }
+            written += block.size;
+            scheduler.Transfer(device, block.size);
+            onWritten(block.size);
+            if (!p.outFree.Push(std::move(block))) return;
+        }
+    }
+
+    /*
+    Function: RunPipeline
+    Description: Opens both files, starts the reader and writer threads around the given
+                 middle stage, and waits for all three. The middle stage runs on the calling
+                 thread; it must Close outFull when it has emitted everything, or call Fail.
+    Parameters:
+      - src, dst: Source file and destination path (dst must not exist).
+      - scheduler: I/O scheduler admitting and pacing the copy.
+      - middle: Transform stage, called with the pipeline.
+      - onWritten: Called from the writer thread with the size of every block written.
+      - outWritten: Output number of bytes written to dst.
+      - outErr: Output string populated with an error message on failure.
+    Returns:
+      - bool: true if the whole file went through; false otherwise (a partial dst may remain).
+    */
+    template <typename Middle>
+    bool RunPipeline(const fs::path& src,
+                     const fs::path& dst,
+                     IoScheduler& scheduler,
+                     Middle&& middle,
+                     const std::function<void(std::uint64_t)>& onWritten,
+                     std::uint64_t& outWritten,
+                     std::string& outErr)
+    {
+        outErr.clear();
+        outWritten = 0;
+
+        const DeviceId srcDev = IoScheduler::DeviceOf(src);
+        const DeviceId dstDev = IoScheduler::DeviceOf(dst.parent_path());
+        IoScheduler::Ticket ticket = scheduler.Acquire({ srcDev, dstDev });
+
+        FileHandle in, out;
+        if (!OpenPair(src, dst, in, out, outErr)) return false;
+
+        Pipeline p;
+        std::thread reader([&] { ReaderStage(p, in, src, scheduler, srcDev); });
+        std::thread writer([&] { WriterStage(p, out, dst, scheduler, dstDev, onWritten, outWritten); });
+        middle(p);
+        reader.join();
+        writer.join();
+
+        if (p.failed)
+        {
+            outErr = p.err;
+            return false;
+        }
+        if (!CloseOutput(out))
+        {
+            outErr = "Write failed for " + dst.string();
+            return false;
+        }
+        return true;
+    }
+
+    /*
+    Function: Ship
+    Description: Hands a filled output block to the writer and takes a fresh one.
+    Parameters:
+      - p: Pipeline.
+      - out: Current output block; replaced by an empty one.
+      - ob: zstd output window over out; reset to the new block.
+    Returns:
+      - bool: true if the pipeline is still running; false otherwise.
+    */
+    bool Ship(Pipeline& p, Block& out, ZSTD_outBuffer& ob)
+    {
+        out.size = ob.pos;
+        if (!p.outFull.Push(std::move(out)) || !p.outFree.Pop(out)) return false;
+        ob = ZSTD_outBuffer{ out.data.get(), kBlock, 0 };
+        return true;
+    }
+
+    // Frees a zstd context on scope exit
+    struct CCtxGuard
+    {
+        ZSTD_CCtx* ctx = ZSTD_createCCtx();
+        ~CCtxGuard() { ZSTD_freeCCtx(ctx); }
+    };
+
+    struct DCtxGuard
+    {
+        ZSTD_DCtx* ctx = ZSTD_createDCtx();
+        ~DCtxGuard() { ZSTD_freeDCtx(ctx); }
+    };
+}
+#endif
+
+/*
+Function: ZstdCopySupported
+Description: Reports whether the compressed paste modes are available in this build.
+Parameters:
+  - None
+Returns:
+  - bool: true if built with FM_HAVE_ZSTD; false otherwise.
+*/
+bool ZstdCopySupported()
+{
+#ifdef FM_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+Function: CompressFileZstd
+Description: Copies a file into a new zstd-compressed file (with a content checksum). Reading,
+             compressing and writing proceed concurrently; with more than one worker, zstd
+             compresses independent blocks of the file on its own threads as well.
+Parameters:
+  - src: Source file.
+  - dst: Destination path (normally src's name plus .zst); must not exist yet.
+  - scheduler: I/O scheduler pacing the copy.
+  - opts: Compression level, worker threads and progress callback.
+  - outRawBytes: Output number of bytes read from src.
+  - outCompressedBytes: Output number of bytes written to dst.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file was compressed completely; false otherwise (a partial dst may remain).
+*/
+bool CompressFileZstd(const fs::path& src,
+                      const fs::path& dst,
+                      IoScheduler& scheduler,
+                      const ZstdCopyOptions& opts,
+                      std::uintmax_t& outRawBytes,
+                      std::uintmax_t& outCompressedBytes,
+                      std::string& outErr)
+{
+    outRawBytes = 0;
+    outCompressedBytes = 0;
+#ifdef FM_HAVE_ZSTD
+    CCtxGuard cctx;
+    if (!cctx.ctx)
+    {
+        outErr = "Out of memory starting zstd.";
+        return false;
+    }
+    ZSTD_CCtx_setParameter(cctx.ctx, ZSTD_c_compressionLevel, opts.level);
+    ZSTD_CCtx_setParameter(cctx.ctx, ZSTD_c_checksumFlag, 1);
+    if (opts.workers > 1)
+    {
+        // fails harmlessly when libzstd was built without threads
+        ZSTD_CCtx_setParameter(cctx.ctx, ZSTD_c_nbWorkers, (int)opts.workers);
+    }
+
+    std::uint64_t raw = 0;
+    auto compress = [&](Pipeline& p)
+    {
+        Block out;
+        if (!p.outFree.Pop(out)) return;
+        ZSTD_outBuffer ob{ out.data.get(), kBlock, 0 };
+
+        // Feeds one input window to zstd, shipping output blocks as they fill
+        auto feed = [&](ZSTD_inBuffer& ib, ZSTD_EndDirective mode)
+        {
+            for (;;)
+            {
+                const std::size_t left = ZSTD_compressStream2(cctx.ctx, &ob, &ib, mode);
+                if (ZSTD_isError(left))
+                {
+                    p.Fail(std::string("Compression failed for ") + src.string() + ": " + ZSTD_getErrorName(left));
+                    return false;
+                }
+                if (ob.pos == ob.size && !Ship(p, out, ob)) return false;
+                if (mode == ZSTD_e_end ? left == 0 : ib.pos == ib.size) return true;
+            }
+        };
+
+        Block in;
+        while (p.inFull.Pop(in))
+        {
+            ZSTD_inBuffer ib{ in.data.get(), in.size, 0 };
+            if (!feed(ib, ZSTD_e_continue)) return;
+            raw += in.size;
+            if (opts.onProgress) opts.onProgress(in.size, 0);
+            if (!p.inFree.Push(std::move(in))) return;
+        }
+        if (p.failed) return;
+
+        ZSTD_inBuffer none{ nullptr, 0, 0 };
+        if (!feed(none, ZSTD_e_end)) return;
+        if (ob.pos > 0)
+        {
+            out.size = ob.pos;
+            if (!p.outFull.Push(std::move(out))) return;
+        }
+        p.outFull.Close();
+    };
+
+    std::uint64_t written = 0;
+    auto onWritten = [&](std::uint64_t n) { if (opts.onProgress) opts.onProgress(0, n); };
+    const bool ok = RunPipeline(src, dst, scheduler, compress, onWritten, written, outErr);
+    outRawBytes = raw;
+    outCompressedBytes = written;
+    return ok;
+#else
+    (void)src; (void)dst; (void)scheduler; (void)opts;
+    outErr = "This build has no zstd support (rebuild with ZSTD=1).";
+    return false;
+#endif
+}
+
+/*
+Function: DecompressFileZstd
+Description: Copies a zstd-compressed file (one or more frames) into a new file holding the
+             original data, reading, decompressing and writing concurrently. A stream that
+             ends in the middle of a frame is reported as truncated.
+Parameters:
+  - src: Compressed source file.
+  - dst: Destination path (normally src's name without .zst); must not exist yet.
+  - scheduler: I/O scheduler pacing the copy.
+  - opts: Progress callback (level and workers are not used).
+  - outRawBytes: Output number of bytes written to dst.
+  - outCompressedBytes: Output number of bytes read from src.
+  - outErr: Output string populated with an error message on failure; cleared on success.
+Returns:
+  - bool: true if the file was decompressed completely; false otherwise (a partial dst may remain).
+*/
+bool DecompressFileZstd(const fs::path& src,
+                        const fs::path& dst,
+                        IoScheduler& scheduler,
+                        const ZstdCopyOptions& opts,
+                        std::uintmax_t& outRawBytes,
+                        std::uintmax_t& outCompressedBytes,
+                        std::string& outErr)
+{
+    outRawBytes = 0;
+    outCompressedBytes = 0;
+#ifdef FM_HAVE_ZSTD
+    DCtxGuard dctx;
+    if (!dctx.ctx)
+    {
+        outErr = "Out of memory starting zstd.";
+        return false;
+    }
+
+    std::uint64_t compressed = 0;
+    auto decompress = [&](Pipeline& p)
+    {
+        Block out;
+        if (!p.outFree.Pop(out)) return;
+        ZSTD_outBuffer ob{ out.data.get(), kBlock, 0 };
+
+        // non-zero until a frame has been completed
+        std::size_t pending = 1;
+        Block in;
+        while (p.inFull.Pop(in))
+        {
+            ZSTD_inBuffer ib{ in.data.get(), in.size, 0 };
+            for (;;)
+            {
+                pending = ZSTD_decompressStream(dctx.ctx, &ob, &ib);
+                if (ZSTD_isError(pending))
+                {
+                    p.Fail(std::string("Decompression failed for ") + src.string() + ": " + ZSTD_getErrorName(pending));
+                    return;
+                }
+
+                // a full window may leave more output buffered inside zstd
+                const bool full = ob.pos == ob.size;
+                if (full && !Ship(p, out, ob)) return;
+                if (ib.pos == ib.size && !full) break;
+            }
+            compressed += in.size;
+            if (opts.onProgress) opts.onProgress(0, in.size);
+            if (!p.inFree.Push(std::move(in))) return;
+        }
+        if (p.failed) return;
+
+        if (pending != 0)
+        {
+            p.Fail("Decompression failed for " + src.string() + ": truncated or not a zstd file");
+            return;
+        }
+        if (ob.pos > 0)
+        {
+            out.size = ob.pos;
+            if (!p.outFull.Push(std::move(out))) return;
+        }
+        p.outFull.Close();
+    };
+
+    std::uint64_t written = 0;
+    auto onWritten = [&](std::uint64_t n) { if (opts.onProgress) opts.onProgress(n, 0); };
+    const bool ok = RunPipeline(src, dst, scheduler, decompress, onWritten, written, outErr);
+    outRawBytes = written;
+    outCompressedBytes = compressed;
+    return ok;
+#else
+    (void)src; (void)dst; (void)scheduler; (void)opts;
+    outErr = "This build has no zstd support (rebuild with ZSTD=1).";
+    return false;
+#endif
+}
@@ -0,0 +1,50 @@
+/*
+Parneet Baidwan - 251259638
+Description: This header file declares the compressing and decompressing file copies used by the compressed paste modes. Each copy runs as a three-stage pipeline (read, zstd, write) so the source disk, the CPU and the destination disk are busy at the same time, and compression is additionally split into blocks across zstd worker threads. Both copies are paced by the IoScheduler like plain copies.
+February 1, 2026
+*/
+
+#ifndef ZSTDCOPY_H
+#define ZSTDCOPY_H
+
+#include "IoScheduler.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// File name suffix written by compressed pastes and removed by decompressed ones
+constexpr const char* kZstdSuffix = ".zst";
+
+// Settings for CompressFileZstd / DecompressFileZstd
+struct ZstdCopyOptions
+{
+    int level = 3;              // zstd compression level (1..19)
+    unsigned workers = 1;       // zstd block-compression threads for one file
+    // Called from the pipeline threads with the raw and compressed bytes processed since the last call
+    std::function<void(std::uint64_t rawDelta, std::uint64_t compressedDelta)> onProgress;
+};
+
+// True when the program was built with zstd support
+bool ZstdCopySupported();
+
+bool CompressFileZstd(const fs::path& src,
+                      const fs::path& dst,
+                      IoScheduler& scheduler,
+                      const ZstdCopyOptions& opts,
+                      std::uintmax_t& outRawBytes,
+                      std::uintmax_t& outCompressedBytes,
+                      std::string& outErr);
+
+bool DecompressFileZstd(const fs::path& src,
+                        const fs::path& dst,
+                        IoScheduler& scheduler,
+                        const ZstdCopyOptions& opts,
+                        std::uintmax_t& outRawBytes,
+                        std::uintmax_t& outCompressedBytes,
+                        std::string& outErr);
+
+#endif // ZSTDCOPY_H
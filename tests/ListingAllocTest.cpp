@@ -0,0 +1,120 @@
+/*
+Parneet Baidwan - 251259638
+Description: This test counts the allocations of listing refreshes with the counting operator new of AllocCounter (it is linked with an AllocCounter built with FM_COUNT_ALLOCS). A refresh served from the listing cache must cost the same few allocations for a large directory as for a small one, a re-read must allocate nothing per entry beyond building the entry's path, and formatting the size and date cells of rows already seen must not allocate at all.
+February 1, 2026
+*/
+
+#include "AllocCounter.h"
+#include "FileSystemService.h"
+#include "ListingFormatter.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    constexpr int kSmallDir = 100;
+    constexpr int kLargeDir = 20000;
+
+    // Allocations a refresh may make besides its entries (shared_ptr, scratch buffers)
+    constexpr std::uint64_t kFixedAllocs = 32;
+
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what, std::uint64_t allocs)
+    {
+        if (ok) return;
+        std::printf("ListingAllocTest: FAILED: %s (%llu allocations)\n", what, (unsigned long long)allocs);
+        ++g_failures;
+    }
+
+    // Fills dir with count empty files whose names are too long for the small-string buffer
+    void MakeDir(const fs::path& dir, int count)
+    {
+        fs::create_directories(dir);
+        for (int i = 0; i < count; ++i)
+            std::ofstream(dir / ("entry-with-a-long-name-" + std::to_string(i) + ".dat"));
+    }
+
+    template <typename Fn>
+    std::uint64_t Allocations(Fn&& fn)
+    {
+        const std::uint64_t before = AllocationCount();
+        fn();
+        return AllocationCount() - before;
+    }
+}
+
+/*
+Function: main
+Description: Lists a small and a large directory, then measures cached refreshes, re-reads and
+             cell formatting of the large one.
+Parameters:
+  - None
+Returns:
+  - int: 0 if every check passed, 1 otherwise.
+*/
+int main()
+{
+    if (Allocations([] { ::operator delete(::operator new(1)); }) != 1)
+    {
+        std::printf("ListingAllocTest: allocations are not being counted (AllocCounter built without FM_COUNT_ALLOCS)\n");
+        return 1;
+    }
+
+    const fs::path root = fs::temp_directory_path() / "fm-test-allocs";
+    fs::remove_all(root);
+    MakeDir(root / "small", kSmallDir);
+    MakeDir(root / "large", kLargeDir);
+
+    FileSystemService service;
+    std::string err;
+    DirectoryListing small = service.ListDirectoryCached(root / "small", true, err);
+    DirectoryListing large = service.ListDirectoryCached(root / "large", true, err);
+    if (!small || !large || small->size() != kSmallDir || large->size() != kLargeDir)
+    {
+        std::printf("ListingAllocTest: cannot list %s: %s\n", root.string().c_str(), err.c_str());
+        fs::remove_all(root);
+        return 1;
+    }
+
+    // a cached refresh swaps a pointer: its cost does not depend on the directory's size
+    const std::uint64_t smallHit = Allocations([&] { small = service.ListDirectoryCached(root / "small", true, err); });
+    const std::uint64_t largeHit = Allocations([&] { large = service.ListDirectoryCached(root / "large", true, err); });
+    Check(largeHit <= kFixedAllocs, "cached refresh of a large directory", largeHit);
+    Check(largeHit == smallHit, "cached refresh costs the same for any size", largeHit);
+
+    // a re-read allocates nothing per entry beyond the entry's fs::path (its string and, depending
+    // on the standard library, its component list), into a vector sized up front
+    const std::string sample = (root / "large" / "entry-with-a-long-name-10000.dat").native();
+    const std::uint64_t perPath = Allocations([&]
+    {
+        std::string full;
+        full.reserve(sample.size());
+        full.append(sample);
+        fs::path p(std::move(full));
+    });
+    const std::uint64_t reread = Allocations([&] { large = service.ListDirectoryCached(root / "large", false, err); });
+    Check(large && large->size() == kLargeDir, "re-read lists every entry", reread);
+    Check(reread <= perPath * kLargeDir + kFixedAllocs, "re-read of a large directory", reread);
+
+    // cells are formatted into reused buffers; once the dates' prefixes are cached, nothing allocates
+    ListingFormatter format;
+    format.SetHumanReadableSizes(true);
+    std::size_t sink = 0;
+    const auto formatAll = [&]
+    {
+        for (const FileItem& item : *large)
+            sink += format.FormatDate(item.modified).size() + format.FormatSize(item.sizeBytes).size();
+    };
+    formatAll();
+    const std::uint64_t cells = Allocations(formatAll);
+    Check(cells == 0, "formatting rows already seen", cells);
+
+    fs::remove_all(root);
+    if (g_failures == 0)
+        std::printf("ListingAllocTest: passed (cached refresh %llu, re-read of %d entries %llu allocations, %llu per path)\n",
+                    (unsigned long long)largeHit, kLargeDir, (unsigned long long)reread, (unsigned long long)perPath);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+Parneet Baidwan - 251259638
+Description: This test pastes a sparse file (two data extents and a trailing hole) with and without verification and checks that the copy reads back the same, keeps its holes unallocated (by its st_blocks count) and that the paste reports exactly the holes it skipped. It is skipped where the temporary directory's filesystem does not store holes.
+February 1, 2026
+*/
+
+#include "Checksum.h"
+#include "FileSystemService.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr std::uint64_t kFileBytes = 64ull << 20;
+    constexpr std::uint64_t kExtentBytes = 1ull << 20;
+    constexpr std::uint64_t kSecondExtent = 32ull << 20;
+
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        if (ok) return;
+        std::printf("SparseCopyTest: FAILED: %s\n", what);
+        ++g_failures;
+    }
+
+    // Bytes allocated to a file on disk
+    std::uint64_t Allocated(const fs::path& p)
+    {
+        struct stat st{};
+        return ::stat(p.c_str(), &st) == 0 ? (std::uint64_t)st.st_blocks * 512 : 0;
+    }
+
+    std::uint64_t HashFile(const fs::path& p)
+    {
+        Hash64 hash;
+        std::unique_ptr<char[]> buf(new char[1u << 20]);
+        const int fd = ::open(p.c_str(), O_RDONLY);
+        for (ssize_t n; fd >= 0 && (n = ::read(fd, buf.get(), 1u << 20)) > 0;)
+            hash.Update(buf.get(), (std::size_t)n);
+        if (fd >= 0) ::close(fd);
+        return hash.Digest();
+    }
+
+    /*
+    Function: WriteSparse
+    Description: Writes kExtentBytes of data at offset 0 and at kSecondExtent and extends the
+                 file to kFileBytes, leaving holes between and after the extents.
+    Parameters:
+      - p: File to create.
+    Returns:
+      - bool: true if the file was written.
+    */
+    bool WriteSparse(const fs::path& p)
+    {
+        const int fd = ::open(p.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        std::string data(kExtentBytes, 'x');
+        bool ok = ::pwrite(fd, data.data(), data.size(), 0) == (ssize_t)data.size()
+                  && ::pwrite(fd, data.data(), data.size(), (off_t)kSecondExtent) == (ssize_t)data.size()
+                  && ::ftruncate(fd, (off_t)kFileBytes) == 0;
+        ok = ::close(fd) == 0 && ok;
+        return ok;
+    }
+}
+
+/*
+Function: main
+Description: Pastes the sparse file twice (plain and verified) and checks each copy.
+Parameters:
+  - None
+Returns:
+  - int: 0 if every check passed or the test was skipped, 1 otherwise.
+*/
+int main()
+{
+    const fs::path dir = fs::temp_directory_path() / "fm-test-sparse";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "out");
+    const fs::path src = dir / "image.bin";
+    if (!WriteSparse(src))
+    {
+        std::printf("SparseCopyTest: cannot write %s\n", src.string().c_str());
+        return 1;
+    }
+    if (Allocated(src) >= kFileBytes / 2)
+    {
+        std::printf("SparseCopyTest: skipped, %s does not store holes\n", dir.string().c_str());
+        fs::remove_all(dir);
+        return 0;
+    }
+    const std::uint64_t expected = HashFile(src);
+    const std::uint64_t dataBytes = 2 * kExtentBytes;
+
+    FileSystemService service;
+    for (bool verify : { false, true })
+    {
+        const fs::path dst = dir / "out" / src.filename();
+        fs::remove(dst);
+
+        VirtualClipboard clip;
+        clip.source = src;
+        clip.hasItem = true;
+        PasteOptions opts;
+        opts.verify = verify;
+        PasteStats stats;
+        std::string err;
+        Check(service.PasteInto(clip, dir / "out", opts, stats, err), verify ? "verified paste" : "paste");
+        if (!err.empty()) std::printf("SparseCopyTest: %s\n", err.c_str());
+
+        std::error_code ec;
+        Check(fs::file_size(dst, ec) == kFileBytes, "copy has the source's length");
+        Check(HashFile(dst) == expected, "copy reads back the same");
+        Check(stats.bytesCopied == dataBytes, "only the data extents are copied");
+        Check(stats.holeBytes == kFileBytes - dataBytes, "holes reported are the ones skipped");
+        Check(Allocated(dst) <= Allocated(src) + kExtentBytes, "copy allocates no more than the source");
+        Check(Allocated(dst) < kFileBytes / 2, "holes of the copy stay unallocated");
+        Check(stats.verifyFailures.empty(), "verification matches");
+    }
+
+    fs::remove_all(dir);
+    if (g_failures == 0) std::printf("SparseCopyTest: passed\n");
+    return g_failures == 0 ? 0 : 1;
+}